@@ -65,6 +65,9 @@ GT_INLINE bool gt_alignment_get_next_matching_strata(
  */
 GT_INLINE void gt_alignment_sort_by_distance__score(gt_alignment* const alignment);
 GT_INLINE void gt_alignment_sort_by_distance__score_no_split(gt_alignment* const alignment);
+// Counters recalculated along with the sorting (single pass over the maps)
+GT_INLINE void gt_alignment_recalculate_counters_and_sort(gt_alignment* const alignment);
+GT_INLINE void gt_alignment_recalculate_counters_and_sort_no_splits(gt_alignment* const alignment);
 
 /*
  * Alignment's Maps Utils
@@ -80,6 +83,34 @@ GT_INLINE void gt_alignment_merge_alignment_maps_fx(
     int64_t (*gt_map_cmp)(gt_map*,gt_map*),
     gt_alignment* const alignment_dst,gt_alignment* const alignment_src);
 
+/*
+ * Alignment's Maps n-way merge
+ *   Maps are indexed by begin position (positions sharing a key are chained in insertion
+ *   order), so successive merges into the same destination resolve duplicates like
+ *   @gt_alignment_put_map without rescanning (or re-indexing) the destination
+ */
+#define GT_ALIGNMENT_MAP_INDEX_NIL UINT64_MAX
+#define GT_ALIGNMENT_MAP_INDEX_MIN_MAPS 100 // Below this, a linear search is cheaper
+typedef struct {
+  gt_ihash* first_position; // Key -> Position of the first element with that key (uint64_t*)
+  gt_vector* next_position; // Position -> Next position with the same key (uint64_t)
+} gt_alignment_map_index;
+
+GT_INLINE gt_alignment_map_index* gt_alignment_map_index_new(void);
+GT_INLINE void gt_alignment_map_index_clear(gt_alignment_map_index* const map_index);
+GT_INLINE void gt_alignment_map_index_delete(gt_alignment_map_index* const map_index);
+GT_INLINE void gt_alignment_map_index_add(gt_alignment_map_index* const map_index,const int64_t key);
+GT_INLINE uint64_t gt_alignment_map_index_first(gt_alignment_map_index* const map_index,const int64_t key);
+GT_INLINE uint64_t gt_alignment_map_index_next(gt_alignment_map_index* const map_index,const uint64_t position);
+
+GT_INLINE void gt_alignment_map_index_build(gt_alignment_map_index* const map_index,gt_alignment* const alignment);
+GT_INLINE gt_map* gt_alignment_map_index_put_map(
+    int64_t (*gt_map_cmp_fx)(gt_map*,gt_map*),gt_alignment* const alignment,
+    gt_alignment_map_index* const map_index,gt_map* const map,const bool replace_duplicated);
+
+GT_INLINE void gt_alignment_merge_alignment_maps_a(
+    gt_alignment* const alignment_dst,gt_alignment** const alignments_src,const uint64_t num_src_alignments);
+
 GT_INLINE gt_alignment* gt_alignment_union_alignment_maps_va(
     const uint64_t num_src_alignments,gt_alignment* const alignment_src,...);
 #define gt_alignment_union_alignment_maps(alignment_src_A,alignment_src_B) \
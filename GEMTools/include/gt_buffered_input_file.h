@@ -32,6 +32,8 @@ typedef struct {
   uint64_t current_line_num;
   /* Attached output buffer */
   gt_vector* attached_buffered_output_file; /* (gt_buffered_output_file*) */
+  /* Memory pool (owned by the thread that opened the buffered file) */
+  gt_mm_pool* mm_pool;
 } gt_buffered_input_file;
 
 /*
@@ -48,6 +50,7 @@ gt_buffered_input_file* gt_buffered_input_file_new(gt_input_file* const input_fi
 gt_status gt_buffered_input_file_close(gt_buffered_input_file* const buffered_input_file);
 GT_INLINE uint64_t gt_buffered_input_file_get_cursor_pos(gt_buffered_input_file* const buffered_input_file);
 GT_INLINE bool gt_buffered_input_file_eob(gt_buffered_input_file* const buffered_input_file);
+GT_INLINE gt_mm_pool* gt_buffered_input_file_get_mm_pool(gt_buffered_input_file* const buffered_input_file);
 GT_INLINE gt_status gt_buffered_input_file_get_block(
     gt_buffered_input_file* const buffered_input_file,const uint64_t num_lines);
 GT_INLINE gt_status gt_buffered_input_file_add_lines_to_block(
@@ -198,6 +198,11 @@ GT_INLINE uint64_t gt_rand_IID(const uint64_t min,const uint64_t max);
 #define GT_ALL UINT64_MAX
 #define GT_NO_STRATA ((int64_t)(-1))
 
+/*
+ * Forward declarations
+ */
+typedef struct _gt_mm_pool gt_mm_pool; /* Memory pool (gt_mm.h) */
+
 /*
  * Common data processing/formating
  */
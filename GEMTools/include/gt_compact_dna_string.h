@@ -37,6 +37,15 @@
 #define GT_CDNA_EXTRACT_MASK      GT_CDNA_ONE_MASK
 #define GT_CDNA_EXTRACT_LAST_MASK GT_CDNA_ONE_LAST_MASK
 
+/*
+ * CDNA Packed Words
+ *   Up to GT_CDNA_WORD_MAX_CHARS encoded characters packed into a uint64_t
+ *   (GT_CDNA_WORD_CHAR_BITS per character; the first one at the least significant bits)
+ */
+#define GT_CDNA_WORD_CHAR_BITS  3
+#define GT_CDNA_WORD_CHAR_MASK  0x7ull
+#define GT_CDNA_WORD_MAX_CHARS  21
+
 /*
  * CDNA DataStructures
  */
@@ -89,6 +98,13 @@ GT_INLINE void gt_cdna_string_set_char_at(gt_compact_dna_string* const cdna_stri
 GT_INLINE uint64_t gt_cdna_string_get_length(gt_compact_dna_string* const cdna_string);
 GT_INLINE void gt_cdna_string_append_string(gt_compact_dna_string* const cdna_string,const char* const string,const uint64_t length);
 
+/*
+ * Word-level extraction
+ *   Packs @num_chars(<=GT_CDNA_WORD_MAX_CHARS) characters straight from the bitmaps (no decoding)
+ */
+GT_INLINE uint64_t gt_cdna_bitmaps_get_word(uint64_t bm_0,uint64_t bm_1,uint64_t bm_2,const uint64_t num_chars);
+GT_INLINE uint64_t gt_cdna_string_get_word(gt_compact_dna_string* const cdna_string,const uint64_t position,const uint64_t num_chars);
+
 /*
  * Compact DNA String Sequence Iterator
  */
@@ -34,4 +34,22 @@ GT_INLINE void gt_counters_calculate_num_maps(
     uint64_t* num_strata,uint64_t* num_matches);
 GT_INLINE uint64_t gt_counters_reduce_sum(gt_vector* const counters);
 
+/*
+ * Stratum sort
+ *   Stable sort of @num_elements (@element_size bytes each) by stratum (ascending) and score (descending).
+ *   Keys are bucketed (radix/counting sort, no comparisons) as strata are small integers.
+ *   @keys holds the (stratum,score) of each element along with its index (@position). Used as scratch.
+ *   If @counters!=NULL, they are rebuilt with the number of elements of each stratum
+ */
+typedef struct {
+  uint64_t stratum;
+  uint64_t score;
+  uint64_t position;
+} gt_counters_sort_key;
+#define GT_COUNTERS_SORT_STACK_KEYS 32
+
+GT_INLINE void gt_counters_stratum_sort(
+    void* const elements,const uint64_t num_elements,const uint64_t element_size,
+    gt_counters_sort_key* const keys,gt_vector* const counters);
+
 #endif /* GT_COUNTERS_UTILS_H_ */
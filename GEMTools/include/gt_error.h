@@ -274,6 +274,9 @@ gt_status gt_tprintf(const char* format,...);
 #define GT_ERROR_MEM_CURSOR_OUT_OF_SEGMENT "Current memory cursor is out of boundaries (Segmentation fault)"
 #define GT_ERROR_MEM_CURSOR_SEEK "Could not seek to address %"PRIu64". Out of boundaries (Segmentation fault)"
 #define GT_ERROR_MEM_ALG_FAILED "Failed aligning the memory address to the specified boundary"
+#define GT_ERROR_MEM_SLAB_ELEMENT_SIZE "Slab element size (%"PRIu64") exceeds the slab unit size"
+#define GT_ERROR_MEM_SLAB_CAST_IN_USE "Cannot cast slab. Slab has elements in use"
+#define GT_ERROR_MEM_POLICY_UNKNOWN "Unknown memory policy '%.*s' (ignored)"
 #define GT_ERROR_NULL_HANDLER "Null handler or fields not properly allocated"
 #define GT_ERROR_NULL_HANDLER_INFO "Null handler %s "
 
@@ -283,6 +286,7 @@ gt_status gt_tprintf(const char* format,...);
 #define GT_ERROR_SYS_MMAP_FILE "Could not map file '%s' to memory"
 #define GT_ERROR_SYS_UNMAP "Could not unmap memory"
 #define GT_ERROR_SYS_THREAD "Could not create thread"
+#define GT_ERROR_SYS_THREAD_JOIN "Could not join thread"
 #define GT_ERROR_SYS_PIPE "Could not create pipe"
 #define GT_ERROR_SYS_MUTEX "Mutex call error"
 #define GT_ERROR_SYS_MUTEX_INIT "Mutex initialization error"
@@ -348,6 +352,7 @@ gt_status gt_tprintf(const char* format,...);
 // Sequence Archive/Segmented Sequence errors
 #define GT_ERROR_SEGMENTED_SEQ_IDX_OUT_OF_RANGE "Error accessing segmented sequence. Index %"PRIu64" out out range [0,%"PRIu64")"
 #define GT_ERROR_CDNA_IT_OUT_OF_RANGE "Error seeking sequence. Index %"PRIu64" out out range [0,%"PRIu64")"
+#define GT_ERROR_CDNA_WORD_TOO_LONG "Error extracting sequence word. Length %"PRIu64" exceeds the maximum (%"PRIu64")"
 #define GT_ERROR_SEQ_ARCHIVE_WRONG_TYPE "Wrong sequence archive type"
 #define GT_ERROR_SEQ_ARCHIVE_NOT_FOUND "Sequence '%s' not found in reference archive"
 #define GT_ERROR_SEQ_ARCHIVE_POS_OUT_OF_RANGE "Requested position '%"PRIu64"' out of sequence boundaries"
@@ -41,5 +41,8 @@ GT_INLINE void gt_gemIdx_load_archive(
 GT_INLINE int64_t gt_gemIdx_get_bed_sequence_string(
   gt_sequence_archive* const sequence_archive,char* const seq_id,
   const uint64_t position,const uint64_t length,gt_string* const string);
+GT_INLINE int64_t gt_gemIdx_get_bed_sequence_word(
+  gt_sequence_archive* const sequence_archive,char* const seq_id,
+  const uint64_t position,const uint64_t num_chars,uint64_t* const word);
 
 #endif /* GT_GEM_INDEX_LOADER_H_ */
@@ -9,6 +9,8 @@
 #include "gt_string.h"
 #include "gt_vector.h"
 #include "gt_shash.h"
+#include "gt_ihash.h"
+#include "gt_mm.h"
 #include "gt_template.h"
 #include "gt_output_map.h"
 #include "gt_input_map_parser.h"
@@ -24,6 +26,12 @@
 #define GT_GTF_TYPE_EMPTY_BLOCK "empty_block"
 
 #define GTF_DEFAULT_ENTRIES 1000
+#define GT_GTF_INDEX_NIL UINT32_MAX
+#define GT_GTF_INDEX_CHUNK 64
+
+#define GT_GTF_COMPILED_MAGIC 0x5844494654474d47ull /* "GMGTFIDX" little endian */
+#define GT_GTF_COMPILED_VERSION 1
+#define GT_GTF_COMPILED_NIL UINT32_MAX
 #define GTF_MAX_LINE_LENGTH 2048
 
 #define GT_GTF_INVALID_LINE 10
@@ -69,15 +77,33 @@ typedef struct {
 	gt_string* gene_type; // the gene id if it exists
 } gt_gtf_entry;
 
-typedef struct _gt_gtf_node gt_gtf_node;
-
-struct _gt_gtf_node {
+/**
+ * Centered interval tree node of the flattened per reference index.
+ * Nodes are laid out in pre-order and point to their children and to
+ * their (start sorted) slice of the index entry arrays by position.
+ */
+typedef struct {
   uint64_t midpoint;
-  gt_vector* entries_by_start;
-  gt_vector* entries_by_end;
-  gt_gtf_node* left;
-  gt_gtf_node* right;
-} ;
+  uint32_t entries_offset; // first entry of the node in the index arrays
+  uint32_t num_entries; // number of entries overlapping the midpoint
+  uint32_t left; // left child or GT_GTF_INDEX_NIL
+  uint32_t right; // right child or GT_GTF_INDEX_NIL
+} gt_gtf_index_node;
+
+/**
+ * Flattened interval index. The entry starts and ends are kept in
+ * separate arrays next to the entries so the overlap tests of a node
+ * run over contiguous memory.
+ */
+typedef struct {
+  gt_gtf_index_node* nodes; // root at position 0
+  gt_gtf_entry** entries;
+  uint64_t* starts; // start of the entry at the same position
+  uint64_t* ends; // end of the entry at the same position
+  uint64_t num_nodes;
+  uint64_t num_entries;
+  bool mapped; // nodes, starts and ends point into a compiled annotation file
+} gt_gtf_index;
 
 /**
  * Single chromosome reference with
@@ -85,9 +111,36 @@ struct _gt_gtf_node {
  */
 typedef struct {
 	gt_vector* entries; // gt_gtf_entry list
-	gt_gtf_node* node; // gt_gtf_entry list
+	gt_gtf_index* index; // interval index over the entries
 } gt_gtf_ref;
 
+/**
+ * On-disk entry of a compiled annotation. Strings are
+ * referenced by their position in the string pool.
+ */
+typedef struct {
+  uint64_t uid;
+  uint64_t start;
+  uint64_t end;
+  uint64_t num_children;
+  uint64_t length;
+  uint32_t strand;
+  uint32_t type; // string id or GT_GTF_COMPILED_NIL
+  uint32_t gene_id;
+  uint32_t transcript_id;
+  uint32_t gene_type;
+  uint32_t padding;
+} gt_gtf_compiled_entry;
+
+/**
+ * Single region query for the batched search
+ */
+typedef struct {
+  char* ref; // reference name, NULL queries match nothing
+  uint64_t start;
+  uint64_t end;
+} gt_gtf_query;
+
 /**
  * GTF file with a map to the chromosome references
  * and all available types (exon, gene, ...).
@@ -100,6 +153,9 @@ typedef struct {
 	gt_shash* gene_types; // maps from char* to gt_string* for gene_types char* -> gt_string*
 	gt_shash* genes; // maps from char* to gt_gtf_entry for genes
 	gt_shash* transcripts; // maps from char* to gt_gtf_entry for genes
+	gt_mm* mm; // memory map of a compiled annotation, NULL for parsed annotations
+	gt_vector* compiled_strings; // gt_string* list referencing the compiled string pool
+	gt_gtf_entry* compiled_entries; // entries of a compiled annotation
 }gt_gtf;
 
 /**
@@ -177,6 +233,12 @@ GT_INLINE void gt_gtf_entry_delete(gt_gtf_entry* const entry);
 GT_INLINE gt_gtf_ref* gt_gtf_ref_new(void);
 GT_INLINE void gt_gtf_ref_delete(gt_gtf_ref* const ref);
 
+/**
+ * Create and delete the interval index over a start sorted entry list
+ */
+GT_INLINE gt_gtf_index* gt_gtf_index_new(gt_vector* const entries);
+GT_INLINE void gt_gtf_index_delete(gt_gtf_index* const index);
+
 /**
  * Parse GTF files and return a new gt_gtf*. The ref entries
  * will be sorted by star,end,type
@@ -185,6 +247,17 @@ GT_INLINE gt_gtf* gt_gtf_read(gt_input_file* input, uint64_t threads);
 GT_INLINE gt_gtf* gt_gtf_read_from_stream(FILE* input, uint64_t threads);
 GT_INLINE gt_gtf* gt_gtf_read_from_file(char* input, uint64_t threads);
 
+/**
+ * Compiled annotations. gt_gtf_write_compiled() stores a read annotation, including the
+ * synthesized introns and the interval indexes, in a binary file. gt_gtf_read_compiled()
+ * maps such a file and uses the index arrays and the string pool in place, so concurrent
+ * jobs share one copy through the page cache. gt_gtf_read_from_file() detects compiled
+ * files automatically.
+ */
+GT_INLINE void gt_gtf_write_compiled(const gt_gtf* const gtf, char* const file_name);
+GT_INLINE gt_gtf* gt_gtf_read_compiled(char* const file_name);
+GT_INLINE bool gt_gtf_is_compiled(char* const file_name);
+
 /**
  * Access the chromosome refs
  */
@@ -241,6 +314,13 @@ GT_INLINE uint64_t gt_gtf_count_map(const gt_gtf* const gtf, gt_map* const map1,
  * vector. Note that the target vector is cleared at the beginning of the method!
  */
 GT_INLINE uint64_t gt_gtf_search(const gt_gtf* const gtf, gt_vector* const target, char* const ref, const uint64_t start, const uint64_t end, const bool clean_target);
+/**
+ * Search a batch of regions. Hits are appended to the target vector and offsets is filled with
+ * num_queries+1 positions so the hits of query i are target[offsets[i]..offsets[i+1]). Queries
+ * sorted by reference and position (i.e. the blocks of a map or a sorted block of maps)
+ * resolve each reference only once. Note that target and offsets are cleared at the beginning.
+ */
+GT_INLINE uint64_t gt_gtf_search_batch(const gt_gtf* const gtf, gt_vector* const target, gt_vector* const offsets, const gt_gtf_query* const queries, const uint64_t num_queries);
 /**
  * Search for exons that overlap with the given template mappings.
  */
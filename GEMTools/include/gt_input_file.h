@@ -63,6 +63,18 @@ typedef struct {
   uint64_t processed_lines;
   /* ID generator */
   uint64_t processed_id;
+  /* Asynchronous refills (double buffering) */
+  bool prefetch_enabled;
+  pthread_t prefetch_thread;
+  pthread_mutex_t prefetch_mutex;
+  pthread_cond_t prefetch_cond;
+  uint8_t* prefetch_buffer;   /* Next block (read ahead by the prefetch thread) */
+  uint64_t prefetch_size;
+  bool prefetch_ready;
+  bool prefetch_eof;
+  bool prefetch_exit;
+  /* Readahead hints (mapped files) */
+  uint64_t readahead_pos;
 } gt_input_file;
 
 /*
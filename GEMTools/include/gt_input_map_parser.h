@@ -118,8 +118,11 @@ typedef struct {
   uint64_t max_parsed_maps; // Maximum number of maps to be parsed
   bool skip_based_model; // Allows only mismatches & skips in the cigar string
   bool remove_duplicates; // Instead of strictly parse the record, tries to merge duplicates (sort of cleanup in case of bugs ...)
+  /* Block reading */
+  bool synch_segmented_reads; // Never split records sharing the same tag (segmented reads) across blocks
   /* Auxiliary Buffers */
   gt_string* src_text; // Source text line parsed (parsing from file)
+  gt_mm_pool* mm_pool; // Memory pool the parsed maps are drawn from (set while parsing from a buffered input)
 } gt_map_parser_attributes;
 #define GT_MAP_PARSER_ATTR_DEFAULT(_force_read_paired) { \
   /* PE/SE */ \
@@ -128,8 +131,11 @@ typedef struct {
   .max_parsed_maps=GT_ALL,  \
   .skip_based_model=false, \
   .remove_duplicates=false, \
+  /* Block reading */ \
+  .synch_segmented_reads=false, \
   /* Auxiliary Buffers */ \
   .src_text=NULL, \
+  .mm_pool=NULL, \
 }
 #define GT_MAP_PARSER_CHECK_ATTRIBUTES(attributes) \
   gt_map_parser_attributes __##attributes; \
@@ -146,6 +152,7 @@ GT_INLINE void gt_input_map_parser_attributes_reset_defaults(gt_map_parser_attri
 GT_INLINE bool gt_input_map_parser_attributes_is_paired(gt_map_parser_attributes* const attributes);
 GT_INLINE void gt_input_map_parser_attributes_set_paired(gt_map_parser_attributes* const attributes,const bool force_read_paired);
 GT_INLINE void gt_input_map_parser_attributes_set_max_parsed_maps(gt_map_parser_attributes* const attributes,const uint64_t max_parsed_maps);
+GT_INLINE void gt_input_map_parser_attributes_set_synch_segmented_reads(gt_map_parser_attributes* const attributes,const bool synch_segmented_reads);
 GT_INLINE void gt_input_map_parser_attributes_set_src_text(gt_map_parser_attributes* const attributes,gt_string* const src_text);
 GT_INLINE void gt_input_map_parser_attributes_set_skip_model(gt_map_parser_attributes* const attributes,const bool skip_based_model);
 GT_INLINE void gt_input_map_parser_attributes_set_duplicates_removal(gt_map_parser_attributes* const attributes,const bool remove_duplicates);
@@ -51,6 +51,8 @@ struct _gt_map {
   gt_map_junction next_block;
   /* Attributes */
   gt_attributes* attributes;
+  /* Memory pool (NULL if allocated with malloc) */
+  gt_mm_pool* mm_pool;
 };
 
 // Iterators
@@ -91,6 +93,7 @@ typedef struct {
  * Setup
  */
 GT_INLINE gt_map* gt_map_new(void);
+GT_INLINE gt_map* gt_map_new_from_pool(gt_mm_pool* const mm_pool);
 GT_INLINE void gt_map_clear(gt_map* const map);
 GT_INLINE void gt_map_delete(gt_map* const map);
 
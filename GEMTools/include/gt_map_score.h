@@ -26,7 +26,30 @@ GT_INLINE void gt_map_set_phred_score(gt_map* const map,const uint8_t phred_scor
  * TODO
  * fx(MAP) Scoring functions
  * fx(ALIGNMENT,MAP) Scoring functions
+ */
+
+/*
  * fx(TEMPLATE) Scoring functions
+ *   MAPQ of every distinct end location and paired location of a scored template
+ *   (Posterior probability over the template's gt_score likelihoods, phred scaled)
  */
+#define GT_MAP_SCORE_MAPQ_MAX 254
+#define GT_MAP_SCORE_EXP_TABLE_SIZE 1024
+typedef struct {
+  gt_string* seq_name[2];
+  uint64_t position[2];
+  uint64_t score;
+  uint64_t order;       // Position of first appearance
+  uint8_t* phred_score; // Destination (map or mmap attributes)
+} gt_map_score_mapq_entry;
+typedef struct {
+  gt_vector* entries[3];    /* (gt_map_score_mapq_entry) End1, End2, Paired */
+  gt_vector* first_scores;  /* (uint64_t) */
+  double exp_table[GT_MAP_SCORE_EXP_TABLE_SIZE]; // exp(-log(10)/10*d)
+} gt_map_score_mapq_scratch;
+
+GT_INLINE gt_map_score_mapq_scratch* gt_map_score_mapq_scratch_new();
+GT_INLINE void gt_map_score_mapq_scratch_delete(gt_map_score_mapq_scratch* const scratch);
+GT_INLINE void gt_map_score_template_mapq(gt_template* const template,gt_map_score_mapq_scratch* const scratch);
 
 #endif /* GT_MAP_SCORE_H_ */
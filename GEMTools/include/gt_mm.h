@@ -15,9 +15,8 @@
  *         Objects of a certain type are ready to go inside the slab, thus reducing
  *         the overhead of malloc/setup/free cycles along the program
  *     - PoolMemory
- *         Pool of Slabs as gather all slabs needed along a program
- *         The goal is to minimize all memory malloc/setup/free overhead
- *         Offers thread safe allocation of slabs as to balance memory consumption across threads
+ *         Per-thread pool of size-classed slabs. The goal is to minimize all memory malloc/setup/free
+ *         overhead (and malloc arena contention) along a program. Memory can be freed from any thread
  */
 
 #ifndef GT_MEMORY_MANAGEMENT_H_
@@ -94,6 +93,24 @@ extern const uint64_t gt_mm_mem_alignment_bits_mask[];
 GT_INLINE char* gt_mm_get_tmp_folder();
 GT_INLINE void gt_mm_set_tmp_folder(char* const tmp_folder_path);
 
+/*
+ * Memory policy for bulk buffers (I/O blocks, output buffers, ...)
+ *   Set with gt_mm_set_policy() or through the environment variable GT_MM_POLICY
+ *   as a comma separated list of {default,thp,hugetlb,numa} (e.g. GT_MM_POLICY=thp,numa)
+ *   The policy is applied when the buffer is allocated. Buffers held in a gt_vector lose it
+ *   if the vector grows (realloc), although a thread buffer keeps its first-touch placement
+ */
+#define GT_MM_POLICY_ENV "GT_MM_POLICY"
+#define GT_MM_POLICY_DEFAULT 0x0 /* Plain malloc'd memory */
+#define GT_MM_POLICY_THP     0x1 /* Transparent hugepages (madvise) */
+#define GT_MM_POLICY_HUGETLB 0x2 /* Explicit hugepages for anonymous mappings (MAP_HUGETLB) */
+#define GT_MM_POLICY_NUMA    0x4 /* First-touch. Thread buffers on the worker's node, shared ones interleaved */
+
+GT_INLINE uint64_t gt_mm_parse_policy(const char* const policy_string);
+GT_INLINE uint64_t gt_mm_get_policy();
+GT_INLINE void gt_mm_set_policy(const uint64_t policy);
+GT_INLINE void gt_mm_advise_bulk_buffer(void* const memory,const uint64_t num_bytes,const bool thread_buffer);
+
 /*
  * UnitMemory
  *   Allocate relative small chunks of memory relying on the regular memory manager,
@@ -124,6 +141,7 @@ typedef struct {
   void* memory;           /* Pointer to block of memory */
   void* cursor;           /* Pointer current position of memory */
   /* Mapped File Memory*/
+  uint64_t mapped;        /* Total mapped Bytes (whole hugepages if MAP_HUGETLB) */
   int fd;                 /* File descriptor */
   char *file_name;        /* File name */
 } gt_mm;
@@ -204,21 +222,16 @@ GT_INLINE void gt_mm_write_mem(gt_mm* const mm,void* const src,const uint64_t nu
  *   Objects of a certain type are ready to go inside the slab, thus reducing
  *   the overhead of malloc/setup/free cycles along the program
  */
-#define GT_MM_NUM_INITIAL_SLABS 10 /* 1 SysPage => (usually) => 4KB => 514*(uint64_t) */
-typedef enum { GT_SLAB_EMPTY, GT_SLAB_PARTIAL, GT_SLAB_FULL } gt_mm_slab_state;
-typedef struct {
-  void* memory;                 /* Memory chunk of PageSize Bytes */
-  uint64_t* occupancy_map;      /* Bitmap with 1-Allocated/0-Free */
-  uint64_t element_size;
-  uint64_t total_elements;
-  uint64_t allocated_elements;
-} gt_mm_slab_unit;
+#define GT_MM_SLAB_UNIT_SIZE (64*1024) /* 64KB per slab unit */
+#define GT_MM_NUM_INITIAL_SLABS 1
 typedef struct {
   /* Slab Units */
   uint64_t element_size;
-  gt_vector* slabs_units; /* (gt_mm_slab_unit*) */
-  /* Internals */
-  uint64_t page_size;     /* System Page Size (Constant) */
+  uint64_t elements_per_unit;
+  gt_vector* slabs_units;      /* (void*) Memory chunks of GT_MM_SLAB_UNIT_SIZE Bytes */
+  /* Free elements */
+  void* free_elements;         /* Free list (chained through the first word of each element) */
+  uint64_t allocated_elements; /* Elements currently handed out */
 } gt_mm_slab;
 
 #define gt_mm_slab_new(type) (gt_mm_slab_new_(sizeof(type),GT_MM_NUM_INITIAL_SLABS))
@@ -232,20 +245,46 @@ GT_INLINE void gt_mm_slab_free(gt_mm_slab* const slab,void* mem_addr);
 
 /*
  * PoolMemory
- *   Pool of Slabs as gather all slabs needed along a program
- *   The goal is to minimize all memory malloc/setup/free overhead
- *   Offers thread safe allocation of slabs as to balance memory consumption across threads
+ *   Per-thread pool of size-classed slabs (16B..4KB, powers of two)
+ *     - Allocations are served by the owner thread (the one calling gt_mm_pool_new) without locking.
+ *       Bigger requests, or requests issued from any other thread, fall back to malloc
+ *     - Any thread can free pool memory. Frees from other threads are pushed (lock-free)
+ *       into a return list that the owner drains when a size class runs empty
+ *     - Deleting the pool with objects still alive is allowed. The pool memory is released
+ *       once the last of them is freed (from any thread)
  */
+#define GT_MM_POOL_MIN_SIZE_CLASS_LOG2 4  /* 16B */
+#define GT_MM_POOL_MAX_SIZE_CLASS_LOG2 12 /* 4KB */
+#define GT_MM_POOL_NUM_SIZE_CLASSES (GT_MM_POOL_MAX_SIZE_CLASS_LOG2-GT_MM_POOL_MIN_SIZE_CLASS_LOG2+1)
+#define GT_MM_POOL_MAX_SIZE_CLASS (1ull<<GT_MM_POOL_MAX_SIZE_CLASS_LOG2)
 typedef struct {
-  // Slab Pool
-  gt_vector* free_slabs_units; /* (gt_mm_slab_unit*) */
-
-  // Concurrent items
-  uint64_t pool_id;
-  pthread_mutex_t input_mutex;
-} gt_mm_pool;
+  uint64_t num_allocs;       /* Allocations served from the slabs */
+  uint64_t num_frees;        /* Frees from the owner thread */
+  uint64_t num_remote_frees; /* Frees from other threads (atomic) */
+  uint64_t num_cas_retries;  /* Failed CAS pushing into the return list (atomic) */
+  uint64_t num_fallbacks;    /* Allocations delegated to malloc (atomic) */
+} gt_mm_pool_stats;
+struct _gt_mm_pool {
+  /* Size-classed slabs (owner thread only) */
+  gt_mm_slab* slabs[GT_MM_POOL_NUM_SIZE_CLASSES];
+  pthread_t owner_thread;
+  bool orphaned;             /* Deleted by the owner (objects still alive) */
+  /* Return path for cross-thread frees */
+  void* remote_free_list;    /* Lock-free LIFO of freed elements */
+  int64_t orphaned_balance;  /* Elements alive after deletion */
+  /* Stats */
+  gt_mm_pool_stats stats;
+};
 
 GT_INLINE gt_mm_pool* gt_mm_pool_new();
-GT_INLINE gt_mm_pool* gt_mm_pool_get_new_instance(gt_mm_pool* mm_pool);
+GT_INLINE void gt_mm_pool_delete(gt_mm_pool* const pool);
+
+GT_INLINE void* gt_mm_pool_malloc(gt_mm_pool* const pool,const uint64_t num_bytes);
+GT_INLINE void* gt_mm_pool_realloc(void* const mem_addr,const uint64_t num_bytes);
+GT_INLINE void gt_mm_pool_free(void* const mem_addr);
+GT_INLINE uint64_t gt_mm_pool_get_capacity(void* const mem_addr);
+
+GT_INLINE gt_mm_pool_stats* gt_mm_pool_get_stats(gt_mm_pool* const pool);
+GT_INLINE void gt_mm_pool_profile(gt_mm_pool* const pool);
 
 #endif /* GT_MEMORY_MANAGEMENT_H_ */
@@ -69,5 +69,7 @@ GT_INLINE gt_status gt_vbprintf_(
     const char *template,va_list v_args);
 GT_INLINE gt_status gt_bprintf_(
     gt_output_buffer* const output_buffer,const uint64_t expected_mem_usage,const char *template,...);
+// Raw copy (no formatting)
+GT_INLINE gt_status gt_bwrite(gt_output_buffer* const output_buffer,const char* const data,const uint64_t length);
 
 #endif /* GT_OUTPUT_BUFFER_H_ */
@@ -29,6 +29,24 @@
  * SAM Output attributes
  */
 typedef enum { GT_SAM, GT_BAM } gt_output_sam_format_t;
+/*
+ * Optional fields emission plan
+ *   @sam_attributes compiled (in printing order) into emitters with their text pre-rendered
+ *   (the whole field for constant values, the "\tTG:T:" prefix otherwise)
+ */
+#define GT_OUTPUT_SAM_OF_PREFIX_LENGTH 6
+typedef struct {
+  gt_sam_attribute attribute; // Copy of the attribute (tag,type,value/function,scope)
+  uint64_t text_offset;       // Pre-rendered text within @optional_fields_text
+  uint64_t text_length;
+  /* Record-scoped value cache ([0] mapped lines, [1] unmapped lines) */
+  uint64_t cached_record[2];  // Record the value belongs to (0 none)
+  gt_status cached_status[2];
+  int32_t cached_i[2];
+  float cached_f[2];
+  uint64_t cached_s_offset[2]; // String values within @optional_fields_record_values
+  uint64_t cached_s_length[2];
+} gt_output_sam_of_emitter;
 typedef struct {
   /* Format */
   gt_output_sam_format_t format; // TODO
@@ -44,6 +62,22 @@ typedef struct {
   bool print_optional_fields;
   gt_sam_attributes* sam_attributes; // Optional fields stored as sam_attributes
   gt_sam_attribute_func_params* attribute_func_params; // Parameters provided to generate functional attributes
+  bool optional_fields_plan_valid;                     // Emission plan of @sam_attributes
+  uint64_t optional_fields_plan_num_attributes;        // Number of attributes compiled (rebuilt if it changes)
+  gt_vector* optional_fields_plan;                     // (gt_output_sam_of_emitter)
+  gt_string* optional_fields_text;                     // Pre-rendered text of the emitters
+  gt_string* optional_fields_record_values;            // String values of record-scoped attributes
+  /* Record cache (Valid while printing one template/alignment. Attributes cannot be shared among threads) */
+  bool record_cache_active;
+  uint64_t record_id;                // Current record (never 0 while active)
+  bool read__qualities_rc_cached[2];
+  gt_string* read_rc[2];             // Reverse-complemented read of each end
+  gt_string* qualities_r[2];         // Reversed qualities of each end
+  gt_string* qualities_offset33[2];  // Qualities of each end adapted to offset-33
+  bool encode_md;                    // MD:Z requested (encoded along with the CIGAR)
+  gt_string* encoding_buffer;        // CIGARs/MDs of the record's map segments
+  gt_vector* map_encodings;          // (gt_sam_map_encoding)
+  gt_vector* map_encodings_index;    // Open addressing over @map_encodings (uint32_t; position+1, 0 empty)
 } gt_output_sam_attributes;
 /*
  * BAM record
@@ -87,6 +121,8 @@ GT_INLINE void gt_output_sam_attributes_set_print_mismatches(gt_output_sam_attri
 /* SAM Optional Fields */
 GT_INLINE void gt_output_sam_attributes_set_print_optional_fields(gt_output_sam_attributes* const attributes,const bool print_optional_fields);
 GT_INLINE void gt_output_sam_attributes_set_reference_sequence_archive(gt_output_sam_attributes* const attributes,gt_sequence_archive* const reference_sequence_archive);
+GT_INLINE void gt_output_sam_attributes_set_splice_motifs(gt_output_sam_attributes* const attributes,gt_sam_splice_motifs* const splice_motifs);
+/* Resets the optional fields emission plan (rebuilt on the next record) */
 GT_INLINE gt_sam_attributes* gt_output_sam_attributes_get_sam_attributes(gt_output_sam_attributes* const attributes);
 
 /*
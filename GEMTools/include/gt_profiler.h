@@ -44,7 +44,12 @@
   // #define GT_RC_
 
   // EC:: Event Counters [400,...]
-  // #define GT_EC_
+  #define GT_EC_MM_POOL_ALLOCS       400 /* gt_mm_pool allocations served from slabs */
+  #define GT_EC_MM_POOL_FREES        401 /* gt_mm_pool frees from the owner thread */
+  #define GT_EC_MM_POOL_REMOTE_FREES 402 /* gt_mm_pool frees from other threads */
+  #define GT_EC_MM_POOL_CAS_RETRIES  403 /* gt_mm_pool contention on the return list */
+  #define GT_EC_MM_POOL_FALLBACKS    404 /* gt_mm_pool allocations delegated to malloc */
+  #define GT_EC_MM_POOL_SLAB_UNITS   405 /* gt_mm_pool slab units allocated */
 
   // TIME counters
   extern struct timeval *gt_prof_begin_timer;
@@ -70,7 +70,53 @@ GT_INLINE void gt_sam_header_add_comment(gt_sam_headers* const sam_headers,gt_st
  */
 typedef enum { SAM_ATTR_INT_VALUE, SAM_ATTR_FLOAT_VALUE, SAM_ATTR_STRING_VALUE,
                SAM_ATTR_INT_FUNC,  SAM_ATTR_FLOAT_FUNC,  SAM_ATTR_STRING_FUNC } gt_sam_attribute_t;
+/*
+ * Scope of a functional attribute
+ *   SAM_ATTR_SCOPE_MAP    => Value depends on the map printed (generated for each SAM line)
+ *   SAM_ATTR_SCOPE_RECORD => Value depends only on the template/alignment (and on whether the line is mapped)
+ *                            so it can be generated once per record (see gt_output_sam)
+ */
+typedef enum { SAM_ATTR_SCOPE_MAP, SAM_ATTR_SCOPE_RECORD } gt_sam_attribute_scope;
 typedef gt_shash gt_sam_attributes;
+/*
+ * Splice-site motifs (XS strand inference)
+ *   Table of intron {donor,acceptor} dinucleotides (as read on the forward strand of the reference)
+ *   indexed by their packed encoding (see gt_cdna_string_get_word()) giving the transcription strand
+ */
+#define GT_SAM_SPLICE_MOTIF_LENGTH 2
+#define GT_SAM_SPLICE_MOTIF_WORD_BITS (GT_SAM_SPLICE_MOTIF_LENGTH*GT_CDNA_WORD_CHAR_BITS)
+#define GT_SAM_SPLICE_MOTIFS_TABLE_SIZE (1<<(2*GT_SAM_SPLICE_MOTIF_WORD_BITS))
+#define GT_SAM_SPLICE_MOTIFS_DEFAULT "GT-AG,GC-AG,AT-AC"
+
+#define GT_SAM_XS_UNKNOWN   0
+#define GT_SAM_XS_FORWARD   1
+#define GT_SAM_XS_REVERSE   2
+#define GT_SAM_XS_AMBIGUOUS (GT_SAM_XS_FORWARD|GT_SAM_XS_REVERSE)
+
+typedef struct {
+  uint8_t strand[GT_SAM_SPLICE_MOTIFS_TABLE_SIZE]; // GT_SAM_XS_* for each {donor,acceptor}
+} gt_sam_splice_motifs;
+/*
+ * Junction cache
+ *   Strand already inferred for each junction {contig,donor,acceptor} (one per thread)
+ */
+typedef struct {
+  gt_sam_splice_motifs* default_motifs; // Used if no motifs are given (GT_SAM_SPLICE_MOTIFS_DEFAULT)
+  gt_shash* contigs_junctions;          // Junctions per contig (gt_ihash*<uint8_t>)
+  gt_string* contig_name;               // Last contig looked up (EOS-terminated)
+  gt_ihash* junctions;                  // Its junctions
+} gt_sam_junction_cache;
+
+GT_INLINE gt_sam_splice_motifs* gt_sam_splice_motifs_new();
+GT_INLINE void gt_sam_splice_motifs_clear(gt_sam_splice_motifs* const splice_motifs);
+GT_INLINE void gt_sam_splice_motifs_delete(gt_sam_splice_motifs* const splice_motifs);
+/* Adds the motif (forward strand) together with its reverse complement (reverse strand) */
+GT_INLINE bool gt_sam_splice_motifs_add(gt_sam_splice_motifs* const splice_motifs,const char* const donor,const char* const acceptor);
+/* Parses a list of motifs {DONOR-ACCEPTOR}[,...] (e.g. GT_SAM_SPLICE_MOTIFS_DEFAULT) */
+GT_INLINE gt_status gt_sam_splice_motifs_parse(gt_sam_splice_motifs* const splice_motifs,const char* const motifs_list);
+GT_INLINE uint8_t gt_sam_splice_motifs_get_strand(
+    gt_sam_splice_motifs* const splice_motifs,const uint64_t donor_word,const uint64_t acceptor_word);
+
 typedef struct {
   /* Return Values
    *   Depending on the function type, the proper field will be returned/output
@@ -95,10 +141,22 @@ typedef struct {
   gt_vector* mmap_placeholder; // gt_vector<gt_map_placeholder>
   /* Attributes */
   gt_attributes* attributes;
+  /*
+   * Map Encoding
+   *   CIGAR/MD/NM of @alignment_info->map if already generated by the SAM printer (NULL otherwise)
+   */
+  struct _gt_sam_map_encoding* map_encoding;
+  gt_string* map_encoding_buffer;
+  /*
+   * Splice-site strand inference (XS)
+   */
+  gt_sam_splice_motifs* splice_motifs;   // Motifs table (shared; NULL for the default ones)
+  gt_sam_junction_cache* junction_cache; // Junctions already seen (allocated on demand)
 } gt_sam_attribute_func_params;
 typedef struct {
   char tag[2];
   gt_sam_attribute_t attribute_type;
+  gt_sam_attribute_scope scope;
   char type_id;
   union {
     /* Values */
@@ -163,6 +221,8 @@ GT_INLINE void gt_sam_attribute_func_params_delete(gt_sam_attribute_func_params*
 GT_INLINE void gt_sam_attribute_func_params_clear(gt_sam_attribute_func_params* const func_params);
 GT_INLINE void gt_sam_attribute_func_params_set_sequence_archive(
     gt_sam_attribute_func_params* const func_params,gt_sequence_archive* const sequence_archive);
+GT_INLINE void gt_sam_attribute_func_params_set_splice_motifs(
+    gt_sam_attribute_func_params* const func_params,gt_sam_splice_motifs* const splice_motifs);
 GT_INLINE void gt_sam_attribute_func_params_set_sam_flags(
     gt_sam_attribute_func_params* const func_params,const bool not_passing_QC,const bool PCR_duplicate);
 
@@ -175,6 +235,28 @@ GT_INLINE void gt_sam_attribute_func_params_set_pe(
     gt_sam_attribute_func_params* const func_params,gt_template* const template,
     uint64_t paired_end_position,gt_map* const map,gt_map* const mate,gt_mmap_attributes* const mmap_attributes);
 
+/*
+ * SAM Map Encoder
+ *   Generates the CIGAR, MD:Z and NM:i of a map segment walking its mismatches once.
+ *   Fields are written (no formatted printing) at the end of @buffer with a single reservation
+ *   (@buffer is used as a byte array, it's not EOS-terminated)
+ */
+#define GT_SAM_ENCODER_BAD_MISMS 10
+
+typedef struct _gt_sam_map_encoding {
+  gt_map* map;           // Map segment
+  uint64_t cigar_offset; // CIGAR (hard-trims not included) within the buffer
+  uint64_t cigar_length;
+  uint64_t md_offset;    // MD:Z within the buffer
+  uint64_t md_length;
+  bool md_encoded;       // MD:Z generated (SAM deletions require the reference)
+  int32_t nm;            // NM:i
+} gt_sam_map_encoding;
+
+GT_INLINE gt_status gt_sam_map_encode(
+    gt_string* const buffer,gt_map* const map_segment,const bool print_mismatches,
+    const bool encode_md,gt_sequence_archive* const sequence_archive,gt_sam_map_encoding* const map_encoding);
+
 /*
  * Functional Internal Data
  *   Storage for calculation to do once for all template/alignmet/map SAM output
@@ -210,6 +292,8 @@ GT_INLINE void gt_sam_attribute_func_params_set_pe(
 //  HI  i  Query hit index, indicating the alignment record is the i-th one stored in SAM
 //  IH  i  Number of stored alignments in SAM that contains the query in the current record
 //  MD  Z  String for mismatching positions. Regex : [0-9]+(([A-Z]|\^[A-Z]+)[0-9]+)*
+//         (Omitted for alignments with deletions if no reference is available)
+GT_INLINE void gt_sam_attributes_add_tag_MD(gt_sam_attributes* const sam_attributes);
 //  MQ  i  Mapping quality of the mate/next segment
 GT_INLINE void gt_sam_attributes_add_tag_MQ(gt_sam_attributes* const sam_attributes);
 
@@ -275,6 +359,8 @@ GT_INLINE void gt_sam_attributes_add_tag_cs(gt_sam_attributes* const sam_attribu
 //  md  Z  GEM CIGAR String
 GT_INLINE void gt_sam_attributes_add_tag_md(gt_sam_attributes* const sam_attributes);
 //  XS  A  XS directionality information
+//         Strand of the split maps inferred from the splice-site motifs of their junctions
+//         (requires the reference sequences; not printed if unknown or contradictory)
 GT_INLINE void gt_sam_attributes_add_tag_XS(gt_sam_attributes* const sam_attributes);
 
 #endif /* GT_SAM_DATA_ATTRIBUTES_H_ */
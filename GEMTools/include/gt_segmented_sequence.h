@@ -71,6 +71,8 @@ GT_INLINE void gt_segmented_sequence_append_string(gt_segmented_sequence* const
 
 GT_INLINE gt_status gt_segmented_sequence_get_sequence(
     gt_segmented_sequence* const sequence,const uint64_t position,const uint64_t length,gt_string* const string);
+GT_INLINE gt_status gt_segmented_sequence_get_word(
+    gt_segmented_sequence* const sequence,const uint64_t position,const uint64_t num_chars,uint64_t* const word);
 /*
  * SegmentedSEQ Iterator
  */
@@ -91,6 +91,14 @@ GT_INLINE gt_status gt_sequence_archive_get_sequence_string(
 GT_INLINE gt_status gt_sequence_archive_retrieve_sequence_chunk(
     gt_sequence_archive* const seq_archive,char* const seq_id,const gt_strand strand,
     const uint64_t position,const uint64_t length,const uint64_t extra_length,gt_string* const string);
+/*
+ * SequenceARCHIVE retrieve packed words (forward strand)
+ *   @num_chars(<=GT_CDNA_WORD_MAX_CHARS) encoded characters from @position(0-based) packed into @word
+ *   as in gt_cdna_string_get_word(). Errors are just returned (not reported)
+ */
+GT_INLINE gt_status gt_sequence_archive_get_sequence_word(
+    gt_sequence_archive* const seq_archive,char* const seq_id,
+    const uint64_t position,const uint64_t num_chars,uint64_t* const word);
 
 /*
  * SequenceARCHIVE sorting functions
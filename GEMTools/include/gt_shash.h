@@ -61,6 +61,7 @@ GT_INLINE void gt_shash_remove(gt_shash* const shash,char* const key,const bool
 #define gt_shash_insert(shash,string_key,element,type) gt_shash_insert_primitive(shash,string_key,(void*)element,sizeof(type))
 #define gt_shash_insert_string(shash,string_key,string) gt_shash_insert_object(shash,string_key,(void*)string,(void*(*)())gt_string_dup,(void(*)())gt_string_delete)
 GT_INLINE bool gt_shash_is_contained(gt_shash* const shash,char* const key);
+GT_INLINE bool gt_shash_is_contained_nstring(gt_shash* const shash,char* const key,const uint64_t key_length);
 GT_INLINE uint64_t gt_shash_get_num_elements(gt_shash* const shash);
 
 /*
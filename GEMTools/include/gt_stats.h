@@ -143,6 +143,7 @@
 #define GT_STATS_DOMINANT_RANGE 7
 
 #define GT_STATS_DIVERSITY_DOMINANT_RANGE (GT_STATS_DIVERSITY_RANGE*GT_STATS_DOMINANT_RANGE)
+#define GT_STATS_POPULATION_CONTIGS 1000 /* Initial number of contigs (grows on demand) */
 
 /*
  * Stats Data Structures
@@ -219,9 +220,13 @@ typedef struct {
   // Quimeras
   uint64_t num_map_quimeras;
   uint64_t num_pair_quimeras;
-  // Aux
-  gt_shash* _local_diversity_hash;    // Auxiliary hash for diversity
-  gt_shash* _global_diversity_hash;   // Auxiliary hash for diversity
+  // Aux (Dense per-contig counters indexed by the local contig ID)
+  gt_shash* _contig_id_hash;   // Contig name -> Contig ID (uint64_t)
+  gt_vector* _contig_names;    // Contig ID -> Contig name (char*)
+  gt_vector* _local_counts;    // Contig ID -> #Maps in the current template (uint64_t)
+  gt_vector* _local_touched;   // Contig IDs touched by the current template (uint64_t)
+  gt_vector* _global_counts;   // Contig ID -> #Maps overall (uint64_t)
+  uint64_t _last_contig_id;    // Last contig looked up (Maps tend to cluster)
 } gt_population_profile;
 
 typedef struct {
@@ -18,6 +18,7 @@ typedef struct {
   char* buffer;
   uint64_t allocated;
   uint64_t length;
+  gt_mm_pool* mm_pool; /* Memory pool (NULL if allocated with malloc) */
 } gt_string;
 
 /*
@@ -43,6 +44,7 @@ typedef struct {
  * Constructor & Accessors
  */
 GT_INLINE gt_string* gt_string_new(const uint64_t initial_buffer_size);
+GT_INLINE gt_string* gt_string_new_from_pool(gt_mm_pool* const mm_pool,const uint64_t initial_buffer_size);
 GT_INLINE gt_string* gt_string_set_new(const char* const string_src);
 GT_INLINE void gt_string_resize(gt_string* const string,const uint64_t new_buffer_size);
 GT_INLINE void gt_string_clear(gt_string* const string);
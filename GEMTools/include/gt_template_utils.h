@@ -82,6 +82,9 @@ GT_INLINE bool gt_template_get_next_matching_strata(
  */
 GT_INLINE void gt_template_sort_by_distance__score(gt_template* const template);
 GT_INLINE void gt_template_sort_by_distance__score_no_split(gt_template* const template);
+// Counters recalculated along with the sorting (single pass over the mmaps)
+GT_INLINE void gt_template_recalculate_counters_and_sort(gt_template* const template);
+GT_INLINE void gt_template_recalculate_counters_and_sort_no_splits(gt_template* const template);
 
 /*
  * Template's MMaps Utils
@@ -96,6 +99,8 @@ GT_INLINE void gt_template_merge_template_mmaps(gt_template* const template_dst,
 GT_INLINE void gt_template_merge_template_mmaps_fx(
     int64_t (*gt_mmap_cmp_fx)(gt_map**,gt_map**,uint64_t),int64_t (*gt_map_cmp_fx)(gt_map*,gt_map*),
     gt_template* const template_dst,gt_template* const template_src);
+GT_INLINE void gt_template_merge_template_mmaps_a(
+    gt_template* const template_dst,gt_template** const templates_src,const uint64_t num_src_templates);
 
 GT_INLINE gt_template* gt_template_union_template_mmaps_v(
     const uint64_t num_src_templates,gt_template* const template_src,va_list v_args);
@@ -34,6 +34,7 @@ typedef struct {
   size_t used;
   size_t element_size;
   size_t elements_allocated;
+  gt_mm_pool* mm_pool; /* Memory pool (NULL if allocated with malloc) */
 } gt_vector;
 
 // Get the content of the vector
@@ -81,6 +82,7 @@ typedef struct {
 #define gt_vector_set_elm(vector,position,type,elm) (*gt_vector_get_elm(vector,position,type) = elm)
 
 GT_INLINE gt_vector* gt_vector_new(size_t num_initial_elements,size_t element_size); // FIXME: wrt to type MACRO
+GT_INLINE gt_vector* gt_vector_new_from_pool(gt_mm_pool* const mm_pool,size_t num_initial_elements,size_t element_size);
 GT_INLINE gt_status gt_vector_reserve(gt_vector* vector,size_t num_elements,bool zero_mem);
 GT_INLINE gt_status gt_vector_resize__clear(gt_vector* vector,size_t num_elements);
 
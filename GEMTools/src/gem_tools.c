@@ -89,10 +89,11 @@ gt_option gt_filter_options[] = {
   { 901, "sample-read", GT_OPT_REQUIRED, GT_OPT_STRING, 9 , true, "<chunk_size>,<step_size>,<left_trim>,<right_trim>[,<min_remainder>]" , "" },
   { 902, "group-read-chunks", GT_OPT_NO_ARGUMENT, GT_OPT_NONE, 9 , true, "" , "" },
   /* Display/Information */
-  { 1000, "error-plot", GT_OPT_NO_ARGUMENT, GT_OPT_NONE, 10 , false, "" , "" },
-  { 1001, "insert-size-plot", GT_OPT_NO_ARGUMENT, GT_OPT_NONE, 10 , false, "" , "" },
+  { 1000, "error-plot", GT_OPT_NO_ARGUMENT, GT_OPT_NONE, 10 , false, "" , "Histograms of the number of errors (per mmap, summed over both ends), error positions and qualities by cycle" },
+  { 1001, "insert-size-plot", GT_OPT_NO_ARGUMENT, GT_OPT_NONE, 10 , false, "" , "Histogram of the insert sizes (as read by gt.scorereads --insert-dist). Negative sizes, pairs on different contigs and same-strand pairs are not counted" },
   { 1002, "sequence-list", GT_OPT_NO_ARGUMENT, GT_OPT_NONE, 10 , true, "" , "" },
   { 1003, "display-pretty", GT_OPT_NO_ARGUMENT, GT_OPT_NONE, 10 , true, "" , "" },
+  { 1004, "filter-stats", GT_OPT_NO_ARGUMENT, GT_OPT_NONE, 10 , true, "(rejections & time per filtering criterion)" , "" },
   /* Misc */
 #ifdef HAVE_OPENMP
   { 't', "threads", GT_OPT_REQUIRED, GT_OPT_INT, 11 , true, "" , "" },
@@ -230,6 +231,8 @@ gt_option gt_scorereads_options[] = {
   { 402, "max-insert", GT_OPT_REQUIRED, GT_OPT_FLOAT, 4 , true, "" , "" },
   { 403, "indel-score", GT_OPT_REQUIRED, GT_OPT_FLOAT, 4 , true, "" , "" },
   { 'm', "mapping-quality-cutoff", GT_OPT_REQUIRED, GT_OPT_FLOAT, 4 , true, "" , "" },
+  { 404, "compile-model", GT_OPT_REQUIRED, GT_OPT_STRING, 4 , true, "<file>" , "" },
+  { 405, "model-sample", GT_OPT_REQUIRED, GT_OPT_INT, 4 , true, "<num_pairs>" , "" },
   /* Misc */
   { 'v', "verbose", GT_OPT_NO_ARGUMENT, GT_OPT_NONE, 5, true, "", ""},
 #ifdef HAVE_OPENMP
@@ -269,8 +272,10 @@ gt_option gt_map2sam_options[] = {
   { 500, "NH", GT_OPT_NO_ARGUMENT, GT_OPT_NONE, 5 , true, "" , "" },
   { 501, "NM", GT_OPT_NO_ARGUMENT, GT_OPT_NONE, 5 , true, "" , "" },
   { 502, "XT", GT_OPT_NO_ARGUMENT, GT_OPT_NONE, 5 , true, "" , "" },
-  { 503, "XS", GT_OPT_NO_ARGUMENT, GT_OPT_NONE, 5 , true, "" , "" },
+  { 503, "XS", GT_OPT_NO_ARGUMENT, GT_OPT_NONE, 5 , true, "(Strand of split maps. Requires the reference)" , "" },
   { 504, "md", GT_OPT_NO_ARGUMENT, GT_OPT_NONE, 5 , true, "" , "" },
+  { 505, "MD", GT_OPT_NO_ARGUMENT, GT_OPT_NONE, 5 , true, "(Deletions require the reference)" , "" },
+  { 506, "splice-motifs", GT_OPT_REQUIRED, GT_OPT_STRING, 5 , true, "<DONOR-ACCEPTOR>[,...] (default='GT-AG,GC-AG,AT-AC')" , "Splice-site motifs used to infer the XS strand (reverse complements are implied)" },
 //  { 500, "", GT_OPT_NO_ARGUMENT, GT_OPT_NONE, 5 , true, "" , "" },
   /* Format */
   { 'c', "compact", GT_OPT_NO_ARGUMENT, GT_OPT_NONE, 6 , false, "" , "" },
@@ -303,9 +308,10 @@ gt_option gt_gtfcount_options[] = {
   { 'i', "input", GT_OPT_REQUIRED, GT_OPT_STRING, 2 , true, "<file>" , "" },
   { 'o', "output", GT_OPT_REQUIRED, GT_OPT_STRING, 2 , true, "<file>" , "" },
   { 'g', "counts", GT_OPT_REQUIRED, GT_OPT_STRING, 2 , true, "<file>" , "Output file for the gene counts" },
-  { 'a', "annotation", GT_OPT_REQUIRED, GT_OPT_STRING, 2 , true, "<file>" , "GTF annotation" },
+  { 'a', "annotation", GT_OPT_REQUIRED, GT_OPT_STRING, 2 , true, "<file>" , "GTF annotation or compiled annotation" },
   { 'p', "paired-end", GT_OPT_NO_ARGUMENT, GT_OPT_NONE, 2 , true, "" , "" },
   { 'f', "output-format", GT_OPT_REQUIRED, GT_OPT_STRING, 2 , true, "'report'|'json'|'both' (default='report')" , "" },
+  { 201, "compile-annotation", GT_OPT_REQUIRED, GT_OPT_STRING, 2 , true, "<file>" , "Write the compiled annotation to <file> and exit. Compiled annotations are mapped instead of parsed by all tools" },
   /*Counts*/
   { 'w', "weighted", GT_OPT_NO_ARGUMENT, GT_OPT_NONE, 3, true, "", "Count multi-gene hits (and multi-maps if non unique counts are on) weighted"},
   { 'm', "multi-maps", GT_OPT_NO_ARGUMENT, GT_OPT_NONE, 3, true, "", "Count multi-maps"},
@@ -360,6 +366,39 @@ char* gt_region_groups[] = {
   /*  5 */ "Misc",
 };
 
+/*
+ * gt.junctions menu options
+ */
+gt_option gt_junctions_options[] = {
+  /* I/O */
+  { 'i', "input", GT_OPT_REQUIRED, GT_OPT_STRING, 2 , true, "<file> (MAP)" , "" },
+  { 'o', "output", GT_OPT_REQUIRED, GT_OPT_STRING, 2 , true, "<file>" , "" },
+  { 'p', "paired-end", GT_OPT_NO_ARGUMENT, GT_OPT_NONE, 2 , true, "" , "" },
+  /* Junctions */
+  { 's', "min-split-size", GT_OPT_REQUIRED, GT_OPT_INT, 3 , true, "<number> (default=4)" , "Minimum distance between the blocks of a split-map" },
+  { 'S', "max-split-size", GT_OPT_REQUIRED, GT_OPT_INT, 3 , true, "<number> (default=2500000)" , "Maximum distance between the blocks of a split-map" },
+  { 'm', "max-matches", GT_OPT_REQUIRED, GT_OPT_INT, 3 , true, "<number> (default=1)" , "Skip reads with more matches" },
+  { 'c', "coverage", GT_OPT_REQUIRED, GT_OPT_INT, 3 , true, "<number> (default=0, disabled)" , "Minimum number of split-maps supporting a junction" },
+  { 'a', "annotation", GT_OPT_REQUIRED, GT_OPT_STRING, 3 , true, "<file> (GTF or compiled annotation)" , "Junctions sharing a site with an annotated junction are kept regardless of the coverage" },
+  { 'j', "annotation-junctions", GT_OPT_REQUIRED, GT_OPT_STRING, 3 , true, "<file> (Junctions)" , "Same as --annotation, taking the annotated junctions from a junctions file" },
+  /* Misc */
+  { 'v', "verbose", GT_OPT_NO_ARGUMENT, GT_OPT_NONE, 4, true, "", ""},
+#ifdef HAVE_OPENMP
+  { 't', "threads", GT_OPT_REQUIRED, GT_OPT_INT, 4, true, "", ""},
+#endif
+  { 'h', "help", GT_OPT_NO_ARGUMENT, GT_OPT_NONE, 4, true, "", ""},
+  { 'H', "help-full", GT_OPT_NO_ARGUMENT, GT_OPT_NONE, 4 , false, "" , "" },
+  { 'J', "help-json", GT_OPT_NO_ARGUMENT, GT_OPT_NONE, 4 , false, "" , "" },
+  {  0, "", 0, 0, 0, false, "", ""}
+};
+char* gt_junctions_groups[] = {
+  /*  0 */ "Null",
+  /*  1 */ "Unclassified",
+  /*  2 */ "I/O",
+  /*  3 */ "Junctions",
+  /*  4 */ "Misc",
+};
+
 
 
 GT_INLINE uint64_t gt_options_get_num_options(const gt_option* const options) {
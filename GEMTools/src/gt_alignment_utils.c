@@ -231,15 +231,39 @@ int gt_alignment_cmp_distance__score_no_split(gt_map** const map_a,gt_map** cons
   const uint64_t score_b = (*map_b)->gt_score;
   return (score_a > score_b) ? -1 : (score_a < score_b ? 1 : 0);
 }
+/*
+ * Sort maps by distance (bucketed by stratum, same order as the comparators above; stable)
+ *   Optionally, the counters are rebuilt along (same as gt_alignment_recalculate_counters())
+ */
+GT_INLINE void gt_alignment_sort_by_distance__score_(
+    gt_alignment* const alignment,const bool no_split,gt_vector* const counters) {
+  const uint64_t num_maps = gt_alignment_get_num_maps(alignment);
+  gt_counters_sort_key keys_buffer[GT_COUNTERS_SORT_STACK_KEYS];
+  gt_counters_sort_key* const keys = (num_maps<=GT_COUNTERS_SORT_STACK_KEYS) ?
+      keys_buffer : gt_malloc(num_maps*sizeof(gt_counters_sort_key));
+  GT_VECTOR_ITERATE(alignment->maps,map,map_pos,gt_map*) {
+    keys[map_pos].stratum = (no_split) ? gt_map_get_no_split_distance(*map) : gt_map_get_global_distance(*map);
+    keys[map_pos].score = (*map)->gt_score;
+    keys[map_pos].position = map_pos;
+  }
+  gt_counters_stratum_sort(gt_vector_get_mem(alignment->maps,gt_map*),num_maps,sizeof(gt_map*),keys,counters);
+  if (keys!=keys_buffer) gt_free(keys);
+}
 GT_INLINE void gt_alignment_sort_by_distance__score(gt_alignment* const alignment) {
   GT_ALIGNMENT_CHECK(alignment);
-  qsort(gt_vector_get_mem(alignment->maps,gt_map*),gt_vector_get_used(alignment->maps),
-      sizeof(gt_map*),(int (*)(const void *,const void *))gt_alignment_cmp_distance__score);
+  gt_alignment_sort_by_distance__score_(alignment,false,NULL);
 }
 GT_INLINE void gt_alignment_sort_by_distance__score_no_split(gt_alignment* const alignment) {
   GT_ALIGNMENT_CHECK(alignment);
-  qsort(gt_vector_get_mem(alignment->maps,gt_map*),gt_vector_get_used(alignment->maps),
-      sizeof(gt_map*),(int (*)(const void *,const void *))gt_alignment_cmp_distance__score_no_split);
+  gt_alignment_sort_by_distance__score_(alignment,true,NULL);
+}
+GT_INLINE void gt_alignment_recalculate_counters_and_sort(gt_alignment* const alignment) {
+  GT_ALIGNMENT_CHECK(alignment);
+  gt_alignment_sort_by_distance__score_(alignment,false,gt_alignment_get_counters_vector(alignment));
+}
+GT_INLINE void gt_alignment_recalculate_counters_and_sort_no_splits(gt_alignment* const alignment) {
+  GT_ALIGNMENT_CHECK(alignment);
+  gt_alignment_sort_by_distance__score_(alignment,true,gt_alignment_get_counters_vector(alignment));
 }
 
 /*
@@ -386,6 +410,133 @@ GT_INLINE void gt_alignment_merge_alignment_maps_fx(
   }
 }
 
+/*
+ * Alignment's Maps n-way merge
+ */
+#define GT_ALIGNMENT_MAP_INDEX_INITIAL_ELEMENTS 100
+GT_INLINE gt_alignment_map_index* gt_alignment_map_index_new(void) {
+  gt_alignment_map_index* const map_index = gt_alloc(gt_alignment_map_index);
+  map_index->first_position = gt_ihash_new();
+  map_index->next_position = gt_vector_new(GT_ALIGNMENT_MAP_INDEX_INITIAL_ELEMENTS,sizeof(uint64_t));
+  return map_index;
+}
+GT_INLINE void gt_alignment_map_index_clear(gt_alignment_map_index* const map_index) {
+  GT_NULL_CHECK(map_index);
+  gt_ihash_clear(map_index->first_position,true);
+  gt_vector_clear(map_index->next_position);
+}
+GT_INLINE void gt_alignment_map_index_delete(gt_alignment_map_index* const map_index) {
+  GT_NULL_CHECK(map_index);
+  gt_ihash_delete(map_index->first_position,true);
+  gt_vector_delete(map_index->next_position);
+  gt_free(map_index);
+}
+/* Indexes the next position (positions are added in order, one per indexed element) */
+GT_INLINE void gt_alignment_map_index_add(gt_alignment_map_index* const map_index,const int64_t key) {
+  GT_NULL_CHECK(map_index);
+  const uint64_t position = gt_vector_get_used(map_index->next_position);
+  gt_vector_insert(map_index->next_position,GT_ALIGNMENT_MAP_INDEX_NIL,uint64_t);
+  uint64_t* const first_position = gt_ihash_get(map_index->first_position,key,uint64_t);
+  if (first_position==NULL) {
+    uint64_t* const new_first_position = gt_alloc(uint64_t);
+    *new_first_position = position;
+    gt_ihash_insert(map_index->first_position,key,new_first_position,uint64_t);
+  } else {
+    uint64_t* const next_position = gt_vector_get_mem(map_index->next_position,uint64_t);
+    uint64_t last_position = *first_position;
+    while (next_position[last_position]!=GT_ALIGNMENT_MAP_INDEX_NIL) last_position = next_position[last_position];
+    next_position[last_position] = position;
+  }
+}
+GT_INLINE uint64_t gt_alignment_map_index_first(gt_alignment_map_index* const map_index,const int64_t key) {
+  GT_NULL_CHECK(map_index);
+  uint64_t* const first_position = gt_ihash_get(map_index->first_position,key,uint64_t);
+  return (first_position==NULL) ? GT_ALIGNMENT_MAP_INDEX_NIL : *first_position;
+}
+GT_INLINE uint64_t gt_alignment_map_index_next(gt_alignment_map_index* const map_index,const uint64_t position) {
+  GT_NULL_CHECK(map_index);
+  return *gt_vector_get_elm(map_index->next_position,position,uint64_t);
+}
+GT_INLINE void gt_alignment_map_index_build(gt_alignment_map_index* const map_index,gt_alignment* const alignment) {
+  GT_NULL_CHECK(map_index);
+  GT_ALIGNMENT_CHECK(alignment);
+  gt_alignment_map_index_clear(map_index);
+  GT_ALIGNMENT_ITERATE(alignment,map) {
+    gt_alignment_map_index_add(map_index,gt_map_get_begin_mapping_position(map));
+  }
+}
+/*
+ * Same as @gt_alignment_put_map, looking up duplicates through @map_index (kept up to date)
+ *   A NULL @map_index falls back to the linear search (cheaper for a few maps)
+ */
+GT_INLINE gt_map* gt_alignment_map_index_put_map(
+    int64_t (*gt_map_cmp_fx)(gt_map*,gt_map*),gt_alignment* const alignment,
+    gt_alignment_map_index* const map_index,gt_map* const map,const bool replace_duplicated) {
+  GT_NULL_CHECK(gt_map_cmp_fx);
+  GT_ALIGNMENT_CHECK(alignment); GT_MAP_CHECK(map);
+  if (map_index==NULL) return gt_alignment_put_map(gt_map_cmp_fx,alignment,map,replace_duplicated);
+  const int64_t key = gt_map_get_begin_mapping_position(map);
+  uint64_t position;
+  for (position=gt_alignment_map_index_first(map_index,key);
+       position!=GT_ALIGNMENT_MAP_INDEX_NIL;
+       position=gt_alignment_map_index_next(map_index,position)) {
+    gt_map* const found_map = gt_alignment_get_map(alignment,position);
+    if (gt_map_cmp_fx(found_map,map)==0) {
+      if (gt_expect_true(replace_duplicated && gt_map_get_global_distance(map) < gt_map_get_global_distance(found_map))) {
+        gt_alignment_dec_counter(alignment,gt_map_get_global_distance(found_map));
+        gt_map_delete(found_map);
+        gt_alignment_inc_counter(alignment,gt_map_get_global_distance(map));
+        gt_alignment_set_map(alignment,map,position); // Same key, the index stays valid
+        return map;
+      } else {
+        gt_map_delete(map);
+        return found_map;
+      }
+    }
+  }
+  // Add new map
+  gt_alignment_inc_counter(alignment,gt_map_get_global_distance(map));
+  gt_alignment_add_map(alignment,map);
+  gt_alignment_map_index_add(map_index,key);
+  return map;
+}
+/*
+ * Merges the maps of all @alignments_src into @alignment_dst, in order. Equivalent to calling
+ * @gt_alignment_merge_alignment_maps_fx(gt_map_cmp,...) for each source, but the destination
+ * is indexed just once
+ */
+GT_INLINE void gt_alignment_merge_alignment_maps_a(
+    gt_alignment* const alignment_dst,gt_alignment** const alignments_src,const uint64_t num_src_alignments) {
+  GT_ALIGNMENT_CHECK(alignment_dst);
+  GT_NULL_CHECK(alignments_src);
+  // Index the destination (only if there are enough maps to pay off)
+  uint64_t total_maps = gt_alignment_get_num_maps(alignment_dst), i;
+  for (i=0;i<num_src_alignments;++i) total_maps += gt_alignment_get_num_maps(alignments_src[i]);
+  gt_alignment_map_index* map_index = NULL;
+  if (total_maps > GT_ALIGNMENT_MAP_INDEX_MIN_MAPS) {
+    map_index = gt_alignment_map_index_new();
+    gt_alignment_map_index_build(map_index,alignment_dst);
+  }
+  for (i=0;i<num_src_alignments;++i) {
+    gt_alignment* const alignment_src = alignments_src[i];
+    GT_ALIGNMENT_CHECK(alignment_src);
+    // Like the pairwise merge, maps are just appended if either side is empty
+    const bool copy_only = gt_alignment_get_num_maps(alignment_src)==0 || gt_alignment_get_num_maps(alignment_dst)==0;
+    GT_ALIGNMENT_ITERATE(alignment_src,map_src) {
+      gt_map* const map_src_cp = gt_map_copy(map_src);
+      if (copy_only) {
+        gt_alignment_inc_counter(alignment_dst,gt_map_get_global_distance(map_src_cp));
+        gt_alignment_add_map(alignment_dst,map_src_cp);
+        if (map_index!=NULL) gt_alignment_map_index_add(map_index,gt_map_get_begin_mapping_position(map_src_cp));
+      } else {
+        gt_alignment_map_index_put_map(gt_map_cmp,alignment_dst,map_index,map_src_cp,true);
+      }
+    }
+    gt_alignment_set_mcs(alignment_dst,GT_MIN(gt_alignment_get_mcs(alignment_dst),gt_alignment_get_mcs(alignment_src)));
+  }
+  if (map_index!=NULL) gt_alignment_map_index_delete(map_index);
+}
+
 GT_INLINE gt_alignment* gt_alignment_union_alignment_maps_v(
     const uint64_t num_src_alignments,gt_alignment* const alignment_src,va_list v_args) {
   GT_ZERO_CHECK(num_src_alignments);
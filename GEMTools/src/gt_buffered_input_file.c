@@ -22,15 +22,19 @@ gt_buffered_input_file* gt_buffered_input_file_new(gt_input_file* const input_fi
   /* Block buffer and cursors */
   buffered_input_file->block_id = UINT32_MAX;
   buffered_input_file->block_buffer = gt_vector_new(GT_BMI_BUFFER_SIZE,sizeof(uint8_t));
+  gt_mm_advise_bulk_buffer(gt_vector_get_mem(buffered_input_file->block_buffer,uint8_t),GT_BMI_BUFFER_SIZE,true);
   buffered_input_file->cursor = (char*) gt_vector_get_mem(buffered_input_file->block_buffer,uint8_t);
   buffered_input_file->current_line_num = UINT64_MAX;
   /* Attached output buffer */
   buffered_input_file->attached_buffered_output_file = gt_vector_new(2,sizeof(gt_buffered_output_file*));
+  /* Memory pool */
+  buffered_input_file->mm_pool = gt_mm_pool_new();
   return buffered_input_file;
 }
 gt_status gt_buffered_input_file_close(gt_buffered_input_file* const buffered_input_file) {
   GT_BUFFERED_INPUT_FILE_CHECK(buffered_input_file);
   gt_vector_delete(buffered_input_file->block_buffer);
+  gt_mm_pool_delete(buffered_input_file->mm_pool);
   gt_free(buffered_input_file);
   return GT_BMI_OK;
 }
@@ -43,6 +47,10 @@ GT_INLINE bool gt_buffered_input_file_eob(gt_buffered_input_file* const buffered
   GT_BUFFERED_INPUT_FILE_CHECK(buffered_input_file);
   return gt_buffered_input_file_get_cursor_pos(buffered_input_file) >= gt_vector_get_used(buffered_input_file->block_buffer);
 }
+GT_INLINE gt_mm_pool* gt_buffered_input_file_get_mm_pool(gt_buffered_input_file* const buffered_input_file) {
+  GT_BUFFERED_INPUT_FILE_CHECK(buffered_input_file);
+  return buffered_input_file->mm_pool;
+}
 GT_INLINE gt_status gt_buffered_input_file_get_block(
     gt_buffered_input_file* const buffered_input_file,const uint64_t num_lines) {
   GT_BUFFERED_INPUT_FILE_CHECK(buffered_input_file);
@@ -202,6 +202,35 @@ GT_INLINE void gt_cdna_string_append_string(gt_compact_dna_string* const cdna_st
   cdna_string->length = total_chars+1;
 }
 
+/*
+ * Word-level extraction
+ */
+GT_INLINE uint64_t gt_cdna_bitmaps_get_word(uint64_t bm_0,uint64_t bm_1,uint64_t bm_2,const uint64_t num_chars) {
+  gt_fatal_check(num_chars>GT_CDNA_WORD_MAX_CHARS,CDNA_WORD_TOO_LONG,num_chars,(uint64_t)GT_CDNA_WORD_MAX_CHARS);
+  uint64_t word = 0, i;
+  for (i=0;i<num_chars;++i) {
+    word |= ((uint64_t)GT_CDNA_EXTRACT_CHAR(bm_0,bm_1,bm_2)) << (i*GT_CDNA_WORD_CHAR_BITS);
+    bm_0 >>= 1; bm_1 >>= 1; bm_2 >>= 1;
+  }
+  return word;
+}
+GT_INLINE uint64_t gt_cdna_string_get_word(gt_compact_dna_string* const cdna_string,const uint64_t position,const uint64_t num_chars) {
+  GT_COMPACT_DNA_STRING_CHECK(cdna_string);
+  GT_ZERO_CHECK(num_chars);
+  GT_COMPACT_DNA_STRING_POSITION_CHECK(cdna_string,position+num_chars-1);
+  uint64_t block_num, block_pos;
+  uint64_t bm_0, bm_1, bm_2;
+  GT_CDNA_GET_BLOCK_POS(position,block_num,block_pos);
+  GT_CDNA_GET_BLOCKS(cdna_string->bitmaps,block_num,bm_0,bm_1,bm_2);
+  GT_CDNA_SHIFT_FORWARD_CHARS(block_pos,bm_0,bm_1,bm_2);
+  const uint64_t block_chars = GT_CDNA_BLOCK_CHARS-block_pos;
+  if (num_chars<=block_chars) return gt_cdna_bitmaps_get_word(bm_0,bm_1,bm_2,num_chars);
+  // The word spans into the next block
+  const uint64_t word = gt_cdna_bitmaps_get_word(bm_0,bm_1,bm_2,block_chars);
+  GT_CDNA_GET_BLOCKS(cdna_string->bitmaps,block_num+1,bm_0,bm_1,bm_2);
+  return word | (gt_cdna_bitmaps_get_word(bm_0,bm_1,bm_2,num_chars-block_chars) << (block_chars*GT_CDNA_WORD_CHAR_BITS));
+}
+
 /*
  * Compact DNA String Sequence Iterator
  */
@@ -114,3 +114,110 @@ GT_INLINE uint64_t gt_counters_reduce_sum(gt_vector* const counters) {
   }
   return acc;
 }
+
+/*
+ * Stratum sort
+ *   Small inputs are insertion-sorted. Otherwise, LSD radix sort (stable) by score (descending)
+ *   and then by stratum (ascending); only the bytes that differ among the keys take a pass
+ *   (typically one per field, as strata and scores span a narrow range)
+ */
+#define GT_COUNTERS_SORT_INSERTION_THRESHOLD 16
+#define GT_COUNTERS_SORT_RADIX_BITS 8
+#define GT_COUNTERS_SORT_RADIX_BUCKETS (1<<GT_COUNTERS_SORT_RADIX_BITS)
+#define GT_COUNTERS_SORT_RADIX_MASK (GT_COUNTERS_SORT_RADIX_BUCKETS-1)
+GT_INLINE int gt_counters_sort_key_cmp(const gt_counters_sort_key* const key_a,const gt_counters_sort_key* const key_b) {
+  if (key_a->stratum != key_b->stratum) return (key_a->stratum < key_b->stratum) ? -1 : 1;
+  return (key_a->score > key_b->score) ? -1 : (key_a->score < key_b->score ? 1 : 0);
+}
+GT_INLINE void gt_counters_sort_keys_insertion(gt_counters_sort_key* const keys,const uint64_t num_keys) {
+  uint64_t i;
+  for (i=1;i<num_keys;++i) {
+    const gt_counters_sort_key key = keys[i];
+    uint64_t j = i;
+    while (j>0 && gt_counters_sort_key_cmp(&key,keys+(j-1))<0) {
+      keys[j] = keys[j-1]; --j;
+    }
+    keys[j] = key;
+  }
+}
+GT_INLINE void gt_counters_sort_keys_radix_pass(
+    gt_counters_sort_key* const keys_src,gt_counters_sort_key* const keys_dst,const uint64_t num_keys,
+    const bool by_score,const uint64_t shift) {
+  uint64_t buckets[GT_COUNTERS_SORT_RADIX_BUCKETS+1], i;
+  memset(buckets,0,sizeof(buckets));
+  // Count
+  for (i=0;i<num_keys;++i) {
+    const uint64_t digit = by_score ?
+        GT_COUNTERS_SORT_RADIX_MASK-((keys_src[i].score>>shift) & GT_COUNTERS_SORT_RADIX_MASK) : // Descending
+        ((keys_src[i].stratum>>shift) & GT_COUNTERS_SORT_RADIX_MASK);
+    ++buckets[digit+1];
+  }
+  for (i=1;i<=GT_COUNTERS_SORT_RADIX_BUCKETS;++i) buckets[i] += buckets[i-1];
+  // Scatter
+  for (i=0;i<num_keys;++i) {
+    const uint64_t digit = by_score ?
+        GT_COUNTERS_SORT_RADIX_MASK-((keys_src[i].score>>shift) & GT_COUNTERS_SORT_RADIX_MASK) :
+        ((keys_src[i].stratum>>shift) & GT_COUNTERS_SORT_RADIX_MASK);
+    keys_dst[buckets[digit]++] = keys_src[i];
+  }
+}
+GT_INLINE gt_counters_sort_key* gt_counters_sort_keys(
+    gt_counters_sort_key* const keys,gt_counters_sort_key* const keys_buffer,const uint64_t num_keys) {
+  // Small
+  if (num_keys<=GT_COUNTERS_SORT_INSERTION_THRESHOLD) {
+    gt_counters_sort_keys_insertion(keys,num_keys);
+    return keys;
+  }
+  // Bits that differ among the keys
+  uint64_t stratum_or = 0, stratum_and = UINT64_MAX, score_or = 0, score_and = UINT64_MAX, i;
+  for (i=0;i<num_keys;++i) {
+    stratum_or |= keys[i].stratum; stratum_and &= keys[i].stratum;
+    score_or |= keys[i].score; score_and &= keys[i].score;
+  }
+  const uint64_t stratum_diff = stratum_or ^ stratum_and;
+  const uint64_t score_diff = score_or ^ score_and;
+  // Radix passes (least significant first; score, then stratum)
+  gt_counters_sort_key *keys_src = keys, *keys_dst = keys_buffer;
+  uint64_t shift;
+  for (shift=0;shift<64;shift+=GT_COUNTERS_SORT_RADIX_BITS) {
+    if (((score_diff>>shift) & GT_COUNTERS_SORT_RADIX_MASK)==0) continue;
+    gt_counters_sort_keys_radix_pass(keys_src,keys_dst,num_keys,true,shift);
+    gt_counters_sort_key* const keys_aux = keys_src; keys_src = keys_dst; keys_dst = keys_aux;
+  }
+  for (shift=0;shift<64;shift+=GT_COUNTERS_SORT_RADIX_BITS) {
+    if (((stratum_diff>>shift) & GT_COUNTERS_SORT_RADIX_MASK)==0) continue;
+    gt_counters_sort_keys_radix_pass(keys_src,keys_dst,num_keys,false,shift);
+    gt_counters_sort_key* const keys_aux = keys_src; keys_src = keys_dst; keys_dst = keys_aux;
+  }
+  return keys_src;
+}
+GT_INLINE void gt_counters_stratum_sort(
+    void* const elements,const uint64_t num_elements,const uint64_t element_size,
+    gt_counters_sort_key* const keys,gt_vector* const counters) {
+  GT_NULL_CHECK(keys);
+  uint64_t i;
+  // Sort keys
+  gt_counters_sort_key* keys_buffer = NULL;
+  gt_counters_sort_key* keys_sorted = keys;
+  if (num_elements>1) {
+    if (num_elements>GT_COUNTERS_SORT_INSERTION_THRESHOLD) keys_buffer = gt_malloc(num_elements*sizeof(gt_counters_sort_key));
+    keys_sorted = gt_counters_sort_keys(keys,keys_buffer,num_elements);
+  }
+  // Rebuild counters
+  if (counters!=NULL) {
+    GT_VECTOR_CHECK(counters);
+    gt_vector_clear(counters);
+    for (i=0;i<num_elements;++i) gt_counters_inc_counter(counters,keys_sorted[i].stratum);
+  }
+  // Permute elements (if needed)
+  for (i=0;i<num_elements && keys_sorted[i].position==i;++i);
+  if (i<num_elements) {
+    char* const elements_sorted = gt_malloc(num_elements*element_size);
+    for (i=0;i<num_elements;++i) {
+      memcpy(elements_sorted+i*element_size,(char*)elements+keys_sorted[i].position*element_size,element_size);
+    }
+    memcpy(elements,elements_sorted,num_elements*element_size);
+    gt_free(elements_sorted);
+  }
+  if (keys_buffer!=NULL) gt_free(keys_buffer);
+}
@@ -128,11 +128,13 @@ GT_INLINE void gt_gemIdx_load_archive(
 /*
  * Retrieve sequences from GEMindex
  */
-GT_INLINE int64_t gt_gemIdx_get_bed_sequence_string(
+/*
+ * Locates the BED interval of @position; returns the BED position (or an error code)
+ *   @interval_length holds the number of characters left in the interval from @position
+ */
+GT_INLINE int64_t gt_gemIdx_locate_bed_position(
   gt_sequence_archive* const sequence_archive,char* const seq_id,
-  const uint64_t position,const uint64_t length,gt_string* const string) {
-  GT_SEQUENCE_BED_ARCHIVE_CHECK(sequence_archive);
-  // Locate BED position
+  const uint64_t position,uint64_t* const interval_length) {
   const int64_t seq_position = position; // Guarantee signed arithmetic
   gt_vector* const intervals_vector = gt_sequence_archive_get_bed_intervals_vector(sequence_archive,seq_id);
   if (intervals_vector==NULL) return GT_GEMIDX_SEQ_NOT_FOUND;
@@ -148,8 +150,18 @@ GT_INLINE int64_t gt_gemIdx_get_bed_sequence_string(
   }
   if (seq_position < intervals[sup].sequence_offset ||
       seq_position >= intervals[sup].sequence_offset+(intervals[sup].top-intervals[sup].bot)) return GT_GEMIDX_INTERVAL_NOT_FOUND;
-  // Get BED position
-  const uint64_t bed_position = intervals[sup].bot + (seq_position-intervals[sup].sequence_offset);
+  *interval_length = (intervals[sup].sequence_offset+(intervals[sup].top-intervals[sup].bot)) - seq_position;
+  return intervals[sup].bot + (seq_position-intervals[sup].sequence_offset);
+}
+GT_INLINE int64_t gt_gemIdx_get_bed_sequence_string(
+  gt_sequence_archive* const sequence_archive,char* const seq_id,
+  const uint64_t position,const uint64_t length,gt_string* const string) {
+  GT_SEQUENCE_BED_ARCHIVE_CHECK(sequence_archive);
+  // Locate BED position
+  uint64_t interval_length;
+  const int64_t located_position = gt_gemIdx_locate_bed_position(sequence_archive,seq_id,position,&interval_length);
+  if (located_position < 0) return located_position;
+  const uint64_t bed_position = located_position;
   // Clean string
   gt_string_clear(string);
   // Decode sequence string
@@ -181,3 +193,26 @@ GT_INLINE int64_t gt_gemIdx_get_bed_sequence_string(
   gt_string_append_eos(string);
   return i;
 }
+GT_INLINE int64_t gt_gemIdx_get_bed_sequence_word(
+  gt_sequence_archive* const sequence_archive,char* const seq_id,
+  const uint64_t position,const uint64_t num_chars,uint64_t* const word) {
+  GT_SEQUENCE_BED_ARCHIVE_CHECK(sequence_archive);
+  GT_ZERO_CHECK(num_chars);
+  // Locate BED position (the word cannot leave the interval)
+  uint64_t interval_length;
+  const int64_t located_position = gt_gemIdx_locate_bed_position(sequence_archive,seq_id,position,&interval_length);
+  if (located_position < 0) return located_position;
+  if (num_chars > interval_length) return GT_GEMIDX_INTERVAL_NOT_FOUND;
+  const uint64_t bed_position = located_position;
+  // Pack the characters straight from the BED bitmaps (stored as {bm_2,bm_1,bm_0})
+  const uint64_t be_block_mod = bed_position%GT_CDNA_BLOCK_CHARS;
+  const uint64_t block_chars = GT_CDNA_BLOCK_CHARS-be_block_mod;
+  uint64_t* const ptr_block = sequence_archive->bed + (bed_position/GT_CDNA_BLOCK_CHARS)*GT_CDNA_BLOCK_BITMAPS;
+  if (num_chars<=block_chars) {
+    *word = gt_cdna_bitmaps_get_word(ptr_block[2]>>be_block_mod,ptr_block[1]>>be_block_mod,ptr_block[0]>>be_block_mod,num_chars);
+  } else { // The word spans into the next block
+    *word = gt_cdna_bitmaps_get_word(ptr_block[2]>>be_block_mod,ptr_block[1]>>be_block_mod,ptr_block[0]>>be_block_mod,block_chars) |
+        (gt_cdna_bitmaps_get_word(ptr_block[5],ptr_block[4],ptr_block[3],num_chars-block_chars) << (block_chars*GT_CDNA_WORD_CHAR_BITS));
+  }
+  return num_chars;
+}
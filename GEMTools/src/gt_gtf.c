@@ -21,6 +21,7 @@ GT_INLINE void gt_gtf_entry_delete(gt_gtf_entry* const entry){
 GT_INLINE gt_gtf_ref* gt_gtf_ref_new(void){
   gt_gtf_ref* ref = malloc(sizeof(gt_gtf_ref));
   ref->entries = gt_vector_new(GTF_DEFAULT_ENTRIES, sizeof(gt_gtf_entry*));
+  ref->index = NULL;
   return ref;
 }
 GT_INLINE void gt_gtf_ref_delete(gt_gtf_ref* const ref){
@@ -30,6 +31,7 @@ GT_INLINE void gt_gtf_ref_delete(gt_gtf_ref* const ref){
     gt_gtf_entry_delete( (gt_vector_get_elm(ref->entries, i, gt_gtf_entry)));
   }
   gt_vector_delete(ref->entries);
+  if(ref->index != NULL) gt_gtf_index_delete(ref->index);
   free(ref);
 }
 
@@ -42,17 +44,34 @@ GT_INLINE gt_gtf* gt_gtf_new(void){
   gtf->gene_types = gt_shash_new();
   gtf->genes = gt_shash_new();
   gtf->transcripts = gt_shash_new();
+  gtf->mm = NULL;
+  gtf->compiled_strings = NULL;
+  gtf->compiled_entries = NULL;
   return gtf;
 }
 
 GT_INLINE void gt_gtf_delete(gt_gtf* const gtf){
+  GT_SHASH_BEGIN_ELEMENT_ITERATE(gtf->refs,ref,gt_gtf_ref) {
+    if(ref->index != NULL) gt_gtf_index_delete(ref->index);
+    gt_vector_delete(ref->entries);
+  } GT_SHASH_END_ITERATE
+  // the strings of a compiled annotation are owned by the string list
+  const bool owns_strings = gtf->compiled_strings == NULL;
   gt_shash_delete(gtf->refs, true);
-  gt_shash_delete(gtf->types, true);
-  gt_shash_delete(gtf->gene_ids, true);
-  gt_shash_delete(gtf->transcript_ids, true);
-  gt_shash_delete(gtf->gene_types, true);
+  gt_shash_delete(gtf->types, owns_strings);
+  gt_shash_delete(gtf->gene_ids, owns_strings);
+  gt_shash_delete(gtf->transcript_ids, owns_strings);
+  gt_shash_delete(gtf->gene_types, owns_strings);
   gt_shash_delete(gtf->genes, false);
   gt_shash_delete(gtf->transcripts, false);
+  if(gtf->compiled_strings != NULL){
+    GT_VECTOR_ITERATE(gtf->compiled_strings, string, counter, gt_string*){
+      gt_string_delete(*string);
+    }
+    gt_vector_delete(gtf->compiled_strings);
+  }
+  if(gtf->compiled_entries != NULL) gt_free(gtf->compiled_entries);
+  if(gtf->mm != NULL) gt_mm_free(gtf->mm);
   free(gtf);
 }
 
@@ -215,49 +234,87 @@ GT_INLINE void gt_gtf_sort_by_end( gt_vector* entries) {
     sizeof(gt_gtf_entry**),
     (int (*)(const void *,const void *))gt_gtf_sort_by_end_cmp_);
 }
-GT_INLINE gt_gtf_node* gt_gtf_create_node(gt_vector* entries){
+/**
+ * Append the centered interval tree node for the given entries to the index
+ * and build its subtrees. Nodes are written in pre-order, so the left child of a
+ * node (if any) always follows it directly. The incoming entry list is consumed.
+ */
+GT_INLINE uint32_t gt_gtf_index_add_node_(gt_gtf_index* const index, gt_vector* const nodes, gt_vector* const entries){
   const uint64_t len = gt_vector_get_used(entries);
   if(len == 0){
-    return NULL;
+    gt_vector_delete(entries);
+    return GT_GTF_INDEX_NIL;
   }
-  gt_gtf_node* const node = malloc(sizeof(gt_gtf_node));
   const gt_gtf_entry* mid = *gt_vector_get_elm(entries, len/2, gt_gtf_entry*);
-  node->midpoint = mid->start + ((mid->end - mid->start)/2);
-  node->entries_by_end = gt_vector_new(16, sizeof(gt_gtf_entry*));
-  node->entries_by_start = gt_vector_new(16, sizeof(gt_gtf_entry*));
-  gt_vector* to_left = gt_vector_new(16, sizeof(gt_gtf_entry*));
-  gt_vector* to_right = gt_vector_new(16, sizeof(gt_gtf_entry*));
+  const uint64_t midpoint = mid->start + ((mid->end - mid->start)/2);
+  gt_vector* const node_entries = gt_vector_new(16, sizeof(gt_gtf_entry*));
+  gt_vector* const to_left = gt_vector_new(16, sizeof(gt_gtf_entry*));
+  gt_vector* const to_right = gt_vector_new(16, sizeof(gt_gtf_entry*));
   GT_VECTOR_ITERATE(entries, element, counter, gt_gtf_entry*){
-    if((*element)->end < node->midpoint){
+    if((*element)->end < midpoint){
       gt_vector_insert(to_left, (*element), gt_gtf_entry*);
-    }else if((*element)->start > node->midpoint){
+    }else if((*element)->start > midpoint){
       gt_vector_insert(to_right, (*element), gt_gtf_entry*);
     }else{
-      gt_vector_insert(node->entries_by_end, (*element), gt_gtf_entry*);
-      gt_vector_insert(node->entries_by_start, (*element), gt_gtf_entry*);
+      gt_vector_insert(node_entries, (*element), gt_gtf_entry*);
     }
   }
-  // sort the start and end lists
-  gt_gtf_sort_by_start(node->entries_by_start);
-  gt_gtf_sort_by_end(node->entries_by_end);
-
-  // delete incoming entry list
   gt_vector_delete(entries);
-  if(gt_vector_get_used(to_left) > 0){
-    // create left node
-    node->left = gt_gtf_create_node(to_left);
-  }else{
-    node->left = NULL;
-    gt_vector_delete(to_left);
-  }
-  if(gt_vector_get_used(to_right) > 0){
-    // create right node
-    node->right = gt_gtf_create_node(to_right);
-  }else{
-    node->right = NULL;
-    gt_vector_delete(to_right);
-  }
-  return node;
+  gt_gtf_sort_by_start(node_entries);
+
+  // add the node and its entries
+  const uint32_t node_id = gt_vector_get_used(nodes);
+  gt_vector_reserve_additional(nodes, 1);
+  gt_vector_inc_used(nodes);
+  gt_gtf_index_node* node = gt_vector_get_elm(nodes, node_id, gt_gtf_index_node);
+  node->midpoint = midpoint;
+  node->entries_offset = index->num_entries;
+  node->num_entries = gt_vector_get_used(node_entries);
+  GT_VECTOR_ITERATE(node_entries, node_entry, node_counter, gt_gtf_entry*){
+    index->entries[index->num_entries] = *node_entry;
+    index->starts[index->num_entries] = (*node_entry)->start;
+    index->ends[index->num_entries] = (*node_entry)->end;
+    ++index->num_entries;
+  }
+  gt_vector_delete(node_entries);
+
+  // create the subtrees (the node vector might be reallocated)
+  const uint32_t left = gt_gtf_index_add_node_(index, nodes, to_left);
+  const uint32_t right = gt_gtf_index_add_node_(index, nodes, to_right);
+  node = gt_vector_get_elm(nodes, node_id, gt_gtf_index_node);
+  node->left = left;
+  node->right = right;
+  return node_id;
+}
+
+GT_INLINE gt_gtf_index* gt_gtf_index_new(gt_vector* const entries){
+  const uint64_t num_entries = gt_vector_get_used(entries);
+  gt_gtf_index* const index = gt_alloc(gt_gtf_index);
+  // every entry ends up in exactly one node
+  index->entries = gt_calloc(num_entries+1, gt_gtf_entry*, false);
+  index->starts = gt_calloc(num_entries+1, uint64_t, false);
+  index->ends = gt_calloc(num_entries+1, uint64_t, false);
+  index->num_entries = 0;
+  index->mapped = false;
+  // the node builder consumes its input, so hand over a copy
+  gt_vector* const nodes = gt_vector_new(num_entries/4+1, sizeof(gt_gtf_index_node));
+  gt_vector* const root_entries = gt_vector_new(num_entries+1, sizeof(gt_gtf_entry*));
+  gt_vector_copy(root_entries, entries);
+  gt_gtf_index_add_node_(index, nodes, root_entries);
+  index->num_nodes = gt_vector_get_used(nodes);
+  index->nodes = gt_calloc(index->num_nodes+1, gt_gtf_index_node, false);
+  memcpy(index->nodes, gt_vector_get_mem(nodes, gt_gtf_index_node), index->num_nodes*sizeof(gt_gtf_index_node));
+  gt_vector_delete(nodes);
+  return index;
+}
+GT_INLINE void gt_gtf_index_delete(gt_gtf_index* const index){
+  if(!index->mapped){
+    gt_free(index->nodes);
+    gt_free(index->starts);
+    gt_free(index->ends);
+  }
+  gt_free(index->entries);
+  gt_free(index);
 }
 
 /*
@@ -623,6 +680,9 @@ GT_INLINE gt_gtf* gt_gtf_read_from_stream(FILE* input, uint64_t threads){
   return gt_gtf_read(input_file, threads);
 }
 GT_INLINE gt_gtf* gt_gtf_read_from_file(char* input, uint64_t threads){
+  if(gt_gtf_is_compiled(input)){
+    return gt_gtf_read_compiled(input);
+  }
   gt_input_file* input_file = gt_input_file_open(input, false);
   return gt_gtf_read(input_file, threads);
 }
@@ -730,12 +790,300 @@ GT_INLINE gt_gtf* gt_gtf_read(gt_input_file* input_file, const uint64_t threads)
     gt_shash_delete(last_exons, false);
     gt_shash_delete(exons_counts, true);
 
-    // create a interval tree node for each ref
-    shash_element->node = gt_gtf_create_node(shash_element->entries);
+    // create the interval index for each ref
+    shash_element->index = gt_gtf_index_new(shash_element->entries);
+  } GT_SHASH_END_ITERATE
+  return gtf;
+}
+
+/*
+ * Compiled annotations
+ *
+ * Layout (all sections 64 bit aligned, native byte order):
+ *   header:   magic, version, num_strings, pool_length, num_entries, num_refs
+ *   strings:  uint64_t pool offsets[num_strings], '\0' terminated string pool
+ *   entries:  gt_gtf_compiled_entry[num_entries], grouped by reference
+ *   tables:   types, gene_ids, transcript_ids, gene_types (count + uint32_t string ids)
+ *             genes, transcripts (count + uint32_t entry ids)
+ *   refs:     name id, num_entries, num_nodes, num_index_entries,
+ *             gt_gtf_index_node[num_nodes], uint32_t entry ids, starts, ends
+ *   trailer:  magic
+ */
+GT_INLINE void gt_gtf_compiled_write_(FILE* const file, const void* const data, const uint64_t num_bytes, char* const file_name){
+  if(num_bytes == 0) return;
+  gt_cond_fatal_error(fwrite(data, 1, num_bytes, file) != num_bytes, FILE_WRITE, file_name);
+}
+GT_INLINE void gt_gtf_compiled_write_uint64_(FILE* const file, const uint64_t value, char* const file_name){
+  gt_gtf_compiled_write_(file, &value, sizeof(uint64_t), file_name);
+}
+GT_INLINE void gt_gtf_compiled_write_align_(FILE* const file, const uint64_t num_bytes, char* const file_name){
+  const uint64_t padding = 0;
+  gt_gtf_compiled_write_(file, &padding, (8-(num_bytes%8))%8, file_name);
+}
+GT_INLINE void gt_gtf_compiled_add_id_(gt_ihash* const ids, const void* const key, const uint64_t id){
+  uint64_t* const value = gt_malloc_uint64();
+  *value = id;
+  gt_ihash_insert(ids, (int64_t)key, value, uint64_t);
+}
+GT_INLINE uint32_t gt_gtf_compiled_get_id_(gt_ihash* const ids, const void* const key){
+  if(key == NULL) return GT_GTF_COMPILED_NIL;
+  uint64_t* const id = gt_ihash_get(ids, (int64_t)key, uint64_t);
+  gt_cond_fatal_error_msg(id == NULL, "Annotation element not found while compiling");
+  return *id;
+}
+GT_INLINE void gt_gtf_compiled_add_string_(gt_ihash* const string_ids, gt_vector* const strings, gt_string* const string){
+  if(string == NULL || gt_ihash_is_contained(string_ids, (int64_t)string)) return;
+  gt_gtf_compiled_add_id_(string_ids, string, gt_vector_get_used(strings));
+  gt_vector_insert(strings, gt_string_get_string(string), char*);
+}
+GT_INLINE void gt_gtf_compiled_write_ids_(FILE* const file, gt_vector* const ids, char* const file_name){
+  gt_gtf_compiled_write_uint64_(file, gt_vector_get_used(ids), file_name);
+  gt_gtf_compiled_write_(file, gt_vector_get_mem(ids, uint32_t), gt_vector_get_used(ids)*sizeof(uint32_t), file_name);
+  gt_gtf_compiled_write_align_(file, gt_vector_get_used(ids)*sizeof(uint32_t), file_name);
+}
+GT_INLINE void gt_gtf_compiled_write_string_table_(FILE* const file, gt_shash* const table, gt_ihash* const string_ids, char* const file_name){
+  gt_vector* const ids = gt_vector_new(gt_shash_get_num_elements(table)+1, sizeof(uint32_t));
+  GT_SHASH_BEGIN_ELEMENT_ITERATE(table, string, gt_string) {
+    gt_vector_insert(ids, gt_gtf_compiled_get_id_(string_ids, string), uint32_t);
   } GT_SHASH_END_ITERATE
+  gt_gtf_compiled_write_ids_(file, ids, file_name);
+  gt_vector_delete(ids);
+}
+GT_INLINE void gt_gtf_compiled_write_entry_table_(FILE* const file, gt_shash* const table, gt_ihash* const entry_ids, char* const file_name){
+  gt_vector* const ids = gt_vector_new(gt_shash_get_num_elements(table)+1, sizeof(uint32_t));
+  GT_SHASH_BEGIN_ELEMENT_ITERATE(table, entry, gt_gtf_entry) {
+    gt_vector_insert(ids, gt_gtf_compiled_get_id_(entry_ids, entry), uint32_t);
+  } GT_SHASH_END_ITERATE
+  gt_gtf_compiled_write_ids_(file, ids, file_name);
+  gt_vector_delete(ids);
+}
+
+GT_INLINE void gt_gtf_write_compiled(const gt_gtf* const gtf, char* const file_name){
+  GT_NULL_CHECK(gtf);
+  GT_NULL_CHECK(file_name);
+  gt_vector* const strings = gt_vector_new(GTF_DEFAULT_ENTRIES, sizeof(char*));
+  gt_vector* const ref_name_ids = gt_vector_new(16, sizeof(uint64_t));
+  gt_ihash* const string_ids = gt_ihash_new();
+  gt_ihash* const entry_ids = gt_ihash_new();
+  // number the strings and the entries
+  gt_shash* const tables[] = {gtf->types, gtf->gene_ids, gtf->transcript_ids, gtf->gene_types};
+  uint64_t i, num_entries = 0;
+  for(i=0; i<4; i++){
+    GT_SHASH_BEGIN_ELEMENT_ITERATE(tables[i], string, gt_string) {
+      gt_gtf_compiled_add_string_(string_ids, strings, string);
+    } GT_SHASH_END_ITERATE
+  }
+  GT_SHASH_BEGIN_ITERATE(gtf->refs, ref_name, ref, gt_gtf_ref) {
+    gt_vector_insert(ref_name_ids, gt_vector_get_used(strings), uint64_t);
+    gt_vector_insert(strings, ref_name, char*);
+    GT_VECTOR_ITERATE(ref->entries, element, counter, gt_gtf_entry*){
+      gt_gtf_entry* const entry = *element;
+      gt_gtf_compiled_add_id_(entry_ids, entry, num_entries++);
+      gt_gtf_compiled_add_string_(string_ids, strings, entry->type);
+      gt_gtf_compiled_add_string_(string_ids, strings, entry->gene_id);
+      gt_gtf_compiled_add_string_(string_ids, strings, entry->transcript_id);
+      gt_gtf_compiled_add_string_(string_ids, strings, entry->gene_type);
+    }
+  } GT_SHASH_END_ITERATE
+  gt_vector* const string_offsets = gt_vector_new(gt_vector_get_used(strings)+1, sizeof(uint64_t));
+  uint64_t pool_length = 0;
+  GT_VECTOR_ITERATE(strings, string, counter, char*){
+    gt_vector_insert(string_offsets, pool_length, uint64_t);
+    pool_length += strlen(*string)+1;
+  }
+
+  FILE* const file = fopen(file_name, "wb");
+  gt_cond_fatal_error(file==NULL, FILE_OPEN, file_name);
+  // header
+  gt_gtf_compiled_write_uint64_(file, GT_GTF_COMPILED_MAGIC, file_name);
+  gt_gtf_compiled_write_uint64_(file, GT_GTF_COMPILED_VERSION, file_name);
+  gt_gtf_compiled_write_uint64_(file, gt_vector_get_used(strings), file_name);
+  gt_gtf_compiled_write_uint64_(file, pool_length, file_name);
+  gt_gtf_compiled_write_uint64_(file, num_entries, file_name);
+  gt_gtf_compiled_write_uint64_(file, gt_shash_get_num_elements(gtf->refs), file_name);
+  // string pool
+  gt_gtf_compiled_write_(file, gt_vector_get_mem(string_offsets, uint64_t), gt_vector_get_used(string_offsets)*sizeof(uint64_t), file_name);
+  GT_VECTOR_ITERATE(strings, pool_string, pool_counter, char*){
+    gt_gtf_compiled_write_(file, *pool_string, strlen(*pool_string)+1, file_name);
+  }
+  gt_gtf_compiled_write_align_(file, pool_length, file_name);
+  // entries
+  GT_SHASH_BEGIN_ELEMENT_ITERATE(gtf->refs, ref, gt_gtf_ref) {
+    GT_VECTOR_ITERATE(ref->entries, element, counter, gt_gtf_entry*){
+      gt_gtf_entry* const entry = *element;
+      gt_gtf_compiled_entry record;
+      record.uid = entry->uid;
+      record.start = entry->start;
+      record.end = entry->end;
+      record.num_children = entry->num_children;
+      record.length = entry->length;
+      record.strand = entry->strand;
+      record.type = gt_gtf_compiled_get_id_(string_ids, entry->type);
+      record.gene_id = gt_gtf_compiled_get_id_(string_ids, entry->gene_id);
+      record.transcript_id = gt_gtf_compiled_get_id_(string_ids, entry->transcript_id);
+      record.gene_type = gt_gtf_compiled_get_id_(string_ids, entry->gene_type);
+      record.padding = 0;
+      gt_gtf_compiled_write_(file, &record, sizeof(gt_gtf_compiled_entry), file_name);
+    }
+  } GT_SHASH_END_ITERATE
+  // lookup tables
+  for(i=0; i<4; i++){
+    gt_gtf_compiled_write_string_table_(file, tables[i], string_ids, file_name);
+  }
+  gt_gtf_compiled_write_entry_table_(file, gtf->genes, entry_ids, file_name);
+  gt_gtf_compiled_write_entry_table_(file, gtf->transcripts, entry_ids, file_name);
+  // references and their interval indexes
+  gt_vector* const index_ids = gt_vector_new(GTF_DEFAULT_ENTRIES, sizeof(uint32_t));
+  uint64_t ref_counter = 0;
+  GT_SHASH_BEGIN_ELEMENT_ITERATE(gtf->refs, ref, gt_gtf_ref) {
+    const gt_gtf_index* const index = ref->index;
+    const uint64_t num_nodes = (index != NULL) ? index->num_nodes : 0;
+    const uint64_t num_index_entries = (index != NULL) ? index->num_entries : 0;
+    gt_gtf_compiled_write_uint64_(file, *gt_vector_get_elm(ref_name_ids, ref_counter++, uint64_t), file_name);
+    gt_gtf_compiled_write_uint64_(file, gt_vector_get_used(ref->entries), file_name);
+    gt_gtf_compiled_write_uint64_(file, num_nodes, file_name);
+    gt_gtf_compiled_write_uint64_(file, num_index_entries, file_name);
+    if(index == NULL) continue;
+    gt_gtf_compiled_write_(file, index->nodes, num_nodes*sizeof(gt_gtf_index_node), file_name);
+    gt_vector_clear(index_ids);
+    for(i=0; i<num_index_entries; i++){
+      gt_vector_insert(index_ids, gt_gtf_compiled_get_id_(entry_ids, index->entries[i]), uint32_t);
+    }
+    gt_gtf_compiled_write_(file, gt_vector_get_mem(index_ids, uint32_t), num_index_entries*sizeof(uint32_t), file_name);
+    gt_gtf_compiled_write_align_(file, num_index_entries*sizeof(uint32_t), file_name);
+    gt_gtf_compiled_write_(file, index->starts, num_index_entries*sizeof(uint64_t), file_name);
+    gt_gtf_compiled_write_(file, index->ends, num_index_entries*sizeof(uint64_t), file_name);
+  } GT_SHASH_END_ITERATE
+  gt_gtf_compiled_write_uint64_(file, GT_GTF_COMPILED_MAGIC, file_name);
+  gt_cond_fatal_error(fclose(file)!=0, FILE_WRITE, file_name);
+
+  gt_vector_delete(index_ids);
+  gt_vector_delete(string_offsets);
+  gt_vector_delete(ref_name_ids);
+  gt_vector_delete(strings);
+  gt_ihash_delete(string_ids, true);
+  gt_ihash_delete(entry_ids, true);
+}
+
+#define GT_GTF_COMPILED_STRING(strings,id) (((id)==GT_GTF_COMPILED_NIL) ? NULL : (strings)[id])
+
+GT_INLINE void gt_gtf_compiled_read_string_table_(gt_mm* const mm, gt_shash* const table, gt_string** const strings){
+  const uint64_t num_ids = gt_mm_read_uint64(mm);
+  const uint32_t* const ids = gt_mm_read_mem(mm, num_ids*sizeof(uint32_t));
+  gt_mm_skip_align_64(mm);
+  uint64_t i;
+  for(i=0; i<num_ids; i++){
+    gt_string* const string = strings[ids[i]];
+    gt_shash_insert(table, gt_string_get_string(string), string, gt_string*);
+  }
+}
+GT_INLINE void gt_gtf_compiled_read_entry_table_(gt_mm* const mm, gt_shash* const table, gt_gtf_entry* const entries, const bool by_gene){
+  const uint64_t num_ids = gt_mm_read_uint64(mm);
+  const uint32_t* const ids = gt_mm_read_mem(mm, num_ids*sizeof(uint32_t));
+  gt_mm_skip_align_64(mm);
+  uint64_t i;
+  for(i=0; i<num_ids; i++){
+    gt_gtf_entry* const entry = entries + ids[i];
+    gt_shash_insert(table, gt_string_get_string(by_gene ? entry->gene_id : entry->transcript_id), entry, gt_gtf_entry*);
+  }
+}
+
+GT_INLINE gt_gtf* gt_gtf_read_compiled(char* const file_name){
+  GT_NULL_CHECK(file_name);
+  gt_mm* const mm = gt_mm_bulk_mmap_file(file_name, GT_MM_READ_ONLY, false);
+  gt_cond_fatal_error_msg(gt_mm_read_uint64(mm) != GT_GTF_COMPILED_MAGIC, "'%s' is not a compiled GTF annotation", file_name);
+  const uint64_t version = gt_mm_read_uint64(mm);
+  gt_cond_fatal_error_msg(version != GT_GTF_COMPILED_VERSION,
+      "Compiled GTF annotation '%s' has version %"PRIu64", expected %d. Please recompile the annotation", file_name, version, GT_GTF_COMPILED_VERSION);
+  const uint64_t num_strings = gt_mm_read_uint64(mm);
+  const uint64_t pool_length = gt_mm_read_uint64(mm);
+  const uint64_t num_entries = gt_mm_read_uint64(mm);
+  const uint64_t num_refs = gt_mm_read_uint64(mm);
+  gt_gtf* const gtf = gt_gtf_new();
+  gtf->mm = mm;
+  // strings point into the mapped pool
+  const uint64_t* const string_offsets = gt_mm_read_mem(mm, num_strings*sizeof(uint64_t));
+  char* const pool = gt_mm_read_mem(mm, pool_length);
+  gt_mm_skip_align_64(mm);
+  gtf->compiled_strings = gt_vector_new(num_strings+1, sizeof(gt_string*));
+  uint64_t i, j;
+  for(i=0; i<num_strings; i++){
+    gt_string* const string = gt_string_new(0);
+    gt_string_set_nstring(string, pool+string_offsets[i], strlen(pool+string_offsets[i]));
+    gt_vector_insert(gtf->compiled_strings, string, gt_string*);
+  }
+  gt_string** const strings = gt_vector_get_mem(gtf->compiled_strings, gt_string*);
+  // entries
+  const gt_gtf_compiled_entry* const records = gt_mm_read_mem(mm, num_entries*sizeof(gt_gtf_compiled_entry));
+  gt_gtf_entry* const entries = gt_calloc(num_entries+1, gt_gtf_entry, false);
+  gtf->compiled_entries = entries;
+  for(i=0; i<num_entries; i++){
+    entries[i].uid = records[i].uid;
+    entries[i].start = records[i].start;
+    entries[i].end = records[i].end;
+    entries[i].num_children = records[i].num_children;
+    entries[i].length = records[i].length;
+    entries[i].strand = records[i].strand;
+    entries[i].type = GT_GTF_COMPILED_STRING(strings, records[i].type);
+    entries[i].gene_id = GT_GTF_COMPILED_STRING(strings, records[i].gene_id);
+    entries[i].transcript_id = GT_GTF_COMPILED_STRING(strings, records[i].transcript_id);
+    entries[i].gene_type = GT_GTF_COMPILED_STRING(strings, records[i].gene_type);
+  }
+  // lookup tables
+  gt_gtf_compiled_read_string_table_(mm, gtf->types, strings);
+  gt_gtf_compiled_read_string_table_(mm, gtf->gene_ids, strings);
+  gt_gtf_compiled_read_string_table_(mm, gtf->transcript_ids, strings);
+  gt_gtf_compiled_read_string_table_(mm, gtf->gene_types, strings);
+  gt_gtf_compiled_read_entry_table_(mm, gtf->genes, entries, true);
+  gt_gtf_compiled_read_entry_table_(mm, gtf->transcripts, entries, false);
+  // references, the index nodes and coordinates are used in place
+  uint64_t entries_offset = 0;
+  for(i=0; i<num_refs; i++){
+    const uint64_t name_id = gt_mm_read_uint64(mm);
+    const uint64_t num_ref_entries = gt_mm_read_uint64(mm);
+    const uint64_t num_nodes = gt_mm_read_uint64(mm);
+    const uint64_t num_index_entries = gt_mm_read_uint64(mm);
+    gt_gtf_ref* const ref = gt_gtf_ref_new();
+    gt_vector_reserve(ref->entries, num_ref_entries, false);
+    gt_vector_set_used(ref->entries, num_ref_entries);
+    for(j=0; j<num_ref_entries; j++){
+      *gt_vector_get_elm(ref->entries, j, gt_gtf_entry*) = entries + entries_offset + j;
+    }
+    entries_offset += num_ref_entries;
+    if(num_nodes > 0){
+      gt_gtf_index* const index = gt_alloc(gt_gtf_index);
+      index->mapped = true;
+      index->num_nodes = num_nodes;
+      index->num_entries = num_index_entries;
+      index->nodes = gt_mm_read_mem(mm, num_nodes*sizeof(gt_gtf_index_node));
+      const uint32_t* const index_ids = gt_mm_read_mem(mm, num_index_entries*sizeof(uint32_t));
+      gt_mm_skip_align_64(mm);
+      index->entries = gt_calloc(num_index_entries+1, gt_gtf_entry*, false);
+      for(j=0; j<num_index_entries; j++){
+        index->entries[j] = entries + index_ids[j];
+      }
+      index->starts = gt_mm_read_mem(mm, num_index_entries*sizeof(uint64_t));
+      index->ends = gt_mm_read_mem(mm, num_index_entries*sizeof(uint64_t));
+      ref->index = index;
+    }
+    gt_shash_insert(gtf->refs, gt_string_get_string(strings[name_id]), ref, gt_gtf_ref*);
+  }
+  // trailing magic, checked in place (the cursor can't be left past the end of the mapping)
+  gt_cond_fatal_error_msg(gt_mm_get_current_position(mm)+sizeof(uint64_t) != mm->allocated ||
+      *((uint64_t*)gt_mm_get_mem(mm)) != GT_GTF_COMPILED_MAGIC, "Compiled GTF annotation '%s' is truncated", file_name);
   return gtf;
 }
 
+GT_INLINE bool gt_gtf_is_compiled(char* const file_name){
+  GT_NULL_CHECK(file_name);
+  FILE* const file = fopen(file_name, "rb");
+  if(file == NULL) return false;
+  uint64_t magic = 0;
+  const bool compiled = fread(&magic, sizeof(uint64_t), 1, file) == 1 && magic == GT_GTF_COMPILED_MAGIC;
+  fclose(file);
+  return compiled;
+}
+
 /*
  * Binary search for start position
  */
@@ -764,46 +1112,96 @@ GT_INLINE uint64_t gt_gtf_bin_search(gt_vector* const entries, const uint64_t t,
   }
 }
 
-GT_INLINE void gt_gtf_search_node_(gt_gtf_node* node, const uint64_t start, const uint64_t end, gt_vector* const target){
-  if(node == NULL) return;
-
-  // add overlapping intervals from this node
-  GT_VECTOR_ITERATE(node->entries_by_start, element, counter, gt_gtf_entry*){
-    if((*element)->start > end){
-      break;
+/*
+ * Add the entries of a node that overlap with [start,end]. Only the prefix of
+ * entries with start <= end can overlap; the tests are done chunk-wise into a
+ * mask over the dense start/end arrays so the compiler can vectorize them.
+ */
+GT_INLINE void gt_gtf_search_node_entries_(const gt_gtf_index* const index, const gt_gtf_index_node* const node,
+                                           const uint64_t start, const uint64_t end, gt_vector* const target){
+  const uint64_t* const starts = index->starts + node->entries_offset;
+  const uint64_t* const ends = index->ends + node->entries_offset;
+  gt_gtf_entry** const entries = index->entries + node->entries_offset;
+  // find the number of entries with start <= end
+  uint64_t l = 0, h = node->num_entries;
+  while(l < h){
+    const uint64_t m = (l + h) / 2;
+    if(starts[m] > end){
+      h = m;
+    }else{
+      l = m + 1;
+    }
+  }
+  const uint64_t num_candidates = l;
+  uint8_t mask[GT_GTF_INDEX_CHUNK];
+  uint64_t chunk, i;
+  for(chunk=0; chunk<num_candidates; chunk+=GT_GTF_INDEX_CHUNK){
+    const uint64_t chunk_size = (num_candidates-chunk) < GT_GTF_INDEX_CHUNK ? (num_candidates-chunk) : GT_GTF_INDEX_CHUNK;
+    const uint64_t* const s = starts + chunk;
+    const uint64_t* const e = ends + chunk;
+    for(i=0; i<chunk_size; i++){
+      mask[i] = (start < e[i] && end > s[i])
+          | (start >= s[i] && end <= e[i])
+          | (start < e[i] && end >= e[i])
+          | (start < s[i] && end > e[i]);
     }
-    gt_gtf_entry* e = *element;
-    //if((*element)->start <= start && (*element)->end >= end){
-    if((start < e->end && end > e->start)
-      || (start >= e->start && end <=e->end)
-      || (start < e->end && end >= e->end)
-      || (start < e->start && end > e->end)){
-      gt_vector_insert(target, (*element), gt_gtf_entry*);
+    for(i=0; i<chunk_size; i++){
+      if(mask[i]) gt_vector_insert(target, entries[chunk+i], gt_gtf_entry*);
     }
   }
+}
 
-
-  if(end < node->midpoint || start < node->midpoint){
-    // search left tree
-    gt_gtf_search_node_(node->left, start, end, target);
-  }
-  if (start > node->midpoint || end > node->midpoint){
-    gt_gtf_search_node_(node->right, start, end, target);
+GT_INLINE void gt_gtf_search_index_(const gt_gtf_index* const index, uint32_t node_id, const uint64_t start, const uint64_t end, gt_vector* const target){
+  const gt_gtf_index_node* const nodes = index->nodes;
+  while(node_id != GT_GTF_INDEX_NIL){
+    const gt_gtf_index_node* const node = nodes + node_id;
+    // add overlapping intervals from this node
+    gt_gtf_search_node_entries_(index, node, start, end, target);
+    const bool search_left = node->left != GT_GTF_INDEX_NIL && (end < node->midpoint || start < node->midpoint);
+    const bool search_right = node->right != GT_GTF_INDEX_NIL && (start > node->midpoint || end > node->midpoint);
+    if(search_left && search_right){
+      // keep the pre-order of the hits, the right subtree is searched after the left one
+      const uint32_t right = node->right;
+      gt_gtf_search_index_(index, node->left, start, end, target);
+      node_id = right;
+    }else{
+      node_id = search_left ? node->left : (search_right ? node->right : GT_GTF_INDEX_NIL);
+    }
   }
-
 }
 
-
-
-
 GT_INLINE uint64_t gt_gtf_search(const gt_gtf* const gtf,  gt_vector* const target, char* const ref, const uint64_t start, const uint64_t end, const bool clear_target){
   if(clear_target)gt_vector_clear(target);
   // make sure the target ref is contained
-  if (! gt_shash_is_contained(gtf->refs, ref)){
+  const gt_gtf_ref* const source_ref = gt_shash_get(gtf->refs, ref, gt_gtf_ref);
+  if(source_ref == NULL || source_ref->index == NULL || source_ref->index->num_nodes == 0){
     return 0;
   }
-  const gt_gtf_ref* const source_ref = gt_gtf_get_ref(gtf, ref);
-  gt_gtf_search_node_(source_ref->node, start, end, target);
+  gt_gtf_search_index_(source_ref->index, 0, start, end, target);
+  return gt_vector_get_used(target);
+}
+
+GT_INLINE uint64_t gt_gtf_search_batch(const gt_gtf* const gtf, gt_vector* const target, gt_vector* const offsets, const gt_gtf_query* const queries, const uint64_t num_queries){
+  gt_vector_clear(target);
+  gt_vector_clear(offsets);
+  gt_vector_reserve(offsets, num_queries+1, false);
+  char* last_ref = NULL;
+  const gt_gtf_ref* source_ref = NULL;
+  uint64_t i;
+  for(i=0; i<num_queries; i++){
+    const gt_gtf_query* const query = queries + i;
+    gt_vector_insert(offsets, gt_vector_get_used(target), uint64_t);
+    if(query->ref == NULL) continue;
+    // resolve the reference only when it changes
+    if(last_ref == NULL || (query->ref != last_ref && strcmp(query->ref, last_ref) != 0)){
+      source_ref = gt_shash_get(gtf->refs, query->ref, gt_gtf_ref);
+      last_ref = query->ref;
+    }
+    if(source_ref != NULL && source_ref->index != NULL && source_ref->index->num_nodes > 0){
+      gt_gtf_search_index_(source_ref->index, 0, query->start, query->end, target);
+    }
+  }
+  gt_vector_insert(offsets, gt_vector_get_used(target), uint64_t);
   return gt_vector_get_used(target);
 }
 
@@ -1100,6 +1498,8 @@ GT_INLINE void gt_gtf_count_coverage_(const gt_gtf* const gtf, gt_map* const map
  *
  * @param gt_gtf* gtf                the gtf reference
  * @param gt_map*                    continuous map block
+ * @param gt_gtf_entry** hits        the annotation entries overlapping the block
+ * @param uint64_t num_hits          the number of overlapping entries
  * @param gt_shash* type_counts      the type counts, i.e exon/intron etc
  * @param gt_shash* gene_counts      the gene counts with the gene_id's hit by the map.
  * @param gt_shash* exon_counts      the exon counts with the gene_id's hit by the map.
@@ -1108,6 +1508,7 @@ GT_INLINE void gt_gtf_count_coverage_(const gt_gtf* const gtf, gt_map* const map
  * @return uint64_t num_gene_exons   number of unique gene_ids hit by exons
  */
 GT_INLINE uint64_t gt_gtf_count_map_(const gt_gtf* const gtf, gt_map* const map,
+                                     gt_gtf_entry** const hits, const uint64_t num_hits,
                                      gt_shash* const type_counts,
                                      gt_shash* const gene_counts,
                                      gt_shash* const exon_counts,
@@ -1123,10 +1524,6 @@ GT_INLINE uint64_t gt_gtf_count_map_(const gt_gtf* const gtf, gt_map* const map,
   }
   uint64_t map_length = (end-start)+1;
 
-  // store the search hits and search
-  gt_vector* const hits = gt_vector_new(32, sizeof(gt_gtf_entry*));
-  gt_gtf_search(gtf, hits, gt_map_get_seq_name(map), start, end, true);
-
   // we do a complete local count for this block
   // and then merge the local count with the global count
   // to be able to resolve genes/gene_types that are
@@ -1137,8 +1534,9 @@ GT_INLINE uint64_t gt_gtf_count_map_(const gt_gtf* const gtf, gt_map* const map,
   gt_shash* local_gene_counts = gt_shash_new();
   gt_shash* local_exon_gene_counts = gt_shash_new();
   float max_overlap = 0.0;
-  GT_VECTOR_ITERATE(hits, e, i, gt_gtf_entry*){
-    gt_gtf_entry* hit = *e;
+  uint64_t i;
+  for(i=0; i<num_hits; i++){
+    gt_gtf_entry* hit = hits[i];
     // count type
     gt_gtf_count_(local_type_counts, gt_string_get_string(hit->type));
     // count gene id
@@ -1174,7 +1572,7 @@ GT_INLINE uint64_t gt_gtf_count_map_(const gt_gtf* const gtf, gt_map* const map,
   //   3. count intron hits
   //   4. count unknown if the hit was neither an intron nor exon hit
   // all counting steps are exclusive, thats why the order matters!
-  if(gt_vector_get_used(hits) == 0){
+  if(num_hits == 0){
     // count 'NA' type if we did not hit anything
     gt_gtf_count_(type_counts, GT_GTF_TYPE_NA);
   }else if(gt_gtf_get_count_(local_type_counts, GT_GTF_TYPE_EXON) > 0){
@@ -1204,7 +1602,6 @@ GT_INLINE uint64_t gt_gtf_count_map_(const gt_gtf* const gtf, gt_map* const map,
   gt_shash_delete(local_gene_counts, true);
   gt_shash_delete(local_type_counts, true);
   gt_shash_delete(local_exon_gene_counts, true);
-  gt_vector_delete(hits);
   return num_gene_hit_exons;
 }
 
@@ -1232,6 +1629,21 @@ GT_INLINE double gt_gtf_count_get_sum_(gt_shash* table){
   }GT_SHASH_END_ITERATE;
   return v;
 }
+/**
+ * Add a search query for each block of the map. Empty blocks, where the
+ * trimmed begin is behind the end, get a query without reference.
+ */
+GT_INLINE void gt_gtf_add_map_queries_(gt_vector* const queries, gt_map* const map){
+  GT_MAP_ITERATE(map, map_block){
+    gt_vector_reserve_additional(queries, 1);
+    gt_gtf_query* const query = gt_vector_get_free_elm(queries, gt_gtf_query);
+    query->start = gt_gtf_get_map_begin(map_block);
+    query->end = gt_gtf_get_map_end(map_block);
+    query->ref = (query->start > query->end) ? NULL : gt_map_get_seq_name(map_block);
+    gt_vector_inc_used(queries);
+  }
+}
+
 GT_INLINE uint64_t gt_gtf_get_map_length(gt_map* const maps){
   uint64_t map_length = 0;
   GT_MAP_ITERATE(maps, map){
@@ -1301,9 +1713,21 @@ GT_INLINE uint64_t gt_gtf_count_map(const gt_gtf* const gtf, gt_map* const map1,
   uint64_t i = 0;
   float block_1_overlap = 0.0;
   float block_2_overlap = 0.0;
+
+  // search the annotation overlaps of all blocks at once
+  gt_vector* const queries = gt_vector_new(blocks, sizeof(gt_gtf_query));
+  gt_gtf_add_map_queries_(queries, map1);
+  if(map2 != NULL) gt_gtf_add_map_queries_(queries, map2);
+  gt_vector* const hits = gt_vector_new(32, sizeof(gt_gtf_entry*));
+  gt_vector* const hit_offsets = gt_vector_new(blocks+1, sizeof(uint64_t));
+  gt_gtf_search_batch(gtf, hits, hit_offsets, gt_vector_get_mem(queries, gt_gtf_query), blocks);
+  gt_gtf_entry** const block_hits = gt_vector_get_mem(hits, gt_gtf_entry*);
+  const uint64_t* const block_offsets = gt_vector_get_mem(hit_offsets, uint64_t);
+
   uint64_t map_1_length = gt_gtf_get_map_length(map1);
   GT_MAP_ITERATE(map1, map_block){
-    local_exon_gene_hits[i++] = gt_gtf_count_map_(gtf, map_block, local_type_counts, local_gene_counts_1, local_exon_counts_1,local_junction_counts_1, &block_1_overlap, map_1_length, params);
+    local_exon_gene_hits[i] = gt_gtf_count_map_(gtf, map_block, block_hits+block_offsets[i], block_offsets[i+1]-block_offsets[i], local_type_counts, local_gene_counts_1, local_exon_counts_1,local_junction_counts_1, &block_1_overlap, map_1_length, params);
+    i++;
     uint64_t _exons = exons + gt_gtf_get_count_(local_type_counts, GT_GTF_TYPE_EXON);
     uint64_t _introns = introns + gt_gtf_get_count_(local_type_counts, GT_GTF_TYPE_INTRON);
     uint64_t _unknown = unknown + gt_gtf_get_count_(local_type_counts, GT_GTF_TYPE_UNKNOWN);
@@ -1360,7 +1784,8 @@ GT_INLINE uint64_t gt_gtf_count_map(const gt_gtf* const gtf, gt_map* const map1,
     uint64_t map_2_length = gt_gtf_get_map_length(map2);
 
     GT_MAP_ITERATE(map2, map_block){
-      local_exon_gene_hits[i++] = gt_gtf_count_map_(gtf, map_block, local_type_counts, local_gene_counts_2, local_exon_counts_2, local_junction_counts_2, &block_2_overlap, map_2_length, params);
+      local_exon_gene_hits[i] = gt_gtf_count_map_(gtf, map_block, block_hits+block_offsets[i], block_offsets[i+1]-block_offsets[i], local_type_counts, local_gene_counts_2, local_exon_counts_2, local_junction_counts_2, &block_2_overlap, map_2_length, params);
+      i++;
       uint64_t _exons = exons + gt_gtf_get_count_(local_type_counts, GT_GTF_TYPE_EXON);
       uint64_t _introns = introns + gt_gtf_get_count_(local_type_counts, GT_GTF_TYPE_INTRON);
       uint64_t _unknown = unknown + gt_gtf_get_count_(local_type_counts, GT_GTF_TYPE_UNKNOWN);
@@ -1527,6 +1952,9 @@ GT_INLINE uint64_t gt_gtf_count_map(const gt_gtf* const gtf, gt_map* const map1,
   }
 
   // cleanup
+  gt_vector_delete(queries);
+  gt_vector_delete(hits);
+  gt_vector_delete(hit_offsets);
   gt_vector_delete(local_type_patterns);
   gt_shash_delete(local_gene_counts, true);
   // cleanup
@@ -65,11 +65,14 @@ GT_INLINE void gt_ihash_destroy(gt_ihash* const ihash) {
 
 /*
  * Basic (Type-unsafe) Accessors
+ *   Keys are hashed as a whole (HASH_{FIND,ADD}_INT would only take sizeof(int) bytes of the int64_t)
  */
+#define GT_IHASH_FIND_KEY(ihash_head,key_ptr,ihash_element) HASH_FIND(hh,ihash_head,key_ptr,sizeof(int64_t),ihash_element)
+#define GT_IHASH_ADD_KEY(ihash_head,ihash_element) HASH_ADD(hh,ihash_head,key,sizeof(int64_t),ihash_element)
 GT_INLINE gt_ihash_element* gt_ihash_get_ihash_element(gt_ihash* const ihash,const int64_t key) {
   GT_HASH_CHECK(ihash);
   gt_ihash_element *ihash_element;
-  HASH_FIND_INT(ihash->ihash_head,&key,ihash_element);
+  GT_IHASH_FIND_KEY(ihash->ihash_head,&key,ihash_element);
   return ihash_element;
 }
 GT_INLINE void gt_ihash_insert_primitive(
@@ -82,7 +85,7 @@ GT_INLINE void gt_ihash_insert_primitive(
     ihash_element = gt_alloc(gt_ihash_element);
     ihash_element->key = key;
     ihash_element->element = element;
-    HASH_ADD_INT(ihash->ihash_head,key,ihash_element);
+    GT_IHASH_ADD_KEY(ihash->ihash_head,ihash_element);
   } else {
     gt_ihash_free_element(ihash_element);
     ihash_element->element = element;
@@ -102,7 +105,7 @@ GT_INLINE void gt_ihash_insert_object(
     ihash_element = gt_alloc(gt_ihash_element);
     ihash_element->key = key;
     ihash_element->element = object;
-    HASH_ADD_INT(ihash->ihash_head,key,ihash_element);
+    GT_IHASH_ADD_KEY(ihash->ihash_head,ihash_element);
   } else {
     gt_ihash_free_element(ihash_element);
     ihash_element->element = object;
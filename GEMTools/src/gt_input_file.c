@@ -16,6 +16,152 @@
 
 // Internal constants
 #define GT_INPUT_BUFFER_SIZE GT_BUFFER_SIZE_64M
+#define GT_INPUT_READAHEAD_SIZE GT_BUFFER_SIZE_64M
+
+/*
+ * Setup (common fields)
+ */
+GT_INLINE void gt_input_file_init_buffers(gt_input_file* const input_file) {
+  // Auxiliary Buffer (for synch purposes)
+  input_file->buffer_size = 0;
+  input_file->buffer_begin = 0;
+  input_file->buffer_pos = 0;
+  input_file->global_pos = 0;
+  input_file->processed_lines = 0;
+  // ID generator
+  input_file->processed_id = 0;
+  // Asynchronous refills (started on the first full block)
+  input_file->prefetch_enabled = false;
+  input_file->prefetch_buffer = NULL;
+  input_file->prefetch_size = 0;
+  input_file->prefetch_ready = false;
+  input_file->prefetch_eof = false;
+  input_file->prefetch_exit = false;
+  // Readahead hints
+  input_file->readahead_pos = 0;
+}
+
+/*
+ * Block readers
+ */
+GT_INLINE size_t gt_input_file_read_block(gt_input_file* const input_file,uint8_t* const buffer) {
+#ifdef HAVE_BZLIB
+  int bzerr;
+#endif
+  switch (input_file->file_type) {
+    case STREAM:
+      return (feof(input_file->file)) ? 0 : fread(buffer,sizeof(uint8_t),GT_INPUT_BUFFER_SIZE,input_file->file);
+    case REGULAR_FILE: {
+      if (feof(input_file->file)) return 0;
+      const size_t block_size = fread(buffer,sizeof(uint8_t),GT_INPUT_BUFFER_SIZE,input_file->file);
+      // Ask the kernel for the block after this one
+      const off_t offset = ftello(input_file->file);
+      if (block_size==GT_INPUT_BUFFER_SIZE && offset!=-1) {
+        posix_fadvise(fileno(input_file->file),offset,GT_INPUT_BUFFER_SIZE,POSIX_FADV_WILLNEED);
+      }
+      return block_size;
+    }
+#ifdef HAVE_ZLIB
+    case GZIPPED_FILE: {
+      if (gzeof((gzFile)input_file->file)) return 0;
+      const int block_size = gzread((gzFile)input_file->file,buffer,GT_INPUT_BUFFER_SIZE);
+      return (block_size>0) ? block_size : 0;
+    }
+#endif
+#ifdef HAVE_BZLIB
+    case BZIPPED_FILE: {
+      const int block_size = BZ2_bzRead(&bzerr,input_file->file,buffer,GT_INPUT_BUFFER_SIZE);
+      return (block_size>0) ? block_size : 0;
+    }
+#endif
+    default:
+      return 0;
+  }
+}
+/*
+ * Asynchronous refills
+ *   Once a file has proven bigger than one block, a prefetch thread reads block N+1
+ *   while block N is being split into the buffered inputs. Pipes/streams are read
+ *   synchronously (a blocked read would prevent closing the file early)
+ */
+void* gt_input_file_prefetch_thread(void* const thread_data) {
+  gt_input_file* const input_file = (gt_input_file*) thread_data;
+  GT_BEGIN_MUTEX_SECTION(input_file->prefetch_mutex);
+  while (true) {
+    while (input_file->prefetch_ready && !input_file->prefetch_exit) {
+      GT_CV_WAIT(input_file->prefetch_cond,input_file->prefetch_mutex);
+    }
+    if (input_file->prefetch_exit) break;
+    GT_END_MUTEX_SECTION(input_file->prefetch_mutex);
+    const size_t block_size = gt_input_file_read_block(input_file,input_file->prefetch_buffer);
+    GT_BEGIN_MUTEX_SECTION(input_file->prefetch_mutex);
+    input_file->prefetch_size = block_size;
+    input_file->prefetch_ready = true;
+    GT_CV_SIGNAL(input_file->prefetch_cond);
+    if (block_size==0) {
+      input_file->prefetch_eof = true;
+      break;
+    }
+  }
+  GT_END_MUTEX_SECTION(input_file->prefetch_mutex);
+  return NULL;
+}
+GT_INLINE void gt_input_file_prefetch_start(gt_input_file* const input_file) {
+  if (input_file->file_type==STREAM) return;
+  input_file->prefetch_buffer = gt_malloc(GT_INPUT_BUFFER_SIZE);
+  gt_mm_advise_bulk_buffer(input_file->prefetch_buffer,GT_INPUT_BUFFER_SIZE,false);
+  input_file->prefetch_ready = false;
+  input_file->prefetch_eof = false;
+  input_file->prefetch_exit = false;
+  gt_cond_fatal_error(pthread_mutex_init(&input_file->prefetch_mutex,NULL),SYS_MUTEX_INIT);
+  gt_cond_fatal_error(pthread_cond_init(&input_file->prefetch_cond,NULL),SYS_COND_VAR_INIT);
+  gt_cond_fatal_error(pthread_create(&input_file->prefetch_thread,NULL,
+      gt_input_file_prefetch_thread,(void*)input_file),SYS_THREAD);
+  input_file->prefetch_enabled = true;
+}
+GT_INLINE size_t gt_input_file_prefetch_get_block(gt_input_file* const input_file) {
+  size_t block_size = 0;
+  GT_BEGIN_MUTEX_SECTION(input_file->prefetch_mutex);
+  while (!input_file->prefetch_ready && !input_file->prefetch_eof) {
+    GT_CV_WAIT(input_file->prefetch_cond,input_file->prefetch_mutex);
+  }
+  if (input_file->prefetch_ready) {
+    // Swap buffers (the current block has already been consumed)
+    uint8_t* const file_buffer = input_file->file_buffer;
+    input_file->file_buffer = input_file->prefetch_buffer;
+    input_file->prefetch_buffer = file_buffer;
+    block_size = input_file->prefetch_size;
+    input_file->prefetch_ready = false;
+    GT_CV_SIGNAL(input_file->prefetch_cond);
+  }
+  GT_END_MUTEX_SECTION(input_file->prefetch_mutex);
+  return block_size;
+}
+GT_INLINE void gt_input_file_prefetch_stop(gt_input_file* const input_file) {
+  if (!input_file->prefetch_enabled) return;
+  GT_BEGIN_MUTEX_SECTION(input_file->prefetch_mutex);
+  input_file->prefetch_exit = true;
+  GT_CV_SIGNAL(input_file->prefetch_cond);
+  GT_END_MUTEX_SECTION(input_file->prefetch_mutex);
+  gt_cond_fatal_error(pthread_join(input_file->prefetch_thread,NULL),SYS_THREAD_JOIN);
+  pthread_cond_destroy(&input_file->prefetch_cond);
+  pthread_mutex_destroy(&input_file->prefetch_mutex);
+  gt_free(input_file->prefetch_buffer);
+  input_file->prefetch_enabled = false;
+}
+/*
+ * Readahead hints for mapped files. Keeps (at least) one window requested ahead of the consumption point
+ */
+GT_INLINE void gt_input_file_readahead(gt_input_file* const input_file) {
+  if (input_file->file_type!=MAPPED_FILE) return;
+  const uint64_t consumed = input_file->global_pos+input_file->buffer_pos;
+  while (input_file->readahead_pos < input_file->file_size &&
+         input_file->readahead_pos < consumed+GT_INPUT_READAHEAD_SIZE) {
+    const uint64_t window = GT_MIN(GT_INPUT_READAHEAD_SIZE,input_file->file_size-input_file->readahead_pos);
+    madvise(input_file->file_buffer+input_file->readahead_pos,window,MADV_WILLNEED);
+    input_file->readahead_pos += window;
+  }
+}
 
 /*
  * Basic I/O functions
@@ -35,13 +181,8 @@ gt_input_file* gt_input_stream_open(FILE* stream) {
   gt_cond_fatal_error(pthread_mutex_init(&input_file->input_mutex, NULL),SYS_MUTEX_INIT);
   // Auxiliary Buffer (for synch purposes)
   input_file->file_buffer = gt_malloc(GT_INPUT_BUFFER_SIZE);
-  input_file->buffer_size = 0;
-  input_file->buffer_begin = 0;
-  input_file->buffer_pos = 0;
-  input_file->global_pos = 0;
-  input_file->processed_lines = 0;
-  // ID generator
-  input_file->processed_id = 0;
+  gt_mm_advise_bulk_buffer(input_file->file_buffer,GT_INPUT_BUFFER_SIZE,false);
+  gt_input_file_init_buffers(input_file);
   // Detect file format
   gt_input_file_detect_file_format(input_file);
   return input_file;
@@ -68,6 +209,8 @@ gt_input_file* gt_input_file_open(char* const file_name,const bool mmap_file) {
       (uint8_t*) mmap(0,input_file->file_size,PROT_READ,MAP_PRIVATE,input_file->fildes,0);
     gt_cond_fatal_error(input_file->file_buffer==MAP_FAILED,SYS_MMAP_FILE,file_name);
     input_file->file_type = MAPPED_FILE;
+    // Sequential access (the first window is requested by gt_input_file_readahead)
+    madvise(input_file->file_buffer,input_file->file_size,MADV_SEQUENTIAL);
   } else {
     input_file->fildes = -1;
     gt_cond_fatal_error(!(input_file->file=fopen(file_name,"r")),FILE_OPEN,file_name);
@@ -77,15 +220,21 @@ gt_input_file* gt_input_file_open(char* const file_name,const bool mmap_file) {
       i=(int)fread(tbuf,(size_t)1,(size_t)4,input_file->file);
       if(tbuf[0]==0x1f && tbuf[1]==0x8b && tbuf[2]==0x08) {
         input_file->file_type=GZIPPED_FILE;
-        fclose(input_file->file);
 #ifdef HAVE_ZLIB
-        gt_cond_fatal_error(!(input_file->file=(void *)gzopen(file_name,"r")),FILE_GZIP_OPEN,file_name);
+        // Keep the descriptor (to hint the kernel) and hand it over to zlib
+        const int gz_fildes = dup(fileno(input_file->file));
+        fclose(input_file->file);
+        gt_cond_fatal_error(gz_fildes==-1 || lseek(gz_fildes,0,SEEK_SET)==-1,FILE_GZIP_OPEN,file_name);
+        posix_fadvise(gz_fildes,0,0,POSIX_FADV_SEQUENTIAL);
+        gt_cond_fatal_error(!(input_file->file=(void *)gzdopen(gz_fildes,"r")),FILE_GZIP_OPEN,file_name);
 #else
+        fclose(input_file->file);
         gt_fatal_error(FILE_GZIP_NO_ZLIB,file_name);
 #endif
       } else if(tbuf[0]=='B' && tbuf[1]=='Z' && tbuf[2]=='h' && tbuf[3]>='0' && tbuf[3]<='9') {
         fseek(input_file->file,0L,SEEK_SET);
         input_file->file_type=BZIPPED_FILE;
+        posix_fadvise(fileno(input_file->file),0,0,POSIX_FADV_SEQUENTIAL);
 #ifdef HAVE_BZLIB
         input_file->file=BZ2_bzReadOpen(&i,input_file->file,0,0,NULL,0);
         gt_cond_fatal_error(i!=BZ_OK,FILE_BZIP2_OPEN,file_name);
@@ -94,20 +243,15 @@ gt_input_file* gt_input_file_open(char* const file_name,const bool mmap_file) {
 #endif
       } else {
         fseek(input_file->file,0L,SEEK_SET);
+        posix_fadvise(fileno(input_file->file),0,0,POSIX_FADV_SEQUENTIAL);
       }
     } else {
       input_file->eof=0;
     }
     input_file->file_buffer = gt_malloc(GT_INPUT_BUFFER_SIZE);
+    gt_mm_advise_bulk_buffer(input_file->file_buffer,GT_INPUT_BUFFER_SIZE,false);
   }
-  // Auxiliary Buffer (for synch purposes)
-  input_file->buffer_size = 0;
-  input_file->buffer_begin = 0;
-  input_file->buffer_pos = 0;
-  input_file->global_pos = 0;
-  input_file->processed_lines = 0;
-  // ID generator
-  input_file->processed_id = 0;
+  gt_input_file_init_buffers(input_file);
   // Detect file format
   gt_input_file_detect_file_format(input_file);
   return input_file;
@@ -122,6 +266,7 @@ gt_status gt_input_file_close(gt_input_file* const input_file) {
 #ifdef HAVE_BZLIB
   int bzerr;
 #endif
+  gt_input_file_prefetch_stop(input_file);
   switch (input_file->file_type) {
     case REGULAR_FILE:
       gt_free(input_file->file_buffer);
@@ -141,7 +286,7 @@ gt_status gt_input_file_close(gt_input_file* const input_file) {
 #endif
       break;
     case MAPPED_FILE:
-      gt_cond_error(munmap(input_file->file,input_file->file_size)==-1,SYS_UNMAP);
+      gt_cond_error(munmap(input_file->file_buffer,input_file->file_size)==-1,SYS_UNMAP);
       if (close(input_file->fildes)) status = GT_INPUT_FILE_CLOSE_ERR;
       break;
     case STREAM:
@@ -186,45 +331,27 @@ GT_INLINE size_t gt_input_file_dump_to_buffer(gt_input_file* const input_file,gt
   return chunk_size;
 }
 GT_INLINE size_t gt_input_file_fill_buffer(gt_input_file* const input_file) {
-#ifdef HAVE_BZLIB
-  int bzerr;
-#endif
   GT_INPUT_FILE_CHECK(input_file);
   input_file->global_pos += input_file->buffer_size;
   input_file->buffer_pos = 0;
   input_file->buffer_begin = 0;
-  if (gt_expect_true(
-      (input_file->file_type==STREAM && !feof(input_file->file)) ||
-      (input_file->file_type==REGULAR_FILE && !feof(input_file->file)))) {
-    input_file->buffer_size =
-        fread(input_file->file_buffer,sizeof(uint8_t),GT_INPUT_BUFFER_SIZE,input_file->file);
-    if (input_file->buffer_size==0) {
-      input_file->eof = true;
+  if (input_file->file_type==MAPPED_FILE) {
+    if (input_file->global_pos < input_file->file_size) {
+      input_file->buffer_size = input_file->file_size-input_file->global_pos;
+      return input_file->buffer_size;
     }
-    return input_file->buffer_size;
-  } else if (input_file->file_type==MAPPED_FILE && input_file->global_pos < input_file->file_size) {
-    input_file->buffer_size = input_file->file_size-input_file->global_pos;
-    return input_file->buffer_size;
-#ifdef HAVE_ZLIB
-  } else if (input_file->file_type==GZIPPED_FILE && !gzeof((gzFile)input_file->file)) {
-    input_file->buffer_size = gzread((gzFile)input_file->file,input_file->file_buffer,GT_INPUT_BUFFER_SIZE);
-    if (input_file->buffer_size==0) {
-      input_file->eof = true;
-    }
-    return input_file->buffer_size;
-#endif
-#ifdef HAVE_BZLIB
-  } else if (input_file->file_type==BZIPPED_FILE) {
-    input_file->buffer_size = BZ2_bzRead(&bzerr,input_file->file,input_file->file_buffer,GT_INPUT_BUFFER_SIZE);
-    if(input_file->buffer_size==0) {
-      input_file->eof=true;
-    }
-    return input_file->buffer_size;
-#endif
-  } else {
     input_file->eof = true;
     return 0;
   }
+  // Read the next block (swapping in the prefetched one, if any)
+  if (input_file->prefetch_enabled) {
+    input_file->buffer_size = gt_input_file_prefetch_get_block(input_file);
+  } else {
+    input_file->buffer_size = gt_input_file_read_block(input_file,input_file->file_buffer);
+    if (input_file->buffer_size==GT_INPUT_BUFFER_SIZE) gt_input_file_prefetch_start(input_file);
+  }
+  if (input_file->buffer_size==0) input_file->eof = true;
+  return input_file->buffer_size;
 }
 GT_INLINE size_t gt_input_file_next_line(gt_input_file* const input_file,gt_vector* const buffer_dst) {
   GT_INPUT_FILE_CHECK(input_file);
@@ -363,6 +490,7 @@ GT_INLINE uint64_t gt_input_file_add_lines(
   GT_VECTOR_CHECK(buffer_dst);
   // Read lines
   uint64_t lines_read = 0;
+  gt_input_file_readahead(input_file);
   while (lines_read<num_lines && gt_input_file_next_line(input_file,buffer_dst)) {
     ++lines_read;
   }
@@ -39,8 +39,10 @@ GT_INLINE void gt_input_map_parser_attributes_reset_defaults(gt_map_parser_attri
   attributes->max_parsed_maps = GT_ALL;
   attributes->force_read_paired = false;
   attributes->src_text = NULL;
+  attributes->mm_pool = NULL;
   attributes->skip_based_model=false;
   attributes->remove_duplicates=false;
+  attributes->synch_segmented_reads=false;
 }
 GT_INLINE bool gt_input_map_parser_attributes_is_paired(gt_map_parser_attributes* const attributes) {
   GT_NULL_CHECK(attributes);
@@ -54,6 +56,10 @@ GT_INLINE void gt_input_map_parser_attributes_set_max_parsed_maps(gt_map_parser_
   GT_NULL_CHECK(attributes);
   attributes->max_parsed_maps = max_parsed_maps;
 }
+GT_INLINE void gt_input_map_parser_attributes_set_synch_segmented_reads(gt_map_parser_attributes* const attributes,const bool synch_segmented_reads) {
+  GT_NULL_CHECK(attributes);
+  attributes->synch_segmented_reads = synch_segmented_reads;
+}
 GT_INLINE void gt_input_map_parser_attributes_set_src_text(gt_map_parser_attributes* const attributes,gt_string* const src_text) {
   GT_NULL_CHECK(attributes);
   attributes->src_text = src_text;
@@ -294,9 +300,22 @@ GT_INLINE gt_status gt_imp_reload_buffer_matching_tag(
   gt_string_delete(last_tag);
   return GT_IMP_OK;
 }
-/* MAP file. Synchronized get block wrt to paired map records */
+/* MAP file. Truncates the record's tag to the read name (as compared by @gt_input_file_next_record_cmp_first_field) */
+GT_INLINE void gt_imp_chomp_block_tag(gt_string* const tag) {
+  char* const tag_buffer = gt_string_get_string(tag);
+  const uint64_t tag_length = gt_string_get_length(tag);
+  uint64_t i;
+  for (i=0;i<tag_length && tag_buffer[i]!=SPACE;++i);
+  gt_string_set_length(tag,i);
+  gt_input_parse_tag_chomp_pairend_info(tag);
+}
+/*
+ * MAP file. Synchronized get block wrt to paired map records
+ *   If @synch_segmented_reads, the block is extended past @num_records until the tag changes, so
+ *   all the records of a segmented read (sharing the tag, sorted) end up in the same block
+ */
 GT_INLINE gt_status gt_imp_get_block(
-    gt_buffered_input_file* const buffered_map_input,const uint64_t num_records) {
+    gt_buffered_input_file* const buffered_map_input,const uint64_t num_records,const bool synch_segmented_reads) {
   GT_BUFFERED_INPUT_FILE_CHECK(buffered_map_input);
   gt_input_file* const input_file = buffered_map_input->input_file;
   // Read lines
@@ -313,6 +332,19 @@ GT_INLINE gt_status gt_imp_get_block(
   uint64_t lines_read = 0, num_blocks = 0, num_tabs = 0;
   while ( (lines_read<num_records || num_blocks%2!=0) &&
       gt_input_file_next_record(input_file,buffered_map_input->block_buffer,NULL,&num_blocks,&num_tabs) ) ++lines_read;
+  if (synch_segmented_reads && lines_read>=num_records) { // !EOF, Synch wrt to tag content
+    gt_string* const reference_tag = gt_string_new(30);
+    if (gt_input_file_next_record(input_file,buffered_map_input->block_buffer,reference_tag,&num_blocks,&num_tabs)) {
+      ++lines_read;
+      gt_imp_chomp_block_tag(reference_tag);
+      while (num_blocks%2!=0 || gt_input_file_next_record_cmp_first_field(input_file,reference_tag)) {
+        if (!gt_input_file_next_record(input_file,buffered_map_input->block_buffer,reference_tag,&num_blocks,&num_tabs)) break;
+        ++lines_read;
+        gt_imp_chomp_block_tag(reference_tag); // Compare against the last record (the cmp can be optimistic)
+      }
+    }
+    gt_string_delete(reference_tag);
+  }
   // Dump remaining content into the buffer
   gt_input_file_dump_to_buffer(input_file,buffered_map_input->block_buffer);
   if (lines_read > 0 && *gt_vector_get_last_elm(buffered_map_input->block_buffer,char) != EOL) {
@@ -326,20 +358,25 @@ GT_INLINE gt_status gt_imp_get_block(
   return buffered_map_input->lines_in_buffer;
 }
 /* MAP file. Reload internal buffer */
-GT_INLINE gt_status gt_input_map_parser_reload_buffer(
-    gt_buffered_input_file* const buffered_map_input,const bool synchronized_map,const uint64_t num_lines) {
+GT_INLINE gt_status gt_imp_reload_buffer(
+    gt_buffered_input_file* const buffered_map_input,const bool synchronized_map,
+    const bool synch_segmented_reads,const uint64_t num_lines) {
   GT_BUFFERED_INPUT_FILE_CHECK(buffered_map_input);
   // Dump buffer if BOF it attached to Map-input, and get new out block (always FIRST)
   gt_buffered_input_file_dump_attached_buffers(buffered_map_input->attached_buffered_output_file);
   // Read new input block
   const uint64_t read_lines = (synchronized_map) ?
-      gt_imp_get_block(buffered_map_input,num_lines):
+      gt_imp_get_block(buffered_map_input,num_lines,synch_segmented_reads):
       gt_buffered_input_file_get_block(buffered_map_input,num_lines);
   if (gt_expect_false(read_lines==0)) return GT_IMP_EOF;
   // Assign block ID
   gt_buffered_input_file_set_id_attached_buffers(buffered_map_input->attached_buffered_output_file,buffered_map_input->block_id);
   return GT_IMP_OK;
 }
+GT_INLINE gt_status gt_input_map_parser_reload_buffer(
+    gt_buffered_input_file* const buffered_map_input,const bool synchronized_map,const uint64_t num_lines) {
+  return gt_imp_reload_buffer(buffered_map_input,synchronized_map,false,num_lines);
+}
 
 /*
  * MAP format. Basic building block for parsing
@@ -558,7 +595,7 @@ GT_INLINE gt_status gt_imp_parse_mismatch_string_v0(const char** const text_line
         gt_map_set_base_length(map,position-last_cut_point);
         last_cut_point = position;
         // Create a new map block
-        gt_map* next_map = gt_map_new();
+        gt_map* next_map = gt_map_new_from_pool(map->mm_pool);
         gt_map_set_seq_name(next_map,gt_map_get_seq_name(map),gt_map_get_seq_name_length(map));
         gt_map_set_strand(next_map,gt_map_get_strand(map));
         gt_map_set_base_length(next_map,global_length-position);
@@ -671,7 +708,7 @@ GT_INLINE gt_status gt_imp_parse_mismatch_string_v1(const char** const text_line
         }
         GT_NEXT_CHAR(text_line);
         // Create a new map block
-        gt_map* const next_map = gt_map_new();
+        gt_map* const next_map = gt_map_new_from_pool(map->mm_pool);
         gt_map_set_seq_name(next_map,gt_map_get_seq_name(map),gt_map_get_seq_name_length(map));
         gt_map_set_strand(next_map,gt_map_get_strand(map));
         // FIXME: gt_map_set_base_length(next_map,gt_map_get_base_length(map)-read_span);
@@ -756,7 +793,8 @@ GT_INLINE gt_status gt_imp_next_element(const char** const text_line) {
 #define GT_IMP_PARSE_SPLIT_MAP_CLEAN1__RETURN(error_code) { gt_map_delete(donor_map); return error_code; }
 #define GT_IMP_PARSE_SPLIT_MAP_CLEAN2__RETURN(error_code) { gt_map_delete(donor_map); gt_map_delete(acceptor_map); return error_code; }
 #define GT_IMP_PARSE_SPLITMAP_IS_SEP(text_line) ((**text_line)==GT_MAP_SPLITMAP_NEXT_GEMv0_0 || (**text_line)==GT_MAP_SPLITMAP_NEXT_GEMv0_1)
-GT_INLINE gt_status gt_imp_parse_split_map_v0(const char** const text_line,gt_map** const split_map,const uint64_t read_base_length) {
+GT_INLINE gt_status gt_imp_parse_split_map_v0(
+    const char** const text_line,gt_map** const split_map,const uint64_t read_base_length,gt_mm_pool* const mm_pool) {
   /*
    * ReturnValues = { GT_IMP_PE_MAP_BAD_CHARACTER, GT_IMP_PE_PREMATURE_EOL, OK=0 }
    */
@@ -778,7 +816,7 @@ GT_INLINE gt_status gt_imp_parse_split_map_v0(const char** const text_line,gt_ma
    */
   if (gt_expect_false((**text_line)!=GT_MAP_SPLITMAP_OPEN_GEMv0)) return GT_IMP_PE_MAP_BAD_CHARACTER;
   // Create the SM
-  gt_map* const donor_map = gt_map_new();
+  gt_map* const donor_map = gt_map_new_from_pool(mm_pool);
   // Read split-points
   uint64_t sm_position;
   bool sm_elm_parsed = false;
@@ -840,7 +878,7 @@ GT_INLINE gt_status gt_imp_parse_split_map_v0(const char** const text_line,gt_ma
    * Parse acceptor(s)
    */
   // Read acceptor's TAG
-  gt_map* const acceptor_map = gt_map_new();
+  gt_map* const acceptor_map = gt_map_new_from_pool(mm_pool);
   const char* const acceptor_name = *text_line;
   GT_READ_UNTIL(text_line,(**text_line)==GT_MAP_SEP);
   if (GT_IS_EOL(text_line)) GT_IMP_PARSE_SPLIT_MAP_CLEAN2__RETURN(GT_IMP_PE_PREMATURE_EOL);
@@ -932,12 +970,12 @@ GT_INLINE gt_status gt_imp_parse_map(
       return GT_IMP_PE_MMAP_ATTRIBUTE_SCORE;
     }
   } else if (gt_expect_false((**text_line)==GT_MAP_SPLITMAP_OPEN_GEMv0)) { // Parse Old Split-Maps
-    if ((error_code=gt_imp_parse_split_map_v0(text_line,return_map,read_base_length))) return error_code;
+    if ((error_code=gt_imp_parse_split_map_v0(text_line,return_map,read_base_length,map_parser_attr->mm_pool))) return error_code;
   } else {
     /*
      * Parse MAP (Regular Map... for whatever that means)
      */
-    gt_map* const map = gt_map_new();
+    gt_map* const map = gt_map_new_from_pool(map_parser_attr->mm_pool);
     gt_map_set_base_length(map,read_base_length); // Tentative base length (for GEMv0)
     // Read TAG
     const char* const seq_name_start = *text_line;
@@ -1473,7 +1511,8 @@ GT_INLINE gt_status gt_imp_get_template(
   gt_status error_code;
   // Check the end_of_block. Reload buffer if needed
   if (gt_buffered_input_file_eob(buffered_map_input)) {
-    if ((error_code=gt_input_map_parser_reload_buffer(buffered_map_input,true,GT_IMP_NUM_LINES))!=GT_IMP_OK) return error_code;
+    if ((error_code=gt_imp_reload_buffer(buffered_map_input,true,
+        map_parser_attr->synch_segmented_reads,GT_IMP_NUM_LINES))!=GT_IMP_OK) return error_code;
   }
   // Check file format
   if (gt_input_map_parser_check_map_file_format(buffered_map_input)) {
@@ -1485,9 +1524,12 @@ GT_INLINE gt_status gt_imp_get_template(
   const uint64_t line_num = buffered_map_input->current_line_num;
   gt_template_clear(template,true);
   template->template_id = line_num;
-  // Parse template
-  if ((error_code=gt_imp_parse_template((const char** const)&(buffered_map_input->cursor),
-      template,input_file->map_type.contains_qualities,map_parser_attr))) {
+  // Parse template (maps are drawn from the buffered input's pool)
+  map_parser_attr->mm_pool = gt_buffered_input_file_get_mm_pool(buffered_map_input);
+  error_code=gt_imp_parse_template((const char** const)&(buffered_map_input->cursor),
+      template,input_file->map_type.contains_qualities,map_parser_attr);
+  map_parser_attr->mm_pool = NULL;
+  if (error_code) {
     gt_input_map_parser_prompt_error(buffered_map_input,line_num,
         buffered_map_input->cursor-line_start,error_code);
     gt_input_map_parser_next_record(buffered_map_input);
@@ -1526,9 +1568,12 @@ GT_INLINE gt_status gt_imp_get_alignment(
   const uint64_t line_num = buffered_map_input->current_line_num;
   gt_alignment_clear(alignment);
   alignment->alignment_id = line_num;
-  // Parse alignment
-  if ((error_code=gt_imp_parse_alignment((const char** const)&(buffered_map_input->cursor),
-      alignment,input_file->map_type.contains_qualities,map_parser_attr))) {
+  // Parse alignment (maps are drawn from the buffered input's pool)
+  map_parser_attr->mm_pool = gt_buffered_input_file_get_mm_pool(buffered_map_input);
+  error_code=gt_imp_parse_alignment((const char** const)&(buffered_map_input->cursor),
+      alignment,input_file->map_type.contains_qualities,map_parser_attr);
+  map_parser_attr->mm_pool = NULL;
+  if (error_code) {
     gt_input_map_parser_prompt_error(buffered_map_input,line_num,
         buffered_map_input->cursor-line_start,error_code);
     gt_input_map_parser_next_record(buffered_map_input);
@@ -358,7 +358,7 @@ GT_INLINE gt_status gt_isp_parse_sam_cigar(char** const text_line,gt_map** _map,
         break;
       case 'N': { // Split. Eg TOPHAT, GEM, ...
         // Create a new map block
-        gt_map* next_map = gt_map_new();
+        gt_map* next_map = gt_map_new_from_pool(map->mm_pool);
         gt_map_set_seq_name(next_map,gt_map_get_seq_name(map),gt_map_get_seq_name_length(map));
         gt_map_set_position(next_map,gt_map_get_position(map)+reference_span+length);
         gt_map_set_strand(next_map,gt_map_get_strand(map));
@@ -410,10 +410,10 @@ GT_INLINE gt_status gt_isp_parse_sam_cigar(char** const text_line,gt_map** _map,
 
 GT_INLINE gt_status gt_isp_parse_sam_opt_xa_bwa(
     char** const text_line,gt_alignment* const alignment,
-    gt_vector* const maps_vector,gt_sam_pending_end* const pending) {
+    gt_vector* const maps_vector,gt_sam_pending_end* const pending,gt_mm_pool* const mm_pool) {
   *text_line+=5;
   while (**text_line!=TAB && **text_line!=EOL) { // Read new attached maps
-    gt_map* map = gt_map_new();
+    gt_map* map = gt_map_new_from_pool(mm_pool);
     gt_map_set_base_length(map,gt_alignment_get_read_length(alignment));
     // Sequence-name/Chromosome
     char* const seq_name = *text_line;
@@ -453,7 +453,7 @@ GT_INLINE gt_status gt_isp_parse_sam_opt_xa_bwa(
 GT_INLINE gt_status gt_isp_parse_sam_optional_field(
     char** const text_line,gt_alignment* const alignment,
     gt_vector* const maps_vector,gt_sam_pending_end* const pending,
-    const bool is_mapped) {
+    const bool is_mapped,gt_mm_pool* const mm_pool) {
   char* const init_opt_field = *text_line;
 
   /*
@@ -461,7 +461,7 @@ GT_INLINE gt_status gt_isp_parse_sam_optional_field(
    */
   GT_ISP_IF_OPT_FIELD(text_line,'X','A','Z') {
     if (!is_mapped) return GT_ISP_PE_SAM_UNMAPPED_XA;
-    if (gt_isp_parse_sam_opt_xa_bwa(text_line,alignment,maps_vector,pending)) {
+    if (gt_isp_parse_sam_opt_xa_bwa(text_line,alignment,maps_vector,pending,mm_pool)) {
       *text_line = init_opt_field;
     }
   } GT_ISP_END_OPT_FIELD;
@@ -480,10 +480,11 @@ GT_INLINE gt_status gt_isp_parse_sam_optional_field(
 // TODO: Increase the level of checking SAM consistency
 GT_INLINE gt_status gt_isp_parse_sam_alignment(
     char** const text_line,gt_template* const _template,gt_alignment* const _alignment,
-    uint64_t* const alignment_flag,gt_sam_pending_end* const pending,const bool override_pairing) {
+    uint64_t* const alignment_flag,gt_sam_pending_end* const pending,const bool override_pairing,
+    gt_mm_pool* const mm_pool) {
   gt_status error_code;
   bool is_mapped = true, is_single_segment;
-  gt_map* map = gt_map_new();
+  gt_map* map = gt_map_new_from_pool(mm_pool);
   /*
    * Parse FLAG
    */
@@ -662,7 +663,7 @@ GT_INLINE gt_status gt_isp_parse_sam_alignment(
    */
   while (**text_line==TAB) {
     GT_NEXT_CHAR(text_line);
-    if ((error_code=gt_isp_parse_sam_optional_field(text_line,alignment,maps_vector,pending,is_mapped))) {
+    if ((error_code=gt_isp_parse_sam_optional_field(text_line,alignment,maps_vector,pending,is_mapped,mm_pool))) {
       if (maps_vector) {
         GT_VECTOR_ITERATE(maps_vector,map_elm,map_pos,gt_map*) gt_map_delete(*map_elm);
       }
@@ -692,20 +693,26 @@ GT_INLINE bool gt_isp_fetch_next_line(
   GT_NULL_CHECK(expected_tag);
   // Check next record/line
   gt_input_sam_parser_next_record(buffered_sam_input);
-  if (gt_buffered_input_file_eob(buffered_sam_input)) return false;
-  // Fetch next tag
-  gt_string* const next_tag = gt_string_new(0);
-  char* ptext_line;
-  if (gt_isp_read_tag(&(buffered_sam_input->cursor),&ptext_line,next_tag)) return false;
-  if (chomp_tag) gt_input_parse_tag_chomp_pairend_info(next_tag);
-  const bool same_tag = gt_string_equals(expected_tag,next_tag);
-  gt_string_delete(next_tag);
-  if (same_tag) {
-    buffered_sam_input->cursor = ptext_line;
-    return true;
-  } else {
-    return false;
+  if (gt_expect_false(gt_buffered_input_file_eob(buffered_sam_input))) return false;
+  // Fetch next tag (compared in place against the block buffer)
+  char* const tag_begin = buffered_sam_input->cursor;
+  char* tag_end = tag_begin;
+  while (*tag_end!=TAB && *tag_end!=SPACE && *tag_end!=EOL && *tag_end!=EOS) ++tag_end;
+  if (gt_expect_false(*tag_end==EOL || *tag_end==EOS)) return false;
+  uint64_t tag_length = tag_end-tag_begin;
+  if (chomp_tag && tag_length>2 && tag_begin[tag_length-2]==SLASH &&
+      (tag_begin[tag_length-1]=='1' || tag_begin[tag_length-1]=='2' || tag_begin[tag_length-1]=='3')) {
+    tag_length -= 2;
+  }
+  if (tag_length!=gt_string_get_length(expected_tag) ||
+      gt_strncmp(tag_begin,gt_string_get_string(expected_tag),tag_length)) return false;
+  // Skip the rest of the QNAME field
+  if (*tag_end==SPACE) {
+    while (*tag_end!=TAB && *tag_end!=EOL && *tag_end!=EOS) ++tag_end;
+    if (gt_expect_false(*tag_end!=TAB)) return false;
   }
+  buffered_sam_input->cursor = tag_end+1;
+  return true;
 }
 
 GT_INLINE void gt_isp_add_mmap(
@@ -747,21 +754,87 @@ GT_INLINE bool gt_isp_check_pending_record__add_mmap(
   return false;
 }
 
+/*
+ * Pending mates table. Open-addressing (linear probing) over the pending vector,
+ *   keyed by (RNEXT,PNEXT,segment-flag). Records sharing a key are probed in
+ *   insertion order, so the first unsolved candidate wins as in a linear scan.
+ */
+#define GT_ISP_PENDING_TABLE_INITIAL_SLOTS 16
+#define GT_ISP_PENDING_TABLE_EMPTY UINT64_MAX
+typedef struct {
+  gt_vector* pending;  /* (gt_sam_pending_end) */
+  uint64_t* slots;     // Positions into @pending
+  uint64_t num_slots;  // Power of two
+  uint64_t num_used;
+} gt_isp_pending_table;
+
+GT_INLINE uint64_t gt_isp_pending_hash(
+    const uint64_t end_position,gt_string* const seq_name,const uint64_t position) {
+  const uint64_t length = gt_string_get_length(seq_name);
+  const char* const name = gt_string_get_string(seq_name);
+  uint64_t i, hash = 14695981039346656037ull ^ end_position;
+  for (i=0;i<length;++i) hash = (hash ^ (uint8_t)name[i]) * 1099511628211ull;
+  hash = (hash ^ position) * 0x9E3779B97F4A7C15ull;
+  return hash ^ (hash >> 29);
+}
+GT_INLINE void gt_isp_pending_table_init(gt_isp_pending_table* const table) {
+  table->pending = gt_vector_new(GT_ISP_NUM_INITIAL_MAPS,sizeof(gt_sam_pending_end));
+  table->num_slots = GT_ISP_PENDING_TABLE_INITIAL_SLOTS;
+  table->num_used = 0;
+  table->slots = gt_malloc(table->num_slots*sizeof(uint64_t));
+  memset(table->slots,0xFF,table->num_slots*sizeof(uint64_t));
+}
+GT_INLINE void gt_isp_pending_table_destroy(gt_isp_pending_table* const table) {
+  gt_vector_delete(table->pending);
+  gt_free(table->slots);
+}
+GT_INLINE void gt_isp_pending_table_place(gt_isp_pending_table* const table,const uint64_t pending_pos) {
+  gt_sam_pending_end* const pending = gt_vector_get_elm(table->pending,pending_pos,gt_sam_pending_end);
+  const uint64_t mask = table->num_slots-1;
+  uint64_t slot = gt_isp_pending_hash(pending->end_position,&pending->next_seq_name,pending->next_position) & mask;
+  while (table->slots[slot]!=GT_ISP_PENDING_TABLE_EMPTY) slot = (slot+1) & mask;
+  table->slots[slot] = pending_pos;
+  ++table->num_used;
+}
+GT_INLINE void gt_isp_pending_table_grow(gt_isp_pending_table* const table) {
+  // Rebuild with unsolved records only (re-placed in insertion order)
+  gt_free(table->slots);
+  table->num_slots *= 2;
+  table->num_used = 0;
+  table->slots = gt_malloc(table->num_slots*sizeof(uint64_t));
+  memset(table->slots,0xFF,table->num_slots*sizeof(uint64_t));
+  const uint64_t num_pending = gt_vector_get_used(table->pending);
+  uint64_t i;
+  for (i=0;i<num_pending;++i) {
+    gt_sam_pending_end* const pending = gt_vector_get_elm(table->pending,i,gt_sam_pending_end);
+    if (!gt_string_is_null(&pending->next_seq_name)) gt_isp_pending_table_place(table,i);
+  }
+}
+
 GT_INLINE void gt_isp_solve_pending_maps(
-    gt_vector* pending_v,gt_sam_pending_end* pending,gt_template* const template) {
-  bool found_match = false;
-  // Look into pending records
-  GT_VECTOR_ITERATE(pending_v,pending_elm,pending_counter,gt_sam_pending_end) {
-    if (gt_string_is_null(&pending_elm->next_seq_name)) continue;
-    if ((found_match=gt_isp_check_pending_record__add_mmap(
+    gt_isp_pending_table* const table,gt_sam_pending_end* pending,gt_template* const template) {
+  // Probe the records expecting this one as their mate (other segment, RNEXT/PNEXT pointing here)
+  const uint64_t mask = table->num_slots-1;
+  uint64_t slot = gt_isp_pending_hash(
+      (pending->end_position+1)%2,&pending->map_seq_name,pending->map_position) & mask;
+  while (table->slots[slot]!=GT_ISP_PENDING_TABLE_EMPTY) {
+    gt_sam_pending_end* const pending_elm = gt_vector_get_elm(table->pending,table->slots[slot],gt_sam_pending_end);
+    if (!gt_string_is_null(&pending_elm->next_seq_name) &&
+        gt_isp_check_pending_record__add_mmap(
             template,pending_elm,pending->end_position,&pending->map_seq_name,
-            pending->map_position,pending->map_displacement,pending->num_maps))) {
+            pending->map_position,pending->map_displacement,pending->num_maps)) {
       gt_string_clear(&pending_elm->next_seq_name); // Mark as solved
-      break;
+      return;
     }
+    slot = (slot+1) & mask;
   }
   // Queue if not found
-  if (!found_match) gt_vector_insert(pending_v,*pending,gt_sam_pending_end);
+  gt_vector_insert(table->pending,*pending,gt_sam_pending_end);
+  if (gt_expect_false(2*(table->num_used+1) > table->num_slots)) {
+    gt_isp_pending_table_grow(table);
+  } else {
+    gt_isp_pending_table_place(table,gt_vector_get_used(table->pending)-1);
+  }
 }
 
 GT_INLINE gt_status gt_isp_solve_remaining_maps(gt_vector* const pending_v,gt_template* const template) {
@@ -800,23 +873,25 @@ GT_INLINE gt_status gt_input_sam_parser_parse_template(
   if ((error_code=gt_isp_read_tag(text_line,text_line,template->tag))) return error_code;
   gt_input_parse_tag_chomp_pairend_info(template->tag);
   // Read all maps related to this TAG
-  gt_vector* pending_v = gt_vector_new(GT_ISP_NUM_INITIAL_MAPS,sizeof(gt_sam_pending_end));
+  gt_isp_pending_table pending_table;
+  gt_isp_pending_table_init(&pending_table);
   do {
     // Parse SAM Alignment
     gt_sam_pending_end pending = GT_SAM_INIT_PENDING;
     uint64_t alignment_flag;
     if (gt_expect_false(error_code=gt_isp_parse_sam_alignment(
-          text_line,template,NULL,&alignment_flag,&pending,false))) {
-      gt_vector_delete(pending_v);
+          text_line,template,NULL,&alignment_flag,&pending,false,
+          gt_buffered_input_file_get_mm_pool(buffered_sam_input)))) {
+      gt_isp_pending_table_destroy(&pending_table);
       gt_isp_skip_remaining_records(buffered_sam_input,template->tag);
       return error_code;
     }
     // Solve pending ends
-    if (!gt_string_is_null(&pending.next_seq_name)) gt_isp_solve_pending_maps(pending_v,&pending,template);
+    if (!gt_string_is_null(&pending.next_seq_name)) gt_isp_solve_pending_maps(&pending_table,&pending,template);
   } while (gt_isp_fetch_next_line(buffered_sam_input,template->tag,true));
   // Check for unsolved pending maps (try to solve them)
-  error_code = gt_isp_solve_remaining_maps(pending_v,template);
-  gt_vector_delete(pending_v);
+  error_code = gt_isp_solve_remaining_maps(pending_table.pending,template);
+  gt_isp_pending_table_destroy(&pending_table);
   if (error_code) gt_isp_skip_remaining_records(buffered_sam_input,template->tag);
   // Setup alignment's tag info
   gt_template_setup_pair_attributes_to_alignments(template,true);
@@ -838,7 +913,8 @@ GT_INLINE gt_status gt_input_sam_parser_parse_soap_template(
     gt_sam_pending_end pending = GT_SAM_INIT_PENDING;
     uint64_t alignment_flag;
     if (gt_expect_false(error_code=gt_isp_parse_sam_alignment(
-          text_line,template,NULL,&alignment_flag,&pending,false))) {
+          text_line,template,NULL,&alignment_flag,&pending,false,
+          gt_buffered_input_file_get_mm_pool(buffered_sam_input)))) {
       gt_isp_skip_remaining_records(buffered_sam_input,template->tag);
       return error_code;
     }
@@ -875,7 +951,8 @@ GT_INLINE gt_status gt_input_sam_parser_parse_alignment(
     gt_sam_pending_end pending = GT_SAM_INIT_PENDING;
     uint64_t alignment_flag;
     if (gt_expect_false((error_code=gt_isp_parse_sam_alignment(
-        text_line,NULL,alignment,&alignment_flag,&pending,true))!=0)) {
+        text_line,NULL,alignment,&alignment_flag,&pending,true,
+        gt_buffered_input_file_get_mm_pool(buffered_sam_input)))!=0)) {
       return error_code;
     }
   } while (gt_isp_fetch_next_line(buffered_sam_input,alignment->tag,false));
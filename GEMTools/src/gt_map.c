@@ -25,6 +25,21 @@ GT_INLINE gt_map* gt_map_new() {
   map->mismatches = gt_vector_new(GT_MAP_NUM_INITIAL_MISMS,sizeof(gt_misms));
   map->next_block.map = NULL;
   map->attributes = NULL;
+  map->mm_pool = NULL;
+  return map;
+}
+GT_INLINE gt_map* gt_map_new_from_pool(gt_mm_pool* const mm_pool) {
+  if (mm_pool==NULL) return gt_map_new();
+  gt_map* map = gt_mm_pool_malloc(mm_pool,sizeof(gt_map));
+  map->seq_name = gt_string_new_from_pool(mm_pool,GT_MAP_INITIAL_SEQ_NAME_SIZE);
+  map->position = 0;
+  map->base_length = 0;
+  map->gt_score = GT_MAP_NO_GT_SCORE;
+  map->phred_score = GT_MAP_NO_PHRED_SCORE;
+  map->mismatches = gt_vector_new_from_pool(mm_pool,GT_MAP_NUM_INITIAL_MISMS,sizeof(gt_misms));
+  map->next_block.map = NULL;
+  map->attributes = NULL;
+  map->mm_pool = mm_pool;
   return map;
 }
 GT_INLINE void gt_map_clear(gt_map* const map) {
@@ -43,7 +58,11 @@ GT_INLINE void gt_map_block_delete(gt_map* const map) {
   gt_string_delete(map->seq_name);
   gt_vector_delete(map->mismatches);
   if (map->attributes!=NULL) gt_attributes_delete(map->attributes);
-  gt_free(map);
+  if (map->mm_pool!=NULL) {
+    gt_mm_pool_free(map);
+  } else {
+    gt_free(map);
+  }
 }
 GT_INLINE void gt_map_delete(gt_map* const map) {
   GT_MAP_CHECK(map);
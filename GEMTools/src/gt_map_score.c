@@ -27,3 +27,129 @@ GT_INLINE void gt_map_set_phred_score(gt_map* const map,const uint8_t phred_scor
   GT_MAP_CHECK(map);
   map->phred_score = phred_score;
 }
+
+/*
+ * fx(TEMPLATE) Scoring functions
+ */
+#define GT_MAP_SCORE_PHRED_KONST -0.23025850929940456840 // -log(10)/10;
+#define GT_MAP_SCORE_NO_FIRST_SCORE UINT64_MAX
+#define GT_MAP_SCORE_MAPQ_INITIAL_ENTRIES 16
+
+GT_INLINE gt_map_score_mapq_scratch* gt_map_score_mapq_scratch_new() {
+  gt_map_score_mapq_scratch* const scratch = gt_alloc(gt_map_score_mapq_scratch);
+  uint64_t i;
+  for (i=0;i<3;++i) scratch->entries[i] = gt_vector_new(GT_MAP_SCORE_MAPQ_INITIAL_ENTRIES,sizeof(gt_map_score_mapq_entry));
+  scratch->first_scores = gt_vector_new(GT_MAP_SCORE_MAPQ_INITIAL_ENTRIES,sizeof(uint64_t));
+  for (i=0;i<GT_MAP_SCORE_EXP_TABLE_SIZE;++i) scratch->exp_table[i] = exp(GT_MAP_SCORE_PHRED_KONST*(double)i);
+  return scratch;
+}
+GT_INLINE void gt_map_score_mapq_scratch_delete(gt_map_score_mapq_scratch* const scratch) {
+  GT_NULL_CHECK(scratch);
+  uint64_t i;
+  for (i=0;i<3;++i) gt_vector_delete(scratch->entries[i]);
+  gt_vector_delete(scratch->first_scores);
+  gt_free(scratch);
+}
+GT_INLINE void gt_map_score_mapq_add_entry(
+    gt_vector* const entries,gt_map* const map_end1,gt_map* const map_end2,
+    const uint64_t score,uint8_t* const phred_score) {
+  gt_vector_reserve_additional(entries,1);
+  gt_map_score_mapq_entry* const entry = gt_vector_get_free_elm(entries,gt_map_score_mapq_entry);
+  entry->seq_name[0] = map_end1->seq_name;
+  entry->position[0] = map_end1->position;
+  entry->seq_name[1] = (map_end2!=NULL) ? map_end2->seq_name : NULL;
+  entry->position[1] = (map_end2!=NULL) ? map_end2->position : 0;
+  entry->score = score;
+  entry->order = gt_vector_get_used(entries);
+  entry->phred_score = phred_score;
+  gt_vector_inc_used(entries);
+}
+GT_INLINE int gt_map_score_mapq_cmp_seq_name(gt_string* const seq_name_a,gt_string* const seq_name_b) {
+  if (seq_name_a==seq_name_b) return 0;
+  if (seq_name_a==NULL) return -1;
+  if (seq_name_b==NULL) return 1;
+  const uint64_t length_a = gt_string_get_length(seq_name_a);
+  const uint64_t length_b = gt_string_get_length(seq_name_b);
+  if (length_a!=length_b) return (length_a<length_b) ? -1 : 1;
+  return memcmp(gt_string_get_string(seq_name_a),gt_string_get_string(seq_name_b),length_a);
+}
+GT_INLINE int gt_map_score_mapq_cmp_location(
+    const gt_map_score_mapq_entry* const entry_a,const gt_map_score_mapq_entry* const entry_b) {
+  int cmp;
+  if (entry_a->position[0]!=entry_b->position[0]) return (entry_a->position[0]<entry_b->position[0]) ? -1 : 1;
+  if (entry_a->position[1]!=entry_b->position[1]) return (entry_a->position[1]<entry_b->position[1]) ? -1 : 1;
+  if ((cmp=gt_map_score_mapq_cmp_seq_name(entry_a->seq_name[0],entry_b->seq_name[0]))) return cmp;
+  return gt_map_score_mapq_cmp_seq_name(entry_a->seq_name[1],entry_b->seq_name[1]);
+}
+int gt_map_score_mapq_cmp_entry(const void* const a,const void* const b) {
+  const gt_map_score_mapq_entry* const entry_a = a;
+  const gt_map_score_mapq_entry* const entry_b = b;
+  const int cmp = gt_map_score_mapq_cmp_location(entry_a,entry_b);
+  if (cmp) return cmp;
+  return (entry_a->order<entry_b->order) ? -1 : (entry_a->order>entry_b->order);
+}
+GT_INLINE double gt_map_score_mapq_likelihood(gt_map_score_mapq_scratch* const scratch,const uint64_t score_diff) {
+  return (score_diff<GT_MAP_SCORE_EXP_TABLE_SIZE) ?
+      scratch->exp_table[score_diff] : exp(GT_MAP_SCORE_PHRED_KONST*(double)score_diff);
+}
+GT_INLINE void gt_map_score_mapq_solve(gt_map_score_mapq_scratch* const scratch,gt_vector* const entries) {
+  const uint64_t num_entries = gt_vector_get_used(entries);
+  if (num_entries==0) return;
+  gt_map_score_mapq_entry* const entry = gt_vector_get_mem(entries,gt_map_score_mapq_entry);
+  // Group equal locations (the first appearance of each location leads its group)
+  qsort(entry,num_entries,sizeof(gt_map_score_mapq_entry),gt_map_score_mapq_cmp_entry);
+  gt_vector_reserve(scratch->first_scores,num_entries,false);
+  uint64_t* const first_scores = gt_vector_get_mem(scratch->first_scores,uint64_t);
+  uint64_t i, min_score = 0xffff;
+  for (i=0;i<num_entries;++i) first_scores[i] = GT_MAP_SCORE_NO_FIRST_SCORE;
+  for (i=0;i<num_entries;++i) {
+    if (i>0 && gt_map_score_mapq_cmp_location(entry+(i-1),entry+i)==0) continue;
+    first_scores[entry[i].order] = entry[i].score;
+    if (entry[i].score<min_score) min_score = entry[i].score;
+  }
+  // Normalizing constant (accumulated in order of first appearance)
+  double z = 0.0;
+  for (i=0;i<num_entries;++i) {
+    if (first_scores[i]!=GT_MAP_SCORE_NO_FIRST_SCORE) {
+      z += gt_map_score_mapq_likelihood(scratch,first_scores[i]-min_score);
+    }
+  }
+  // Phred-scale the posterior of each location
+  uint8_t phred = 0;
+  for (i=0;i<num_entries;++i) {
+    if (i==0 || gt_map_score_mapq_cmp_location(entry+(i-1),entry+i)!=0) {
+      const double prob = gt_map_score_mapq_likelihood(scratch,entry[i].score-min_score)/z;
+      if (1.0-prob<1.0e-255) {
+        phred = GT_MAP_SCORE_MAPQ_MAX;
+      } else {
+        const int tp = (int)(0.5+log(1.0-prob)/GT_MAP_SCORE_PHRED_KONST);
+        phred = (tp>GT_MAP_SCORE_MAPQ_MAX) ? GT_MAP_SCORE_MAPQ_MAX : tp;
+      }
+    }
+    *(entry[i].phred_score) = phred;
+  }
+}
+GT_INLINE void gt_map_score_template_mapq(gt_template* const template,gt_map_score_mapq_scratch* const scratch) {
+  GT_TEMPLATE_CHECK(template);
+  GT_NULL_CHECK(scratch);
+  uint64_t i;
+  for (i=0;i<3;++i) gt_vector_clear(scratch->entries[i]);
+  // Gather single-end and paired locations with their likelihoods
+  GT_TEMPLATE_ITERATE_MMAP__ATTR_(template,maps,maps_attr) {
+    if (!maps_attr) gt_fatal_error(TEMPLATE_NOT_SCORED);
+    const uint64_t score = maps_attr->gt_score;
+    if (score==GT_MAP_NO_GT_SCORE) gt_fatal_error(TEMPLATE_NOT_SCORED);
+    const uint64_t seq_like[2] = { score&0xffff, (score>>16)&0xffff };
+    const uint64_t interval_like = (score>>32)&0xff;
+    uint64_t rd;
+    for (rd=0;rd<2;++rd) {
+      if (maps[rd]) gt_map_score_mapq_add_entry(scratch->entries[rd],maps[rd],NULL,seq_like[rd],&maps[rd]->phred_score);
+    }
+    if (maps[0] && maps[1]) {
+      gt_map_score_mapq_add_entry(scratch->entries[2],maps[0],maps[1],
+          seq_like[0]+seq_like[1]+interval_like,&maps_attr->phred_score);
+    }
+  }
+  // Calculate the single and paired end MAPQ values
+  for (i=0;i<3;++i) gt_map_score_mapq_solve(scratch,scratch->entries[i]);
+}
@@ -15,9 +15,8 @@
  *         Objects of a certain type are ready to go inside the slab, thus reducing
  *         the overhead of malloc/setup/free cycles along the program
  *     - PoolMemory
- *         Pool of Slabs as gather all slabs needed along a program
- *         The goal is to minimize all memory malloc/setup/free overhead
- *         Offers thread safe allocation of slabs as to balance memory consumption across threads
+ *         Per-thread pool of size-classed slabs. The goal is to minimize all memory malloc/setup/free
+ *         overhead (and malloc arena contention) along a program. Memory can be freed from any thread
  */
 
 // TODO TODO TODO TODO TODO TODO TODO TODO TODO TODO TODO TODO TODO TODO TODO TODO TODO TODO
@@ -27,6 +26,8 @@
 // TODO TODO TODO TODO TODO TODO TODO TODO TODO TODO TODO TODO TODO TODO TODO TODO TODO TODO
 
 #include "gt_mm.h"
+#include "gt_profiler.h"
+#include <sys/syscall.h>
 
 // In some environments MAP_HUGETLB can be undefined
 #ifndef MAP_HUGETLB
@@ -41,6 +42,11 @@
   #define MAP_POPULATE 0 // TODO: disable for mac compatibility
 #endif
 
+// NUMA memory policies (as in <numaif.h>, which may not be installed)
+#define GT_MM_MPOL_PREFERRED  1
+#define GT_MM_MPOL_INTERLEAVE 3
+#define GT_MM_HUGE_PAGE_SIZE (2*1024*1024)
+
 /*
  * Memory Alignment Utils
  */
@@ -80,6 +86,77 @@ GT_INLINE void gt_mm_set_tmp_folder(char* const tmp_folder_path) {
   gt_mm_temp_folder_path = tmp_folder_path;
 }
 
+/*
+ * Memory policy for bulk buffers
+ */
+int64_t gt_mm_policy = -1; // Not set (read from GT_MM_POLICY on first use)
+
+GT_INLINE uint64_t gt_mm_parse_policy(const char* const policy_string) {
+  GT_NULL_CHECK(policy_string);
+  uint64_t policy = GT_MM_POLICY_DEFAULT;
+  const char* token = policy_string;
+  while (*token!=EOS) {
+    const char* const token_end = strchrnul(token,COMA);
+    const int length = token_end-token;
+    if (length==7 && strncmp(token,"default",7)==0) {
+      policy = GT_MM_POLICY_DEFAULT;
+    } else if (length==3 && strncmp(token,"thp",3)==0) {
+      policy |= GT_MM_POLICY_THP;
+    } else if (length==7 && strncmp(token,"hugetlb",7)==0) {
+      policy |= GT_MM_POLICY_HUGETLB;
+    } else if (length==4 && strncmp(token,"numa",4)==0) {
+      policy |= GT_MM_POLICY_NUMA;
+    } else if (length>0) {
+      gt_warn(MEM_POLICY_UNKNOWN,length,token);
+    }
+    token = (*token_end==COMA) ? token_end+1 : token_end;
+  }
+  return policy;
+}
+GT_INLINE uint64_t gt_mm_get_policy() {
+  if (gt_expect_false(gt_mm_policy<0)) {
+    const char* const policy_string = getenv(GT_MM_POLICY_ENV);
+    gt_mm_policy = (policy_string!=NULL) ? gt_mm_parse_policy(policy_string) : GT_MM_POLICY_DEFAULT;
+  }
+  return gt_mm_policy;
+}
+GT_INLINE void gt_mm_set_policy(const uint64_t policy) {
+  gt_mm_policy = policy;
+}
+/*
+ * Applies the memory policy to a freshly allocated buffer (all hints are advisory)
+ *   - THP: Back the buffer with transparent hugepages
+ *   - NUMA: Thread buffers prefer the node of the calling thread, shared ones are interleaved.
+ *       Then the calling thread touches every page, so the policy takes effect right away
+ */
+GT_INLINE void gt_mm_advise_bulk_buffer(void* const memory,const uint64_t num_bytes,const bool thread_buffer) {
+  const uint64_t policy = gt_mm_get_policy();
+  if (policy==GT_MM_POLICY_DEFAULT || memory==NULL) return;
+  // Whole pages of the buffer
+  const uintptr_t page_size = sysconf(_SC_PAGESIZE);
+  const uintptr_t begin = (GT_MM_CAST_ADDR(memory)+page_size-1) & ~(page_size-1);
+  const uintptr_t end = (GT_MM_CAST_ADDR(memory)+num_bytes) & ~(page_size-1);
+  if (begin>=end) return;
+#ifdef MADV_HUGEPAGE
+  if (policy & GT_MM_POLICY_THP) madvise((void*)begin,end-begin,MADV_HUGEPAGE);
+#endif
+#if defined(SYS_mbind) && defined(SYS_getcpu)
+  if (policy & GT_MM_POLICY_NUMA) {
+    unsigned long node_mask = UINT64_ONES;
+    int mode = GT_MM_MPOL_INTERLEAVE;
+    unsigned int cpu, node;
+    if (thread_buffer && syscall(SYS_getcpu,&cpu,&node,NULL)==0 && node<64) {
+      node_mask = 1ul<<node;
+      mode = GT_MM_MPOL_PREFERRED;
+    }
+    syscall(SYS_mbind,(void*)begin,end-begin,mode,&node_mask,65,0);
+    // First-touch
+    uintptr_t page;
+    for (page=begin;page<end;page+=page_size) *((volatile char*)page) = 0;
+  }
+#endif
+}
+
 /*
  * UnitMemory
  *   Allocate relative small chunks of memory relying on the regular memory manager,
@@ -120,6 +197,7 @@ GT_INLINE gt_mm* gt_mm_bulk_malloc(const uint64_t num_bytes,const bool init_mem)
   GT_ZERO_CHECK(num_bytes);
   void* memory = gt_malloc_nothrow(num_bytes,1,init_mem,0);
   if (gt_expect_true(memory!=NULL)) { // Fits in HEAP
+    gt_mm_advise_bulk_buffer(memory,num_bytes,false);
     gt_mm* const mm = gt_alloc(gt_mm);
     mm->memory = memory;
     mm->mem_type = GT_MM_HEAP;
@@ -149,10 +227,20 @@ GT_INLINE gt_mm* gt_mm_bulk_mmalloc(const uint64_t num_bytes,const bool use_huge
    *       to consume all the free RAM and swap on the system, eventually
    *       triggering the OOM killer (Linux) or causing a SIGSEGV.
    */
-  int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE;
-  if (use_huge_pages) flags |= MAP_HUGETLB;
-  mm->memory = mmap(0,num_bytes,PROT_READ|PROT_WRITE,flags,-1,0);
-  gt_cond_fatal_error__perror(mm->memory==MAP_FAILED,MEM_ALLOC_MMAP_FAIL,num_bytes);
+  const int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE;
+  mm->memory = MAP_FAILED;
+  if (MAP_HUGETLB!=0 && (use_huge_pages || (gt_mm_get_policy() & GT_MM_POLICY_HUGETLB))) {
+    // Explicit hugepages (the mapping must span whole hugepages). Might fail if none are reserved.
+    // Reserved upfront (no MAP_NORESERVE), otherwise a short hugepage pool raises SIGBUS on first touch
+    mm->mapped = (num_bytes+(GT_MM_HUGE_PAGE_SIZE-1)) & ~((uint64_t)GT_MM_HUGE_PAGE_SIZE-1);
+    mm->memory = mmap(0,mm->mapped,PROT_READ|PROT_WRITE,(flags&~MAP_NORESERVE)|MAP_HUGETLB,-1,0);
+  }
+  if (mm->memory==MAP_FAILED) {
+    mm->mapped = num_bytes;
+    mm->memory = mmap(0,num_bytes,PROT_READ|PROT_WRITE,flags,-1,0);
+    gt_cond_fatal_error__perror(mm->memory==MAP_FAILED,MEM_ALLOC_MMAP_FAIL,num_bytes);
+  }
+  gt_mm_advise_bulk_buffer(mm->memory,num_bytes,false);
   mm->cursor = mm->memory;
   // Set MM
   mm->mem_type = GT_MM_MMAPPED;
@@ -192,6 +280,7 @@ GT_INLINE gt_mm* gt_mm_bulk_mmap_file(char* const file_name,const gt_mm_mode mod
   mm->mem_type = GT_MM_MMAPPED;
   mm->mode = mode;
   mm->allocated = stat_info.st_size;
+  mm->mapped = stat_info.st_size;
   mm->file_name = gt_strndup(file_name,gt_strlen(file_name));
   // GT_MM_PRINT_MEM_ALIGMENT(mm->memory); // Debug
   return mm;
@@ -229,6 +318,7 @@ GT_INLINE gt_mm* gt_mm_bulk_mmalloc_temp(const uint64_t num_bytes) {
   mm->mem_type = GT_MM_MMAPPED;
   mm->mode = GT_MM_READ_WRITE;
   mm->allocated = num_bytes;
+  mm->mapped = num_bytes;
   // GT_MM_PRINT_MEM_ALIGMENT(mm->memory); // Debug
   return mm;
 }
@@ -260,7 +350,7 @@ GT_INLINE void gt_mm_free(gt_mm* const mm) {
   if (mm->mem_type==GT_MM_HEAP) { // Heap BulkMemory
     gt_free(mm->memory);
   } else { // MMapped BulkMemory
-    gt_cond_fatal_error__perror(munmap(mm->memory,mm->allocated)==-1,SYS_UNMAP);
+    gt_cond_fatal_error__perror(munmap(mm->memory,mm->mapped)==-1,SYS_UNMAP);
     if (mm->fd!=-1) {
       gt_cond_fatal_error__perror(close(mm->fd),SYS_HANDLE_TMP);
     }
@@ -546,7 +636,228 @@ GT_INLINE void gt_mm_write_mem(gt_mm* const mm,void* const src,const uint64_t nu
  *   Objects of a certain type are ready to go inside the slab, thus reducing
  *   the overhead of malloc/setup/free cycles along the program
  */
-//GT_INLINE void* gt_mm_slab_mmalloc(gt_mm_slab* const slab,const uint64_t num_elements); // TODO
-//GT_INLINE void gt_mm_slab_mfree(gt_mm_slab* const slab,void* mem_addr,const uint64_t num_elements); // TODO
+#define GT_MM_SLAB_ELEMENT_ALIGNMENT 16
+GT_INLINE void gt_mm_slab_add_unit(gt_mm_slab* const slab) {
+  char* const unit = gt_malloc(GT_MM_SLAB_UNIT_SIZE);
+  gt_vector_insert(slab->slabs_units,unit,void*);
+  // Chain all the elements of the unit into the free list
+  uint64_t i;
+  for (i=slab->elements_per_unit;i>0;--i) {
+    void** const element = (void**)(unit+(i-1)*slab->element_size);
+    *element = slab->free_elements;
+    slab->free_elements = element;
+  }
+}
+GT_INLINE void gt_mm_slab_setup(gt_mm_slab* const slab,const uint64_t element_size) {
+  GT_ZERO_CHECK(element_size);
+  slab->element_size = (element_size+(GT_MM_SLAB_ELEMENT_ALIGNMENT-1)) & ~((uint64_t)GT_MM_SLAB_ELEMENT_ALIGNMENT-1);
+  gt_cond_fatal_error(slab->element_size>GT_MM_SLAB_UNIT_SIZE,MEM_SLAB_ELEMENT_SIZE,element_size);
+  slab->elements_per_unit = GT_MM_SLAB_UNIT_SIZE/slab->element_size;
+}
+GT_INLINE gt_mm_slab* gt_mm_slab_new_(const uint64_t element_size,const uint64_t num_intial_slabs) {
+  gt_mm_slab* const slab = gt_alloc(gt_mm_slab);
+  gt_mm_slab_setup(slab,element_size);
+  slab->slabs_units = gt_vector_new(num_intial_slabs+1,sizeof(void*));
+  slab->free_elements = NULL;
+  slab->allocated_elements = 0;
+  uint64_t i;
+  for (i=0;i<num_intial_slabs;++i) gt_mm_slab_add_unit(slab);
+  return slab;
+}
+GT_INLINE void gt_mm_slab_cast(gt_mm_slab* const slab,const uint64_t element_size) {
+  GT_NULL_CHECK(slab);
+  gt_cond_fatal_error(slab->allocated_elements>0,MEM_SLAB_CAST_IN_USE);
+  // Re-chain all units using the new element size
+  gt_mm_slab_setup(slab,element_size);
+  slab->free_elements = NULL;
+  const uint64_t num_units = gt_vector_get_used(slab->slabs_units);
+  void** const units = gt_vector_get_mem(slab->slabs_units,void*);
+  uint64_t i, j;
+  for (i=num_units;i>0;--i) {
+    for (j=slab->elements_per_unit;j>0;--j) {
+      void** const element = (void**)((char*)units[i-1]+(j-1)*slab->element_size);
+      *element = slab->free_elements;
+      slab->free_elements = element;
+    }
+  }
+}
+GT_INLINE void gt_mm_slab_reap_empty(gt_mm_slab* const slab) {
+  GT_NULL_CHECK(slab);
+  // Units are released only when no element is in use
+  if (slab->allocated_elements>0) return;
+  GT_VECTOR_ITERATE(slab->slabs_units,unit,unit_pos,void*) {
+    gt_free(*unit);
+  }
+  gt_vector_clear(slab->slabs_units);
+  slab->free_elements = NULL;
+}
+GT_INLINE void gt_mm_slab_delete(gt_mm_slab* const slab) {
+  GT_NULL_CHECK(slab);
+  GT_VECTOR_ITERATE(slab->slabs_units,unit,unit_pos,void*) {
+    gt_free(*unit);
+  }
+  gt_vector_delete(slab->slabs_units);
+  gt_free(slab);
+}
+GT_INLINE void* gt_mm_slab_malloc(gt_mm_slab* const slab) {
+  GT_NULL_CHECK(slab);
+  if (gt_expect_false(slab->free_elements==NULL)) gt_mm_slab_add_unit(slab);
+  void** const element = slab->free_elements;
+  slab->free_elements = *element;
+  ++slab->allocated_elements;
+  return element;
+}
+GT_INLINE void gt_mm_slab_free(gt_mm_slab* const slab,void* mem_addr) {
+  GT_NULL_CHECK(slab); GT_NULL_CHECK(mem_addr);
+  *((void**)mem_addr) = slab->free_elements;
+  slab->free_elements = mem_addr;
+  --slab->allocated_elements;
+}
 
+/*
+ * PoolMemory
+ *   Per-thread pool of size-classed slabs (16B..4KB, powers of two)
+ *   Each element carries a header {pool,capacity} in front of the memory returned to the user,
+ *   so any thread can return it to its pool (or to malloc, if pool==NULL)
+ */
+typedef struct {
+  gt_mm_pool* pool;  /* Owner pool (NULL if allocated with malloc) */
+  uint64_t capacity; /* Usable bytes */
+} gt_mm_pool_header;
+#define GT_MM_POOL_HEADER(mem_addr) (((gt_mm_pool_header*)(mem_addr))-1)
+#define GT_MM_POOL_ORPHANED ((void*)1) /* Return list tag of a deleted pool */
 
+GT_INLINE uint64_t gt_mm_pool_get_size_class(const uint64_t num_bytes) {
+  if (num_bytes<=(1ull<<GT_MM_POOL_MIN_SIZE_CLASS_LOG2)) return 0;
+  return (64-__builtin_clzll(num_bytes-1))-GT_MM_POOL_MIN_SIZE_CLASS_LOG2;
+}
+GT_INLINE gt_mm_pool* gt_mm_pool_new() {
+  gt_mm_pool* const pool = gt_alloc(gt_mm_pool);
+  // Size-classed slabs (no unit is allocated until needed)
+  uint64_t i;
+  for (i=0;i<GT_MM_POOL_NUM_SIZE_CLASSES;++i) {
+    const uint64_t class_size = 1ull<<(i+GT_MM_POOL_MIN_SIZE_CLASS_LOG2);
+    pool->slabs[i] = gt_mm_slab_new_(sizeof(gt_mm_pool_header)+class_size,0);
+  }
+  pool->owner_thread = pthread_self();
+  pool->orphaned = false;
+  // Return path
+  pool->remote_free_list = NULL;
+  pool->orphaned_balance = 0;
+  // Stats
+  memset(&pool->stats,0,sizeof(gt_mm_pool_stats));
+  return pool;
+}
+GT_INLINE void gt_mm_pool_release(gt_mm_pool* const pool) {
+  uint64_t i;
+  for (i=0;i<GT_MM_POOL_NUM_SIZE_CLASSES;++i) gt_mm_slab_delete(pool->slabs[i]);
+  gt_free(pool);
+}
+GT_INLINE void gt_mm_pool_return_elements(gt_mm_pool* const pool,void* elements) {
+  while (elements!=NULL) {
+    void* const next = *((void**)elements);
+    gt_mm_pool_header* const header = GT_MM_POOL_HEADER(elements);
+    gt_mm_slab_free(pool->slabs[gt_mm_pool_get_size_class(header->capacity)],header);
+    elements = next;
+  }
+}
+GT_INLINE void gt_mm_pool_delete(gt_mm_pool* const pool) {
+  GT_NULL_CHECK(pool);
+  gt_mm_pool_profile(pool);
+  // Close the return path (later frees from other threads just account for the alive elements)
+  pool->orphaned = true;
+  gt_mm_pool_return_elements(pool,__atomic_exchange_n(&pool->remote_free_list,GT_MM_POOL_ORPHANED,__ATOMIC_ACQ_REL));
+  // Release now, or leave it to the last element alive
+  int64_t num_alive = 0;
+  uint64_t i;
+  for (i=0;i<GT_MM_POOL_NUM_SIZE_CLASSES;++i) num_alive += pool->slabs[i]->allocated_elements;
+  if (__atomic_add_fetch(&pool->orphaned_balance,num_alive,__ATOMIC_ACQ_REL)==0) gt_mm_pool_release(pool);
+}
+GT_INLINE void* gt_mm_pool_malloc(gt_mm_pool* const pool,const uint64_t num_bytes) {
+  gt_mm_pool_header* header;
+  if (gt_expect_true(pool!=NULL && num_bytes<=GT_MM_POOL_MAX_SIZE_CLASS &&
+      pthread_equal(pool->owner_thread,pthread_self()) && !pool->orphaned)) {
+    const uint64_t size_class = gt_mm_pool_get_size_class(num_bytes);
+    gt_mm_slab* const slab = pool->slabs[size_class];
+    // Recover the elements freed by other threads before growing the slab
+    if (slab->free_elements==NULL && pool->remote_free_list!=NULL) {
+      gt_mm_pool_return_elements(pool,__atomic_exchange_n(&pool->remote_free_list,NULL,__ATOMIC_ACQUIRE));
+    }
+    header = gt_mm_slab_malloc(slab);
+    header->pool = pool;
+    header->capacity = 1ull<<(size_class+GT_MM_POOL_MIN_SIZE_CLASS_LOG2);
+    ++pool->stats.num_allocs;
+  } else {
+    header = gt_malloc(sizeof(gt_mm_pool_header)+num_bytes);
+    header->pool = NULL;
+    header->capacity = num_bytes;
+    if (pool!=NULL) __atomic_add_fetch(&pool->stats.num_fallbacks,1,__ATOMIC_RELAXED);
+  }
+  return header+1;
+}
+GT_INLINE void gt_mm_pool_remote_free(gt_mm_pool* const pool,void* const mem_addr) {
+  __atomic_add_fetch(&pool->stats.num_remote_frees,1,__ATOMIC_RELAXED);
+  void* head = __atomic_load_n(&pool->remote_free_list,__ATOMIC_RELAXED);
+  while (true) {
+    if (gt_expect_false(head==GT_MM_POOL_ORPHANED)) {
+      // The pool was deleted. The last element alive releases it
+      if (__atomic_sub_fetch(&pool->orphaned_balance,1,__ATOMIC_ACQ_REL)==0) gt_mm_pool_release(pool);
+      return;
+    }
+    *((void**)mem_addr) = head;
+    if (__atomic_compare_exchange_n(&pool->remote_free_list,&head,mem_addr,
+        true,__ATOMIC_RELEASE,__ATOMIC_RELAXED)) return;
+    __atomic_add_fetch(&pool->stats.num_cas_retries,1,__ATOMIC_RELAXED);
+  }
+}
+GT_INLINE void gt_mm_pool_free(void* const mem_addr) {
+  if (mem_addr==NULL) return;
+  gt_mm_pool_header* const header = GT_MM_POOL_HEADER(mem_addr);
+  gt_mm_pool* const pool = header->pool;
+  if (pool==NULL) {
+    gt_free(header);
+  } else if (pthread_equal(pool->owner_thread,pthread_self()) && !pool->orphaned) {
+    gt_mm_slab_free(pool->slabs[gt_mm_pool_get_size_class(header->capacity)],header);
+    ++pool->stats.num_frees;
+  } else {
+    gt_mm_pool_remote_free(pool,mem_addr);
+  }
+}
+GT_INLINE void* gt_mm_pool_realloc(void* const mem_addr,const uint64_t num_bytes) {
+  GT_NULL_CHECK(mem_addr);
+  gt_mm_pool_header* const header = GT_MM_POOL_HEADER(mem_addr);
+  if (header->capacity>=num_bytes) return mem_addr;
+  if (header->pool==NULL) {
+    gt_mm_pool_header* const new_header = realloc(header,sizeof(gt_mm_pool_header)+num_bytes);
+    gt_cond_fatal_error(!new_header,MEM_REALLOC);
+    new_header->capacity = num_bytes;
+    return new_header+1;
+  } else {
+    void* const new_mem_addr = gt_mm_pool_malloc(header->pool,num_bytes);
+    memcpy(new_mem_addr,mem_addr,header->capacity);
+    gt_mm_pool_free(mem_addr);
+    return new_mem_addr;
+  }
+}
+GT_INLINE uint64_t gt_mm_pool_get_capacity(void* const mem_addr) {
+  GT_NULL_CHECK(mem_addr);
+  return GT_MM_POOL_HEADER(mem_addr)->capacity;
+}
+GT_INLINE gt_mm_pool_stats* gt_mm_pool_get_stats(gt_mm_pool* const pool) {
+  GT_NULL_CHECK(pool);
+  return &pool->stats;
+}
+GT_INLINE void gt_mm_pool_profile(gt_mm_pool* const pool) {
+  GT_NULL_CHECK(pool);
+#ifndef GT_NOPROFILE
+  if (gt_prof_counter==NULL) return; // Profiler not initialized
+  uint64_t num_units = 0, i;
+  for (i=0;i<GT_MM_POOL_NUM_SIZE_CLASSES;++i) num_units += gt_vector_get_used(pool->slabs[i]->slabs_units);
+  __atomic_add_fetch(&GT_GET_COUNTER(GT_EC_MM_POOL_ALLOCS),pool->stats.num_allocs,__ATOMIC_RELAXED);
+  __atomic_add_fetch(&GT_GET_COUNTER(GT_EC_MM_POOL_FREES),pool->stats.num_frees,__ATOMIC_RELAXED);
+  __atomic_add_fetch(&GT_GET_COUNTER(GT_EC_MM_POOL_REMOTE_FREES),pool->stats.num_remote_frees,__ATOMIC_RELAXED);
+  __atomic_add_fetch(&GT_GET_COUNTER(GT_EC_MM_POOL_CAS_RETRIES),pool->stats.num_cas_retries,__ATOMIC_RELAXED);
+  __atomic_add_fetch(&GT_GET_COUNTER(GT_EC_MM_POOL_FALLBACKS),pool->stats.num_fallbacks,__ATOMIC_RELAXED);
+  __atomic_add_fetch(&GT_GET_COUNTER(GT_EC_MM_POOL_SLAB_UNITS),num_units,__ATOMIC_RELAXED);
+#endif
+}
@@ -16,6 +16,7 @@
 GT_INLINE gt_output_buffer* gt_output_buffer_new(void) {
   gt_output_buffer* output_buffer = gt_alloc(gt_output_buffer);
   output_buffer->buffer=gt_vector_new(GT_OUTPUT_BUFFER_INITIAL_SIZE,sizeof(char));
+  gt_mm_advise_bulk_buffer(gt_vector_get_mem(output_buffer->buffer,char),GT_OUTPUT_BUFFER_INITIAL_SIZE,false);
   gt_output_buffer_initiallize(output_buffer,GT_OUTPUT_BUFFER_FREE);
   return output_buffer;
 }
@@ -132,3 +133,11 @@ GT_INLINE gt_status gt_bprintf_(
   va_end(v_args);
   return chars_printed;
 }
+GT_INLINE gt_status gt_bwrite(gt_output_buffer* const output_buffer,const char* const data,const uint64_t length) {
+  GT_OUTPUT_BUFFER_CHECK(output_buffer);
+  GT_NULL_CHECK(data);
+  gt_vector_reserve_additional(output_buffer->buffer,length);
+  memcpy(gt_vector_get_free_elm(output_buffer->buffer,char),data,length);
+  gt_vector_add_used(output_buffer->buffer,length);
+  return length;
+}
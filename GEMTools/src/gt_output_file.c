@@ -13,6 +13,12 @@
 #include <bzlib.h>
 #endif
 #include "gt_output_file.h"
+#include <sys/uio.h>
+#include <limits.h>
+
+#ifndef IOV_MAX
+  #define IOV_MAX 1024
+#endif
 
 /*
  * Setup
@@ -34,22 +40,52 @@ GT_INLINE void gt_output_file_init_buffers(gt_output_file* const output_file) {
   gt_cond_fatal_error(pthread_mutex_init(&output_file->out_file_mutex, NULL),SYS_MUTEX_INIT);
 }
 
+/*
+ * Raw output (bypassing stdio)
+ */
+GT_INLINE void gt_output_file_writev(gt_output_file* const output_file,struct iovec* iov,int iovcnt) {
+  // Anything printed through stdio (e.g. headers) goes first
+  gt_cond_fatal_error(fflush(output_file->file),OUTPUT_FILE_FAIL_WRITE);
+  const int fildes = fileno(output_file->file);
+  while (iovcnt>0) {
+    const ssize_t bytes_written = writev(fildes,iov,GT_MIN(iovcnt,IOV_MAX));
+    if (bytes_written<0) {
+      gt_cond_fatal_error(errno!=EINTR,OUTPUT_FILE_FAIL_WRITE);
+      continue;
+    }
+    // Skip the vectors fully written (and advance within the partial one)
+    size_t remaining = bytes_written;
+    while (iovcnt>0 && remaining>=iov->iov_len) {
+      remaining -= iov->iov_len;
+      ++iov; --iovcnt;
+    }
+    if (iovcnt>0) {
+      iov->iov_base = (char*)iov->iov_base+remaining;
+      iov->iov_len -= remaining;
+    }
+  }
+}
+GT_INLINE ssize_t gt_output_file_pipe_read(gt_output_file* const output_file,u_int8_t* const buffer) {
+  ssize_t n;
+  do {
+    n = read(output_file->pipe_fd[0],buffer,GT_OUTPUT_COMPRESS_BUFFER_SIZE);
+  } while (n<0 && errno==EINTR);
+  return n;
+}
+
 #ifdef HAVE_ZLIB
 static void* gt_output_file_pipe_gzip(void *s)
 {
-	u_int8_t *buffer[GT_OUTPUT_COMPRESS_BUFFER_SIZE];
+	u_int8_t buffer[GT_OUTPUT_COMPRESS_BUFFER_SIZE];
 	gt_output_file* output_file=s;
-	FILE *in;
-  gt_cond_fatal_error(!(in=fdopen(output_file->pipe_fd[0],"r")),FILE_FDOPEN);
-  while(!feof(in)) {
-  	size_t n=fread(buffer,1,GT_OUTPUT_COMPRESS_BUFFER_SIZE,in);
-  	if(!n) break;
+	ssize_t n;
+  while((n=gt_output_file_pipe_read(output_file,buffer))>0) {
   	size_t bytes_written=gzwrite(output_file->cfile,buffer,n);
     gt_cond_fatal_error(bytes_written!=n,OUTPUT_FILE_FAIL_WRITE);
   }
   int err=gzclose(output_file->cfile);
   gt_cond_error(err!=Z_OK,FILE_CLOSE,output_file->file_name);
-  fclose(in);
+  close(output_file->pipe_fd[0]);
 	return 0;
 }
 #endif
@@ -57,13 +93,10 @@ static void* gt_output_file_pipe_gzip(void *s)
 #ifdef HAVE_BZLIB
 static void* gt_output_file_pipe_bzip(void *s)
 {
-	u_int8_t *buffer[GT_OUTPUT_COMPRESS_BUFFER_SIZE];
+	u_int8_t buffer[GT_OUTPUT_COMPRESS_BUFFER_SIZE];
 	gt_output_file* output_file=s;
-	FILE *in;
-  gt_cond_fatal_error(!(in=fdopen(output_file->pipe_fd[0],"r")),FILE_FDOPEN);
-  while(!feof(in)) {
-  	size_t n=fread(buffer,1,GT_OUTPUT_COMPRESS_BUFFER_SIZE,in);
-  	if(!n) break;
+	ssize_t n;
+  while((n=gt_output_file_pipe_read(output_file,buffer))>0) {
   	int err;
   	BZ2_bzWrite(&err,output_file->cfile,buffer,n);
     gt_cond_fatal_error(err!=BZ_OK,OUTPUT_FILE_FAIL_WRITE);
@@ -71,7 +104,7 @@ static void* gt_output_file_pipe_bzip(void *s)
   int err;
   BZ2_bzWriteClose(&err,output_file->cfile,0,NULL,NULL);
   gt_cond_error(err!=BZ_OK,FILE_CLOSE,output_file->file_name);
-  fclose(in);
+  close(output_file->pipe_fd[0]);
 	return 0;
 }
 #endif
@@ -283,15 +316,13 @@ GT_INLINE gt_output_buffer* gt_output_file_write_buffer(
     gt_output_file* const output_file,gt_output_buffer* const output_buffer) {
   GT_OUTPUT_FILE_CONSISTENCY_CHECK(output_file);
   if (gt_output_buffer_get_used(output_buffer) > 0) {
-    int64_t bytes_written;
     gt_vector* const vbuffer = gt_output_buffer_to_vchar(output_buffer);
+    struct iovec iov = { .iov_base=gt_vector_get_mem(vbuffer,char), .iov_len=gt_vector_get_used(vbuffer) };
     GT_BEGIN_MUTEX_SECTION(output_file->out_file_mutex)
     {
-      bytes_written = fwrite(gt_vector_get_mem(vbuffer,char),1,
-          gt_vector_get_used(vbuffer),output_file->file);
+      gt_output_file_writev(output_file,&iov,1);
     }
     GT_END_MUTEX_SECTION(output_file->out_file_mutex);
-    gt_cond_fatal_error(bytes_written!=gt_vector_get_used(vbuffer),OUTPUT_FILE_FAIL_WRITE);
   }
   gt_output_buffer_initiallize(output_buffer,GT_OUTPUT_BUFFER_BUSY);
   return output_buffer;
@@ -324,45 +355,62 @@ GT_INLINE gt_output_buffer* gt_output_file_sorted_write_buffer_asynchronous(
     }
   }
   GT_END_MUTEX_SECTION(output_file->out_file_mutex);
-  // I'm the victim, I will output as much as I can
+  // I'm the victim, I will output as much as I can (all consecutive buffers ready, with a single writev)
+  gt_output_buffer* chain[GT_MAX_OUTPUT_BUFFERS];
+  struct iovec chain_iov[GT_MAX_OUTPUT_BUFFERS];
+  uint64_t chain_length = 1, i;
+  chain[0] = output_buffer;
   do {
-    // Write the current buffer
-    if (gt_output_buffer_get_used(output_buffer) > 0) {
-      gt_vector* const vbuffer = gt_output_buffer_to_vchar(output_buffer);
-      const int64_t bytes_written =
-          fwrite(gt_vector_get_mem(vbuffer,char),1,gt_vector_get_used(vbuffer),output_file->file);
-      gt_cond_fatal_error(bytes_written!=gt_vector_get_used(vbuffer),OUTPUT_FILE_FAIL_WRITE);
+    // Write the chain of buffers
+    int iovcnt = 0;
+    for (i=0;i<chain_length;++i) {
+      if (gt_output_buffer_get_used(chain[i]) > 0) {
+        gt_vector* const vbuffer = gt_output_buffer_to_vchar(chain[i]);
+        chain_iov[iovcnt].iov_base = gt_vector_get_mem(vbuffer,char);
+        chain_iov[iovcnt].iov_len = gt_vector_get_used(vbuffer);
+        ++iovcnt;
+      }
     }
+    if (iovcnt>0) gt_output_file_writev(output_file,chain_iov,iovcnt);
     // Update buffers' state
     GT_BEGIN_MUTEX_SECTION(output_file->out_file_mutex) {
       // Decrement write-pending blocks and update next block ID (mayorID,minorID)
-      --output_file->buffer_write_pending;
-      if (output_buffer->is_final_block) {
-        ++mayor_block_id;
-        minor_block_id = 0;
-      } else {
-        ++minor_block_id;
+      output_file->buffer_write_pending -= chain_length;
+      for (i=0;i<chain_length;++i) {
+        if (chain[i]->is_final_block) {
+          ++mayor_block_id;
+          minor_block_id = 0;
+        } else {
+          ++minor_block_id;
+        }
+        if (i+1<chain_length) __gt_buffered_output_file_release_buffer(output_file,chain[i]);
       }
-      // Search for the next block buffer in order
-      bool next_found = false;
-      if (output_file->buffer_write_pending>0) {
-        uint64_t i;
+      output_buffer = chain[chain_length-1];
+      // Collect the next block buffers in order
+      uint32_t next_mayor_block_id = mayor_block_id, next_minor_block_id = minor_block_id;
+      chain_length = 0;
+      while (chain_length<output_file->buffer_write_pending) {
+        gt_output_buffer* next_buffer = NULL;
         for (i=0;i<GT_MAX_OUTPUT_BUFFERS&&output_file->buffer[i]!=NULL;++i) {
-          if (mayor_block_id==gt_output_buffer_get_mayor_block_id(output_file->buffer[i]) &&
-              minor_block_id==gt_output_buffer_get_minor_block_id(output_file->buffer[i])) {
-            if (gt_output_buffer_get_state(output_file->buffer[i])!=GT_OUTPUT_BUFFER_WRITE_PENDING) {
-              break; // Cannot dump a busy buffer
-            } else {
-              // I'm still the victim, free the current buffer and output the new one
-              __gt_buffered_output_file_release_buffer(output_file,output_buffer);
-              next_found = true;
-              output_buffer = output_file->buffer[i];
-              break;
+          if (next_mayor_block_id==gt_output_buffer_get_mayor_block_id(output_file->buffer[i]) &&
+              next_minor_block_id==gt_output_buffer_get_minor_block_id(output_file->buffer[i])) {
+            // Cannot dump a busy buffer
+            if (gt_output_buffer_get_state(output_file->buffer[i])==GT_OUTPUT_BUFFER_WRITE_PENDING) {
+              next_buffer = output_file->buffer[i];
             }
+            break;
           }
         }
+        if (next_buffer==NULL) break;
+        chain[chain_length++] = next_buffer;
+        if (next_buffer->is_final_block) {
+          ++next_mayor_block_id;
+          next_minor_block_id = 0;
+        } else {
+          ++next_minor_block_id;
+        }
       }
-      if (!next_found) {
+      if (chain_length==0) {
         // Fine, I'm done, let's get out of here ASAP
         output_file->mayor_block_id = mayor_block_id;
         output_file->minor_block_id = minor_block_id;
@@ -371,6 +419,8 @@ GT_INLINE gt_output_buffer* gt_output_file_sorted_write_buffer_asynchronous(
         GT_END_MUTEX_SECTION(output_file->out_file_mutex);
         return output_buffer;
       }
+      // I'm still the victim, free the current buffer and output the new ones
+      __gt_buffered_output_file_release_buffer(output_file,output_buffer);
     } GT_END_MUTEX_SECTION(output_file->out_file_mutex);
   } while (true);
 }
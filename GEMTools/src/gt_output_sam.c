@@ -12,6 +12,12 @@
  * Constants
  */
 #define GT_OUTPUT_SAM_FORMAT_VERSION "1.4"
+#define GT_OUTPUT_SAM_READ_INITIAL_LENGTH 256
+#define GT_OUTPUT_SAM_ENCODING_BUFFER_INITIAL_LENGTH 1024
+#define GT_OUTPUT_SAM_MAP_ENCODINGS_INITIAL_SLOTS 16
+#define GT_OUTPUT_SAM_OF_PLAN_INITIAL_LENGTH 16
+#define GT_OUTPUT_SAM_OF_TEXT_INITIAL_LENGTH 128
+#define GT_OUTPUT_SAM_OF_INT_MAX_LENGTH 21
 
 /*
  * Output SAM Attributes
@@ -22,6 +28,20 @@ GT_INLINE gt_output_sam_attributes* gt_output_sam_attributes_new() {
   /* Optional fields */
   attributes->sam_attributes=NULL;
   attributes->attribute_func_params=NULL;
+  attributes->optional_fields_plan = gt_vector_new(GT_OUTPUT_SAM_OF_PLAN_INITIAL_LENGTH,sizeof(gt_output_sam_of_emitter));
+  attributes->optional_fields_text = gt_string_new(GT_OUTPUT_SAM_OF_TEXT_INITIAL_LENGTH);
+  attributes->optional_fields_record_values = gt_string_new(GT_OUTPUT_SAM_OF_TEXT_INITIAL_LENGTH);
+  /* Record cache */
+  attributes->record_id = 0;
+  uint64_t i;
+  for (i=0;i<2;++i) {
+    attributes->read_rc[i] = gt_string_new(GT_OUTPUT_SAM_READ_INITIAL_LENGTH);
+    attributes->qualities_r[i] = gt_string_new(GT_OUTPUT_SAM_READ_INITIAL_LENGTH);
+    attributes->qualities_offset33[i] = gt_string_new(GT_OUTPUT_SAM_READ_INITIAL_LENGTH);
+  }
+  attributes->encoding_buffer = gt_string_new(GT_OUTPUT_SAM_ENCODING_BUFFER_INITIAL_LENGTH);
+  attributes->map_encodings = gt_vector_new(GT_OUTPUT_SAM_MAP_ENCODINGS_INITIAL_SLOTS,sizeof(gt_sam_map_encoding));
+  attributes->map_encodings_index = gt_vector_new(GT_OUTPUT_SAM_MAP_ENCODINGS_INITIAL_SLOTS,sizeof(uint32_t));
   /* Reset defaults */
   gt_output_sam_attributes_clear(attributes);
   return attributes;
@@ -30,6 +50,18 @@ GT_INLINE void gt_output_sam_attributes_delete(gt_output_sam_attributes* const a
   GT_NULL_CHECK(attributes);
   if (attributes->sam_attributes!=NULL) gt_sam_attributes_delete(attributes->sam_attributes);
   if (attributes->attribute_func_params!=NULL) gt_sam_attribute_func_params_delete(attributes->attribute_func_params);
+  gt_vector_delete(attributes->optional_fields_plan);
+  gt_string_delete(attributes->optional_fields_text);
+  gt_string_delete(attributes->optional_fields_record_values);
+  uint64_t i;
+  for (i=0;i<2;++i) {
+    gt_string_delete(attributes->read_rc[i]);
+    gt_string_delete(attributes->qualities_r[i]);
+    gt_string_delete(attributes->qualities_offset33[i]);
+  }
+  gt_string_delete(attributes->encoding_buffer);
+  gt_vector_delete(attributes->map_encodings);
+  gt_vector_delete(attributes->map_encodings_index);
   gt_free(attributes);
 }
 GT_INLINE void gt_output_sam_attributes_clear(gt_output_sam_attributes* const attributes) {
@@ -56,6 +88,10 @@ GT_INLINE void gt_output_sam_attributes_clear(gt_output_sam_attributes* const at
   } else {
     attributes->attribute_func_params = gt_sam_attribute_func_params_new();
   }
+  attributes->optional_fields_plan_valid = false;
+  /* Record cache */
+  attributes->record_cache_active = false;
+  attributes->encode_md = false;
 }
 
 /* Format */
@@ -98,11 +134,118 @@ GT_INLINE void gt_output_sam_attributes_set_reference_sequence_archive(gt_output
   GT_NULL_CHECK(attributes);
   attributes->attribute_func_params->sequence_archive = reference_sequence_archive;
 }
+GT_INLINE void gt_output_sam_attributes_set_splice_motifs(gt_output_sam_attributes* const attributes,gt_sam_splice_motifs* const splice_motifs) {
+  GT_NULL_CHECK(attributes);
+  gt_sam_attribute_func_params_set_splice_motifs(attributes->attribute_func_params,splice_motifs);
+}
 GT_INLINE gt_sam_attributes* gt_output_sam_attributes_get_sam_attributes(gt_output_sam_attributes* const attributes) {
   GT_NULL_CHECK(attributes);
+  attributes->optional_fields_plan_valid = false; // Might be modified
   return attributes->sam_attributes;
 }
 
+/*
+ * Record cache
+ *   Between gt_output_sam_attributes_begin_record() and gt_output_sam_attributes_end_record()
+ *   the RC of the read, the reversed/adapted qualities and the CIGAR of each map segment
+ *   are computed at most once (into buffers reused across records)
+ */
+GT_INLINE void gt_output_sam_attributes_begin_record(gt_output_sam_attributes* const attributes) {
+  attributes->record_cache_active = true;
+  ++(attributes->record_id);
+  gt_string_clear(attributes->optional_fields_record_values);
+  attributes->read__qualities_rc_cached[0] = false;
+  attributes->read__qualities_rc_cached[1] = false;
+  gt_string_clear(attributes->encoding_buffer);
+  gt_vector_clear(attributes->map_encodings);
+  gt_vector_clear(attributes->map_encodings_index);
+  attributes->encode_md = attributes->print_optional_fields &&
+      gt_sam_attributes_get_attribute(attributes->sam_attributes,"MD")!=NULL;
+}
+GT_INLINE void gt_output_sam_attributes_end_record(gt_output_sam_attributes* const attributes) {
+  attributes->record_cache_active = false;
+}
+GT_INLINE void gt_output_sam_attributes_get_read__qualities_rc(
+    gt_output_sam_attributes* const attributes,const uint64_t end_position,
+    gt_string* const read_f,gt_string* const qualities_f,gt_string** const read_rc,gt_string** const qualities_r) {
+  if (read_f==NULL) {
+    *read_rc = NULL; *qualities_r = NULL;
+    return;
+  }
+  if (!attributes->read__qualities_rc_cached[end_position]) {
+    gt_dna_string_reverse_complement_copy(attributes->read_rc[end_position],read_f);
+    if (qualities_f!=NULL) gt_string_reverse_copy(attributes->qualities_r[end_position],qualities_f);
+    attributes->read__qualities_rc_cached[end_position] = attributes->record_cache_active;
+  }
+  *read_rc = attributes->read_rc[end_position];
+  *qualities_r = (qualities_f!=NULL) ? attributes->qualities_r[end_position] : NULL;
+}
+GT_INLINE gt_string* gt_output_sam_attributes_get_qualities_offset33(
+    gt_output_sam_attributes* const attributes,const uint64_t end_position,gt_string* const qualities) {
+  if (qualities==NULL) return NULL;
+  gt_string* const qualities_offset33 = attributes->qualities_offset33[end_position];
+  const uint64_t length = gt_string_get_length(qualities);
+  gt_string_resize(qualities_offset33,length+1);
+  char* const qualities_offset33_buf = gt_string_get_string(qualities_offset33);
+  GT_STRING_ITERATE(qualities,qualities_buf,pos) {
+    qualities_offset33_buf[pos] = qualities_buf[pos]-64+33;
+  }
+  qualities_offset33_buf[length] = EOS;
+  gt_string_set_length(qualities_offset33,length);
+  return qualities_offset33;
+}
+GT_INLINE uint64_t gt_output_sam_map_encodings_hash(gt_map* const map) {
+  uint64_t key = (uint64_t)map;
+  key ^= key >> 33;
+  key *= 0xff51afd7ed558ccdULL;
+  key ^= key >> 33;
+  return key;
+}
+GT_INLINE gt_sam_map_encoding* gt_output_sam_map_encodings_get(gt_output_sam_attributes* const attributes,gt_map* const map) {
+  const uint64_t num_slots = gt_vector_get_used(attributes->map_encodings_index);
+  if (num_slots==0) return NULL;
+  const uint32_t* const slots = gt_vector_get_mem(attributes->map_encodings_index,uint32_t);
+  const uint64_t mask = num_slots-1;
+  uint64_t slot = gt_output_sam_map_encodings_hash(map) & mask;
+  while (slots[slot]!=0) {
+    gt_sam_map_encoding* const map_encoding = gt_vector_get_elm(attributes->map_encodings,slots[slot]-1,gt_sam_map_encoding);
+    if (map_encoding->map==map) return map_encoding;
+    slot = (slot+1) & mask;
+  }
+  return NULL;
+}
+GT_INLINE void gt_output_sam_map_encodings_index_rebuild(gt_output_sam_attributes* const attributes,const uint64_t num_slots) {
+  gt_vector* const index = attributes->map_encodings_index;
+  gt_vector_reserve(index,num_slots,false);
+  gt_vector_set_used(index,num_slots);
+  uint32_t* const slots = gt_vector_get_mem(index,uint32_t);
+  memset(slots,0,num_slots*sizeof(uint32_t));
+  const uint64_t mask = num_slots-1;
+  GT_VECTOR_ITERATE(attributes->map_encodings,map_encoding,map_encoding_pos,gt_sam_map_encoding) {
+    uint64_t slot = gt_output_sam_map_encodings_hash(map_encoding->map) & mask;
+    while (slots[slot]!=0) slot = (slot+1) & mask;
+    slots[slot] = map_encoding_pos+1;
+  }
+}
+GT_INLINE void gt_output_sam_map_encodings_add(
+    gt_output_sam_attributes* const attributes,gt_sam_map_encoding* const map_encoding) {
+  gt_map* const map = map_encoding->map;
+  gt_vector_insert(attributes->map_encodings,*map_encoding,gt_sam_map_encoding);
+  // Keep the load factor below 1/2
+  const uint64_t num_encodings = gt_vector_get_used(attributes->map_encodings);
+  const uint64_t num_slots = gt_vector_get_used(attributes->map_encodings_index);
+  if (2*num_encodings > num_slots) {
+    gt_output_sam_map_encodings_index_rebuild(attributes,
+        (num_slots==0) ? GT_OUTPUT_SAM_MAP_ENCODINGS_INITIAL_SLOTS : 2*num_slots);
+  } else {
+    uint32_t* const slots = gt_vector_get_mem(attributes->map_encodings_index,uint32_t);
+    const uint64_t mask = num_slots-1;
+    uint64_t slot = gt_output_sam_map_encodings_hash(map) & mask;
+    while (slots[slot]!=0) slot = (slot+1) & mask;
+    slots[slot] = num_encodings;
+  }
+}
+
 /*
  * // TODO replace with sample
  * SAM Headers
@@ -325,115 +468,6 @@ GT_INLINE uint16_t gt_output_sam_calculate_flag(
 /*
  * SAM CIGAR
  */
-#define GT_OUTPUT_SAM_CIGAR_FORWARD_MATCH() \
-  if (misms_pos!=centinel) { \
-    gt_gprintf(gprinter,"%"PRIu64"%c",misms_pos-centinel,(attributes->print_mismatches)?'=':'M'); \
-    centinel = misms_pos; \
-  }
-#define GT_OUTPUT_SAM_CIGAR_REVERSE_MATCH() \
-  if (misms_pos!=centinel) { \
-    gt_gprintf(gprinter,"%"PRIu64"%c",centinel-misms_pos,(attributes->print_mismatches)?'=':'M'); \
-    centinel = misms_pos; \
-  }
-GT_INLINE gt_status gt_output_sam_gprint_map_block_cigar_reverse(gt_generic_printer* const gprinter,gt_map* const map,gt_output_sam_attributes* const attributes) {
-  GT_GENERIC_PRINTER_CHECK(gprinter);
-  GT_MAP_CHECK(map);
-  // Map auxiliary variables
-  const uint64_t map_length = gt_map_get_base_length(map);
-  int64_t centinel = map_length;
-  // Mismatches auxiliary variables
-  const uint64_t num_misms = gt_map_get_num_misms(map);
-  uint64_t misms_n = num_misms;
-  gt_misms* misms;
-  while (misms_n > 0) {
-    misms = gt_map_get_misms(map,misms_n-1);
-    const uint64_t misms_pos = gt_misms_get_position(misms);
-    switch (misms->misms_type) {
-      case MISMS:
-        if (attributes->print_mismatches) {
-          GT_OUTPUT_SAM_CIGAR_REVERSE_MATCH();
-          gt_gprintf(gprinter,"1X");
-          --centinel;
-        }
-        break;
-      case INS: // SAM Deletion
-        GT_OUTPUT_SAM_CIGAR_REVERSE_MATCH();
-        gt_gprintf(gprinter,"%"PRIu64"D",gt_misms_get_size(misms));
-        break;
-      case DEL: // SAM Insertion
-        centinel-=gt_misms_get_size(misms);
-        GT_OUTPUT_SAM_CIGAR_REVERSE_MATCH();
-        gt_gprintf(gprinter,"%"PRIu64"I",gt_misms_get_size(misms));
-        break;
-      default:
-        gt_error(SELECTION_NOT_VALID);
-        return GT_SOE_PRINTING_MISM_STRING;
-        break;
-    }
-    --misms_n;
-  }
-  if (centinel >= 0) gt_gprintf(gprinter,"%"PRIu64"M",centinel);
-  return 0;
-}
-GT_INLINE gt_status gt_output_sam_gprint_map_block_cigar_forward(gt_generic_printer* const gprinter,gt_map* const map,gt_output_sam_attributes* const attributes) {
-  GT_GENERIC_PRINTER_CHECK(gprinter);
-  GT_MAP_CHECK(map);
-  const uint64_t map_length = gt_map_get_base_length(map);
-  uint64_t centinel = 0;
-  GT_MISMS_ITERATE(map,misms) {
-    const uint64_t misms_pos = gt_misms_get_position(misms);
-    switch (misms->misms_type) {
-      case MISMS:
-        if (attributes->print_mismatches) {
-          GT_OUTPUT_SAM_CIGAR_FORWARD_MATCH();
-          gt_gprintf(gprinter,"1X");
-          ++centinel;
-        }
-        break;
-      case INS: // SAM Deletion
-        GT_OUTPUT_SAM_CIGAR_FORWARD_MATCH();
-        gt_gprintf(gprinter,"%"PRIu64"D",gt_misms_get_size(misms));
-        break;
-      case DEL: // SAM Insertion
-        GT_OUTPUT_SAM_CIGAR_FORWARD_MATCH();
-        gt_gprintf(gprinter,"%"PRIu64"I",gt_misms_get_size(misms));
-        centinel+=gt_misms_get_size(misms);
-        break;
-      default:
-        gt_error(SELECTION_NOT_VALID);
-        return GT_SOE_PRINTING_MISM_STRING;
-        break;
-    }
-  }
-  if (centinel < map_length) gt_gprintf(gprinter,"%"PRIu64"M",map_length-centinel);
-  return 0;
-}
-GT_INLINE gt_status gt_output_sam_gprint_map_block_cigar(
-    gt_generic_printer* const gprinter,gt_map* const map_block,gt_output_sam_attributes* const attributes) {
-  GT_GENERIC_PRINTER_CHECK(gprinter);
-  GT_MAP_CHECK(map_block);
-  gt_status error_code = 0;
-  if (gt_map_get_strand(map_block)==REVERSE) {
-    // Check following map blocks
-    gt_map* const next_map_block = gt_map_get_next_block(map_block);
-    if (next_map_block!=NULL && GT_MAP_IS_SAME_SEGMENT(map_block,next_map_block)) { // SplitMap (Otherwise is a quimera)
-      error_code = gt_output_sam_gprint_map_block_cigar(gprinter,next_map_block,attributes);
-      gt_gprintf(gprinter,"%"PRIu64"N",gt_map_get_junction_size(map_block));
-    }
-    // Print CIGAR for current map block
-    gt_output_sam_gprint_map_block_cigar_reverse(gprinter,map_block,attributes);
-  } else {
-    // Print CIGAR for current map block
-    gt_output_sam_gprint_map_block_cigar_forward(gprinter,map_block,attributes);
-    // Check following map blocks
-    gt_map* const next_map_block = gt_map_get_next_block(map_block);
-    if (next_map_block!=NULL && GT_MAP_IS_SAME_SEGMENT(map_block,next_map_block)) { // SplitMap (Otherwise is a quimera)
-      gt_gprintf(gprinter,"%"PRIu64"N",gt_map_get_junction_size(map_block));
-      error_code = gt_output_sam_gprint_map_block_cigar(gprinter,next_map_block,attributes);
-    }
-  }
-  return error_code;
-}
 GT_INLINE gt_status gt_output_sam_gprint_map_cigar(
     gt_generic_printer* const gprinter,gt_map* const map_segment,gt_output_sam_attributes* const attributes,
     const uint64_t hard_left_trim_read,const uint64_t hard_right_trim_read) {
@@ -441,15 +475,35 @@ GT_INLINE gt_status gt_output_sam_gprint_map_cigar(
   GT_MAP_CHECK(map_segment);
   gt_status error_code = 0;
   // Check strandness
-  if (gt_map_get_strand(map_segment)==FORWARD) {
-    if (hard_left_trim_read>0) gt_gprintf(gprinter,"%"PRIu64"H",hard_left_trim_read);
-    error_code=gt_output_sam_gprint_map_block_cigar(gprinter,map_segment,attributes);
-    if (hard_right_trim_read>0) gt_gprintf(gprinter,"%"PRIu64"H",hard_right_trim_read);
+  const bool forward = gt_map_get_strand(map_segment)==FORWARD;
+  const uint64_t hard_trim_first = (forward) ? hard_left_trim_read : hard_right_trim_read;
+  const uint64_t hard_trim_last = (forward) ? hard_right_trim_read : hard_left_trim_read;
+  if (hard_trim_first>0) gt_gprintf(gprinter,"%"PRIu64"H",hard_trim_first);
+  if (attributes->record_cache_active) {
+    // Encode the CIGAR (and MD/NM) once per map segment and record
+    gt_sam_map_encoding* map_encoding = gt_output_sam_map_encodings_get(attributes,map_segment);
+    if (map_encoding==NULL) {
+      gt_sam_map_encoding encoding;
+      if (gt_sam_map_encode(attributes->encoding_buffer,map_segment,attributes->print_mismatches,
+          attributes->encode_md,attributes->attribute_func_params->sequence_archive,&encoding)) {
+        error_code = GT_SOE_PRINTING_MISM_STRING;
+      } else {
+        gt_output_sam_map_encodings_add(attributes,&encoding);
+      }
+      gt_gwrite(gprinter,gt_string_get_string(attributes->encoding_buffer)+encoding.cigar_offset,encoding.cigar_length);
+    } else {
+      gt_gwrite(gprinter,gt_string_get_string(attributes->encoding_buffer)+map_encoding->cigar_offset,map_encoding->cigar_length);
+    }
   } else {
-    if (hard_right_trim_read>0) gt_gprintf(gprinter,"%"PRIu64"H",hard_right_trim_read);
-    error_code=gt_output_sam_gprint_map_block_cigar(gprinter,map_segment,attributes);
-    if (hard_left_trim_read>0) gt_gprintf(gprinter,"%"PRIu64"H",hard_left_trim_read);
+    // Encode at the end of the buffer (the record's encodings, if any, are kept)
+    gt_sam_map_encoding encoding;
+    const uint64_t buffer_length = gt_string_get_length(attributes->encoding_buffer);
+    if (gt_sam_map_encode(attributes->encoding_buffer,map_segment,
+        attributes->print_mismatches,false,NULL,&encoding)) error_code = GT_SOE_PRINTING_MISM_STRING;
+    gt_gwrite(gprinter,gt_string_get_string(attributes->encoding_buffer)+encoding.cigar_offset,encoding.cigar_length);
+    gt_string_set_length(attributes->encoding_buffer,buffer_length);
   }
+  if (hard_trim_last>0) gt_gprintf(gprinter,"%"PRIu64"H",hard_trim_last);
   return error_code;
 }
 #undef GT_GENERIC_PRINTER_DELEGATE_CALL_PARAMS
@@ -695,6 +749,129 @@ GT_INLINE gt_status gt_output_sam_gprint_optional_fields_values(gt_generic_print
   }
   return 0;
 }
+/*
+ * SAM Optional fields emission plan
+ *   - @output_attributes->sam_attributes is compiled once into a vector of emitters (same order)
+ *   - Constant values are rendered at compile time. Functional attributes just get their prefix
+ *     rendered and their values are written straight into the output (floats aside)
+ *   - Record-scoped attributes (e.g. NH,XT) are generated once per record (while the record cache is active)
+ *   - The plan is rebuilt if the number of attributes changes (or they're accessed through
+ *     gt_output_sam_attributes_get_sam_attributes())
+ */
+GT_INLINE uint64_t gt_output_sam_of_write_int(char* const mem,const int64_t value) {
+  char digits[GT_OUTPUT_SAM_OF_INT_MAX_LENGTH];
+  uint64_t num_digits = 0, length = 0;
+  uint64_t abs_value = (value<0) ? -((uint64_t)value) : (uint64_t)value;
+  do {
+    digits[num_digits++] = '0'+(abs_value%10);
+    abs_value /= 10;
+  } while (abs_value>0);
+  if (value<0) mem[length++] = '-';
+  while (num_digits>0) mem[length++] = digits[--num_digits];
+  return length;
+}
+GT_INLINE void gt_output_sam_of_render_prefix(gt_string* const text,gt_sam_attribute* const sam_attribute) {
+  char prefix[GT_OUTPUT_SAM_OF_PREFIX_LENGTH] =
+    { TAB, sam_attribute->tag[0], sam_attribute->tag[1], ':', sam_attribute->type_id, ':' };
+  gt_string_right_append_string(text,prefix,GT_OUTPUT_SAM_OF_PREFIX_LENGTH);
+}
+GT_INLINE void gt_output_sam_optional_fields_compile(gt_output_sam_attributes* const output_attributes) {
+  gt_vector* const plan = output_attributes->optional_fields_plan;
+  gt_string* const text = output_attributes->optional_fields_text;
+  gt_vector_clear(plan);
+  gt_string_clear(text);
+  GT_SAM_ATTRIBUTES_BEGIN_ITERATE(output_attributes->sam_attributes,sam_attribute) {
+    gt_vector_reserve_additional(plan,1);
+    gt_output_sam_of_emitter* const emitter = gt_vector_get_free_elm(plan,gt_output_sam_of_emitter);
+    gt_vector_inc_used(plan);
+    emitter->attribute = *sam_attribute;
+    emitter->cached_record[0] = 0;
+    emitter->cached_record[1] = 0;
+    // Render text
+    emitter->text_offset = gt_string_get_length(text);
+    gt_output_sam_of_render_prefix(text,sam_attribute);
+    if (sam_attribute->attribute_type == SAM_ATTR_INT_VALUE) {
+      char value[GT_OUTPUT_SAM_OF_INT_MAX_LENGTH];
+      gt_string_right_append_string(text,value,gt_output_sam_of_write_int(value,sam_attribute->i_value));
+    } else if (sam_attribute->attribute_type == SAM_ATTR_FLOAT_VALUE) {
+      gt_sprintf_append(text,"%3.2f",sam_attribute->f_value);
+    }
+    emitter->text_length = gt_string_get_length(text)-emitter->text_offset;
+  } GT_SAM_ATTRIBUTES_END_ITERATE;
+  output_attributes->optional_fields_plan_num_attributes = gt_shash_get_num_elements(output_attributes->sam_attributes);
+  output_attributes->optional_fields_plan_valid = true;
+}
+GT_INLINE gt_status gt_output_sam_of_emitter_generate(
+    gt_output_sam_of_emitter* const emitter,gt_sam_attribute_func_params* const func_params) {
+  switch (emitter->attribute.attribute_type) {
+    case SAM_ATTR_INT_FUNC: return emitter->attribute.i_func(func_params);
+    case SAM_ATTR_FLOAT_FUNC: return emitter->attribute.f_func(func_params);
+    case SAM_ATTR_STRING_FUNC: return emitter->attribute.s_func(func_params);
+    default: return -1;
+  }
+}
+GT_INLINE void gt_output_sam_gprint_optional_fields_plan(
+    gt_generic_printer* const gprinter,gt_output_sam_attributes* const output_attributes) {
+  // Check plan
+  if (!output_attributes->optional_fields_plan_valid ||
+      output_attributes->optional_fields_plan_num_attributes!=gt_shash_get_num_elements(output_attributes->sam_attributes)) {
+    gt_output_sam_optional_fields_compile(output_attributes);
+  }
+  gt_sam_attribute_func_params* const func_params = output_attributes->attribute_func_params;
+  const char* const text = gt_string_get_string(output_attributes->optional_fields_text);
+  gt_string* const record_values = output_attributes->optional_fields_record_values;
+  const uint64_t cache_slot = (func_params->alignment_info==NULL || func_params->alignment_info->map==NULL) ? 1 : 0;
+  char value[GT_OUTPUT_SAM_OF_INT_MAX_LENGTH];
+  GT_VECTOR_ITERATE(output_attributes->optional_fields_plan,emitter,emitter_pos,gt_output_sam_of_emitter) {
+    const gt_sam_attribute_t attribute_type = emitter->attribute.attribute_type;
+    // Values
+    if (attribute_type == SAM_ATTR_INT_VALUE || attribute_type == SAM_ATTR_FLOAT_VALUE) {
+      gt_gwrite(gprinter,text+emitter->text_offset,emitter->text_length);
+      continue;
+    } else if (attribute_type == SAM_ATTR_STRING_VALUE) {
+      gt_gwrite(gprinter,text+emitter->text_offset,emitter->text_length);
+      gt_gwrite(gprinter,gt_string_get_string(emitter->attribute.s_value),gt_string_get_length(emitter->attribute.s_value));
+      continue;
+    }
+    // Functions
+    int32_t i_value;
+    float f_value;
+    const char* s_value;
+    uint64_t s_length;
+    if (emitter->attribute.scope==SAM_ATTR_SCOPE_RECORD && output_attributes->record_cache_active) {
+      if (emitter->cached_record[cache_slot]!=output_attributes->record_id) {
+        emitter->cached_record[cache_slot] = output_attributes->record_id;
+        emitter->cached_status[cache_slot] = gt_output_sam_of_emitter_generate(emitter,func_params);
+        emitter->cached_i[cache_slot] = func_params->return_i;
+        emitter->cached_f[cache_slot] = func_params->return_f;
+        if (attribute_type == SAM_ATTR_STRING_FUNC && emitter->cached_status[cache_slot]==0) {
+          emitter->cached_s_offset[cache_slot] = gt_string_get_length(record_values);
+          emitter->cached_s_length[cache_slot] = gt_string_get_length(func_params->return_s);
+          gt_string_right_append_gt_string(record_values,func_params->return_s);
+        }
+      }
+      if (emitter->cached_status[cache_slot]!=0) continue;
+      i_value = emitter->cached_i[cache_slot];
+      f_value = emitter->cached_f[cache_slot];
+      s_value = gt_string_get_string(record_values)+emitter->cached_s_offset[cache_slot];
+      s_length = emitter->cached_s_length[cache_slot];
+    } else {
+      if (gt_output_sam_of_emitter_generate(emitter,func_params)!=0) continue;
+      i_value = func_params->return_i;
+      f_value = func_params->return_f;
+      s_value = gt_string_get_string(func_params->return_s);
+      s_length = gt_string_get_length(func_params->return_s);
+    }
+    gt_gwrite(gprinter,text+emitter->text_offset,emitter->text_length);
+    if (attribute_type == SAM_ATTR_INT_FUNC) {
+      gt_gwrite(gprinter,value,gt_output_sam_of_write_int(value,i_value));
+    } else if (attribute_type == SAM_ATTR_FLOAT_FUNC) {
+      gt_gprintf(gprinter,"%3.2f",f_value);
+    } else {
+      gt_gwrite(gprinter,s_value,s_length);
+    }
+  }
+}
 #undef GT_GENERIC_PRINTER_DELEGATE_CALL_PARAMS
 #define GT_GENERIC_PRINTER_DELEGATE_CALL_PARAMS sam_attributes,output_attributes
 GT_GENERIC_PRINTER_IMPLEMENTATION(gt_output_sam,print_optional_fields,
@@ -706,6 +883,18 @@ GT_INLINE gt_status gt_output_sam_gprint_optional_fields(gt_generic_printer* con
   if (sam_attributes==NULL) sam_attributes = output_attributes->sam_attributes;
   if (sam_attributes!=NULL) {
     GT_SAM_ATTRIBUTES_CHECK(sam_attributes);
+    // Provide the CIGAR encoding of the map (MD/NM computed along)
+    gt_sam_attribute_func_params* const func_params = output_attributes->attribute_func_params;
+    gt_map* const map = (func_params->alignment_info!=NULL) ? func_params->alignment_info->map : NULL;
+    func_params->map_encoding = (output_attributes->record_cache_active && map!=NULL) ?
+        gt_output_sam_map_encodings_get(output_attributes,map) : NULL;
+    func_params->map_encoding_buffer = output_attributes->encoding_buffer;
+    // Output attributes' optional fields (compiled)
+    if (sam_attributes==output_attributes->sam_attributes) {
+      gt_output_sam_gprint_optional_fields_plan(gprinter,output_attributes);
+      return 0;
+    }
+    // Map's own optional fields
     GT_SAM_ATTRIBUTES_BEGIN_ITERATE(sam_attributes,sam_attribute) {
       // Values
       if (sam_attribute->attribute_type == SAM_ATTR_INT_VALUE) {
@@ -788,7 +977,7 @@ GT_INLINE gt_status gt_output_sam_gprint_map_placeholder_se_compact(gt_generic_p
   // Produce RC of the mapping's read/qualities
   gt_string* const read_f = read;
   gt_string* const qualities_f = qualities;
-  gt_string *read_rc = NULL, *qualities_r = NULL;
+  gt_string *read_rc, *qualities_r;
   // Get primary map
   gt_cond_error(primary_position>=gt_vector_get_used(map_placeholder_vector),OUTPUT_SAM_NO_PRIMARY_ALG);
   gt_map_placeholder* const primary_map_ph = gt_vector_get_elm(map_placeholder_vector,primary_position,gt_map_placeholder);
@@ -797,10 +986,7 @@ GT_INLINE gt_status gt_output_sam_gprint_map_placeholder_se_compact(gt_generic_p
   if (primary_map==NULL || gt_map_get_strand(primary_map)==FORWARD) {
     error_code |= gt_output_sam_gprint_map_placeholder(gprinter,tag,read_f,qualities_f,primary_map_ph,attributes);
   } else {
-    if (gt_expect_false(read_rc==NULL)) { // Check RC
-      read_rc = gt_dna_string_reverse_complement_dup(read_f);
-      qualities_r = gt_string_reverse_dup(qualities_f);
-    }
+    gt_output_sam_attributes_get_read__qualities_rc(attributes,0,read_f,qualities_f,&read_rc,&qualities_r);
     error_code |= gt_output_sam_gprint_map_placeholder(gprinter,tag,read_rc,qualities_r,primary_map_ph,attributes);
   }
   // Print XA:Z field
@@ -811,11 +997,6 @@ GT_INLINE gt_status gt_output_sam_gprint_map_placeholder_se_compact(gt_generic_p
   gt_sam_attribute_func_params_set_alignment_info(attributes->attribute_func_params,primary_map_ph); // Set func params for OF
   gt_output_sam_gprint_optional_fields(gprinter,current_sam_attributes,attributes);
   gt_gprintf(gprinter,"\n");
-  // Free
-  if (read_rc!=NULL) {
-    gt_string_delete(read_rc);
-    gt_string_delete(qualities_r);
-  }
   return error_code;
 }
 GT_INLINE gt_status gt_output_sam_gprint_map_placeholder_pe_compact(gt_generic_printer* const gprinter,
@@ -830,8 +1011,7 @@ GT_INLINE gt_status gt_output_sam_gprint_map_placeholder_pe_compact(gt_generic_p
   // Produce RC of the mapping's read/qualities
   gt_string* const read_f = read;
   gt_string* const qualities_f = qualities;
-  gt_string* read_rc = NULL;
-  gt_string* qualities_r = NULL;
+  gt_string *read_rc, *qualities_r;
   // Get primary map
   gt_cond_error(primary_position>=gt_vector_get_used(map_placeholder_vector),OUTPUT_SAM_NO_PRIMARY_ALG);
   gt_map_placeholder* const primary_map_ph = gt_vector_get_elm(map_placeholder_vector,primary_position,gt_map_placeholder);
@@ -840,10 +1020,7 @@ GT_INLINE gt_status gt_output_sam_gprint_map_placeholder_pe_compact(gt_generic_p
   if (primary_map==NULL || gt_map_get_strand(primary_map)==FORWARD) {
     error_code |= gt_output_sam_gprint_map_placeholder(gprinter,tag,read_f,qualities_f,primary_map_ph,attributes);
   } else {
-    if (gt_expect_false(read_rc==NULL)) { // Check RC
-      read_rc = gt_dna_string_reverse_complement_dup(read_f);
-      qualities_r = gt_string_reverse_dup(qualities_f);
-    }
+    gt_output_sam_attributes_get_read__qualities_rc(attributes,end_position,read_f,qualities_f,&read_rc,&qualities_r);
     error_code |= gt_output_sam_gprint_map_placeholder(gprinter,tag,read_rc,qualities_r,primary_map_ph,attributes);
   }
   // Print XA:Z field
@@ -854,11 +1031,6 @@ GT_INLINE gt_status gt_output_sam_gprint_map_placeholder_pe_compact(gt_generic_p
   gt_sam_attribute_func_params_set_alignment_info(attributes->attribute_func_params,primary_map_ph); // Set func params for OF
   gt_output_sam_gprint_optional_fields(gprinter,current_sam_attributes,attributes);
   gt_gprintf(gprinter,"\n");
-  // Free
-  if (read_rc!=NULL) {
-    gt_string_delete(read_rc);
-    gt_string_delete(qualities_r);
-  }
   return error_code;
 }
 GT_INLINE gt_status gt_output_sam_gprint_map_placeholder_vector_se(gt_generic_printer* const gprinter,
@@ -870,7 +1042,7 @@ GT_INLINE gt_status gt_output_sam_gprint_map_placeholder_vector_se(gt_generic_pr
   gt_status error_code = 0;
   // Produce RC of the mapping's read/qualities
   gt_string *read_f = read, *qualities_f = qualities;
-  gt_string *read_rc=NULL, *qualities_r=NULL;
+  gt_string *read_rc, *qualities_r;
   // Iterate over all placeholders
   GT_VECTOR_ITERATE(map_placeholder_vector,map_ph,map_ph_it,gt_map_placeholder) {
     if (map_ph->type!=GT_MAP_PLACEHOLDER) continue;
@@ -878,10 +1050,7 @@ GT_INLINE gt_status gt_output_sam_gprint_map_placeholder_vector_se(gt_generic_pr
     if (map_ph->map==NULL || gt_map_get_strand(map_ph->map)==FORWARD) {
       error_code |= gt_output_sam_gprint_map_placeholder(gprinter,tag,read_f,qualities_f,map_ph,attributes);
     } else {
-      if (gt_expect_false(read_rc==NULL && read_f!=NULL)) { // Check RC
-        read_rc = gt_dna_string_reverse_complement_dup(read_f);
-        qualities_r = gt_string_reverse_dup(qualities_f);
-      }
+      gt_output_sam_attributes_get_read__qualities_rc(attributes,0,read_f,qualities_f,&read_rc,&qualities_r);
       error_code |= gt_output_sam_gprint_map_placeholder(gprinter,tag,read_rc,qualities_r,map_ph,attributes);
     }
     // Print Optional Fields
@@ -893,17 +1062,8 @@ GT_INLINE gt_status gt_output_sam_gprint_map_placeholder_vector_se(gt_generic_pr
     // Nullify read & qualities
     if (gt_expect_false(!attributes->always_output_read__qualities && map_ph_it>0)) {
       read_f = NULL; qualities_f = NULL;
-      if (read_rc!=NULL) {
-        gt_string_delete(read_rc); read_rc = NULL;
-        gt_string_delete(qualities_r); qualities_r = NULL;
-      }
     }
   }
-  // Free
-  if (read_rc!=NULL) {
-    gt_string_delete(read_rc);
-    gt_string_delete(qualities_r);
-  }
   return error_code;
 }
 GT_INLINE gt_status gt_output_sam_gprint_map_placeholder_vector_pe(gt_generic_printer* const gprinter,
@@ -917,7 +1077,7 @@ GT_INLINE gt_status gt_output_sam_gprint_map_placeholder_vector_pe(gt_generic_pr
   // Produce RC of the mapping's read/qualities
   gt_string *read_f_end1 = read_end1, *read_f_end2 = read_end2;
   gt_string *qualities_f_end1 = qualities_end1, *qualities_f_end2 = qualities_end2;
-  gt_string *read_rc_end1=NULL, *qualities_r_end1=NULL, *read_rc_end2=NULL, *qualities_r_end2=NULL;
+  gt_string *read_rc, *qualities_r;
   // Iterate over all placeholders
   GT_VECTOR_ITERATE(map_placeholder_vector,map_ph,map_ph_it,gt_map_placeholder) {
     if (map_ph->type==GT_MAP_PLACEHOLDER) continue;
@@ -926,21 +1086,15 @@ GT_INLINE gt_status gt_output_sam_gprint_map_placeholder_vector_pe(gt_generic_pr
       if (map_ph->map==NULL || gt_map_get_strand(map_ph->map)==FORWARD) {
         error_code |= gt_output_sam_gprint_map_placeholder(gprinter,tag,read_f_end1,qualities_f_end1,map_ph,attributes);
       } else {
-        if (gt_expect_false(read_rc_end1==NULL)) { // Check RC
-          read_rc_end1 = gt_dna_string_reverse_complement_dup(read_f_end1);
-          qualities_r_end1 = gt_string_reverse_dup(qualities_f_end1);
-        }
-        error_code |= gt_output_sam_gprint_map_placeholder(gprinter,tag,read_rc_end1,qualities_r_end1,map_ph,attributes);
+        gt_output_sam_attributes_get_read__qualities_rc(attributes,0,read_f_end1,qualities_f_end1,&read_rc,&qualities_r);
+        error_code |= gt_output_sam_gprint_map_placeholder(gprinter,tag,read_rc,qualities_r,map_ph,attributes);
       }
     } else {
       if (map_ph->map==NULL || gt_map_get_strand(map_ph->map)==FORWARD) {
         error_code |= gt_output_sam_gprint_map_placeholder(gprinter,tag,read_f_end2,qualities_f_end2,map_ph,attributes);
       } else {
-        if (gt_expect_false(read_rc_end2==NULL)) { // Check RC
-          read_rc_end2 = gt_dna_string_reverse_complement_dup(read_f_end2);
-          qualities_r_end2 = gt_string_reverse_dup(qualities_f_end2);
-        }
-        error_code |= gt_output_sam_gprint_map_placeholder(gprinter,tag,read_rc_end2,qualities_r_end2,map_ph,attributes);
+        gt_output_sam_attributes_get_read__qualities_rc(attributes,1,read_f_end2,qualities_f_end2,&read_rc,&qualities_r);
+        error_code |= gt_output_sam_gprint_map_placeholder(gprinter,tag,read_rc,qualities_r,map_ph,attributes);
       }
     }
     // Print Optional Fields
@@ -953,23 +1107,8 @@ GT_INLINE gt_status gt_output_sam_gprint_map_placeholder_vector_pe(gt_generic_pr
     if (gt_expect_false(!attributes->always_output_read__qualities && map_ph_it>0)) {
       read_f_end1 = NULL; qualities_f_end1 = NULL;
       read_f_end2 = NULL; qualities_f_end2 = NULL;
-      if (read_rc_end1!=NULL) {
-        gt_string_delete(read_rc_end1); gt_string_delete(qualities_r_end1);
-        read_rc_end1 = NULL; qualities_r_end1 = NULL;
-      }
-      if (read_rc_end2!=NULL) {
-        gt_string_delete(read_rc_end2); gt_string_delete(qualities_r_end2);
-        read_rc_end2 = NULL; qualities_r_end2 = NULL;
-      }
     }
   }
-  // Free
-  if (read_rc_end1!=NULL) {
-    gt_string_delete(read_rc_end1); gt_string_delete(qualities_r_end1);
-  }
-  if (read_rc_end2!=NULL) {
-    gt_string_delete(read_rc_end2); gt_string_delete(qualities_r_end2);
-  }
   return error_code;
 }
 GT_INLINE gt_status gt_output_sam_gprint_alignment_map_placeholder_vector(gt_generic_printer* const gprinter,
@@ -978,11 +1117,12 @@ GT_INLINE gt_status gt_output_sam_gprint_alignment_map_placeholder_vector(gt_gen
   GT_ALIGNMENT_CHECK(alignment);
   GT_VECTOR_CHECK(map_placeholder_vector);
   GT_NULL_CHECK(attributes);
-  // Check qualities
   gt_status error_code = 0;
+  gt_output_sam_attributes_begin_record(attributes);
+  // Check qualities
   gt_string* qualities = alignment->qualities;
   if (attributes->qualities_offset == GT_QUALS_OFFSET_64) {
-    qualities = gt_qualities_dup__adapt_offset64_to_offset33(alignment->qualities);
+    qualities = gt_output_sam_attributes_get_qualities_offset33(attributes,0,alignment->qualities);
   }
   if (attributes->compact_format) {
     // Print all placeholders (compact)
@@ -993,7 +1133,7 @@ GT_INLINE gt_status gt_output_sam_gprint_alignment_map_placeholder_vector(gt_gen
     error_code = gt_output_sam_gprint_map_placeholder_vector_se(gprinter,
         alignment->tag,alignment->read,qualities,map_placeholder_vector,attributes);
   }
-  if (attributes->qualities_offset == GT_QUALS_OFFSET_64) gt_string_delete(qualities);
+  gt_output_sam_attributes_end_record(attributes);
   return error_code;
 }
 GT_INLINE gt_status gt_output_sam_gprint_template_map_placeholder_vector(gt_generic_printer* const gprinter,
@@ -1004,48 +1144,34 @@ GT_INLINE gt_status gt_output_sam_gprint_template_map_placeholder_vector(gt_gene
   GT_VECTOR_CHECK(map_placeholder_vector);
   GT_NULL_CHECK(attributes);
   gt_status error_code = 0;
+  gt_output_sam_attributes_begin_record(attributes);
   gt_alignment* const alignment_end1 = gt_template_get_end1(template);
   gt_alignment* const alignment_end2 = gt_template_get_end2(template);
   gt_string* qualities_end1 = alignment_end1->qualities;
   gt_string* qualities_end2 = alignment_end2->qualities;
   if (attributes->qualities_offset == GT_QUALS_OFFSET_64) {
-    qualities_end1 = gt_qualities_dup__adapt_offset64_to_offset33(alignment_end1->qualities);
-    qualities_end2 = gt_qualities_dup__adapt_offset64_to_offset33(alignment_end2->qualities);
+    qualities_end1 = gt_output_sam_attributes_get_qualities_offset33(attributes,0,alignment_end1->qualities);
+    qualities_end2 = gt_output_sam_attributes_get_qualities_offset33(attributes,1,alignment_end2->qualities);
   }
   if (attributes->compact_format) {
     // Print End/1
-    error_code|=gt_output_sam_gprint_map_placeholder_pe_compact(gprinter,template->tag,alignment_end1->read,alignment_end1->qualities,
+    error_code|=gt_output_sam_gprint_map_placeholder_pe_compact(gprinter,template->tag,alignment_end1->read,qualities_end1,
         map_placeholder_vector,primary_position_end1,0,attributes);
     // Print End/2
-    error_code|=gt_output_sam_gprint_map_placeholder_pe_compact(gprinter,template->tag,alignment_end2->read,alignment_end2->qualities,
+    error_code|=gt_output_sam_gprint_map_placeholder_pe_compact(gprinter,template->tag,alignment_end2->read,qualities_end2,
         map_placeholder_vector,primary_position_end2,1,attributes);
   } else {
     // Print all placeholders
     error_code|=gt_output_sam_gprint_map_placeholder_vector_pe(gprinter,
         template->tag,alignment_end1->read,alignment_end2->read,
-        alignment_end1->qualities,alignment_end2->qualities,map_placeholder_vector,attributes);
-  }
-  if (attributes->qualities_offset == GT_QUALS_OFFSET_64) {
-    gt_string_delete(qualities_end1); gt_string_delete(qualities_end2);
+        qualities_end1,qualities_end2,map_placeholder_vector,attributes);
   }
+  gt_output_sam_attributes_end_record(attributes);
   return error_code;
 }
 /*
  * SAM High-level MMap/Map Printers
  */
-#define GT_OUTPUT_SAM_SETUP_READ__QUALITIES(alignment,map,read_f,qualities_f,read_rc,qualities_r,rc_complement) \
-  /* Produce RC of the mapping's read/qualities */ \
-  rc_complement = map!=NULL && gt_map_get_strand(map)==REVERSE; \
-  if (alignment!=NULL) { \
-    if (alignment->read!=NULL) { \
-      read_f = alignment->read; \
-      if (rc_complement) read_rc = gt_dna_string_reverse_complement_dup(read_f); \
-    } \
-    if (alignment->qualities!=NULL) { \
-      qualities_f = alignment->qualities; \
-      if (rc_complement) qualities_r = gt_string_reverse_dup(qualities_f); \
-    } \
-  }
 #undef GT_GENERIC_PRINTER_DELEGATE_CALL_PARAMS
 #define GT_GENERIC_PRINTER_DELEGATE_CALL_PARAMS template,map_end1,map_end2,mmap_attributes,secondary_alignment,not_passing_QC,PCR_duplicate,output_attributes
 GT_GENERIC_PRINTER_IMPLEMENTATION(gt_output_sam,print_mmap,
@@ -149,6 +149,7 @@ GT_INLINE void gt_sam_attribute_set_ivalue(gt_sam_attribute* const sam_attribute
   GT_NULL_CHECK(tag);
   GT_ATTRIBUTE_SAM_COPY_TAG(sam_attribute,tag);
   sam_attribute->attribute_type = SAM_ATTR_INT_VALUE;
+  sam_attribute->scope = SAM_ATTR_SCOPE_MAP;
   sam_attribute->type_id = type_id;
   sam_attribute->i_value = value;
 }
@@ -157,6 +158,7 @@ GT_INLINE void gt_sam_attribute_set_fvalue(gt_sam_attribute* const sam_attribute
   GT_NULL_CHECK(tag);
   GT_ATTRIBUTE_SAM_COPY_TAG(sam_attribute,tag);
   sam_attribute->attribute_type = SAM_ATTR_FLOAT_VALUE;
+  sam_attribute->scope = SAM_ATTR_SCOPE_MAP;
   sam_attribute->type_id = type_id;
   sam_attribute->f_value = value;
 }
@@ -166,6 +168,7 @@ GT_INLINE void gt_sam_attribute_set_svalue(gt_sam_attribute* const sam_attribute
   GT_STRING_CHECK(string);
   GT_ATTRIBUTE_SAM_COPY_TAG(sam_attribute,tag);
   sam_attribute->attribute_type = SAM_ATTR_STRING_VALUE;
+  sam_attribute->scope = SAM_ATTR_SCOPE_MAP;
   sam_attribute->type_id = type_id;
   sam_attribute->s_value = string;
 }
@@ -175,6 +178,7 @@ GT_INLINE void gt_sam_attribute_set_ifunc(gt_sam_attribute* const sam_attribute,
   GT_NULL_CHECK(i_func);
   GT_ATTRIBUTE_SAM_COPY_TAG(sam_attribute,tag);
   sam_attribute->attribute_type = SAM_ATTR_INT_FUNC;
+  sam_attribute->scope = SAM_ATTR_SCOPE_MAP;
   sam_attribute->type_id = type_id;
   sam_attribute->i_func = i_func;
 }
@@ -184,6 +188,7 @@ GT_INLINE void gt_sam_attribute_set_ffunc(gt_sam_attribute* const sam_attribute,
   GT_NULL_CHECK(f_func);
   GT_ATTRIBUTE_SAM_COPY_TAG(sam_attribute,tag);
   sam_attribute->attribute_type = SAM_ATTR_FLOAT_FUNC;
+  sam_attribute->scope = SAM_ATTR_SCOPE_MAP;
   sam_attribute->type_id = type_id;
   sam_attribute->f_func = f_func;
 }
@@ -193,6 +198,7 @@ GT_INLINE void gt_sam_attribute_set_sfunc(gt_sam_attribute* const sam_attribute,
   GT_NULL_CHECK(s_func);
   GT_ATTRIBUTE_SAM_COPY_TAG(sam_attribute,tag);
   sam_attribute->attribute_type = SAM_ATTR_STRING_FUNC;
+  sam_attribute->scope = SAM_ATTR_SCOPE_MAP;
   sam_attribute->type_id = type_id;
   sam_attribute->s_func = s_func;
 }
@@ -245,6 +251,116 @@ GT_INLINE void gt_sam_attributes_add_sfunc(gt_sam_attributes* const sam_attribut
   gt_sam_attribute_set_sfunc(sam_attribute,tag,type_id,s_func);
   gt_sam_attributes_add_attribute(sam_attributes,sam_attribute);
 }
+/*
+ * Splice-site motifs
+ */
+#define GT_SAM_SPLICE_MOTIF_INDEX(donor_word,acceptor_word) ((donor_word)|((acceptor_word)<<GT_SAM_SPLICE_MOTIF_WORD_BITS))
+GT_INLINE gt_sam_splice_motifs* gt_sam_splice_motifs_new() {
+  gt_sam_splice_motifs* const splice_motifs = gt_alloc(gt_sam_splice_motifs);
+  gt_sam_splice_motifs_clear(splice_motifs);
+  return splice_motifs;
+}
+GT_INLINE void gt_sam_splice_motifs_clear(gt_sam_splice_motifs* const splice_motifs) {
+  GT_NULL_CHECK(splice_motifs);
+  memset(splice_motifs->strand,GT_SAM_XS_UNKNOWN,GT_SAM_SPLICE_MOTIFS_TABLE_SIZE);
+}
+GT_INLINE void gt_sam_splice_motifs_delete(gt_sam_splice_motifs* const splice_motifs) {
+  GT_NULL_CHECK(splice_motifs);
+  gt_free(splice_motifs);
+}
+GT_INLINE bool gt_sam_splice_motifs_encode(const char* const motif,uint64_t* const word,uint64_t* const rc_word) {
+  uint64_t i;
+  *word = 0; *rc_word = 0;
+  for (i=0;i<GT_SAM_SPLICE_MOTIF_LENGTH;++i) {
+    const uint64_t enc_char = gt_cdna_encode[(uint8_t)motif[i]];
+    if (enc_char==GT_CDNA_ENC_CHAR_N) return false;
+    *word |= enc_char << (i*GT_CDNA_WORD_CHAR_BITS);
+    *rc_word |= (GT_CDNA_ENC_CHAR_T-enc_char) << ((GT_SAM_SPLICE_MOTIF_LENGTH-1-i)*GT_CDNA_WORD_CHAR_BITS);
+  }
+  return true;
+}
+GT_INLINE bool gt_sam_splice_motifs_add(gt_sam_splice_motifs* const splice_motifs,const char* const donor,const char* const acceptor) {
+  GT_NULL_CHECK(splice_motifs);
+  GT_NULL_CHECK(donor); GT_NULL_CHECK(acceptor);
+  uint64_t donor_word, donor_rc_word, acceptor_word, acceptor_rc_word;
+  if (!gt_sam_splice_motifs_encode(donor,&donor_word,&donor_rc_word)) return false;
+  if (!gt_sam_splice_motifs_encode(acceptor,&acceptor_word,&acceptor_rc_word)) return false;
+  // Transcribed from the forward strand (DONOR...ACCEPTOR)
+  splice_motifs->strand[GT_SAM_SPLICE_MOTIF_INDEX(donor_word,acceptor_word)] |= GT_SAM_XS_FORWARD;
+  // Transcribed from the reverse strand (RC(ACCEPTOR)...RC(DONOR))
+  splice_motifs->strand[GT_SAM_SPLICE_MOTIF_INDEX(acceptor_rc_word,donor_rc_word)] |= GT_SAM_XS_REVERSE;
+  return true;
+}
+GT_INLINE gt_status gt_sam_splice_motifs_parse(gt_sam_splice_motifs* const splice_motifs,const char* const motifs_list) {
+  GT_NULL_CHECK(splice_motifs);
+  GT_NULL_CHECK(motifs_list);
+  const char* motif = motifs_list;
+  while (*motif!=EOS) {
+    // DONOR-ACCEPTOR
+    const char* const separator = motif+GT_SAM_SPLICE_MOTIF_LENGTH;
+    if (strnlen(motif,GT_SAM_SPLICE_MOTIF_LENGTH)<GT_SAM_SPLICE_MOTIF_LENGTH || *separator!='-') return -1;
+    const char* const acceptor = separator+1;
+    if (strnlen(acceptor,GT_SAM_SPLICE_MOTIF_LENGTH)<GT_SAM_SPLICE_MOTIF_LENGTH) return -1;
+    if (!gt_sam_splice_motifs_add(splice_motifs,motif,acceptor)) return -1;
+    // Next
+    motif = acceptor+GT_SAM_SPLICE_MOTIF_LENGTH;
+    if (*motif==',') {
+      ++motif;
+      if (*motif==EOS) return -1;
+    } else if (*motif!=EOS) {
+      return -1;
+    }
+  }
+  return 0;
+}
+GT_INLINE uint8_t gt_sam_splice_motifs_get_strand(
+    gt_sam_splice_motifs* const splice_motifs,const uint64_t donor_word,const uint64_t acceptor_word) {
+  GT_NULL_CHECK(splice_motifs);
+  return splice_motifs->strand[GT_SAM_SPLICE_MOTIF_INDEX(donor_word,acceptor_word)];
+}
+/*
+ * Junction cache
+ */
+#define GT_SAM_JUNCTION_CACHE_MAX_POSITION (1ull<<31)
+#define GT_SAM_JUNCTION_CACHE_CONTIG_INIT_LENGTH 32
+#define GT_SAM_JUNCTION_CACHE_KEY(intron_begin,intron_end) ((int64_t)(((intron_begin)<<32)|((intron_end)-(intron_begin))))
+GT_INLINE gt_sam_junction_cache* gt_sam_junction_cache_new() {
+  gt_sam_junction_cache* const junction_cache = gt_alloc(gt_sam_junction_cache);
+  junction_cache->default_motifs = NULL;
+  junction_cache->contigs_junctions = gt_shash_new();
+  junction_cache->contig_name = gt_string_new(GT_SAM_JUNCTION_CACHE_CONTIG_INIT_LENGTH);
+  junction_cache->junctions = NULL;
+  return junction_cache;
+}
+GT_INLINE void gt_sam_junction_cache_clear(gt_sam_junction_cache* const junction_cache) {
+  GT_NULL_CHECK(junction_cache);
+  gt_shash_clear(junction_cache->contigs_junctions,true);
+  gt_string_clear(junction_cache->contig_name);
+  junction_cache->junctions = NULL;
+}
+GT_INLINE void gt_sam_junction_cache_delete(gt_sam_junction_cache* const junction_cache) {
+  GT_NULL_CHECK(junction_cache);
+  if (junction_cache->default_motifs!=NULL) gt_sam_splice_motifs_delete(junction_cache->default_motifs);
+  gt_shash_delete(junction_cache->contigs_junctions,true);
+  gt_string_delete(junction_cache->contig_name);
+  gt_free(junction_cache);
+}
+GT_INLINE gt_ihash* gt_sam_junction_cache_get_junctions(gt_sam_junction_cache* const junction_cache,gt_string* const contig_name) {
+  if (junction_cache->junctions!=NULL && gt_string_equals(junction_cache->contig_name,contig_name)) {
+    return junction_cache->junctions; // Same contig as the last lookup
+  }
+  gt_string_copy(junction_cache->contig_name,contig_name); // EOS-terminated
+  char* const contig = gt_string_get_string(junction_cache->contig_name);
+  gt_ihash* junctions = gt_shash_get(junction_cache->contigs_junctions,contig,gt_ihash);
+  if (junctions==NULL) {
+    junctions = gt_ihash_new();
+    gt_shash_insert_object(junction_cache->contigs_junctions,contig,junctions,
+        (void*(*)())gt_ihash_dup,(void(*)())gt_ihash_destroy);
+  }
+  junction_cache->junctions = junctions;
+  return junctions;
+}
+
 /*
  * Functional Attribute (ifunc,ffunc,sfunc) parameters
  */
@@ -255,6 +371,8 @@ GT_INLINE gt_sam_attribute_func_params* gt_sam_attribute_func_params_new() {
   func_params->return_s = gt_string_new(GT_SAM_ATTR_FUNC_PARAMS_RETURN_S_INIT_LENGTH);
   /* Attributes */
   func_params->attributes = gt_attributes_new();
+  /* Junction cache */
+  func_params->junction_cache = NULL;
   /* Reset defaults */
   gt_sam_attribute_func_params_clear(func_params);
   return func_params;
@@ -265,6 +383,8 @@ GT_INLINE void gt_sam_attribute_func_params_delete(gt_sam_attribute_func_params*
   if (func_params->return_s!=NULL) gt_string_delete(func_params->return_s);
   /* Attributes */
   gt_attributes_delete(func_params->attributes);
+  /* Junction cache */
+  if (func_params->junction_cache!=NULL) gt_sam_junction_cache_delete(func_params->junction_cache);
   gt_free(func_params);
 }
 GT_INLINE void gt_sam_attribute_func_params_clear(gt_sam_attribute_func_params* const func_params) {
@@ -277,12 +397,23 @@ GT_INLINE void gt_sam_attribute_func_params_clear(gt_sam_attribute_func_params*
   func_params->alignment_info=NULL;
   /* Placeholder Vector */
   func_params->mmap_placeholder = NULL;
+  /* Map Encoding */
+  func_params->map_encoding = NULL;
+  func_params->map_encoding_buffer = NULL;
+  /* Splice-site strand inference */
+  func_params->splice_motifs = NULL;
+  if (func_params->junction_cache!=NULL) gt_sam_junction_cache_clear(func_params->junction_cache);
 }
 GT_INLINE void gt_sam_attribute_func_params_set_sequence_archive(
     gt_sam_attribute_func_params* const func_params,gt_sequence_archive* const sequence_archive) {
   GT_NULL_CHECK(func_params);
   func_params->sequence_archive = sequence_archive;
 }
+GT_INLINE void gt_sam_attribute_func_params_set_splice_motifs(
+    gt_sam_attribute_func_params* const func_params,gt_sam_splice_motifs* const splice_motifs) {
+  GT_NULL_CHECK(func_params);
+  func_params->splice_motifs = splice_motifs;
+}
 GT_INLINE void gt_sam_attribute_func_params_set_sam_flags(
     gt_sam_attribute_func_params* const func_params,const bool not_passing_QC,const bool PCR_duplicate) {
   GT_NULL_CHECK(func_params);
@@ -325,6 +456,241 @@ GT_INLINE void gt_sam_attribute_func_params_set_pe(
   func_params->alignment_info->paired_end.mate = mate;
   func_params->alignment_info->paired_end.mmap_attributes = mmap_attributes;
 }
+/*
+ * SAM Map Encoder
+ */
+#define GT_SAM_ENCODER_UINT_MAX_DIGITS 20
+#define GT_SAM_ENCODER_OP_MAX_LENGTH (GT_SAM_ENCODER_UINT_MAX_DIGITS+1)
+typedef struct {
+  gt_string* buffer;
+  char* mem;         // Buffer memory (reloaded on resize)
+  uint64_t cigar_pos;
+  uint64_t md_pos;
+  /* CIGAR */
+  bool print_mismatches;
+  /* MD/NM */
+  bool encode_md;
+  bool md_encoded;
+  uint64_t md_matches;
+  uint64_t nm;
+  gt_sequence_archive* sequence_archive;
+  gt_string* reference;
+} gt_sam_map_encoder;
+
+GT_INLINE uint64_t gt_sam_map_encoder_write_uint(char* const mem,uint64_t value) {
+  char digits[GT_SAM_ENCODER_UINT_MAX_DIGITS];
+  uint64_t num_digits = 0, i;
+  do {
+    digits[num_digits++] = '0'+(value%10);
+    value /= 10;
+  } while (value>0);
+  for (i=0;i<num_digits;++i) mem[i] = digits[num_digits-1-i];
+  return num_digits;
+}
+GT_INLINE void gt_sam_map_encoder_cigar_op(gt_sam_map_encoder* const encoder,const uint64_t length,const char op) {
+  encoder->cigar_pos += gt_sam_map_encoder_write_uint(encoder->mem+encoder->cigar_pos,length);
+  encoder->mem[encoder->cigar_pos++] = op;
+}
+GT_INLINE void gt_sam_map_encoder_md_reserve(gt_sam_map_encoder* const encoder,const uint64_t additional) {
+  const uint64_t required = encoder->md_pos+additional;
+  if (required > encoder->buffer->allocated) {
+    gt_string_resize(encoder->buffer,2*required);
+    encoder->mem = gt_string_get_string(encoder->buffer);
+  }
+}
+GT_INLINE void gt_sam_map_encoder_md_matches(gt_sam_map_encoder* const encoder,const uint64_t num_matches) {
+  encoder->md_matches += num_matches;
+}
+GT_INLINE void gt_sam_map_encoder_md_mismatch(gt_sam_map_encoder* const encoder,const char reference_base) {
+  encoder->nm++;
+  if (!encoder->md_encoded) return;
+  encoder->md_pos += gt_sam_map_encoder_write_uint(encoder->mem+encoder->md_pos,encoder->md_matches);
+  encoder->mem[encoder->md_pos++] = toupper(reference_base);
+  encoder->md_matches = 0;
+}
+GT_INLINE void gt_sam_map_encoder_md_deletion(
+    gt_sam_map_encoder* const encoder,gt_map* const map,const uint64_t position,const uint64_t length) {
+  encoder->nm += length;
+  if (!encoder->md_encoded) return;
+  // Fetch the deleted bases
+  if (encoder->sequence_archive==NULL) {
+    encoder->md_encoded = false;
+    return;
+  }
+  if (encoder->reference==NULL) encoder->reference = gt_string_new(length+1);
+  if (gt_sequence_archive_retrieve_sequence_chunk(encoder->sequence_archive,
+      gt_map_get_seq_name(map),FORWARD,position,length,0,encoder->reference)) {
+    encoder->md_encoded = false;
+    return;
+  }
+  // ^[A-Z]+
+  gt_sam_map_encoder_md_reserve(encoder,GT_SAM_ENCODER_OP_MAX_LENGTH+length);
+  encoder->md_pos += gt_sam_map_encoder_write_uint(encoder->mem+encoder->md_pos,encoder->md_matches);
+  encoder->mem[encoder->md_pos++] = '^';
+  const char* const bases = gt_string_get_string(encoder->reference);
+  uint64_t i;
+  for (i=0;i<length;++i) encoder->mem[encoder->md_pos++] = toupper(bases[i]);
+  encoder->md_matches = 0;
+}
+/*
+ * Map blocks are encoded in reference order, so the MD string comes out straight.
+ *   The CIGAR is the one the former gt_gprintf-based printer produced, except that the last
+ *   match run honours print_mismatches ('='), reverse mismatches (X) are placed at the right
+ *   offset and no empty (0M) operation is emitted
+ */
+GT_INLINE gt_status gt_sam_map_encoder_block_forward(gt_sam_map_encoder* const encoder,gt_map* const map) {
+  const uint64_t map_length = gt_map_get_base_length(map);
+  const char match_op = (encoder->print_mismatches) ? '=' : 'M';
+  uint64_t centinel = 0, read_pos = 0, reference_pos = gt_map_get_position(map);
+  GT_MISMS_ITERATE(map,misms) {
+    const uint64_t misms_pos = gt_misms_get_position(misms);
+    gt_sam_map_encoder_md_matches(encoder,misms_pos-read_pos);
+    reference_pos += misms_pos-read_pos;
+    switch (misms->misms_type) {
+      case MISMS:
+        if (encoder->print_mismatches) {
+          if (misms_pos!=centinel) { gt_sam_map_encoder_cigar_op(encoder,misms_pos-centinel,match_op); centinel = misms_pos; }
+          gt_sam_map_encoder_cigar_op(encoder,1,'X');
+          ++centinel;
+        }
+        gt_sam_map_encoder_md_mismatch(encoder,misms->base);
+        read_pos = misms_pos+1; ++reference_pos;
+        break;
+      case INS: // SAM Deletion
+        if (misms_pos!=centinel) { gt_sam_map_encoder_cigar_op(encoder,misms_pos-centinel,match_op); centinel = misms_pos; }
+        gt_sam_map_encoder_cigar_op(encoder,gt_misms_get_size(misms),'D');
+        gt_sam_map_encoder_md_deletion(encoder,map,reference_pos,gt_misms_get_size(misms));
+        read_pos = misms_pos; reference_pos += gt_misms_get_size(misms);
+        break;
+      case DEL: // SAM Insertion
+        if (misms_pos!=centinel) { gt_sam_map_encoder_cigar_op(encoder,misms_pos-centinel,match_op); centinel = misms_pos; }
+        gt_sam_map_encoder_cigar_op(encoder,gt_misms_get_size(misms),'I');
+        centinel += gt_misms_get_size(misms);
+        encoder->nm += gt_misms_get_size(misms);
+        read_pos = misms_pos+gt_misms_get_size(misms);
+        break;
+      default:
+        gt_error(SELECTION_NOT_VALID);
+        return GT_SAM_ENCODER_BAD_MISMS;
+        break;
+    }
+  }
+  if (centinel < map_length) gt_sam_map_encoder_cigar_op(encoder,map_length-centinel,match_op);
+  gt_sam_map_encoder_md_matches(encoder,map_length-read_pos);
+  return 0;
+}
+GT_INLINE gt_status gt_sam_map_encoder_block_reverse(gt_sam_map_encoder* const encoder,gt_map* const map) {
+  const uint64_t map_length = gt_map_get_base_length(map);
+  const char match_op = (encoder->print_mismatches) ? '=' : 'M';
+  int64_t centinel = map_length;
+  uint64_t read_end = map_length, reference_pos = gt_map_get_position(map);
+  uint64_t misms_n = gt_map_get_num_misms(map);
+  while (misms_n > 0) {
+    gt_misms* const misms = gt_map_get_misms(map,misms_n-1);
+    const uint64_t misms_pos = gt_misms_get_position(misms);
+    switch (misms->misms_type) {
+      case MISMS:
+        if (encoder->print_mismatches) {
+          // The mismatch spans [misms_pos,misms_pos+1) of the read
+          if (misms_pos+1!=centinel) gt_sam_map_encoder_cigar_op(encoder,centinel-(misms_pos+1),match_op);
+          gt_sam_map_encoder_cigar_op(encoder,1,'X');
+          centinel = misms_pos;
+        }
+        gt_sam_map_encoder_md_matches(encoder,read_end-(misms_pos+1));
+        reference_pos += read_end-(misms_pos+1);
+        gt_sam_map_encoder_md_mismatch(encoder,gt_get_complement(misms->base));
+        read_end = misms_pos; ++reference_pos;
+        break;
+      case INS: // SAM Deletion
+        if (misms_pos!=centinel) { gt_sam_map_encoder_cigar_op(encoder,centinel-misms_pos,match_op); centinel = misms_pos; }
+        gt_sam_map_encoder_cigar_op(encoder,gt_misms_get_size(misms),'D');
+        gt_sam_map_encoder_md_matches(encoder,read_end-misms_pos);
+        reference_pos += read_end-misms_pos;
+        gt_sam_map_encoder_md_deletion(encoder,map,reference_pos,gt_misms_get_size(misms));
+        read_end = misms_pos; reference_pos += gt_misms_get_size(misms);
+        break;
+      case DEL: // SAM Insertion
+        centinel -= gt_misms_get_size(misms);
+        if (misms_pos!=centinel) { gt_sam_map_encoder_cigar_op(encoder,centinel-misms_pos,match_op); centinel = misms_pos; }
+        gt_sam_map_encoder_cigar_op(encoder,gt_misms_get_size(misms),'I');
+        encoder->nm += gt_misms_get_size(misms);
+        gt_sam_map_encoder_md_matches(encoder,read_end-(misms_pos+gt_misms_get_size(misms)));
+        reference_pos += read_end-(misms_pos+gt_misms_get_size(misms));
+        read_end = misms_pos;
+        break;
+      default:
+        gt_error(SELECTION_NOT_VALID);
+        return GT_SAM_ENCODER_BAD_MISMS;
+        break;
+    }
+    --misms_n;
+  }
+  if (centinel > 0) gt_sam_map_encoder_cigar_op(encoder,centinel,match_op);
+  gt_sam_map_encoder_md_matches(encoder,read_end);
+  return 0;
+}
+GT_INLINE gt_status gt_sam_map_encoder_blocks(gt_sam_map_encoder* const encoder,gt_map* const map_block) {
+  gt_status error_code = 0;
+  gt_map* const next_map_block = gt_map_get_next_block(map_block);
+  const bool split_map = next_map_block!=NULL && GT_MAP_IS_SAME_SEGMENT(map_block,next_map_block); // Otherwise is a quimera
+  if (gt_map_get_strand(map_block)==REVERSE) {
+    if (split_map) {
+      error_code = gt_sam_map_encoder_blocks(encoder,next_map_block);
+      gt_sam_map_encoder_cigar_op(encoder,gt_map_get_junction_size(map_block),'N');
+    }
+    error_code |= gt_sam_map_encoder_block_reverse(encoder,map_block);
+  } else {
+    error_code = gt_sam_map_encoder_block_forward(encoder,map_block);
+    if (split_map) {
+      gt_sam_map_encoder_cigar_op(encoder,gt_map_get_junction_size(map_block),'N');
+      error_code |= gt_sam_map_encoder_blocks(encoder,next_map_block);
+    }
+  }
+  return error_code;
+}
+GT_INLINE gt_status gt_sam_map_encode(
+    gt_string* const buffer,gt_map* const map_segment,const bool print_mismatches,
+    const bool encode_md,gt_sequence_archive* const sequence_archive,gt_sam_map_encoding* const map_encoding) {
+  GT_STRING_CHECK_NO_STATIC(buffer);
+  GT_MAP_CHECK(map_segment);
+  GT_NULL_CHECK(map_encoding);
+  // Reserve (once) for the worst case: 2 CIGAR operations per mismatch + the last match + junctions
+  uint64_t num_blocks = 0, num_misms = 0;
+  GT_MAP_SEGMENT_ITERATE(map_segment,map_block) {
+    ++num_blocks;
+    num_misms += gt_map_get_num_misms(map_block);
+  }
+  const uint64_t offset = gt_string_get_length(buffer);
+  const uint64_t cigar_bound = (2*num_misms+2*num_blocks)*GT_SAM_ENCODER_OP_MAX_LENGTH;
+  const uint64_t md_bound = (encode_md) ? (num_misms+1)*GT_SAM_ENCODER_OP_MAX_LENGTH : 0;
+  if (offset+cigar_bound+md_bound > buffer->allocated) gt_string_resize(buffer,2*(offset+cigar_bound+md_bound));
+  // Encode
+  gt_sam_map_encoder encoder = {
+      .buffer = buffer, .mem = gt_string_get_string(buffer),
+      .cigar_pos = offset, .md_pos = offset+cigar_bound,
+      .print_mismatches = print_mismatches,
+      .encode_md = encode_md, .md_encoded = encode_md, .md_matches = 0, .nm = 0,
+      .sequence_archive = sequence_archive, .reference = NULL };
+  const gt_status error_code = gt_sam_map_encoder_blocks(&encoder,map_segment);
+  if (encoder.reference!=NULL) gt_string_delete(encoder.reference);
+  // Final MD count & compact (MD right after the CIGAR)
+  map_encoding->map = map_segment;
+  map_encoding->cigar_offset = offset;
+  map_encoding->cigar_length = encoder.cigar_pos-offset;
+  map_encoding->md_encoded = encoder.md_encoded;
+  map_encoding->md_offset = encoder.cigar_pos;
+  map_encoding->md_length = 0;
+  if (encoder.md_encoded) {
+    encoder.md_pos += gt_sam_map_encoder_write_uint(encoder.mem+encoder.md_pos,encoder.md_matches);
+    map_encoding->md_length = encoder.md_pos-(offset+cigar_bound);
+    memmove(encoder.mem+map_encoding->md_offset,encoder.mem+offset+cigar_bound,map_encoding->md_length);
+  }
+  gt_string_set_length(buffer,map_encoding->md_offset+map_encoding->md_length);
+  // NM (Excluding clipping)
+  map_encoding->nm = (int32_t)encoder.nm - gt_map_get_left_trim_length(map_segment) - gt_map_get_right_trim_length(map_segment);
+  return error_code;
+}
+
 /*
  * GT-library PRE-Implemented Functional Attributes
  *   SAM specification predefined
@@ -338,13 +704,22 @@ GT_INLINE gt_status gt_sam_attribute_generate_NH(gt_sam_attribute_func_params* f
   return 0;
 }
 GT_INLINE void gt_sam_attributes_add_tag_NH(gt_sam_attributes* const sam_attributes) {
-  gt_sam_attributes_add_ifunc(sam_attributes,"NH",'i',gt_sam_attribute_generate_NH);
+  GT_SAM_ATTRIBUTES_CHECK(sam_attributes);
+  gt_sam_attribute* const sam_attribute = gt_alloc(gt_sam_attribute);
+  gt_sam_attribute_set_ifunc(sam_attribute,"NH",'i',gt_sam_attribute_generate_NH);
+  sam_attribute->scope = SAM_ATTR_SCOPE_RECORD;
+  gt_sam_attributes_add_attribute(sam_attributes,sam_attribute);
 }
 
 //  NM  i  Edit distance to the reference, including ambiguous bases but excluding clipping
 GT_INLINE gt_status gt_sam_attribute_generate_NM(gt_sam_attribute_func_params* func_params) {
   gt_map* const map = func_params->alignment_info->map;
   if (map == NULL) return -1; // Don't print NM field
+  // Already encoded along with the CIGAR
+  if (func_params->map_encoding!=NULL && func_params->map_encoding->map==map) {
+    func_params->return_i = func_params->map_encoding->nm;
+    return 0;
+  }
   // Get edit distance ( levenshtein distance )
   const int32_t edit_distance = gt_map_get_segment_levenshtein_distance(map);
   // Excluding clipping
@@ -358,6 +733,32 @@ GT_INLINE void gt_sam_attributes_add_tag_NM(gt_sam_attributes* const sam_attribu
   gt_sam_attributes_add_ifunc(sam_attributes,"NM",'i',gt_sam_attribute_generate_NM);
 }
 
+//  MD  Z  String for mismatching positions. Regex : [0-9]+(([A-Z]|\^[A-Z]+)[0-9]+)*
+GT_INLINE gt_status gt_sam_attribute_generate_MD(gt_sam_attribute_func_params* func_params) {
+  gt_map* const map = func_params->alignment_info->map;
+  if (map == NULL) return -1; // Don't print MD field
+  // Already encoded along with the CIGAR
+  gt_sam_map_encoding* const map_encoding = func_params->map_encoding;
+  if (map_encoding!=NULL && map_encoding->map==map && map_encoding->md_encoded) {
+    gt_string_set_nstring(func_params->return_s,
+        gt_string_get_string(func_params->map_encoding_buffer)+map_encoding->md_offset,map_encoding->md_length);
+    return 0;
+  }
+  // Encode it
+  gt_sam_map_encoding encoding;
+  gt_string_clear(func_params->return_s);
+  gt_sam_map_encode(func_params->return_s,map,false,true,func_params->sequence_archive,&encoding);
+  if (!encoding.md_encoded) return -1;
+  char* const buffer = gt_string_get_string(func_params->return_s);
+  memmove(buffer,buffer+encoding.md_offset,encoding.md_length);
+  buffer[encoding.md_length] = EOS;
+  gt_string_set_length(func_params->return_s,encoding.md_length);
+  return 0;
+}
+GT_INLINE void gt_sam_attributes_add_tag_MD(gt_sam_attributes* const sam_attributes) {
+  gt_sam_attributes_add_sfunc(sam_attributes,"MD",'Z',gt_sam_attribute_generate_MD);
+}
+
 //  RG  Z  Read group. Value matches the header RG-ID tag if @RG is present in the header.
 GT_INLINE void gt_sam_attributes_add_tag_RG(gt_sam_attributes* const sam_attributes,gt_string* const read_group) {
   gt_sam_attributes_add_svalue(sam_attributes,"RG",'Z',read_group);
@@ -378,50 +779,47 @@ GT_INLINE void gt_sam_attributes_add_tag_RG(gt_sam_attributes* const sam_attribu
  */
 typedef enum { GT_XT_UNIQUE, GT_XT_REPEAT, GT_XT_UNMAPPED, GT_XT_MATE_SW } gt_sam_xt_value;
 GT_INLINE gt_status gt_sam_attribute_generate_XT(gt_sam_attribute_func_params* func_params) {
-  char* xt_char_value_attr = gt_attributes_get(func_params->attributes,GT_ATTR_ID_SAM_TAG_XT);
-  char xt_char_value;
-  if (xt_char_value_attr==NULL) {
-    gt_sam_xt_value xt_value;
-    if (func_params->alignment_info->map==NULL) { // Unmapped
-      xt_value = GT_XT_UNMAPPED;
-    } else if (func_params->alignment_info->type==GT_MAP_PLACEHOLDER) {
-      if (func_params->alignment_info->single_end.template!=NULL) {
-        const int64_t uniq_degree = gt_template_get_uniq_degree(func_params->alignment_info->single_end.template);
-        xt_value = (uniq_degree!=GT_NO_STRATA) ? GT_XT_UNIQUE : GT_XT_REPEAT;
-      } else if (func_params->alignment_info->single_end.alignment!=NULL) {
-        const int64_t uniq_degree = gt_alignment_get_uniq_degree(func_params->alignment_info->single_end.alignment);
-        xt_value = (uniq_degree!=GT_NO_STRATA) ? GT_XT_UNIQUE : GT_XT_REPEAT;
-      } else {
-        return -1;
-      }
-    } else { // GT_MMAP_PLACEHOLDER_PAIRED, GT_MMAP_PLACEHOLDER_UNPAIRED
-      if (func_params->alignment_info->paired_end.template!=NULL) {
-        const int64_t uniq_degree = gt_template_get_uniq_degree(func_params->alignment_info->paired_end.template);
-        xt_value = (uniq_degree!=GT_NO_STRATA) ? GT_XT_UNIQUE : GT_XT_REPEAT;
-      } else {
-        return -1;
-      }
+  gt_sam_xt_value xt_value;
+  if (func_params->alignment_info->map==NULL) { // Unmapped
+    xt_value = GT_XT_UNMAPPED;
+  } else if (func_params->alignment_info->type==GT_MAP_PLACEHOLDER) {
+    if (func_params->alignment_info->single_end.template!=NULL) {
+      const int64_t uniq_degree = gt_template_get_uniq_degree(func_params->alignment_info->single_end.template);
+      xt_value = (uniq_degree!=GT_NO_STRATA) ? GT_XT_UNIQUE : GT_XT_REPEAT;
+    } else if (func_params->alignment_info->single_end.alignment!=NULL) {
+      const int64_t uniq_degree = gt_alignment_get_uniq_degree(func_params->alignment_info->single_end.alignment);
+      xt_value = (uniq_degree!=GT_NO_STRATA) ? GT_XT_UNIQUE : GT_XT_REPEAT;
+    } else {
+      return -1;
     }
-    // Set proper value to return
-    switch (xt_value) {
-      case GT_XT_UNIQUE:   xt_char_value = 'U'; break;
-      case GT_XT_REPEAT:   xt_char_value = 'R'; break;
-      case GT_XT_UNMAPPED: xt_char_value = 'N'; break;
-      case GT_XT_MATE_SW:  xt_char_value = 'M'; break;
-      default: return -1; break;
+  } else { // GT_MMAP_PLACEHOLDER_PAIRED, GT_MMAP_PLACEHOLDER_UNPAIRED
+    if (func_params->alignment_info->paired_end.template!=NULL) {
+      const int64_t uniq_degree = gt_template_get_uniq_degree(func_params->alignment_info->paired_end.template);
+      xt_value = (uniq_degree!=GT_NO_STRATA) ? GT_XT_UNIQUE : GT_XT_REPEAT;
+    } else {
+      return -1;
     }
-    // Save as Functional Internal Data (let's save computations)
-    xt_char_value_attr = &xt_char_value;
-    gt_attributes_add(func_params->attributes,GT_ATTR_ID_SAM_TAG_XT,&xt_char_value,char);
   }
   // Return value
+  char xt_char_value;
+  switch (xt_value) {
+    case GT_XT_UNIQUE:   xt_char_value = 'U'; break;
+    case GT_XT_REPEAT:   xt_char_value = 'R'; break;
+    case GT_XT_UNMAPPED: xt_char_value = 'N'; break;
+    case GT_XT_MATE_SW:  xt_char_value = 'M'; break;
+    default: return -1; break;
+  }
   gt_string_clear(func_params->return_s);
-  gt_string_append_char(func_params->return_s,*xt_char_value_attr);
+  gt_string_append_char(func_params->return_s,xt_char_value);
   gt_string_append_eos(func_params->return_s);
   return 0;
 }
 GT_INLINE void gt_sam_attributes_add_tag_XT(gt_sam_attributes* const sam_attributes) {
-  gt_sam_attributes_add_sfunc(sam_attributes,"XT",'A',gt_sam_attribute_generate_XT);
+  GT_SAM_ATTRIBUTES_CHECK(sam_attributes);
+  gt_sam_attribute* const sam_attribute = gt_alloc(gt_sam_attribute);
+  gt_sam_attribute_set_sfunc(sam_attribute,"XT",'A',gt_sam_attribute_generate_XT);
+  sam_attribute->scope = SAM_ATTR_SCOPE_RECORD; // Same value for all the maps of the record
+  gt_sam_attributes_add_attribute(sam_attributes,sam_attribute);
 }
 //  cs  Z  Casava TAG (if any)
 GT_INLINE gt_status gt_sam_attribute_generate_cs(gt_sam_attribute_func_params* func_params) {
@@ -455,7 +853,8 @@ GT_INLINE void gt_sam_attributes_add_tag_cs(gt_sam_attributes* const sam_attribu
 //  md  Z  GEM CIGAR String
 GT_INLINE gt_status gt_sam_attribute_generate_md(gt_sam_attribute_func_params* func_params) {
   if (func_params->alignment_info->map == NULL) return -1; // Don't print anything
-  // Print GEM CIGAR String into the buffer
+  // Print GEM CIGAR String into the buffer (the string printer appends)
+  gt_string_clear(func_params->return_s);
   gt_output_map_sprint_mismatch_string(func_params->return_s,func_params->alignment_info->map,NULL);
   return 0; // OK
 }
@@ -464,42 +863,74 @@ GT_INLINE void gt_sam_attributes_add_tag_md(gt_sam_attributes* const sam_attribu
 }
 
 //  XS  A  +/- directionality infomration for split reads
+GT_INLINE uint8_t gt_sam_attribute_XS_junction_strand(
+    gt_sequence_archive* const sequence_archive,gt_sam_splice_motifs* const splice_motifs,
+    gt_sam_junction_cache* const junction_cache,gt_map* const map_block,gt_map* const next_map_block) {
+  // Locate the intron [intron_begin,intron_end] (1-based, forward strand)
+  gt_map* const left_block = (gt_map_get_position(map_block)<=gt_map_get_position(next_map_block)) ? map_block : next_map_block;
+  gt_map* const right_block = (left_block==map_block) ? next_map_block : map_block;
+  const uint64_t intron_begin = gt_map_get_end_mapping_position(left_block)+1;
+  const uint64_t intron_end = gt_map_get_position(right_block)-1;
+  if (intron_end < intron_begin+(2*GT_SAM_SPLICE_MOTIF_LENGTH-1)) return GT_SAM_XS_UNKNOWN;
+  // Check the cache
+  gt_ihash* const junctions = gt_sam_junction_cache_get_junctions(junction_cache,gt_map_get_string_seq_name(map_block));
+  const bool cacheable = intron_end < GT_SAM_JUNCTION_CACHE_MAX_POSITION;
+  const int64_t junction_key = GT_SAM_JUNCTION_CACHE_KEY(intron_begin,intron_end);
+  if (cacheable) {
+    uint8_t* const cached_strand = gt_ihash_get(junctions,junction_key,uint8_t);
+    if (cached_strand!=NULL) return *cached_strand;
+  }
+  // Fetch the donor/acceptor dinucleotides & look up the motif
+  char* const contig = gt_string_get_string(junction_cache->contig_name);
+  uint64_t donor_word, acceptor_word;
+  uint8_t strand = GT_SAM_XS_UNKNOWN;
+  if (gt_sequence_archive_get_sequence_word(sequence_archive,contig,
+          intron_begin-1,GT_SAM_SPLICE_MOTIF_LENGTH,&donor_word)==GT_SEQUENCE_OK &&
+      gt_sequence_archive_get_sequence_word(sequence_archive,contig,
+          intron_end-GT_SAM_SPLICE_MOTIF_LENGTH,GT_SAM_SPLICE_MOTIF_LENGTH,&acceptor_word)==GT_SEQUENCE_OK) {
+    strand = gt_sam_splice_motifs_get_strand(splice_motifs,donor_word,acceptor_word);
+  }
+  if (cacheable) {
+    uint8_t* const cached_strand = gt_alloc(uint8_t);
+    *cached_strand = strand;
+    gt_ihash_insert(junctions,junction_key,cached_strand,uint8_t);
+  }
+  return strand;
+}
 GT_INLINE gt_status gt_sam_attribute_generate_XS(gt_sam_attribute_func_params* func_params) {
-  // do not print this for non split maps
-  if (func_params->alignment_info->map==NULL) { // Unmapped
-    return -1;
-  } else if (func_params->alignment_info->type==GT_MAP_PLACEHOLDER) {
-    gt_map* map = func_params->alignment_info->map;
-    if(!gt_map_has_next_block(map)){
-      return -1; // no split map
-    }else{
-      bool forward = gt_map_get_strand(map) == FORWARD;
-      // is the junction in the overlap ?
-      uint64_t junctions_start = gt_map_get_end_mapping_position(forward ? map: gt_map_get_next_block(map));
-      uint64_t junctions_end = gt_map_get_begin_mapping_position(forward ? gt_map_get_next_block(map): map);
-      gt_sequence_archive* index = func_params->sequence_archive;
-      gt_string* j_start = gt_string_new(8);
-      gt_string* j_end = gt_string_new(8);
-      gt_sequence_archive_get_sequence_string(index, gt_map_get_seq_name(map), gt_map_get_strand(map), junctions_start+1, 5, j_start);
-      gt_sequence_archive_get_sequence_string(index, gt_map_get_seq_name(map), gt_map_get_strand(map), junctions_end-1-5, 5, j_end);
-
-
-      gt_string_delete(j_start);
-      gt_string_delete(j_end);
+  gt_map* const map = func_params->alignment_info->map;
+  if (map==NULL) return -1; // Unmapped
+  if (func_params->sequence_archive==NULL) return -1; // No reference
+  // Junctions strand (all splice junctions must agree)
+  gt_sam_junction_cache* junction_cache = func_params->junction_cache;
+  gt_sam_splice_motifs* splice_motifs = func_params->splice_motifs;
+  uint8_t strand = GT_SAM_XS_UNKNOWN;
+  gt_map *map_block, *next_map_block;
+  for (map_block=map;(next_map_block=gt_map_get_next_block(map_block))!=NULL;map_block=next_map_block) {
+    if (!GT_MAP_IS_SAME_SEGMENT(map_block,next_map_block)) break; // Quimera
+    if (gt_map_get_junction(map_block)!=SPLICE) continue;
+    if (gt_expect_false(junction_cache==NULL)) {
+      junction_cache = func_params->junction_cache = gt_sam_junction_cache_new();
+    }
+    if (splice_motifs==NULL) {
+      if (junction_cache->default_motifs==NULL) {
+        junction_cache->default_motifs = gt_sam_splice_motifs_new();
+        gt_sam_splice_motifs_parse(junction_cache->default_motifs,GT_SAM_SPLICE_MOTIFS_DEFAULT);
+      }
+      splice_motifs = junction_cache->default_motifs;
     }
+    strand |= gt_sam_attribute_XS_junction_strand(
+        func_params->sequence_archive,splice_motifs,junction_cache,map_block,next_map_block);
+    if (strand==GT_SAM_XS_AMBIGUOUS) return -1;
   }
-//    // Set proper value to return
-//    switch (xt_value) {
-//      case GT_XT_UNIQUE:   xt_char_value = 'U'; break;
-//      case GT_XT_REPEAT:   xt_char_value = 'R'; break;
-//      case GT_XT_UNMAPPED: xt_char_value = 'N'; break;
-//      case GT_XT_MATE_SW:  xt_char_value = 'M'; break;
-//      default: return -1; break;
-//    }
-//    // Save as Functional Internal Data (let's save computations)
-//    xt_char_value_attr = &xt_char_value;
-//    gt_attributes_add(func_params->attributes,GT_ATTR_ID_SAM_TAG_XT,&xt_char_value,char);
-
+  // Set proper value to return
+  gt_string_clear(func_params->return_s);
+  switch (strand) {
+    case GT_SAM_XS_FORWARD: gt_string_append_char(func_params->return_s,'+'); break;
+    case GT_SAM_XS_REVERSE: gt_string_append_char(func_params->return_s,'-'); break;
+    default: return -1; break; // Not split or unknown motif (don't print this field)
+  }
+  gt_string_append_eos(func_params->return_s);
   return 0; // OK
 }
 GT_INLINE void gt_sam_attributes_add_tag_XS(gt_sam_attributes* const sam_attributes) {
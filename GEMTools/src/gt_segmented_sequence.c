@@ -123,6 +123,27 @@ GT_INLINE gt_status gt_segmented_sequence_get_sequence(
   gt_string_append_eos(string);
   return (i==length) ? GT_SEQUENCE_OK : GT_SEQUENCE_CHUNK_OUT_OF_RANGE;
 }
+/*
+ * Packs @num_chars(<=GT_CDNA_WORD_MAX_CHARS) encoded characters from @position into @word
+ *   (word-level reads from the compact blocks; see gt_cdna_string_get_word())
+ */
+GT_INLINE gt_status gt_segmented_sequence_get_word(
+    gt_segmented_sequence* const sequence,const uint64_t position,const uint64_t num_chars,uint64_t* const word) {
+  GT_SEGMENTED_SEQ_CHECK(sequence);
+  GT_ZERO_CHECK(num_chars);
+  GT_NULL_CHECK(word);
+  if (gt_expect_false(position+num_chars > sequence->sequence_total_length)) return GT_SEQUENCE_CHUNK_OUT_OF_RANGE;
+  const uint64_t pos_in_block = position%GT_SEQ_ARCHIVE_BLOCK_SIZE;
+  const uint64_t block_chars = GT_SEQ_ARCHIVE_BLOCK_SIZE-pos_in_block;
+  if (gt_expect_true(num_chars<=block_chars)) {
+    *word = gt_cdna_string_get_word(gt_segmented_sequence_get_block(sequence,position),pos_in_block,num_chars);
+  } else { // The word spans into the next segment
+    *word = gt_cdna_string_get_word(gt_segmented_sequence_get_block(sequence,position),pos_in_block,block_chars) |
+        (gt_cdna_string_get_word(gt_segmented_sequence_get_block(sequence,position+block_chars),0,num_chars-block_chars)
+            << (block_chars*GT_CDNA_WORD_CHAR_BITS));
+  }
+  return GT_SEQUENCE_OK;
+}
 
 /*
  * SegmentedSEQ Iterator
@@ -24,6 +24,7 @@ GT_INLINE gt_sequence_archive* gt_sequence_archive_new(const gt_sequence_archive
   if (sequence_archive_type == GT_BED_ARCHIVE) {
     seq_archive->bed_intervals = gt_shash_new();
   }
+  seq_archive->bed = NULL;
   seq_archive->mm = NULL;
   return seq_archive;
 }
@@ -44,6 +45,7 @@ GT_INLINE void gt_sequence_archive_clear(gt_sequence_archive* const seq_archive)
   if (seq_archive->mm!=NULL) {
     gt_mm_free(seq_archive->mm);
     seq_archive->mm = NULL;
+    seq_archive->bed = NULL;
   }
 }
 GT_INLINE void gt_sequence_archive_delete(gt_sequence_archive* const seq_archive) {
@@ -199,6 +201,28 @@ GT_INLINE gt_status gt_sequence_archive_retrieve_sequence_chunk(
   return 0;
 }
 
+GT_INLINE gt_status gt_sequence_archive_get_sequence_word(
+    gt_sequence_archive* const seq_archive,char* const seq_id,
+    const uint64_t position,const uint64_t num_chars,uint64_t* const word) {
+  GT_SEQUENCE_ARCHIVE_CHECK(seq_archive);
+  GT_NULL_CHECK(seq_id);
+  GT_NULL_CHECK(word);
+  switch (seq_archive->sequence_archive_type) {
+    case GT_CDNA_ARCHIVE: {
+      gt_segmented_sequence* const seg_seq = gt_sequence_archive_get_segmented_sequence(seq_archive,seq_id);
+      if (seg_seq==NULL) return GT_SEQUENCE_NOT_FOUND;
+      return gt_segmented_sequence_get_word(seg_seq,position,num_chars,word);
+    }
+    case GT_BED_ARCHIVE:
+      if (seq_archive->bed==NULL) return GT_SEQUENCE_NOT_FOUND; // Sequences not loaded
+      return (gt_gemIdx_get_bed_sequence_word(seq_archive,seq_id,position,num_chars,word) < 0) ?
+          GT_SEQUENCE_NOT_FOUND : GT_SEQUENCE_OK;
+    default:
+      gt_fatal_error(NOT_IMPLEMENTED);
+      break;
+  }
+  return GT_SEQUENCE_OK;
+}
 
 /*
  * SequenceARCHIVE sorting functions
@@ -152,6 +152,14 @@ GT_INLINE bool gt_shash_is_contained(gt_shash* const shash,char* const key) {
   GT_NULL_CHECK(key);
   return (gt_shash_get_shash_element(shash,key)!=NULL);
 }
+GT_INLINE bool gt_shash_is_contained_nstring(gt_shash* const shash,char* const key,const uint64_t key_length) {
+  GT_HASH_CHECK(shash);
+  GT_NULL_CHECK(key);
+  // Key need not be null-terminated (e.g. a static gt_string pointing into a text line)
+  gt_shash_element *shash_element;
+  HASH_FIND(hh,shash->shash_head,key,key_length,shash_element);
+  return (shash_element!=NULL);
+}
 GT_INLINE uint64_t gt_shash_get_num_elements(gt_shash* const shash) {
   GT_HASH_CHECK(shash);
   return (uint64_t)HASH_COUNT(shash->shash_head);
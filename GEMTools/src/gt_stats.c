@@ -248,8 +248,12 @@ GT_INLINE gt_population_profile* gt_population_profile_new() {
   population_profile->num_map_quimeras = 0;
   population_profile->num_pair_quimeras = 0;
   // Aux
-  population_profile->_local_diversity_hash = gt_shash_new();
-  population_profile->_global_diversity_hash = gt_shash_new();
+  population_profile->_contig_id_hash = gt_shash_new();
+  population_profile->_contig_names = gt_vector_new(GT_STATS_POPULATION_CONTIGS,sizeof(char*));
+  population_profile->_local_counts = gt_vector_new(GT_STATS_POPULATION_CONTIGS,sizeof(uint64_t));
+  population_profile->_local_touched = gt_vector_new(GT_STATS_POPULATION_CONTIGS,sizeof(uint64_t));
+  population_profile->_global_counts = gt_vector_new(GT_STATS_POPULATION_CONTIGS,sizeof(uint64_t));
+  population_profile->_last_contig_id = UINT64_MAX;
   return population_profile;
 }
 GT_INLINE void gt_population_profile_clear(gt_population_profile* const population_profile) {
@@ -262,13 +266,48 @@ GT_INLINE void gt_population_profile_clear(gt_population_profile* const populati
   population_profile->num_map_quimeras = 0;
   population_profile->num_pair_quimeras = 0;
   // Auxiliary
-  gt_shash_clear(population_profile->_local_diversity_hash,true);
-  gt_shash_clear(population_profile->_global_diversity_hash,true);
+  gt_shash_clear(population_profile->_contig_id_hash,true);
+  gt_vector_clear(population_profile->_contig_names);
+  gt_vector_clear(population_profile->_local_counts);
+  gt_vector_clear(population_profile->_local_touched);
+  gt_vector_clear(population_profile->_global_counts);
+  population_profile->_last_contig_id = UINT64_MAX;
 }
 GT_INLINE void gt_population_profile_delete(gt_population_profile* const population_profile) {
   gt_free(population_profile->local_diversity);
   gt_free(population_profile->local_dominant);
   gt_free(population_profile->local_diversity__dominant);
+  gt_shash_delete(population_profile->_contig_id_hash,true);
+  gt_vector_delete(population_profile->_contig_names);
+  gt_vector_delete(population_profile->_local_counts);
+  gt_vector_delete(population_profile->_local_touched);
+  gt_vector_delete(population_profile->_global_counts);
+  gt_free(population_profile);
+}
+/*
+ * Returns the (profile-local) ID of the contig, registering it if new.
+ *   Contig IDs are dense [0,num_contigs) so the counters are plain arrays.
+ */
+GT_INLINE uint64_t gt_population_profile_get_contig_id(
+    gt_population_profile* const population_profile,char* const seq_name,const uint64_t seq_name_length) {
+  // Check the last contig looked up
+  const uint64_t last_contig_id = population_profile->_last_contig_id;
+  if (last_contig_id!=UINT64_MAX) {
+    char* const last_seq_name = *gt_vector_get_elm(population_profile->_contig_names,last_contig_id,char*);
+    if (gt_strneq(last_seq_name,seq_name,seq_name_length) && last_seq_name[seq_name_length]==EOS) return last_contig_id;
+  }
+  // Lookup the contig
+  uint64_t* contig_id = gt_shash_get(population_profile->_contig_id_hash,seq_name,uint64_t);
+  if (contig_id==NULL) {
+    contig_id = gt_malloc_uint64();
+    *contig_id = gt_vector_get_used(population_profile->_contig_names);
+    char* const key = gt_shash_insert(population_profile->_contig_id_hash,seq_name,contig_id,uint64_t);
+    gt_vector_insert(population_profile->_contig_names,key,char*);
+    gt_vector_insert(population_profile->_local_counts,0,uint64_t);
+    gt_vector_insert(population_profile->_global_counts,0,uint64_t);
+  }
+  population_profile->_last_contig_id = *contig_id;
+  return *contig_id;
 }
 GT_INLINE void gt_population_profile_merge(
     gt_population_profile* const population_profile_dst,gt_population_profile* const population_profile_src) {
@@ -279,18 +318,17 @@ GT_INLINE void gt_population_profile_merge(
   // Quimeras
   population_profile_dst->num_map_quimeras += population_profile_src->num_map_quimeras;
   population_profile_dst->num_pair_quimeras += population_profile_src->num_pair_quimeras;
-  // Global diversity
-  GT_SHASH_BEGIN_ITERATE(population_profile_src->_global_diversity_hash,key,count_src,uint64_t) {
-    uint64_t* count_dst = gt_shash_get_element(population_profile_dst->_global_diversity_hash,key);
-    if (count_dst==NULL) {
-      count_dst = gt_malloc_uint64();
-      *count_dst = *count_src;
-      gt_shash_insert(population_profile_dst->_global_diversity_hash,key,count_dst,uint64_t);
-    } else {
-      *count_dst+=*count_src;
-    }
-  } GT_SHASH_END_ITERATE;
-  population_profile_dst->global_diversity = gt_shash_get_num_elements(population_profile_dst->_global_diversity_hash);
+  // Global diversity (Translate source contig IDs into destination contig IDs)
+  const uint64_t num_contigs_src = gt_vector_get_used(population_profile_src->_contig_names);
+  char** const contig_names_src = gt_vector_get_mem(population_profile_src->_contig_names,char*);
+  uint64_t* const global_counts_src = gt_vector_get_mem(population_profile_src->_global_counts,uint64_t);
+  uint64_t i;
+  for (i=0;i<num_contigs_src;++i) {
+    const uint64_t contig_id_dst = gt_population_profile_get_contig_id(
+        population_profile_dst,contig_names_src[i],gt_strlen(contig_names_src[i]));
+    *gt_vector_get_elm(population_profile_dst->_global_counts,contig_id_dst,uint64_t) += global_counts_src[i];
+  }
+  population_profile_dst->global_diversity = gt_vector_get_used(population_profile_dst->_contig_names);
 }
 
 /*
@@ -625,21 +663,24 @@ GT_INLINE void gt_stats_merge(gt_stats** const stats,const uint64_t stats_array_
 /*
  * Calculate stats
  */
-GT_INLINE void gt_stats_add_map_to_population(gt_shash* const diversity_hash,gt_string* const seq_name) {
-  uint64_t* count = gt_shash_get_element(diversity_hash,gt_string_get_string(seq_name));
-  if (count==NULL) {
-    count = gt_malloc_uint64();
-    *count = 1;
-    gt_shash_insert(diversity_hash,gt_string_get_string(seq_name),count,uint64_t);
-  } else {
-    ++(*count);
-  }
+GT_INLINE void gt_stats_add_map_to_population(gt_population_profile* const population_profile,gt_string* const seq_name) {
+  const uint64_t contig_id = gt_population_profile_get_contig_id(
+      population_profile,gt_string_get_string(seq_name),gt_string_get_length(seq_name));
+  // Local
+  uint64_t* const local_count = gt_vector_get_elm(population_profile->_local_counts,contig_id,uint64_t);
+  if ((*local_count)++ == 0) gt_vector_insert(population_profile->_local_touched,contig_id,uint64_t);
+  // Global
+  ++(*gt_vector_get_elm(population_profile->_global_counts,contig_id,uint64_t));
 }
-GT_INLINE uint64_t gt_stats_get_local_dominant(gt_shash* const diversity_hash) {
+GT_INLINE uint64_t gt_stats_get_local_dominant(gt_population_profile* const population_profile) {
+  // Computes the dominant contig and resets the touched counters
+  uint64_t* const local_counts = gt_vector_get_mem(population_profile->_local_counts,uint64_t);
   uint64_t local_dominant = 0;
-  GT_SHASH_BEGIN_ELEMENT_ITERATE(diversity_hash,count,uint64_t) {
-    if (local_dominant < *count) local_dominant = *count;
-  } GT_SHASH_END_ITERATE;
+  GT_VECTOR_ITERATE(population_profile->_local_touched,contig_id,contig_id_pos,uint64_t) {
+    if (local_dominant < local_counts[*contig_id]) local_dominant = local_counts[*contig_id];
+    local_counts[*contig_id] = 0;
+  }
+  gt_vector_clear(population_profile->_local_touched);
   return local_dominant;
 }
 GT_INLINE void gt_stats_make_population_profile(
@@ -649,13 +690,11 @@ GT_INLINE void gt_stats_make_population_profile(
   const uint64_t paired_map = (num_blocks_template==2);
   // Check population
   uint64_t num_maps=0;
-  gt_shash_clear(population_profile->_local_diversity_hash,true);
   // Iterate over all/best maps
   GT_TEMPLATE_ITERATE(template,mmap) {
     GT_MMAP_ITERATE(mmap,map,end_pos) {
       ++num_maps;
-      gt_stats_add_map_to_population(population_profile->_local_diversity_hash,map->seq_name);
-      gt_stats_add_map_to_population(population_profile->_global_diversity_hash,map->seq_name);
+      gt_stats_add_map_to_population(population_profile,map->seq_name);
       if (gt_map_segment_get_num_segments(map)>1) ++population_profile->num_map_quimeras;
     }
     if (paired_map) {
@@ -664,9 +703,9 @@ GT_INLINE void gt_stats_make_population_profile(
     // FIRST-MAP :: Break if we just proccess the first one
     if (stats_analysis->first_map) break;
   }
-  const uint64_t local_diversity = gt_shash_get_num_elements(population_profile->_local_diversity_hash);
+  const uint64_t local_diversity = gt_vector_get_used(population_profile->_local_touched);
   const uint64_t local_diversity_bucket = gt_stats_get_local_diversity_bucket(local_diversity);
-  const uint64_t local_dominant = gt_stats_get_local_dominant(population_profile->_local_diversity_hash);
+  const uint64_t local_dominant = gt_stats_get_local_dominant(population_profile);
   const uint64_t local_dominant_bucket = gt_stats_get_local_dominant_bucket(local_dominant,num_maps);
   ++population_profile->local_diversity[local_diversity_bucket];
   ++population_profile->local_dominant[local_dominant_bucket];
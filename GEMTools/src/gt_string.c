@@ -19,6 +19,17 @@
 /*
  * Constructor & Accessors
  */
+/*
+ * Buffer allocation (from the string's memory pool, if any)
+ */
+GT_INLINE char* gt_string_buffer_malloc(gt_string* const string,const uint64_t num_bytes) {
+  return (string->mm_pool!=NULL) ? gt_mm_pool_malloc(string->mm_pool,num_bytes) : gt_malloc(num_bytes);
+}
+GT_INLINE void gt_string_buffer_free(gt_string* const string) {
+  if (string->mm_pool!=NULL) gt_mm_pool_free(string->buffer);
+  else gt_free(string->buffer);
+}
+
 GT_INLINE gt_string* gt_string_new(const uint64_t initial_buffer_size) {
   gt_string* string = gt_alloc(gt_string);
   // Initialize string
@@ -30,6 +41,22 @@ GT_INLINE gt_string* gt_string_new(const uint64_t initial_buffer_size) {
   }
   string->allocated = initial_buffer_size;
   string->length = 0;
+  string->mm_pool = NULL;
+  return string;
+}
+GT_INLINE gt_string* gt_string_new_from_pool(gt_mm_pool* const mm_pool,const uint64_t initial_buffer_size) {
+  if (mm_pool==NULL) return gt_string_new(initial_buffer_size);
+  gt_string* string = gt_mm_pool_malloc(mm_pool,sizeof(gt_string));
+  string->mm_pool = mm_pool;
+  // Initialize string
+  if (gt_expect_true(initial_buffer_size>0)) {
+    string->buffer = gt_mm_pool_malloc(mm_pool,initial_buffer_size);
+    string->buffer[0] = EOS;
+  } else {
+    string->buffer = NULL;
+  }
+  string->allocated = initial_buffer_size;
+  string->length = 0;
   return string;
 }
 GT_INLINE gt_string* gt_string_set_new(const char* const string_src) {
@@ -40,13 +67,18 @@ GT_INLINE gt_string* gt_string_set_new(const char* const string_src) {
   string->allocated = length+1;
   gt_strncpy(string->buffer,string_src,length);
   string->length = length;
+  string->mm_pool = NULL;
   return string;
 }
 GT_INLINE void gt_string_resize(gt_string* const string,const uint64_t new_buffer_size) {
   GT_STRING_CHECK_BUFFER(string);
   if (string->allocated > 0 && string->allocated < new_buffer_size) {
-    string->buffer = realloc(string->buffer,new_buffer_size);
-    gt_cond_fatal_error(!string->buffer,MEM_REALLOC);
+    if (string->mm_pool!=NULL) {
+      string->buffer = gt_mm_pool_realloc(string->buffer,new_buffer_size);
+    } else {
+      string->buffer = realloc(string->buffer,new_buffer_size);
+      gt_cond_fatal_error(!string->buffer,MEM_REALLOC);
+    }
     string->allocated = new_buffer_size;
   }
 }
@@ -58,8 +90,9 @@ GT_INLINE void gt_string_clear(gt_string* const string) {
 }
 GT_INLINE void gt_string_delete(gt_string* const string) {
   GT_STRING_CHECK(string);
-  if (string->allocated) gt_free(string->buffer);
-  gt_free(string);
+  if (string->allocated) gt_string_buffer_free(string);
+  if (string->mm_pool!=NULL) gt_mm_pool_free(string);
+  else gt_free(string);
 }
 
 GT_INLINE bool gt_string_is_static(gt_string* const string) {
@@ -69,7 +102,7 @@ GT_INLINE bool gt_string_is_static(gt_string* const string) {
 GT_INLINE void gt_string_cast_static(gt_string* const string) {
   GT_STRING_CHECK(string);
   if (string->allocated > 0) {
-    gt_free(string->buffer);
+    gt_string_buffer_free(string);
     string->allocated = 0;
   }
   string->buffer = NULL;
@@ -81,10 +114,12 @@ GT_INLINE void gt_string_cast_dynamic(gt_string* const string,const uint64_t ini
     gt_string_cast_static(string);
   } else {
     if (string->buffer!=NULL) {
-      string->buffer = gt_strndup(string->buffer,string->length);
+      char* const buffer = gt_string_buffer_malloc(string,string->length+1);
+      gt_strncpy(buffer,string->buffer,string->length);
+      string->buffer = buffer;
       string->allocated = string->length+1;
     } else {
-      string->buffer = gt_malloc(initial_buffer_size);
+      string->buffer = gt_string_buffer_malloc(string,initial_buffer_size);
       string->buffer[0] = EOS;
     }
   }
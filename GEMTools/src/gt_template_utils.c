@@ -400,27 +400,63 @@ int gt_mmap_cmp_distance__score(gt_mmap* const mmap_a,gt_mmap* const mmap_b) {
 }
 /*
  * Template's Maps Sorting
+ *   MMaps bucketed by distance (stratum) and sorted by score within (same order as gt_mmap_cmp_distance__score(); stable)
+ *   @recalculate_distance => MMaps' distances (and the counters) are recalculated along
+ *     (same as gt_template_recalculate_counters{_no_splits}())
  */
+GT_INLINE void gt_template_sort_by_distance__score_(
+    gt_template* const template,const bool recalculate_distance,const bool no_split) {
+  const uint64_t num_mmap = gt_template_get_num_mmaps(template);
+  const uint64_t num_blocks = gt_template_get_num_blocks(template);
+  gt_counters_sort_key keys_buffer[GT_COUNTERS_SORT_STACK_KEYS];
+  gt_counters_sort_key* const keys = (num_mmap<=GT_COUNTERS_SORT_STACK_KEYS) ?
+      keys_buffer : gt_malloc(num_mmap*sizeof(gt_counters_sort_key));
+  gt_mmap* const mmaps = gt_vector_get_mem(template->mmaps,gt_mmap);
+  uint64_t i, j;
+  for (i=0;i<num_mmap;++i) {
+    if (recalculate_distance) {
+      uint64_t total_distance = 0;
+      for (j=0;j<num_blocks;++j) {
+        total_distance += (no_split) ?
+            gt_map_get_no_split_distance(mmaps[i].mmap[j]) : gt_map_get_global_distance(mmaps[i].mmap[j]);
+      }
+      mmaps[i].attributes.distance = total_distance;
+    }
+    keys[i].stratum = mmaps[i].attributes.distance;
+    keys[i].score = mmaps[i].attributes.gt_score;
+    keys[i].position = i;
+  }
+  gt_counters_stratum_sort(mmaps,num_mmap,sizeof(gt_mmap),keys,
+      (recalculate_distance) ? gt_template_get_counters_vector(template) : NULL);
+  if (keys!=keys_buffer) gt_free(keys);
+}
 GT_INLINE void gt_template_sort_by_distance__score(gt_template* const template) {
   GT_TEMPLATE_CHECK(template);
   GT_TEMPLATE_IF_REDUCES_TO_ALINGMENT(template,alignment) {
     return gt_alignment_sort_by_distance__score(alignment);
   } GT_TEMPLATE_END_REDUCTION;
-  // Sort
-  const uint64_t num_mmap = gt_template_get_num_mmaps(template);
-  qsort(gt_vector_get_mem(template->mmaps,gt_mmap),num_mmap,sizeof(gt_mmap),
-      (int (*)(const void *,const void *))gt_mmap_cmp_distance__score);
+  gt_template_sort_by_distance__score_(template,false,false);
 }
-
 GT_INLINE void gt_template_sort_by_distance__score_no_split(gt_template* const template) {
   GT_TEMPLATE_CHECK(template);
   GT_TEMPLATE_IF_REDUCES_TO_ALINGMENT(template,alignment) {
     return gt_alignment_sort_by_distance__score_no_split(alignment);
   } GT_TEMPLATE_END_REDUCTION;
-  // Sort
-  const uint64_t num_mmap = gt_template_get_num_mmaps(template);
-  qsort(gt_vector_get_mem(template->mmaps,gt_mmap),num_mmap,sizeof(gt_mmap),
-      (int (*)(const void *,const void *))gt_mmap_cmp_distance__score);
+  gt_template_sort_by_distance__score_(template,false,true);
+}
+GT_INLINE void gt_template_recalculate_counters_and_sort(gt_template* const template) {
+  GT_TEMPLATE_CHECK(template);
+  GT_TEMPLATE_IF_REDUCES_TO_ALINGMENT(template,alignment) {
+    return gt_alignment_recalculate_counters_and_sort(alignment);
+  } GT_TEMPLATE_END_REDUCTION;
+  gt_template_sort_by_distance__score_(template,true,false);
+}
+GT_INLINE void gt_template_recalculate_counters_and_sort_no_splits(gt_template* const template) {
+  GT_TEMPLATE_CHECK(template);
+  GT_TEMPLATE_IF_REDUCES_TO_ALINGMENT(template,alignment) {
+    return gt_alignment_recalculate_counters_and_sort_no_splits(alignment);
+  } GT_TEMPLATE_END_REDUCTION;
+  gt_template_sort_by_distance__score_(template,true,true);
 }
 /*
  * Template's MMaps Utils
@@ -490,6 +526,103 @@ GT_INLINE void gt_template_merge_template_mmaps_fx(
     template_dst->alg_dictionary = NULL;
   }
 }
+/*
+ * Merges the mmaps of all @templates_src into @template_dst, in order. Equivalent to calling
+ * @gt_template_merge_template_mmaps for each source, but the destination mmaps (and alignment
+ * blocks) are indexed just once
+ */
+#define GT_TEMPLATE_MMAP_INDEX_KEY_FACTOR 0x9E3779B97F4A7C15ull
+GT_INLINE int64_t gt_template_mmap_index_key(gt_map** const mmap,const uint64_t num_blocks) {
+  uint64_t key = 0, i;
+  for (i=0;i<num_blocks;++i) key = key*GT_TEMPLATE_MMAP_INDEX_KEY_FACTOR + gt_map_get_begin_mapping_position(mmap[i]);
+  return (int64_t)key;
+}
+GT_INLINE void gt_template_merge_template_mmaps_a(
+    gt_template* const template_dst,gt_template** const templates_src,const uint64_t num_src_templates) {
+  GT_TEMPLATE_CHECK(template_dst);
+  GT_NULL_CHECK(templates_src);
+  uint64_t i;
+  GT_TEMPLATE_IF_REDUCES_TO_ALINGMENT(template_dst,alignment_dst) {
+    gt_alignment** const alignments_src = gt_calloc(num_src_templates,gt_alignment*,false);
+    for (i=0;i<num_src_templates;++i) {
+      GT_TEMPLATE_CHECK(templates_src[i]);
+      GT_TEMPLATE_COMMON_CONSISTENCY_ERROR(template_dst,templates_src[i]);
+      alignments_src[i] = gt_template_get_block(templates_src[i],0);
+    }
+    gt_alignment_merge_alignment_maps_a(alignment_dst,alignments_src,num_src_templates);
+    gt_free(alignments_src);
+  } GT_TEMPLATE_END_REDUCTION__RETURN;
+  // Index mmaps & blocks' maps (only if there are enough mmaps to pay off)
+  const uint64_t num_blocks = gt_template_get_num_blocks(template_dst);
+  uint64_t total_mmaps = gt_template_get_num_mmaps(template_dst);
+  for (i=0;i<num_src_templates;++i) total_mmaps += gt_template_get_num_mmaps(templates_src[i]);
+  gt_alignment_map_index* mmap_index = NULL;
+  gt_alignment_map_index** const block_index = gt_calloc(num_blocks,gt_alignment_map_index*,true);
+  if (total_mmaps > GT_ALIGNMENT_MAP_INDEX_MIN_MAPS) {
+    mmap_index = gt_alignment_map_index_new();
+    GT_TEMPLATE_ITERATE_MMAP_(template_dst,mmap_dst) {
+      gt_alignment_map_index_add(mmap_index,gt_template_mmap_index_key(mmap_dst,num_blocks));
+    }
+    for (i=0;i<num_blocks;++i) {
+      block_index[i] = gt_alignment_map_index_new();
+      gt_alignment_map_index_build(block_index[i],gt_template_get_block(template_dst,i));
+    }
+  }
+  // Merge mmaps
+  gt_map** const uniq_mmaps = gt_calloc(num_blocks,gt_map*,false);
+  uint64_t s;
+  for (s=0;s<num_src_templates;++s) {
+    gt_template* const template_src = templates_src[s];
+    GT_TEMPLATE_CHECK(template_src);
+    GT_TEMPLATE_COMMON_CONSISTENCY_ERROR(template_dst,template_src);
+    GT_TEMPLATE_ITERATE_MMAP__ATTR(template_src,mmap,mmap_attr) {
+      gt_map** const mmap_copy = gt_mmap_array_copy(mmap,__mmap_num_blocks);
+      // Find duplicated mmap (always replaced, as in @gt_template_put_mmap)
+      const int64_t key = gt_template_mmap_index_key(mmap_copy,num_blocks);
+      uint64_t found_mmap_pos = GT_ALIGNMENT_MAP_INDEX_NIL, pos;
+      if (mmap_index!=NULL) {
+        for (pos=gt_alignment_map_index_first(mmap_index,key);pos!=GT_ALIGNMENT_MAP_INDEX_NIL;
+             pos=gt_alignment_map_index_next(mmap_index,pos)) {
+          if (gt_mmap_cmp(gt_template_get_mmap_array(template_dst,pos,NULL),mmap_copy,num_blocks)==0) {
+            found_mmap_pos = pos; break;
+          }
+        }
+      } else {
+        gt_map** found_mmap;
+        gt_mmap_attributes* found_mmap_attr;
+        if (!gt_template_find_mmap_fx(gt_mmap_cmp,template_dst,mmap_copy,&pos,&found_mmap,&found_mmap_attr)) {
+          pos = GT_ALIGNMENT_MAP_INDEX_NIL;
+        }
+        found_mmap_pos = pos;
+      }
+      // Resolve mmap aliasing/insertion
+      for (i=0;i<num_blocks;++i) {
+        uniq_mmaps[i] = gt_alignment_map_index_put_map(gt_map_cmp,
+            gt_template_get_block(template_dst,i),block_index[i],mmap_copy[i],false);
+      }
+      if (found_mmap_pos==GT_ALIGNMENT_MAP_INDEX_NIL) { // Add new mmap
+        gt_template_inc_counter(template_dst,mmap_attr->distance);
+        gt_template_add_mmap_array(template_dst,uniq_mmaps,mmap_attr);
+        if (mmap_index!=NULL) gt_alignment_map_index_add(mmap_index,key);
+      } else { // Replace mmap
+        gt_mmap_attributes* found_mmap_attr;
+        gt_template_get_mmap_array(template_dst,found_mmap_pos,&found_mmap_attr);
+        gt_template_dec_counter(template_dst,found_mmap_attr->distance);
+        gt_template_set_mmap_array(template_dst,found_mmap_pos,uniq_mmaps,mmap_attr);
+        gt_template_inc_counter(template_dst,mmap_attr->distance);
+      }
+      gt_free(mmap_copy); // Free array handler
+    }
+    gt_template_set_mcs(template_dst,GT_MIN(gt_template_get_mcs(template_dst),gt_template_get_mcs(template_src)));
+  }
+  // Free
+  gt_free(uniq_mmaps);
+  if (mmap_index!=NULL) {
+    for (i=0;i<num_blocks;++i) gt_alignment_map_index_delete(block_index[i]);
+    gt_alignment_map_index_delete(mmap_index);
+  }
+  gt_free(block_index);
+}
 GT_INLINE gt_template* gt_template_union_template_mmaps_v(
     const uint64_t num_src_templates,gt_template* const template_src,va_list v_args) {
   GT_ZERO_CHECK(num_src_templates);
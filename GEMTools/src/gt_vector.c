@@ -21,6 +21,18 @@ GT_INLINE gt_vector* gt_vector_new(size_t num_initial_elements,size_t element_si
   vector->elements_allocated=num_initial_elements;
   vector->memory=gt_malloc(num_initial_elements*element_size);
   vector->used=0;
+  vector->mm_pool=NULL;
+  return vector;
+}
+GT_INLINE gt_vector* gt_vector_new_from_pool(gt_mm_pool* const mm_pool,size_t num_initial_elements,size_t element_size) {
+  GT_ZERO_CHECK(element_size);
+  if (mm_pool==NULL) return gt_vector_new(num_initial_elements,element_size);
+  gt_vector* vector=gt_mm_pool_malloc(mm_pool,sizeof(gt_vector));
+  vector->element_size=element_size;
+  vector->elements_allocated=num_initial_elements;
+  vector->memory=gt_mm_pool_malloc(mm_pool,num_initial_elements*element_size);
+  vector->used=0;
+  vector->mm_pool=mm_pool;
   return vector;
 }
 GT_INLINE gt_status gt_vector_reserve(gt_vector* vector,size_t num_elements,bool zero_mem) {
@@ -28,8 +40,12 @@ GT_INLINE gt_status gt_vector_reserve(gt_vector* vector,size_t num_elements,bool
   if (vector->elements_allocated < num_elements) {
     size_t proposed=(float)vector->elements_allocated*GT_VECTOR_EXPAND_FACTOR;
     vector->elements_allocated=num_elements>proposed?num_elements:proposed;
-    vector->memory=realloc(vector->memory,vector->elements_allocated*vector->element_size);
-    if (!vector->memory) return GT_VECTOR_FAIL;
+    if (vector->mm_pool!=NULL) {
+      vector->memory=gt_mm_pool_realloc(vector->memory,vector->elements_allocated*vector->element_size);
+    } else {
+      vector->memory=realloc(vector->memory,vector->elements_allocated*vector->element_size);
+      if (!vector->memory) return GT_VECTOR_FAIL;
+    }
   }
   if (gt_expect_false(zero_mem)) {
     memset(vector->memory+vector->used*vector->element_size,0,
@@ -42,9 +58,14 @@ GT_INLINE gt_status gt_vector_resize__clear(gt_vector* vector,size_t num_element
   if (vector->elements_allocated < num_elements) {
     size_t proposed=(float)vector->elements_allocated*GT_VECTOR_EXPAND_FACTOR;
     vector->elements_allocated=num_elements>proposed?num_elements:proposed;
-    gt_free(vector->memory);
-    vector->memory=gt_malloc_nothrow(vector->elements_allocated,vector->element_size,0,0);
-    if (!vector->memory) return GT_VECTOR_FAIL;
+    if (vector->mm_pool!=NULL) {
+      gt_mm_pool_free(vector->memory);
+      vector->memory=gt_mm_pool_malloc(vector->mm_pool,vector->elements_allocated*vector->element_size);
+    } else {
+      gt_free(vector->memory);
+      vector->memory=gt_malloc_nothrow(vector->elements_allocated,vector->element_size,0,0);
+      if (!vector->memory) return GT_VECTOR_FAIL;
+    }
   }
   vector->used=0;
   return GT_VECTOR_OK;
@@ -58,8 +79,13 @@ GT_INLINE void gt_vector_cast__clear(gt_vector* vector,size_t element_size) {
 }
 GT_INLINE void gt_vector_delete(gt_vector* vector) {
   GT_VECTOR_CHECK(vector);
-  gt_free(vector->memory);
-  gt_free(vector);
+  if (vector->mm_pool!=NULL) {
+    gt_mm_pool_free(vector->memory);
+    gt_mm_pool_free(vector);
+  } else {
+    gt_free(vector->memory);
+    gt_free(vector);
+  }
 }
 GT_INLINE void gt_vector_copy(gt_vector* vector_to,gt_vector* vector_from) {
   GT_VECTOR_CHECK(vector_to); GT_VECTOR_CHECK(vector_from);
@@ -0,0 +1,199 @@
+/*
+ * PROJECT: GEM-Tools library
+ * FILE: gt_bench_mapq.c
+ * DATE: 19/10/2026
+ * DESCRIPTION: Microbenchmark of the template MAPQ engine (gt_map_score_template_mapq)
+ *   over synthetic multi-map templates. Checks MAPQ values against the former
+ *   hash-based implementation and reports the time per template of both.
+ */
+
+#include "gem_tools.h"
+
+#define GT_BENCH_MAPQ_NUM_SEQUENCES 4
+#define GT_BENCH_MAPQ_PHRED_KONST -0.23025850929940456840 // -log(10)/10;
+
+/*
+ * Former implementation (uthash keyed by seq_name+position, one malloc per location)
+ */
+void gt_bench_mapq_reference(gt_template* const template) {
+  typedef struct {
+    char *key;
+    double prob;
+    uint64_t score;
+    uint8_t phred;
+    UT_hash_handle hh;
+  } map_hash;
+  map_hash *mhash[3]={0,0,0}, *mp_hash, *tmp;
+  uint64_t min_score[3]={0xffff,0xffff,0xffff};
+  char buf[1024];
+  int rd;
+  {
+    GT_TEMPLATE_ITERATE_MMAP__ATTR_(template,maps,maps_attr) {
+      const uint64_t score=maps_attr->gt_score;
+      uint64_t seq_like[2],interval_like;
+      seq_like[0]=score&0xffff;
+      seq_like[1]=(score>>16)&0xffff;
+      interval_like=(score>>32)&0xff;
+      for(rd=0;rd<2;rd++) {
+        const size_t ssize=gt_string_get_length(maps[rd]->seq_name);
+        const size_t key_size=ssize+sizeof(maps[rd]->position);
+        memcpy(buf,gt_string_get_string(maps[rd]->seq_name),ssize);
+        memcpy(buf+ssize,&maps[rd]->position,sizeof(maps[rd]->position));
+        HASH_FIND(hh,mhash[rd],buf,key_size,mp_hash);
+        if(!mp_hash) {
+          mp_hash=malloc(sizeof(map_hash));
+          mp_hash->key=malloc(key_size);
+          memcpy(mp_hash->key,buf,key_size);
+          mp_hash->score=seq_like[rd];
+          HASH_ADD_KEYPTR(hh,mhash[rd],mp_hash->key,key_size,mp_hash);
+          if(seq_like[rd]<min_score[rd]) min_score[rd]=seq_like[rd];
+        }
+      }
+      const size_t ssize1=gt_string_get_length(maps[0]->seq_name);
+      const size_t ssize2=gt_string_get_length(maps[1]->seq_name);
+      const size_t key_size=ssize1+ssize2+2*sizeof(maps[0]->position);
+      memcpy(buf,gt_string_get_string(maps[0]->seq_name),ssize1);
+      memcpy(buf+ssize1,gt_string_get_string(maps[1]->seq_name),ssize2);
+      memcpy(buf+ssize1+ssize2,&maps[0]->position,sizeof(maps[0]->position));
+      memcpy(buf+ssize1+ssize2+sizeof(maps[0]->position),&maps[1]->position,sizeof(maps[0]->position));
+      HASH_FIND(hh,mhash[2],buf,key_size,mp_hash);
+      if(!mp_hash) {
+        mp_hash=malloc(sizeof(map_hash));
+        mp_hash->key=malloc(key_size);
+        memcpy(mp_hash->key,buf,key_size);
+        const uint64_t sc=seq_like[0]+seq_like[1]+interval_like;
+        mp_hash->score=sc;
+        HASH_ADD_KEYPTR(hh,mhash[2],mp_hash->key,key_size,mp_hash);
+        if(sc<min_score[2]) min_score[2]=sc;
+      }
+    }
+  }
+  for(rd=0;rd<3;rd++) if(mhash[rd]) {
+    double z=0.0;
+    for(mp_hash=mhash[rd];mp_hash;mp_hash=mp_hash->hh.next) {
+      mp_hash->prob=exp(GT_BENCH_MAPQ_PHRED_KONST*(double)(mp_hash->score-min_score[rd]));
+      z+=mp_hash->prob;
+    }
+    for(mp_hash=mhash[rd];mp_hash;mp_hash=mp_hash->hh.next) {
+      mp_hash->prob/=z;
+      if(1.0-mp_hash->prob<1.0e-255) mp_hash->phred=254;
+      else {
+        int tp=(int)(0.5+log(1.0-mp_hash->prob)/GT_BENCH_MAPQ_PHRED_KONST);
+        if(tp>254) tp=254;
+        mp_hash->phred=tp;
+      }
+    }
+  }
+  {
+    GT_TEMPLATE_ITERATE_MMAP__ATTR_(template,maps,maps_attr) {
+      for(rd=0;rd<2;rd++) {
+        const size_t ssize=gt_string_get_length(maps[rd]->seq_name);
+        memcpy(buf,gt_string_get_string(maps[rd]->seq_name),ssize);
+        memcpy(buf+ssize,&maps[rd]->position,sizeof(maps[rd]->position));
+        HASH_FIND(hh,mhash[rd],buf,ssize+sizeof(maps[rd]->position),mp_hash);
+        maps[rd]->phred_score=mp_hash->phred;
+      }
+      const size_t ssize1=gt_string_get_length(maps[0]->seq_name);
+      const size_t ssize2=gt_string_get_length(maps[1]->seq_name);
+      memcpy(buf,gt_string_get_string(maps[0]->seq_name),ssize1);
+      memcpy(buf+ssize1,gt_string_get_string(maps[1]->seq_name),ssize2);
+      memcpy(buf+ssize1+ssize2,&maps[0]->position,sizeof(maps[0]->position));
+      memcpy(buf+ssize1+ssize2+sizeof(maps[0]->position),&maps[1]->position,sizeof(maps[0]->position));
+      HASH_FIND(hh,mhash[2],buf,ssize1+ssize2+2*sizeof(maps[0]->position),mp_hash);
+      maps_attr->phred_score=mp_hash->phred;
+    }
+  }
+  for(rd=0;rd<3;rd++) {
+    HASH_ITER(hh,mhash[rd],mp_hash,tmp) {
+      HASH_DEL(mhash[rd],mp_hash);
+      free(mp_hash->key);
+      free(mp_hash);
+    }
+  }
+}
+
+/*
+ * Synthetic templates. @num_maps locations per end, each paired with up to 4 mates
+ *   (so ends are shared among mmaps) and scores spread over a few phred units.
+ */
+gt_template* gt_bench_mapq_template_new(const uint64_t num_maps,unsigned int* const seed) {
+  const char* const seq_names[GT_BENCH_MAPQ_NUM_SEQUENCES] = {"chr1","chr2","chr10","chrX"};
+  gt_template* const template = gt_template_new();
+  gt_alignment* const alignment_end[2] = {
+      gt_template_get_block_dyn(template,0), gt_template_get_block_dyn(template,1) };
+  uint64_t i, j, end;
+  for (end=0;end<2;++end) {
+    for (i=0;i<num_maps;++i) {
+      gt_map* const map = gt_map_new();
+      const char* const seq_name = seq_names[rand_r(seed)%GT_BENCH_MAPQ_NUM_SEQUENCES];
+      gt_map_set_seq_name(map,seq_name,strlen(seq_name));
+      gt_map_set_position(map,1+rand_r(seed)%(1+8*num_maps));
+      gt_alignment_add_map(alignment_end[end],map);
+    }
+  }
+  for (i=0;i<num_maps;++i) {
+    const uint64_t num_mates = 1+rand_r(seed)%4;
+    for (j=0;j<num_mates;++j) {
+      gt_mmap_attributes attr = { .distance=0, .phred_score=GT_MAP_NO_PHRED_SCORE };
+      const uint64_t like_end1 = rand_r(seed)%40, like_end2 = rand_r(seed)%40, interval_like = rand_r(seed)%20;
+      attr.gt_score = like_end1 | (like_end2<<16) | (interval_like<<32);
+      gt_template_add_mmap_ends(template,
+          gt_alignment_get_map(alignment_end[0],i),
+          gt_alignment_get_map(alignment_end[1],(i+j*7)%num_maps),&attr);
+    }
+  }
+  return template;
+}
+void gt_bench_mapq_get_phreds(gt_template* const template,gt_vector* const phreds) {
+  gt_vector_clear(phreds);
+  GT_TEMPLATE_ITERATE_MMAP__ATTR_(template,maps,maps_attr) {
+    gt_vector_insert(phreds,maps[0]->phred_score,uint8_t);
+    gt_vector_insert(phreds,maps[1]->phred_score,uint8_t);
+    gt_vector_insert(phreds,maps_attr->phred_score,uint8_t);
+  }
+}
+
+int main(int argc,char** argv) {
+  const uint64_t num_maps_list[] = {1, 4, 32, 256, 1024};
+  const uint64_t num_templates = 256;
+  const uint64_t num_rounds = (argc>1) ? atoll(argv[1]) : 20;
+  gt_vector* const phreds_reference = gt_vector_new(1024,sizeof(uint8_t));
+  gt_vector* const phreds = gt_vector_new(1024,sizeof(uint8_t));
+  gt_map_score_mapq_scratch* const scratch = gt_map_score_mapq_scratch_new();
+  gt_template** const templates = gt_calloc(num_templates,gt_template*,false);
+  bool all_equal = true;
+  uint64_t l, i, r;
+  fprintf(stdout,"%10s %16s %16s %8s\n","num_maps","reference(us)","table(us)","speedup");
+  for (l=0;l<sizeof(num_maps_list)/sizeof(uint64_t);++l) {
+    unsigned int seed = 17+l;
+    for (i=0;i<num_templates;++i) templates[i] = gt_bench_mapq_template_new(num_maps_list[l],&seed);
+    // Check
+    for (i=0;i<num_templates;++i) {
+      gt_bench_mapq_reference(templates[i]);
+      gt_bench_mapq_get_phreds(templates[i],phreds_reference);
+      gt_map_score_template_mapq(templates[i],scratch);
+      gt_bench_mapq_get_phreds(templates[i],phreds);
+      if (gt_vector_get_used(phreds)!=gt_vector_get_used(phreds_reference) ||
+          memcmp(gt_vector_get_mem(phreds,uint8_t),gt_vector_get_mem(phreds_reference,uint8_t),gt_vector_get_used(phreds))) {
+        fprintf(stderr,"MAPQ mismatch (num_maps=%"PRIu64", template=%"PRIu64")\n",num_maps_list[l],i);
+        all_equal = false;
+      }
+    }
+    // Time
+    struct timeval time_start, time_reference, time_table;
+    gettimeofday(&time_start,NULL);
+    for (r=0;r<num_rounds;++r) for (i=0;i<num_templates;++i) gt_bench_mapq_reference(templates[i]);
+    gettimeofday(&time_reference,NULL);
+    for (r=0;r<num_rounds;++r) for (i=0;i<num_templates;++i) gt_map_score_template_mapq(templates[i],scratch);
+    gettimeofday(&time_table,NULL);
+    const double reference_us = 1e6*GT_TIME_DIFF(time_start,time_reference)/(double)(num_rounds*num_templates);
+    const double table_us = 1e6*GT_TIME_DIFF(time_reference,time_table)/(double)(num_rounds*num_templates);
+    fprintf(stdout,"%10"PRIu64" %16.3f %16.3f %7.2fx\n",num_maps_list[l],reference_us,table_us,reference_us/table_us);
+    for (i=0;i<num_templates;++i) gt_template_delete(templates[i]);
+  }
+  gt_free(templates);
+  gt_map_score_mapq_scratch_delete(scratch);
+  gt_vector_delete(phreds);
+  gt_vector_delete(phreds_reference);
+  return all_equal ? EXIT_SUCCESS : EXIT_FAILURE;
+}
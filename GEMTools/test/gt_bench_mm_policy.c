@@ -0,0 +1,99 @@
+/*
+ * PROJECT: GEM-Tools library
+ * FILE: gt_bench_mm_policy.c
+ * DATE: 19/10/2026
+ * DESCRIPTION: Benchmark of the parse loop (buffered MAP input, multi-threaded) under each
+ *   memory policy for bulk buffers (GT_MM_POLICY). Usage: gt_bench_mm_policy [file.map] [threads] [rounds]
+ *   Without file, a synthetic one is built replicating datasets/gem.new.PE.map
+ */
+
+#include "gem_tools.h"
+
+#define GT_BENCH_MM_DATASET "../datasets/gem.new.PE.map"
+#define GT_BENCH_MM_SYNTHETIC "/tmp/gt_bench_mm_policy.map"
+#define GT_BENCH_MM_REPLICAS 500
+
+typedef struct {
+  gt_input_file* input_file;
+  uint64_t num_templates;
+} gt_bench_mm_thread;
+
+void* gt_bench_mm_parse(void* const thread_data) {
+  gt_bench_mm_thread* const bench_thread = thread_data;
+  gt_buffered_input_file* const buffered_input = gt_buffered_input_file_new(bench_thread->input_file);
+  gt_generic_parser_attributes* const parser_attr = gt_input_generic_parser_attributes_new(true);
+  gt_template* const template = gt_template_new();
+  gt_status error_code;
+  while ((error_code=gt_input_generic_parser_get_template(buffered_input,template,parser_attr))) {
+    if (error_code==GT_IMP_OK) ++bench_thread->num_templates;
+  }
+  gt_template_delete(template);
+  gt_input_generic_parser_attributes_delete(parser_attr);
+  gt_buffered_input_file_close(buffered_input);
+  return NULL;
+}
+
+double gt_bench_mm_run(char* const file_name,const uint64_t num_threads,uint64_t* const num_templates) {
+  gt_bench_mm_thread* const bench_threads = gt_calloc(num_threads,gt_bench_mm_thread,true);
+  pthread_t* const threads = gt_calloc(num_threads,pthread_t,false);
+  struct timeval time_start, time_end;
+  uint64_t i;
+  gettimeofday(&time_start,NULL);
+  gt_input_file* const input_file = gt_input_file_open(file_name,false);
+  for (i=0;i<num_threads;++i) {
+    bench_threads[i].input_file = input_file;
+    gt_cond_fatal_error(pthread_create(threads+i,NULL,gt_bench_mm_parse,bench_threads+i),SYS_THREAD);
+  }
+  *num_templates = 0;
+  for (i=0;i<num_threads;++i) {
+    pthread_join(threads[i],NULL);
+    *num_templates += bench_threads[i].num_templates;
+  }
+  gt_input_file_close(input_file);
+  gettimeofday(&time_end,NULL);
+  gt_free(threads);
+  gt_free(bench_threads);
+  return GT_TIME_DIFF(time_start,time_end);
+}
+
+void gt_bench_mm_synthetic_file() {
+  gt_mm* const dataset = gt_mm_bulk_load_file(GT_BENCH_MM_DATASET,1);
+  FILE* const file = fopen(GT_BENCH_MM_SYNTHETIC,"w");
+  gt_cond_fatal_error(file==NULL,FILE_OPEN,GT_BENCH_MM_SYNTHETIC);
+  uint64_t i;
+  for (i=0;i<GT_BENCH_MM_REPLICAS;++i) {
+    gt_cond_fatal_error(fwrite(gt_mm_get_base_mem(dataset),1,dataset->allocated,file)!=dataset->allocated,
+        FILE_WRITE,GT_BENCH_MM_SYNTHETIC);
+  }
+  fclose(file);
+  gt_mm_free(dataset);
+}
+
+int main(int argc,char** argv) {
+  const uint64_t policies[] = {
+      GT_MM_POLICY_DEFAULT, GT_MM_POLICY_THP, GT_MM_POLICY_NUMA, GT_MM_POLICY_THP|GT_MM_POLICY_NUMA };
+  const char* const policy_names[] = { "default", "thp", "numa", "thp,numa" };
+  char* const file_name = (argc>1) ? argv[1] : GT_BENCH_MM_SYNTHETIC;
+  const uint64_t num_threads = (argc>2) ? atoll(argv[2]) : sysconf(_SC_NPROCESSORS_ONLN);
+  const uint64_t num_rounds = (argc>3) ? atoll(argv[3]) : 3;
+  if (argc<=1) gt_bench_mm_synthetic_file();
+  // Warm up the page cache
+  uint64_t num_templates, reference_templates, p, r;
+  gt_mm_set_policy(GT_MM_POLICY_DEFAULT);
+  gt_bench_mm_run(file_name,num_threads,&reference_templates);
+  fprintf(stdout,"%"PRIu64" templates, %"PRIu64" threads\n",reference_templates,num_threads);
+  fprintf(stdout,"%10s %12s %14s\n","policy","best(s)","templates/s");
+  bool all_equal = true;
+  for (p=0;p<sizeof(policies)/sizeof(uint64_t);++p) {
+    gt_mm_set_policy(policies[p]);
+    double best_time = DBL_MAX;
+    for (r=0;r<num_rounds;++r) {
+      const double time = gt_bench_mm_run(file_name,num_threads,&num_templates);
+      if (time<best_time) best_time = time;
+      if (num_templates!=reference_templates) all_equal = false;
+    }
+    fprintf(stdout,"%10s %12.3f %14.0f\n",policy_names[p],best_time,(double)num_templates/best_time);
+  }
+  if (argc<=1) unlink(GT_BENCH_MM_SYNTHETIC);
+  return all_equal ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,139 @@
+/*
+ * PROJECT: GEM-Tools library
+ * FILE: gt_bench_strata_sort.c
+ * DATE: 19/10/2026
+ * DESCRIPTION: Microbenchmark of the template mmaps sorting (gt_template_recalculate_counters_and_sort_no_splits)
+ *   over synthetic paired templates. Checks the order and counters against the former
+ *   implementation (counters recalculation + qsort) and reports the time per template of both
+ *   (best of the rounds, the mean is too sensitive to scheduling noise to be quoted).
+ */
+
+#include "gem_tools.h"
+
+#define GT_BENCH_STRATA_SORT_MAX_DISTANCE 8
+#define GT_BENCH_STRATA_SORT_MIN_MMAPS 16384
+
+/*
+ * Former implementation (recalculation pass + qsort through the comparator)
+ */
+int gt_bench_strata_sort_cmp(gt_mmap* const mmap_a,gt_mmap* const mmap_b) {
+  const int64_t distance_a = mmap_a->attributes.distance;
+  const int64_t distance_b = mmap_b->attributes.distance;
+  if (distance_a != distance_b) return distance_a-distance_b;
+  const uint64_t score_a = mmap_a->attributes.gt_score;
+  const uint64_t score_b = mmap_b->attributes.gt_score;
+  return (score_a > score_b) ? -1 : (score_a < score_b ? 1 : 0);
+}
+void gt_bench_strata_sort_reference(gt_template* const template) {
+  gt_template_recalculate_counters_no_splits(template);
+  qsort(gt_vector_get_mem(template->mmaps,gt_mmap),gt_template_get_num_mmaps(template),sizeof(gt_mmap),
+      (int (*)(const void *,const void *))gt_bench_strata_sort_cmp);
+}
+
+/*
+ * Synthetic templates. @num_mmaps pairs with small distances and a few distinct scores (lots of ties)
+ */
+gt_template* gt_bench_strata_sort_template_new(const uint64_t num_mmaps,unsigned int* const seed) {
+  gt_template* const template = gt_template_new();
+  gt_alignment* const alignment_end[2] = {
+      gt_template_get_block_dyn(template,0), gt_template_get_block_dyn(template,1) };
+  uint64_t i, end;
+  for (i=0;i<num_mmaps;++i) {
+    gt_map* mmap[2];
+    for (end=0;end<2;++end) {
+      mmap[end] = gt_map_new();
+      gt_map_set_seq_name(mmap[end],"chr1",4);
+      gt_map_set_position(mmap[end],1+i);
+      gt_map_set_base_length(mmap[end],100);
+      const uint64_t num_misms = rand_r(seed)%(GT_BENCH_STRATA_SORT_MAX_DISTANCE/2);
+      uint64_t m;
+      for (m=0;m<num_misms;++m) {
+        gt_misms misms = { .misms_type=MISMS, .position=m*10, .base='A' };
+        gt_map_add_misms(mmap[end],&misms);
+      }
+      gt_alignment_add_map(alignment_end[end],mmap[end]);
+    }
+    gt_mmap_attributes attr = { .distance=0, .gt_score=rand_r(seed)%4, .phred_score=GT_MAP_NO_PHRED_SCORE };
+    gt_template_add_mmap_ends(template,mmap[0],mmap[1],&attr);
+  }
+  return template;
+}
+bool gt_bench_strata_sort_equal(gt_template* const template_a,gt_template* const template_b) {
+  const uint64_t num_mmaps = gt_template_get_num_mmaps(template_a);
+  uint64_t i;
+  for (i=0;i<num_mmaps;++i) {
+    gt_mmap* const mmap_a = gt_template_get_mmap(template_a,i);
+    gt_mmap* const mmap_b = gt_template_get_mmap(template_b,i);
+    if (gt_map_get_position(mmap_a->mmap[0])!=gt_map_get_position(mmap_b->mmap[0]) ||
+        mmap_a->attributes.distance!=mmap_b->attributes.distance) return false;
+  }
+  gt_vector* const counters_a = gt_template_get_counters_vector(template_a);
+  gt_vector* const counters_b = gt_template_get_counters_vector(template_b);
+  return gt_vector_get_used(counters_a)==gt_vector_get_used(counters_b) &&
+      memcmp(gt_vector_get_mem(counters_a,uint64_t),gt_vector_get_mem(counters_b,uint64_t),
+          gt_vector_get_used(counters_a)*sizeof(uint64_t))==0;
+}
+void gt_bench_strata_sort_shuffle(gt_template* const template,unsigned int* const seed) {
+  gt_mmap* const mmaps = gt_vector_get_mem(template->mmaps,gt_mmap);
+  uint64_t i;
+  for (i=gt_template_get_num_mmaps(template);i>1;--i) {
+    const uint64_t j = rand_r(seed)%i;
+    const gt_mmap mmap = mmaps[i-1]; mmaps[i-1] = mmaps[j]; mmaps[j] = mmap;
+  }
+}
+
+int main(int argc,char** argv) {
+  const uint64_t num_mmaps_list[] = {1, 4, 16, 64, 256, 1024, 10000};
+  const uint64_t max_templates = GT_BENCH_STRATA_SORT_MIN_MMAPS;
+  const uint64_t num_rounds = (argc>1) ? atoll(argv[1]) : 20;
+  gt_template** const templates = gt_calloc(max_templates,gt_template*,false);
+  gt_template** const templates_reference = gt_calloc(max_templates,gt_template*,false);
+  bool all_equal = true;
+  uint64_t l, i, r;
+  fprintf(stdout,"%10s %16s %16s %8s\n","num_mmaps","reference(us)","bucketed(us)","speedup");
+  for (l=0;l<sizeof(num_mmaps_list)/sizeof(uint64_t);++l) {
+    // At least GT_BENCH_STRATA_SORT_MIN_MMAPS mmaps per round (small templates are below the timer resolution)
+    const uint64_t num_templates = GT_MAX(64,GT_BENCH_STRATA_SORT_MIN_MMAPS/num_mmaps_list[l]);
+    unsigned int seed = 17+l;
+    for (i=0;i<num_templates;++i) {
+      templates[i] = gt_bench_strata_sort_template_new(num_mmaps_list[l],&seed);
+      templates_reference[i] = gt_template_dup(templates[i],true,true);
+    }
+    // Check
+    for (i=0;i<num_templates;++i) {
+      gt_bench_strata_sort_reference(templates_reference[i]);
+      gt_template_recalculate_counters_and_sort_no_splits(templates[i]);
+      if (!gt_bench_strata_sort_equal(templates[i],templates_reference[i])) {
+        fprintf(stderr,"Order mismatch (num_mmaps=%"PRIu64", template=%"PRIu64")\n",num_mmaps_list[l],i);
+        all_equal = false;
+      }
+    }
+    // Time (shuffled before each round; same permutation for both)
+    double reference_us = DBL_MAX, bucketed_us = DBL_MAX;
+    for (r=0;r<num_rounds;++r) {
+      struct timeval time_start, time_end;
+      unsigned int shuffle_seed = r;
+      for (i=0;i<num_templates;++i) gt_bench_strata_sort_shuffle(templates_reference[i],&shuffle_seed);
+      gettimeofday(&time_start,NULL);
+      for (i=0;i<num_templates;++i) gt_bench_strata_sort_reference(templates_reference[i]);
+      gettimeofday(&time_end,NULL);
+      reference_us = GT_MIN(reference_us,GT_TIME_DIFF(time_start,time_end));
+      shuffle_seed = r;
+      for (i=0;i<num_templates;++i) gt_bench_strata_sort_shuffle(templates[i],&shuffle_seed);
+      gettimeofday(&time_start,NULL);
+      for (i=0;i<num_templates;++i) gt_template_recalculate_counters_and_sort_no_splits(templates[i]);
+      gettimeofday(&time_end,NULL);
+      bucketed_us = GT_MIN(bucketed_us,GT_TIME_DIFF(time_start,time_end));
+    }
+    reference_us *= 1e6/(double)num_templates;
+    bucketed_us *= 1e6/(double)num_templates;
+    fprintf(stdout,"%10"PRIu64" %16.3f %16.3f %7.2fx\n",num_mmaps_list[l],reference_us,bucketed_us,reference_us/bucketed_us);
+    for (i=0;i<num_templates;++i) {
+      gt_template_delete(templates[i]);
+      gt_template_delete(templates_reference[i]);
+    }
+  }
+  gt_free(templates);
+  gt_free(templates_reference);
+  return all_equal ? EXIT_SUCCESS : EXIT_FAILURE;
+}
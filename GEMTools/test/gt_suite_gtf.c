@@ -15,6 +15,20 @@ void gt_gtf_setup(void) {
 void gt_gtf_teardown(void) {
 }
 
+/*
+ * The compiled annotation file is created/removed by the parent process,
+ * so it doesn't outlive a failed (forked) test
+ */
+char gtf_compiled_file[] = "/tmp/gt_utest_gtf_XXXXXX";
+
+void gt_gtf_compiled_setup(void) {
+  close(mkstemp(gtf_compiled_file));
+}
+
+void gt_gtf_compiled_teardown(void) {
+  unlink(gtf_compiled_file);
+}
+
 START_TEST(gt_test_gtf_entry_create)
 {
 	gt_string* type = gt_string_new(10);
@@ -152,6 +166,83 @@ START_TEST(gt_test_gtf_find_matches)
 }
 END_TEST
 
+START_TEST(gt_test_gtf_search_batch)
+{
+  FILE* fp = fopen("testdata/chr1.gtf", "r");
+  gt_gtf* gtf =  gt_gtf_read_from_stream(fp, 1);
+  fclose(fp);
+  gt_gtf_query queries[] = {
+      {"chr1", 1, 100},
+      {"chr1", 11900, 12230},
+      {NULL, 11900, 12230},
+      {"chrX", 1, 1000000000},
+      {"chr1", 14409, 69092},
+  };
+  gt_vector* target = gt_vector_new(5, sizeof(gt_gtf_entry*));
+  gt_vector* offsets = gt_vector_new(6, sizeof(uint64_t));
+  gt_vector* single = gt_vector_new(5, sizeof(gt_gtf_entry*));
+  gt_gtf_search_batch(gtf, target, offsets, queries, 5);
+  fail_unless(gt_vector_get_used(offsets) == 6, "Wrong number of offsets");
+  fail_unless(gt_vector_get_used(target) == 4, "Wrong number of hits");
+
+  // each query has to match the single search
+  uint64_t i, j;
+  for(i=0; i<5; i++){
+    const uint64_t begin = *gt_vector_get_elm(offsets, i, uint64_t);
+    const uint64_t end = *gt_vector_get_elm(offsets, i+1, uint64_t);
+    gt_vector_clear(single);
+    if(queries[i].ref != NULL) gt_gtf_search(gtf, single, queries[i].ref, queries[i].start, queries[i].end, true);
+    fail_unless(gt_vector_get_used(single) == end-begin, "Batch hits differ from single search");
+    for(j=0; j<end-begin; j++){
+      fail_unless(*gt_vector_get_elm(single, j, gt_gtf_entry*) == *gt_vector_get_elm(target, begin+j, gt_gtf_entry*), "Wrong hit order");
+    }
+  }
+
+  gt_vector_delete(single);
+  gt_vector_delete(offsets);
+  gt_vector_delete(target);
+  gt_gtf_delete(gtf);
+}
+END_TEST
+
+START_TEST(gt_test_gtf_compiled)
+{
+  FILE* fp = fopen("testdata/chr1.gtf", "r");
+  gt_gtf* gtf =  gt_gtf_read_from_stream(fp, 1);
+  fclose(fp);
+  char* const file_name = gtf_compiled_file;
+  gt_gtf_write_compiled(gtf, file_name);
+  fail_unless(gt_gtf_is_compiled(file_name), "Compiled annotation not detected");
+  fail_unless(!gt_gtf_is_compiled("testdata/chr1.gtf"), "GTF detected as compiled annotation");
+  gt_gtf* compiled = gt_gtf_read_from_file(file_name, 1);
+  fail_unless(gt_shash_get_num_elements(compiled->types)==gt_shash_get_num_elements(gtf->types), "Types not restored");
+  fail_unless(gt_shash_get_num_elements(compiled->refs)==gt_shash_get_num_elements(gtf->refs), "References not restored");
+  fail_unless(gt_gtf_contains_transcript_id(compiled, "NR_046018"), "Transcript ids not restored");
+
+  // searches have to return the same entries in the same order
+  gt_vector* hits = gt_vector_new(5, sizeof(gt_gtf_entry*));
+  gt_vector* compiled_hits = gt_vector_new(5, sizeof(gt_gtf_entry*));
+  const uint64_t ranges[][2] = {{1,100}, {11900,12230}, {14409,69092}, {1,1000000000}};
+  uint64_t i, j;
+  for(i=0; i<4; i++){
+    gt_gtf_search(gtf, hits, "chr1", ranges[i][0], ranges[i][1], true);
+    gt_gtf_search(compiled, compiled_hits, "chr1", ranges[i][0], ranges[i][1], true);
+    fail_unless(gt_vector_get_used(hits) == gt_vector_get_used(compiled_hits), "Compiled search differs");
+    for(j=0; j<gt_vector_get_used(hits); j++){
+      gt_gtf_entry* e = *gt_vector_get_elm(hits, j, gt_gtf_entry*);
+      gt_gtf_entry* c = *gt_vector_get_elm(compiled_hits, j, gt_gtf_entry*);
+      fail_unless(e->start == c->start && e->end == c->end && e->strand == c->strand, "Wrong compiled entry");
+      fail_unless(gt_string_equals(e->type, c->type), "Wrong compiled entry type");
+    }
+  }
+
+  gt_vector_delete(hits);
+  gt_vector_delete(compiled_hits);
+  gt_gtf_delete(compiled);
+  gt_gtf_delete(gtf);
+}
+END_TEST
+
 Suite *gt_gtf_suite(void) {
   Suite *s = suite_create("gt_gtf");
 
@@ -162,7 +253,14 @@ Suite *gt_gtf_suite(void) {
   tcase_add_test(tc_core,gt_test_gtf_read);
   tcase_add_test(tc_core,gt_test_gtf_search);
   tcase_add_test(tc_core,gt_test_gtf_find_matches);
+  tcase_add_test(tc_core,gt_test_gtf_search_batch);
   suite_add_tcase(s,tc_core);
 
+  /* Compiled annotation test case */
+  TCase *tc_compiled = tcase_create("gt gtf compiled");
+  tcase_add_unchecked_fixture(tc_compiled,gt_gtf_compiled_setup,gt_gtf_compiled_teardown);
+  tcase_add_test(tc_compiled,gt_test_gtf_compiled);
+  suite_add_tcase(s,tc_compiled);
+
   return s;
 }
@@ -63,6 +63,22 @@ START_TEST(gt_test_ihash_neg_key)
 }
 END_TEST
 
+START_TEST(gt_test_ihash_wide_key)
+{
+  // Keys sharing their lowest 32 bits
+  const int64_t key_a = (1ll<<32)|7, key_b = (2ll<<32)|7;
+  uint64_t* integer_a = gt_alloc(uint64_t);
+  uint64_t* integer_b = gt_alloc(uint64_t);
+  *integer_a = 1; *integer_b = 2;
+  gt_ihash_insert(ihash,key_a,integer_a,uint64_t);
+  gt_ihash_insert(ihash,key_b,integer_b,uint64_t);
+  fail_unless(gt_ihash_get_num_elements(ihash)==2,"Failed inserting 64-bit keys into ihash");
+  fail_unless(*gt_ihash_get(ihash,key_a,uint64_t)==1,"Failed retrieving 64-bit key from ihash");
+  fail_unless(*gt_ihash_get(ihash,key_b,uint64_t)==2,"Failed retrieving 64-bit key from ihash");
+  fail_unless(gt_ihash_get(ihash,7,uint64_t)==NULL,"Failed retrieving 64-bit key from ihash (lowest 32 bits match)");
+}
+END_TEST
+
 Suite *gt_ihash_suite(void) {
   Suite *s = suite_create("gt_ihash");
 
@@ -71,6 +87,7 @@ Suite *gt_ihash_suite(void) {
   tcase_add_checked_fixture(tc_core,gt_ihash_setup,gt_ihash_teardown);
   tcase_add_test(tc_core,gt_test_ihash_basic_insertions);
   tcase_add_test(tc_core,gt_test_ihash_neg_key);
+  tcase_add_test(tc_core,gt_test_ihash_wide_key);
   suite_add_tcase(s,tc_core);
 
   return s;
@@ -0,0 +1,134 @@
+/*
+ * PROJECT: GEM-Tools library
+ * FILE: gt_suite_mm.c
+ * DATE: 19/10/2026
+ * DESCRIPTION: Memory pools (gt_mm_pool) and bulk memory (gt_mm)
+ */
+
+#include "gt_test.h"
+
+#define GT_TEST_MM_NUM_ELEMENTS 10000
+
+gt_mm_pool* mm_pool;
+
+void gt_mm_setup(void) {
+  mm_pool = gt_mm_pool_new();
+}
+
+void gt_mm_teardown(void) {
+  gt_mm_pool_delete(mm_pool);
+}
+
+void* gt_test_mm_remote_free(void* elements) {
+  uint64_t i;
+  for (i=0;i<GT_TEST_MM_NUM_ELEMENTS;++i) gt_mm_pool_free(((void**)elements)[i]);
+  return NULL;
+}
+
+START_TEST(gt_test_mm_pool_size_classes)
+{
+  // Size classes
+  void* const small = gt_mm_pool_malloc(mm_pool,1);
+  void* const medium = gt_mm_pool_malloc(mm_pool,100);
+  void* const big = gt_mm_pool_malloc(mm_pool,GT_MM_POOL_MAX_SIZE_CLASS+1);
+  fail_unless(gt_mm_pool_get_capacity(small)==16,"Failed size class (1 byte)");
+  fail_unless(gt_mm_pool_get_capacity(medium)==128,"Failed size class (100 bytes)");
+  fail_unless(gt_mm_pool_get_capacity(big)==GT_MM_POOL_MAX_SIZE_CLASS+1,"Failed malloc fallback");
+  fail_unless(GT_MM_MEM_IS_ALIGNED(small,128b) && GT_MM_MEM_IS_ALIGNED(medium,128b),"Failed pool alignment");
+  fail_unless(gt_mm_pool_get_stats(mm_pool)->num_allocs==2,"Failed counting allocations");
+  fail_unless(gt_mm_pool_get_stats(mm_pool)->num_fallbacks==1,"Failed counting fallbacks");
+  // Free elements are reused
+  gt_mm_pool_free(medium);
+  fail_unless(gt_mm_pool_malloc(mm_pool,128)==medium,"Failed reusing freed element");
+  // Realloc keeps the content
+  strcpy(medium,"HELLO WORLD");
+  char* const grown = gt_mm_pool_realloc(medium,1000);
+  fail_unless(gt_mm_pool_get_capacity(grown)==1024,"Failed realloc size class");
+  fail_unless(strcmp(grown,"HELLO WORLD")==0,"Failed realloc content");
+  gt_mm_pool_free(grown);
+  gt_mm_pool_free(small);
+  gt_mm_pool_free(big);
+}
+END_TEST
+
+START_TEST(gt_test_mm_pool_vector_string)
+{
+  // Vector
+  gt_vector* const vector = gt_vector_new_from_pool(mm_pool,4,sizeof(uint64_t));
+  uint64_t i;
+  for (i=0;i<1000;++i) gt_vector_insert(vector,i,uint64_t);
+  fail_unless(gt_vector_get_used(vector)==1000,"Failed vector insertions");
+  for (i=0;i<1000;++i) {
+    fail_unless(*gt_vector_get_elm(vector,i,uint64_t)==i,"Failed vector content");
+  }
+  gt_vector_delete(vector);
+  // String
+  gt_string* const string = gt_string_new_from_pool(mm_pool,8);
+  for (i=0;i<100;++i) gt_string_append_string(string,"ACGT",4);
+  gt_string_append_eos(string);
+  fail_unless(gt_string_get_length(string)==400,"Failed string appends");
+  fail_unless(strncmp(gt_string_get_string(string)+396,"ACGT",4)==0,"Failed string content");
+  gt_string_delete(string);
+  // Everything went back to the pool
+  uint64_t num_alive = 0;
+  for (i=0;i<GT_MM_POOL_NUM_SIZE_CLASSES;++i) num_alive += mm_pool->slabs[i]->allocated_elements;
+  fail_unless(num_alive==0,"Failed returning memory to the pool");
+}
+END_TEST
+
+START_TEST(gt_test_mm_pool_remote_free)
+{
+  void** const elements = gt_calloc(GT_TEST_MM_NUM_ELEMENTS,void*,false);
+  pthread_t thread;
+  uint64_t i, num_units;
+  // Free from another thread
+  for (i=0;i<GT_TEST_MM_NUM_ELEMENTS;++i) elements[i] = gt_mm_pool_malloc(mm_pool,48);
+  num_units = gt_vector_get_used(mm_pool->slabs[2]->slabs_units);
+  fail_unless(pthread_create(&thread,NULL,gt_test_mm_remote_free,elements)==0,"Failed creating thread");
+  pthread_join(thread,NULL);
+  fail_unless(gt_mm_pool_get_stats(mm_pool)->num_remote_frees==GT_TEST_MM_NUM_ELEMENTS,"Failed counting remote frees");
+  // Remotely freed elements are reused by the owner
+  for (i=0;i<GT_TEST_MM_NUM_ELEMENTS;++i) elements[i] = gt_mm_pool_malloc(mm_pool,48);
+  fail_unless(gt_vector_get_used(mm_pool->slabs[2]->slabs_units)==num_units,"Failed reusing remote frees");
+  // Delete the pool with elements alive (last free releases it)
+  gt_mm_pool* const orphan_pool = mm_pool;
+  mm_pool = gt_mm_pool_new();
+  gt_mm_pool_delete(orphan_pool);
+  fail_unless(pthread_create(&thread,NULL,gt_test_mm_remote_free,elements)==0,"Failed creating thread");
+  pthread_join(thread,NULL);
+  gt_free(elements);
+}
+END_TEST
+
+START_TEST(gt_test_mm_bulk_mmalloc_hugepages)
+{
+  // The hugepage request rounds the mapping, not the usable size
+  const uint64_t num_bytes = 3000;
+  gt_mm* const mm = gt_mm_bulk_mmalloc(num_bytes,true);
+  fail_unless(mm->allocated==num_bytes,"Failed keeping the requested size");
+  fail_unless(mm->mapped>=num_bytes,"Failed recording the mapped size");
+  gt_mm_seek(mm,num_bytes-1);
+  fail_unless(!gt_mm_eom(mm),"Failed end-of-memory check (last byte)");
+  *((uint8_t*)gt_mm_get_mem(mm)) = 1;
+  gt_mm_free(mm);
+}
+END_TEST
+
+Suite *gt_mm_suite(void) {
+  Suite *s = suite_create("gt_mm");
+
+  /* Pool test case */
+  TCase *tc_pool = tcase_create("memory pool");
+  tcase_add_checked_fixture(tc_pool,gt_mm_setup,gt_mm_teardown);
+  tcase_add_test(tc_pool,gt_test_mm_pool_size_classes);
+  tcase_add_test(tc_pool,gt_test_mm_pool_vector_string);
+  tcase_add_test(tc_pool,gt_test_mm_pool_remote_free);
+  suite_add_tcase(s,tc_pool);
+
+  /* Bulk memory test case */
+  TCase *tc_bulk = tcase_create("bulk memory");
+  tcase_add_test(tc_bulk,gt_test_mm_bulk_mmalloc_hugepages);
+  suite_add_tcase(s,tc_bulk);
+
+  return s;
+}
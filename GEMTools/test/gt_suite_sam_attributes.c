@@ -0,0 +1,270 @@
+/*
+ * PROJECT: GEM-Tools library
+ * FILE: gt_suite_sam_attributes.c
+ * DATE: 19/10/2026
+ * DESCRIPTION: SAM map encoder (CIGAR, MD:Z, NM:i) & splice-site motifs (XS:A)
+ */
+
+#include "gt_test.h"
+
+#define GT_TEST_SAM_REFERENCE "ACGTTGCAAGGCTTAACCGGATCGATCGTAGCTAGCTAGGATCCATGCATGCAAGTCCGAT"
+/*
+ * Split-map contigs. 10nt exon, 20nt intron {donor,acceptor}, 10nt exon (intron at [11,30])
+ */
+#define GT_TEST_SAM_EXON_L "ACGTACGTAC"
+#define GT_TEST_SAM_EXON_R "TTGCATGCAA"
+#define GT_TEST_SAM_INTRON(donor,acceptor) donor "CCCCCCCCCCCCCCCC" acceptor
+#define GT_TEST_SAM_SPLIT_CONTIG(donor,acceptor) GT_TEST_SAM_EXON_L GT_TEST_SAM_INTRON(donor,acceptor) GT_TEST_SAM_EXON_R
+
+gt_sequence_archive* sequence_archive;
+gt_string* sam_buffer;
+
+void gt_sam_attributes_add_contig(const char* const name,const char* const contig) {
+  gt_segmented_sequence* const sequence = gt_segmented_sequence_new();
+  gt_segmented_sequence_set_name(sequence,(char*)name,strlen(name));
+  gt_segmented_sequence_append_string(sequence,(char*)contig,strlen(contig));
+  gt_sequence_archive_add_segmented_sequence(sequence_archive,sequence);
+}
+
+void gt_sam_attributes_setup(void) {
+  sequence_archive = gt_sequence_archive_new(GT_CDNA_ARCHIVE);
+  gt_sam_attributes_add_contig("chr1",GT_TEST_SAM_REFERENCE);
+  gt_sam_attributes_add_contig("gtag",GT_TEST_SAM_SPLIT_CONTIG("GT","AG"));
+  gt_sam_attributes_add_contig("ctac",GT_TEST_SAM_SPLIT_CONTIG("CT","AC"));
+  gt_sam_attributes_add_contig("ctgc",GT_TEST_SAM_SPLIT_CONTIG("CT","GC"));
+  gt_sam_attributes_add_contig("atac",GT_TEST_SAM_SPLIT_CONTIG("AT","AC"));
+  gt_sam_attributes_add_contig("gtat",GT_TEST_SAM_SPLIT_CONTIG("GT","AT"));
+  gt_sam_attributes_add_contig("ggtt",GT_TEST_SAM_SPLIT_CONTIG("GG","TT"));
+  gt_sam_attributes_add_contig("mixed", // GT-AG intron at [11,30] & CT-AC intron at [41,60]
+      GT_TEST_SAM_SPLIT_CONTIG("GT","AG") GT_TEST_SAM_INTRON("CT","AC") GT_TEST_SAM_EXON_L);
+  sam_buffer = gt_string_new(16);
+}
+
+void gt_sam_attributes_teardown(void) {
+  gt_sequence_archive_delete(sequence_archive);
+  gt_string_delete(sam_buffer);
+}
+
+/*
+ * Encodes @map_string and checks the CIGAR, the MD:Z (NULL if it can't be encoded) and the NM:i
+ */
+void gt_test_sam_encode(
+    const char* const map_string,const bool print_mismatches,gt_sequence_archive* const archive,
+    const char* const cigar,const char* const md,const int32_t nm) {
+  gt_map* map;
+  gt_sam_map_encoding map_encoding;
+  fail_unless(gt_input_map_parse_map(map_string,&map,NULL)==0,"Failed parsing map %s",map_string);
+  gt_string_clear(sam_buffer);
+  fail_unless(gt_sam_map_encode(sam_buffer,map,print_mismatches,true,archive,&map_encoding)==0,"Failed encoding %s",map_string);
+  const char* const mem = gt_string_get_string(sam_buffer);
+  fail_unless(map_encoding.cigar_length==strlen(cigar) &&
+      strncmp(mem+map_encoding.cigar_offset,cigar,map_encoding.cigar_length)==0,
+      "Wrong CIGAR for %s ('%.*s' instead of '%s')",map_string,
+      (int)map_encoding.cigar_length,mem+map_encoding.cigar_offset,cigar);
+  if (md==NULL) {
+    fail_unless(!map_encoding.md_encoded,"MD:Z shouldn't be encoded for %s",map_string);
+  } else {
+    fail_unless(map_encoding.md_encoded,"MD:Z not encoded for %s",map_string);
+    fail_unless(map_encoding.md_length==strlen(md) &&
+        strncmp(mem+map_encoding.md_offset,md,map_encoding.md_length)==0,
+        "Wrong MD:Z for %s ('%.*s' instead of '%s')",map_string,
+        (int)map_encoding.md_length,mem+map_encoding.md_offset,md);
+  }
+  fail_unless(map_encoding.nm==nm,"Wrong NM:i for %s (%d instead of %d)",map_string,map_encoding.nm,nm);
+  gt_map_delete(map);
+}
+
+START_TEST(gt_test_sam_encode_mismatches)
+{
+  gt_test_sam_encode("chr1:+:11:10",false,sequence_archive,"10M","10",0);
+  gt_test_sam_encode("chr1:+:11:5A4",false,sequence_archive,"10M","5A4",1);
+  gt_test_sam_encode("chr1:+:11:5A4",true,sequence_archive,"5=1X4=","5A4",1);
+  gt_test_sam_encode("chr1:+:11:A8C",false,sequence_archive,"10M","0A8C0",2);
+  // Reverse strand (mismatch bases complemented, reference order)
+  gt_test_sam_encode("chr1:-:11:5A4",false,sequence_archive,"10M","4T5",1);
+  gt_test_sam_encode("chr1:-:11:2A3G3",false,sequence_archive,"10M","3C3T2",2);
+  gt_test_sam_encode("chr1:-:11:5A4",true,sequence_archive,"4=1X5=","4T5",1);
+  gt_test_sam_encode("chr1:-:11:2A3G3",true,sequence_archive,"3=1X3=1X2=","3C3T2",2);
+  gt_test_sam_encode("chr1:-:11:4>2-A3",true,sequence_archive,"3=1X2I4=","3T4",3);
+}
+END_TEST
+
+START_TEST(gt_test_sam_encode_indels)
+{
+  // Insertion (GEM '-' skip)
+  gt_test_sam_encode("chr1:+:11:5>2-3",false,sequence_archive,"5M2I3M","8",2);
+  gt_test_sam_encode("chr1:+:11:2C2>2-3",false,sequence_archive,"5M2I3M","2C5",3);
+  gt_test_sam_encode("chr1:-:11:3>2-5",false,sequence_archive,"5M2I3M","8",2);
+  // Deletion (GEM '+' skip). Deleted bases taken from the reference
+  gt_test_sam_encode("chr1:+:11:5>2+5",false,sequence_archive,"5M2D5M","5^AC5",2);
+  gt_test_sam_encode("chr1:+:11:5>2+5",false,NULL,"5M2D5M",NULL,2);
+  gt_test_sam_encode("chr1:-:11:4>2+6",false,sequence_archive,"6M2D4M","6^CC4",2);
+  gt_test_sam_encode("chr1:+:11:2T2>3+5",false,sequence_archive,"5M3D5M","2T2^ACC5",4);
+}
+END_TEST
+
+START_TEST(gt_test_sam_encode_splits)
+{
+  gt_test_sam_encode("chr1:+:11:5>20*5",false,sequence_archive,"5M20N5M","10",0);
+  gt_test_sam_encode("chr1:+:11:2A2>20*3C1",false,sequence_archive,"5M20N5M","2A5C1",2);
+  gt_test_sam_encode("chr1:-:11:5>20*5",false,sequence_archive,"5M20N5M","10",0);
+  gt_test_sam_encode("chr1:-:11:2A2>20*3C1",false,sequence_archive,"5M20N5M","1G5T2",2);
+}
+END_TEST
+
+/*
+ * Packed word of @motif (as gt_cdna_string_get_word(), first character at the least significant bits)
+ */
+uint64_t gt_test_sam_motif_word(const char* const motif) {
+  uint64_t i, word = 0;
+  for (i=0;i<strlen(motif);++i) {
+    word |= ((uint64_t)gt_cdna_encode[(uint8_t)motif[i]]) << (i*GT_CDNA_WORD_CHAR_BITS);
+  }
+  return word;
+}
+uint8_t gt_test_sam_motif_strand(gt_sam_splice_motifs* const splice_motifs,const char* const donor,const char* const acceptor) {
+  return gt_sam_splice_motifs_get_strand(splice_motifs,gt_test_sam_motif_word(donor),gt_test_sam_motif_word(acceptor));
+}
+/*
+ * Generates the XS:A of @map_string and checks it (EOS if the field shouldn't be printed)
+ */
+void gt_test_sam_XS(const char* const map_string,gt_sam_splice_motifs* const splice_motifs,const char xs) {
+  gt_map* map;
+  fail_unless(gt_input_map_parse_map(map_string,&map,NULL)==0,"Failed parsing map %s",map_string);
+  gt_sam_attributes* const sam_attributes = gt_sam_attributes_new();
+  gt_sam_attributes_add_tag_XS(sam_attributes);
+  gt_sam_attribute* xs_attribute = NULL;
+  GT_SAM_ATTRIBUTES_BEGIN_ITERATE(sam_attributes,sam_attribute) {
+    xs_attribute = sam_attribute;
+  } GT_SAM_ATTRIBUTES_END_ITERATE;
+  fail_unless(xs_attribute!=NULL && xs_attribute->tag[0]=='X' && xs_attribute->tag[1]=='S');
+  gt_sam_attribute_func_params* const func_params = gt_sam_attribute_func_params_new();
+  gt_map_placeholder map_placeholder;
+  map_placeholder.map = map;
+  gt_sam_attribute_func_params_set_alignment_info(func_params,&map_placeholder);
+  gt_sam_attribute_func_params_set_sequence_archive(func_params,sequence_archive);
+  gt_sam_attribute_func_params_set_splice_motifs(func_params,splice_motifs);
+  // Twice (the second one answered from the junction cache)
+  uint64_t i;
+  for (i=0;i<2;++i) {
+    const gt_status status = xs_attribute->s_func(func_params);
+    if (xs==EOS) {
+      fail_unless(status!=0,"XS:A shouldn't be printed for %s",map_string);
+    } else {
+      fail_unless(status==0,"XS:A not printed for %s",map_string);
+      fail_unless(gt_string_get_string(func_params->return_s)[0]==xs,"Wrong XS:A for %s ('%c' instead of '%c')",
+          map_string,gt_string_get_string(func_params->return_s)[0],xs);
+    }
+  }
+  gt_sam_attribute_func_params_delete(func_params);
+  gt_sam_attributes_delete(sam_attributes);
+  gt_map_delete(map);
+}
+
+START_TEST(gt_test_sam_splice_motifs_word)
+{
+  // Words read from the reference (0-based) agree with the encoding of the motifs
+  const uint64_t length = strlen(GT_TEST_SAM_REFERENCE);
+  uint64_t num_chars, position, word;
+  for (num_chars=1;num_chars<=8;++num_chars) {
+    for (position=0;position+num_chars<=length;++position) {
+      char motif[9];
+      strncpy(motif,GT_TEST_SAM_REFERENCE+position,num_chars); motif[num_chars]=EOS;
+      fail_unless(gt_sequence_archive_get_sequence_word(sequence_archive,"chr1",position,num_chars,&word)==GT_SEQUENCE_OK);
+      fail_unless(word==gt_test_sam_motif_word(motif),"Wrong word at %"PRIu64" (%s)",position,motif);
+    }
+  }
+  fail_unless(gt_sequence_archive_get_sequence_word(sequence_archive,"gtag",10,2,&word)==GT_SEQUENCE_OK);
+  fail_unless(word==gt_test_sam_motif_word("GT"));
+  fail_unless(gt_sequence_archive_get_sequence_word(sequence_archive,"gtag",28,2,&word)==GT_SEQUENCE_OK);
+  fail_unless(word==gt_test_sam_motif_word("AG"));
+  // Out of range/unknown contig
+  fail_unless(gt_sequence_archive_get_sequence_word(sequence_archive,"chr1",length-1,2,&word)!=GT_SEQUENCE_OK);
+  fail_unless(gt_sequence_archive_get_sequence_word(sequence_archive,"chrX",0,2,&word)==GT_SEQUENCE_NOT_FOUND);
+}
+END_TEST
+
+START_TEST(gt_test_sam_splice_motifs_table)
+{
+  gt_sam_splice_motifs* const splice_motifs = gt_sam_splice_motifs_new();
+  fail_unless(gt_sam_splice_motifs_parse(splice_motifs,GT_SAM_SPLICE_MOTIFS_DEFAULT)==0);
+  // Canonical (forward) & their reverse complement (reverse)
+  fail_unless(gt_test_sam_motif_strand(splice_motifs,"GT","AG")==GT_SAM_XS_FORWARD);
+  fail_unless(gt_test_sam_motif_strand(splice_motifs,"GC","AG")==GT_SAM_XS_FORWARD);
+  fail_unless(gt_test_sam_motif_strand(splice_motifs,"AT","AC")==GT_SAM_XS_FORWARD);
+  fail_unless(gt_test_sam_motif_strand(splice_motifs,"CT","AC")==GT_SAM_XS_REVERSE);
+  fail_unless(gt_test_sam_motif_strand(splice_motifs,"CT","GC")==GT_SAM_XS_REVERSE);
+  fail_unless(gt_test_sam_motif_strand(splice_motifs,"GT","AT")==GT_SAM_XS_REVERSE);
+  // Non-canonical
+  fail_unless(gt_test_sam_motif_strand(splice_motifs,"GG","TT")==GT_SAM_XS_UNKNOWN);
+  fail_unless(gt_test_sam_motif_strand(splice_motifs,"AG","GT")==GT_SAM_XS_UNKNOWN);
+  fail_unless(gt_test_sam_motif_strand(splice_motifs,"AC","CT")==GT_SAM_XS_UNKNOWN);
+  // Custom motifs replace the defaults
+  gt_sam_splice_motifs_clear(splice_motifs);
+  fail_unless(gt_sam_splice_motifs_parse(splice_motifs,"GG-TT")==0);
+  fail_unless(gt_test_sam_motif_strand(splice_motifs,"GG","TT")==GT_SAM_XS_FORWARD);
+  fail_unless(gt_test_sam_motif_strand(splice_motifs,"AA","CC")==GT_SAM_XS_REVERSE);
+  fail_unless(gt_test_sam_motif_strand(splice_motifs,"GT","AG")==GT_SAM_XS_UNKNOWN);
+  // Its own reverse complement (both strands)
+  fail_unless(gt_sam_splice_motifs_parse(splice_motifs,"AT-AT,gc-ag")==0);
+  fail_unless(gt_test_sam_motif_strand(splice_motifs,"AT","AT")==GT_SAM_XS_AMBIGUOUS);
+  fail_unless(gt_test_sam_motif_strand(splice_motifs,"GC","AG")==GT_SAM_XS_FORWARD);
+  fail_unless(gt_test_sam_motif_strand(splice_motifs,"GG","TT")==GT_SAM_XS_FORWARD);
+  // Malformed lists
+  fail_unless(gt_sam_splice_motifs_parse(splice_motifs,"GT-A")!=0);
+  fail_unless(gt_sam_splice_motifs_parse(splice_motifs,"GTAG")!=0);
+  fail_unless(gt_sam_splice_motifs_parse(splice_motifs,"GTA-AG")!=0);
+  fail_unless(gt_sam_splice_motifs_parse(splice_motifs,"GT-AG,")!=0);
+  fail_unless(gt_sam_splice_motifs_parse(splice_motifs,"GT-AG;GC-AG")!=0);
+  fail_unless(gt_sam_splice_motifs_parse(splice_motifs,"GN-AG")!=0);
+  gt_sam_splice_motifs_delete(splice_motifs);
+}
+END_TEST
+
+START_TEST(gt_test_sam_XS_split_maps)
+{
+  // Default motifs (the strand of the read doesn't matter)
+  gt_test_sam_XS("gtag:+:1:10>20*10",NULL,'+');
+  gt_test_sam_XS("gtag:-:1:10>20*10",NULL,'+');
+  gt_test_sam_XS("atac:+:1:2A7>20*10",NULL,'+');
+  gt_test_sam_XS("ctac:+:1:10>20*10",NULL,'-');
+  gt_test_sam_XS("ctgc:-:1:10>20*10",NULL,'-');
+  gt_test_sam_XS("gtat:+:1:10>20*10",NULL,'-');
+  // Non-canonical
+  gt_test_sam_XS("ggtt:+:1:10>20*10",NULL,EOS);
+  // Not split / not a splice junction / contradictory junctions
+  gt_test_sam_XS("gtag:+:1:10",NULL,EOS);
+  gt_test_sam_XS("gtag:+:1:10>20+10",NULL,EOS);
+  gt_test_sam_XS("mixed:+:1:10>20*10",NULL,'+');
+  gt_test_sam_XS("mixed:-:31:10>20*10",NULL,'-');
+  gt_test_sam_XS("mixed:+:1:10>20*10>20*10",NULL,EOS);
+  // Custom motifs
+  gt_sam_splice_motifs* const splice_motifs = gt_sam_splice_motifs_new();
+  fail_unless(gt_sam_splice_motifs_parse(splice_motifs,"GG-TT")==0);
+  gt_test_sam_XS("ggtt:+:1:10>20*10",splice_motifs,'+');
+  gt_test_sam_XS("gtag:+:1:10>20*10",splice_motifs,EOS);
+  gt_sam_splice_motifs_delete(splice_motifs);
+}
+END_TEST
+
+Suite *gt_sam_attributes_suite(void) {
+  Suite *s = suite_create("gt_sam_attributes");
+
+  /* SAM map encoder test case */
+  TCase *tc_encoder = tcase_create("SAM map encoder");
+  tcase_add_checked_fixture(tc_encoder,gt_sam_attributes_setup,gt_sam_attributes_teardown);
+  tcase_add_test(tc_encoder,gt_test_sam_encode_mismatches);
+  tcase_add_test(tc_encoder,gt_test_sam_encode_indels);
+  tcase_add_test(tc_encoder,gt_test_sam_encode_splits);
+  suite_add_tcase(s,tc_encoder);
+
+  /* Splice-site motifs (XS:A) test case */
+  TCase *tc_splice_motifs = tcase_create("Splice-site motifs (XS)");
+  tcase_add_checked_fixture(tc_splice_motifs,gt_sam_attributes_setup,gt_sam_attributes_teardown);
+  tcase_add_test(tc_splice_motifs,gt_test_sam_splice_motifs_word);
+  tcase_add_test(tc_splice_motifs,gt_test_sam_splice_motifs_table);
+  tcase_add_test(tc_splice_motifs,gt_test_sam_XS_split_maps);
+  suite_add_tcase(s,tc_splice_motifs);
+
+  return s;
+}
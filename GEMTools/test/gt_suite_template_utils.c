@@ -257,6 +257,29 @@ START_TEST(gt_test_loosing_alignments)
 }
 END_TEST
 
+START_TEST(gt_test_template_sort_by_distance__score)
+{
+  // SE: bucketed by distance, stable within ties; counters rebuilt along
+  fail_unless(gt_input_map_parse_template(
+      "ID\tACGT\t####\t0:0:7\tchr1:+:10:A3,chr2:+:20:4,chr3:+:30:AC2,chr4:+:40:3T,chr5:+:50:4",source)==0);
+  gt_template_recalculate_counters_and_sort(source);
+  gt_string* string = gt_string_new(1024);
+  gt_output_map_sprint_template(string,source,output_attributes);
+  char* line = gt_string_get_string(string);
+  fail_unless(gt_streq(line,"ID\tACGT\t####\t2:2:1\tchr2:+:20:4,chr5:+:50:4,chr1:+:10:A3,chr4:+:40:3T,chr3:+:30:AC2\n"),line);
+  // Scores break the ties (higher first)
+  gt_alignment* const alignment_se = gt_template_get_block(source,0);
+  gt_alignment_get_map(alignment_se,0)->gt_score = 1;
+  gt_alignment_get_map(alignment_se,1)->gt_score = 5;
+  gt_template_sort_by_distance__score(source);
+  gt_string_clear(string);
+  gt_output_map_sprint_template(string,source,output_attributes);
+  line = gt_string_get_string(string);
+  fail_unless(gt_streq(line,"ID\tACGT\t####\t2:2:1\tchr5:+:50:4:::5,chr2:+:20:4:::1,chr1:+:10:A3,chr4:+:40:3T,chr3:+:30:AC2\n"),line);
+  gt_string_delete(string);
+}
+END_TEST
+
 Suite *gt_template_utils_suite(void) {
   Suite *s = suite_create("gt_template_utils");
 
@@ -270,6 +293,7 @@ Suite *gt_template_utils_suite(void) {
   tcase_add_test(test_case,gt_test_template_to_string);
   tcase_add_test(test_case,gt_test_template_copy);
   tcase_add_test(test_case,gt_test_loosing_alignments);
+  tcase_add_test(test_case,gt_test_template_sort_by_distance__score);
   suite_add_tcase(s,test_case);
 
   return s;
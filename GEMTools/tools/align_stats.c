@@ -235,7 +235,7 @@ static as_stats* as_stats_new(bool paired)
 		for(k=0;k<2;k++) stats->indel_length[i*2+k]=as_calloc(sizeof(uint64_t),stats->max_indel_length+1);
 	}
 	stats->insert_size=0;
-	stats->loc_hash=0;
+	stats->loc_table=0;
 	return stats;
 }
 
@@ -308,50 +308,65 @@ static dist_element *as_increase_insert_count(dist_element **de,int ix,int64_t x
 }
 
 #define LH_BIN_SIZE 1024
-static pthread_rwlock_t loc_hash_rwlock;
+#define INIT_LOC_WINDOW_SIZE 128
 
-static void insert_loc(as_stats *stats,uint64_t x,int64_t ins_size,uint32_t tile,gt_string *ctg)
+static loc_table *loc_table_new(void)
+{
+	loc_table *lt=as_malloc(sizeof(loc_table));
+	lt->contigs=0;
+	lt->last=0;
+	return lt;
+}
+
+static void loc_table_free(loc_table *lt)
 {
-	loc_hash *lh;
-	unsigned int k=x/LH_BIN_SIZE;
-	uint16_t loc=x%LH_BIN_SIZE;
-	pthread_rwlock_rdlock(&loc_hash_rwlock);
-	HASH_FIND_STR(*stats->loc_hash,gt_string_get_string(ctg),lh);
-	pthread_rwlock_unlock(&loc_hash_rwlock);
-	if(!lh) {
-		lh=as_malloc(sizeof(loc_hash));
-		lh->ctg=strdup(gt_string_get_string(ctg));
-		lh->lblock=0;
-		pthread_rwlock_init(&lh->rwlock,NULL);
-		pthread_rwlock_wrlock(&loc_hash_rwlock);
-		HASH_ADD_KEYPTR(hh,*stats->loc_hash,lh->ctg,(int)strlen(lh->ctg),lh);
-		pthread_rwlock_unlock(&loc_hash_rwlock);
+	loc_contig *lc,*tmp;
+	HASH_ITER(hh,lt->contigs,lc,tmp) {
+		HASH_DEL(lt->contigs,lc);
+		GT_VECTOR_ITERATE(lc->windows,window,window_pos,gt_vector*) {
+			if(*window) gt_vector_delete(*window);
+		}
+		gt_vector_delete(lc->windows);
+		free(lc->ctg);
+		free(lc);
 	}
-	loc_block *lb;
-	pthread_rwlock_rdlock(&lh->rwlock);
-	HASH_FIND_INT(lh->lblock,&k,lb);
-	pthread_rwlock_unlock(&lh->rwlock);
-	if(!lb) {
-		lb=as_malloc(sizeof(loc_block));
-		lb->n_elem=0;
-		lb->size=INIT_LB_SIZE;
-		lb->x=k;
-		lb->elem=as_malloc(lb->size*sizeof(loc_elem));
-		pthread_mutex_init(&lb->mutex,NULL);
-		pthread_rwlock_wrlock(&lh->rwlock);
-		HASH_ADD_INT(lh->lblock,x,lb);
-		pthread_rwlock_unlock(&lh->rwlock);
+	free(lt);
+}
+
+static loc_contig *loc_table_get_contig(loc_table *lt,char *ctg)
+{
+	loc_contig *lc=lt->last;
+	if(lc && !strcmp(lc->ctg,ctg)) return lc;
+	HASH_FIND_STR(lt->contigs,ctg,lc);
+	if(!lc) {
+		lc=as_malloc(sizeof(loc_contig));
+		lc->ctg=strdup(ctg);
+		lc->windows=gt_vector_new(1,sizeof(gt_vector*));
+		HASH_ADD_KEYPTR(hh,lt->contigs,lc->ctg,(int)strlen(lc->ctg),lc);
 	}
-	pthread_mutex_lock(&lb->mutex);
-	if(lb->n_elem==lb->size) {
-		lb->size*=1.5;
-		lb->elem=as_realloc(lb->elem,lb->size*sizeof(loc_elem));
+	lt->last=lc;
+	return lc;
+}
+
+static gt_vector **loc_contig_get_window(loc_contig *lc,uint64_t w)
+{
+	uint64_t nw=gt_vector_get_used(lc->windows);
+	if(w>=nw) {
+		gt_vector_reserve(lc->windows,w+1,false);
+		for(;nw<=w;nw++) *gt_vector_get_elm(lc->windows,nw,gt_vector*)=0;
+		gt_vector_set_used(lc->windows,w+1);
 	}
-	loc_elem* le=lb->elem+(lb->n_elem++);
-	pthread_mutex_unlock(&lb->mutex);
-	le->loc=loc;
-	le->tile=tile;
-	le->dist=ins_size;
+	return gt_vector_get_elm(lc->windows,w,gt_vector*);
+}
+
+static void insert_loc(as_stats *stats,uint64_t x,int64_t ins_size,uint32_t tile,gt_string *ctg)
+{
+	const int16_t dist=ins_size;
+	const u_int16_t tl=tile;
+	loc_contig *lc=loc_table_get_contig(stats->loc_table,gt_string_get_string(ctg));
+	gt_vector **window=loc_contig_get_window(lc,x>>LOC_WINDOW_BITS);
+	if(!*window) *window=gt_vector_new(INIT_LOC_WINDOW_SIZE,sizeof(uint64_t));
+	gt_vector_insert(*window,LOC_RECORD(x,dist,tl),uint64_t);
 }
 
 static void as_stats_resize(as_stats *stats,uint64_t rd,uint64_t l)
@@ -610,100 +625,77 @@ static int cmp_dist_elem(dist_element *a,dist_element *b)
 	return a->x-b->x;
 }
 
-static int cmp_loc_elem(const void *s1,const void *s2)
+/*
+ * In-place MSD radix sort of the location records (8 bits per level, most significant first)
+ *   No scratch buffer, so a window costs only its 8-byte records; levels where all the
+ *   records of a bucket share the same digit are skipped, small buckets use insertion sort
+ */
+#define LOC_SORT_SMALL 32
+static void sort_loc_records(uint64_t *rec,uint64_t n,int shift)
 {
-  const loc_elem *le1,*le2;
-  int x;
-
-  le1=s1;
-  le2=s2;
-  if(!(x=le1->loc-le2->loc)) {
-    if(!(x=abs(le1->dist)-abs(le2->dist))) {
-      if(!(x=le1->tile-le2->tile)) {
-        x=le1->dist-le2->dist;
-      }
-    }
-  }
-  return x;
+	uint64_t i;
+	if(n<=LOC_SORT_SMALL) {
+		for(i=1;i<n;i++) {
+			uint64_t r=rec[i],j=i;
+			for(;j && rec[j-1]>r;j--) rec[j]=rec[j-1];
+			rec[j]=r;
+		}
+		return;
+	}
+	uint64_t head[256],tail[256];
+	int k;
+	memset(tail,0,sizeof(tail));
+	for(i=0;i<n;i++) tail[(rec[i]>>shift)&0xff]++;
+	if(tail[(rec[0]>>shift)&0xff]==n) {
+		if(shift) sort_loc_records(rec,n,shift-8);
+		return;
+	}
+	uint64_t sum=0;
+	for(k=0;k<256;k++) {
+		head[k]=sum;
+		sum+=tail[k];
+		tail[k]=sum;
+	}
+	// Permute each record into its bucket following the displacement cycles
+	for(k=0;k<256;k++) {
+		while(head[k]<tail[k]) {
+			uint64_t r=rec[head[k]];
+			int d=(r>>shift)&0xff;
+			while(d!=k) {
+				uint64_t t=rec[head[d]];
+				rec[head[d]++]=r;
+				r=t;
+				d=(r>>shift)&0xff;
+			}
+			rec[head[k]++]=r;
+		}
+	}
+	if(shift) {
+		uint64_t start=0;
+		for(k=0;k<256;k++) {
+			if(tail[k]-start>1) sort_loc_records(rec+start,tail[k]-start,shift-8);
+			start=tail[k];
+		}
+	}
 }
 
-static void *as_calc_duplicate_rate(void *ss)
+/*
+ * Counts duplicates of the sorted records of one block (LH_BIN_SIZE bases)
+ */
+static void count_block_duplicates(uint64_t *rec,uint64_t n,uint64_t (*dup_cnt)[DUP_LIMIT+1])
 {
-	as_param* param=ss;
-	as_stats* stats=param->stats[0];
-	loc_hash* lh=*(stats->loc_hash);
-	uint64_t (*dup_cnt)[DUP_LIMIT+1]=stats->duplicate_counts;
 	uint64_t dcounts[2][DUP_LIMIT+1];
-	uint64_t tot=0;
-	int i,j;
-	for(i=0;i<5;i++) for(j=0;j<=DUP_LIMIT;j++) dup_cnt[i][j]=0;
-	for(;lh;lh=lh->hh.next) {
-		loc_block *lb;
-		for(lb=lh->lblock;lb;lb=lb->hh.next) {
-			qsort(lb->elem,lb->n_elem,sizeof(loc_elem),cmp_loc_elem);
-			u_int16_t tile,loc;
-			int16_t dst=0;
-			tile=loc=0;
-			int k,k1,xx;
-			k=k1=xx=0;
-			uint64_t kk[4]={0,0,0,0};
-			tot+=lb->n_elem;
-			loc_elem* le=lb->elem;
-			for(i=0;i<(int)lb->n_elem;i++,le++) {
-				if(le->loc!=loc || abs(le->dist)!=abs(dst)) {
-					if(k) {
-						if(k>DUP_LIMIT) k=DUP_LIMIT+1;
-						else if(k>1) {
-							assert(xx<=DUP_LIMIT);
-							dcounts[0][xx]=kk[0];
-							dcounts[1][xx++]=kk[1];
-							for(k1=0;k1<4;k1++) kk[k1]=0;
-							for(k1=0;k1<xx;k1++) {
-								int k2;
-								for(k2=0;k2<2;k2++) {
-									int k3=dcounts[k2][k1];
-									if(k3>1) kk[0]+=k3*(k3-1);
-								}
-								kk[1]+=dcounts[0][k1]*dcounts[1][k1];
-								for(k2=0;k2<k1;k2++) {
-									kk[2]+=dcounts[0][k1]*dcounts[0][k2]+dcounts[1][k1]*dcounts[1][k2];
-									kk[3]+=dcounts[0][k1]*dcounts[1][k2]+dcounts[1][k1]*dcounts[0][k2];
-								}
-							}
-							kk[0]>>=1;
-							for(k1=0;k1<4;k1++) dup_cnt[k1+1][k-1]+=kk[k1];
-							xx=0;
-						}
-						dup_cnt[0][k-1]++;
-					}
-					k=1;
-					xx=0;
-					tile=le->tile;loc=le->loc;
-					dst=le->dist;
-					k1=(dst<0)?0:1;
-					kk[k1]=1;
-					kk[k1^1]=0;
-				} else {
-					k++;
-					if(le->tile!=tile) {
-						if(xx<DUP_LIMIT) {
-							dcounts[0][xx]=kk[0];
-							dcounts[1][xx++]=kk[1];;
-							tile=le->tile;
-							dst=le->dist;
-							k1=(dst<0)?0:1;
-							kk[k1]=1;
-							kk[k1^1]=0;
-						}
-					} else {
-						if(le->dist!=dst) {
-							k1=1;
-							dst=le->dist;
-						}
-						kk[k1]++;
-					}
-				}
-			}
+	u_int16_t tile,loc;
+	int16_t dst=0;
+	tile=loc=0;
+	int i,k,k1,xx;
+	k=k1=xx=0;
+	uint64_t kk[4]={0,0,0,0};
+	for(i=0;i<(int)n;i++) {
+		const u_int16_t le_loc=LOC_RECORD_X(rec[i])%LH_BIN_SIZE;
+		const u_int16_t le_tile=LOC_RECORD_TILE(rec[i]);
+		const int16_t le_dist=LOC_RECORD_DIST(rec[i]);
+		if(le_loc!=loc || abs(le_dist)!=abs(dst)) {
 			if(k) {
 				if(k>DUP_LIMIT) k=DUP_LIMIT+1;
 				else if(k>1) {
@@ -729,8 +721,145 @@ static void *as_calc_duplicate_rate(void *ss)
 				}
 				dup_cnt[0][k-1]++;
 			}
+			k=1;
+			xx=0;
+			tile=le_tile;loc=le_loc;
+			dst=le_dist;
+			k1=(dst<0)?0:1;
+			kk[k1]=1;
+			kk[k1^1]=0;
+		} else {
+			k++;
+			if(le_tile!=tile) {
+				if(xx<DUP_LIMIT) {
+					dcounts[0][xx]=kk[0];
+					dcounts[1][xx++]=kk[1];;
+					tile=le_tile;
+					dst=le_dist;
+					k1=(dst<0)?0:1;
+					kk[k1]=1;
+					kk[k1^1]=0;
+				}
+			} else {
+				if(le_dist!=dst) {
+					k1=1;
+					dst=le_dist;
+				}
+				kk[k1]++;
+			}
+		}
+	}
+	if(k) {
+		if(k>DUP_LIMIT) k=DUP_LIMIT+1;
+		else if(k>1) {
+			assert(xx<=DUP_LIMIT);
+			dcounts[0][xx]=kk[0];
+			dcounts[1][xx++]=kk[1];
+			for(k1=0;k1<4;k1++) kk[k1]=0;
+			for(k1=0;k1<xx;k1++) {
+				int k2;
+				for(k2=0;k2<2;k2++) {
+					int k3=dcounts[k2][k1];
+					if(k3>1) kk[0]+=k3*(k3-1);
+				}
+				kk[1]+=dcounts[0][k1]*dcounts[1][k1];
+				for(k2=0;k2<k1;k2++) {
+					kk[2]+=dcounts[0][k1]*dcounts[0][k2]+dcounts[1][k1]*dcounts[1][k2];
+					kk[3]+=dcounts[0][k1]*dcounts[1][k2]+dcounts[1][k1]*dcounts[0][k2];
+				}
+			}
+			kk[0]>>=1;
+			for(k1=0;k1<4;k1++) dup_cnt[k1+1][k-1]+=kk[k1];
+			xx=0;
+		}
+		dup_cnt[0][k-1]++;
+	}
+}
+
+/*
+ * Gathers the per-thread buffers of one (contig,window) partition into a single
+ * buffer (releasing the others), sorts it and counts duplicates block by block
+ */
+static uint64_t count_window_duplicates(gt_vector *sources,uint64_t (*dup_cnt)[DUP_LIMIT+1])
+{
+	gt_vector **src=gt_vector_get_mem(sources,gt_vector*);
+	uint64_t i,n=0,nsrc=gt_vector_get_used(sources);
+	for(i=0;i<nsrc;i++) n+=gt_vector_get_used(src[i]);
+	gt_vector *window=src[0];
+	gt_vector_reserve(window,n,false);
+	for(i=1;i<nsrc;i++) {
+		memcpy(gt_vector_get_free_elm(window,uint64_t),gt_vector_get_mem(src[i],uint64_t),gt_vector_get_used(src[i])*sizeof(uint64_t));
+		gt_vector_add_used(window,gt_vector_get_used(src[i]));
+		gt_vector_delete(src[i]);
+	}
+	uint64_t *rec=gt_vector_get_mem(window,uint64_t);
+	sort_loc_records(rec,n,56);
+	uint64_t j;
+	for(i=0;i<n;i=j) {
+		const uint64_t block=LOC_RECORD_X(rec[i])/LH_BIN_SIZE;
+		for(j=i+1;j<n && LOC_RECORD_X(rec[j])/LH_BIN_SIZE==block;j++);
+		count_block_duplicates(rec+i,j-i,dup_cnt);
+	}
+	gt_vector_delete(window);
+	return n;
+}
+
+static void *as_calc_duplicate_rate(void *ss)
+{
+	as_param* param=ss;
+	as_stats* stats=param->stats[0];
+	uint64_t (*dup_cnt)[DUP_LIMIT+1]=stats->duplicate_counts;
+	uint64_t tot=0;
+	int i,j;
+	for(i=0;i<5;i++) for(j=0;j<=DUP_LIMIT;j++) dup_cnt[i][j]=0;
+	// Collect the per-thread buffers of each (contig,window) partition
+	loc_table *global=loc_table_new();
+	gt_vector *partitions=gt_vector_new(1024,sizeof(gt_vector*));
+	for(i=0;i<param->num_threads;i++) {
+		loc_table *lt=param->loc_tables[i];
+		loc_contig *lc;
+		for(lc=lt->contigs;lc;lc=lc->hh.next) {
+			loc_contig *glc=loc_table_get_contig(global,lc->ctg);
+			GT_VECTOR_ITERATE(lc->windows,window,w,gt_vector*) {
+				if(!*window) continue;
+				gt_vector **sources=loc_contig_get_window(glc,w);
+				if(!*sources) {
+					*sources=gt_vector_new(param->num_threads,sizeof(gt_vector*));
+					gt_vector_insert(partitions,*sources,gt_vector*);
+				}
+				gt_vector_insert(*sources,*window,gt_vector*);
+				*window=0;
+			}
+		}
+		loc_table_free(lt);
+	}
+	// Sort and count partitions in parallel
+	const int64_t num_partitions=gt_vector_get_used(partitions);
+	gt_vector **part=gt_vector_get_mem(partitions,gt_vector*);
+#ifdef HAVE_OPENMP
+#pragma omp parallel num_threads(param->num_threads) reduction(+:tot)
+#endif
+	{
+		uint64_t local_dup_cnt[5][DUP_LIMIT+1];
+		memset(local_dup_cnt,0,sizeof(local_dup_cnt));
+		int64_t p;
+#ifdef HAVE_OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+		for(p=0;p<num_partitions;p++) {
+			tot+=count_window_duplicates(part[p],local_dup_cnt);
+			gt_vector_clear(part[p]);
+		}
+#ifdef HAVE_OPENMP
+#pragma omp critical
+#endif
+		{
+			int k1,k2;
+			for(k1=0;k1<5;k1++) for(k2=0;k2<=DUP_LIMIT;k2++) dup_cnt[k1][k2]+=local_dup_cnt[k1][k2];
 		}
 	}
+	gt_vector_delete(partitions);
+	loc_table_free(global);
 	double z1,z2,z3,z4,z5,z6;
 	z1=z2=z3=z4=z5=z6=0.0;
   //int k=0;
@@ -1378,7 +1507,7 @@ int main(int argc,char *argv[])
 	as_set_output_files(&param);
 	as_stats** stats=as_malloc(param.num_threads*sizeof(void *));
 	param.stats=stats;
-	loc_hash *lh=0;
+	param.loc_tables=as_malloc(param.num_threads*sizeof(void *));
 	// Do we have two map files as input (one for each read)?
 	if(param.input_files[1]) {
 		gt_input_generic_parser_attributes_set_paired(param.parser_attr,true);
@@ -1402,7 +1531,7 @@ int main(int argc,char *argv[])
 			gt_template *template=gt_template_new();
 			id_tag *idt=new_id_tag();
 			stats[tid]=as_stats_new(gt_input_generic_parser_attributes_is_paired(param.parser_attr));
-			stats[tid]->loc_hash=&lh;
+			stats[tid]->loc_table=param.loc_tables[tid]=loc_table_new();
 			while(gt_input_map_parser_synch_blocks(buffered_input1,buffered_input2,&mutex)) {
 				error_code=gt_input_map_parser_get_template(buffered_input1,template,NULL);
 				if(error_code!=GT_IMP_OK) {
@@ -1471,7 +1600,7 @@ int main(int argc,char *argv[])
 			gt_status error_code;
 			gt_template *template=gt_template_new();
 			stats[tid]=as_stats_new(gt_input_generic_parser_attributes_is_paired(param.parser_attr));
-			stats[tid]->loc_hash=&lh;
+			stats[tid]->loc_table=param.loc_tables[tid]=loc_table_new();
 			id_tag *idt=new_id_tag();
 			while ((error_code=gt_input_generic_parser_get_template(buffered_input,template,param.parser_attr))) {
 				if (error_code!=GT_IMP_OK) {
@@ -1520,5 +1649,6 @@ int main(int argc,char *argv[])
 	as_print_stats(&param);
 	as_stats_free(stats[0]);
 	free(stats);
+	free(param.loc_tables);
 	return err;
 }
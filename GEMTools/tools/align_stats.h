@@ -31,29 +31,36 @@ typedef struct {
   UT_hash_handle hh;
 } dist_element;
 
-typedef struct {
-  u_int16_t loc;
-  u_int16_t tile;
-  int16_t  dist;
-} loc_elem;
-
-#define INIT_LB_SIZE 128
+/*
+ * Location records used to estimate duplicates. Each thread appends to its own
+ * buffers, one per (contig, window) partition, so no locking is required.
+ * A record packs [x within window | abs(dist) | tile | dist>=0] so that sorting
+ * records as integers yields the (loc,abs(dist),tile,dist) order used to count duplicates
+ */
+#define LOC_WINDOW_BITS 24
+#define LOC_WINDOW_SIZE (((uint64_t)1)<<LOC_WINDOW_BITS)
+#define LOC_SIGN_SHIFT 0
+#define LOC_TILE_SHIFT 1
+#define LOC_DIST_SHIFT 17
+#define LOC_X_SHIFT 33
+#define LOC_RECORD(x,dist,tile) \
+  ((((uint64_t)(x)&(LOC_WINDOW_SIZE-1))<<LOC_X_SHIFT) | \
+   ((uint64_t)abs(dist)<<LOC_DIST_SHIFT) | ((uint64_t)(tile)<<LOC_TILE_SHIFT) | ((uint64_t)((dist)>=0)<<LOC_SIGN_SHIFT))
+#define LOC_RECORD_X(record) ((record)>>LOC_X_SHIFT)
+#define LOC_RECORD_TILE(record) ((u_int16_t)((record)>>LOC_TILE_SHIFT))
+#define LOC_RECORD_DIST(record) \
+  ((int16_t)(((record)>>LOC_SIGN_SHIFT)&1 ? (int)(((record)>>LOC_DIST_SHIFT)&0xFFFF) : -(int)(((record)>>LOC_DIST_SHIFT)&0xFFFF)))
 
 typedef struct {
-  size_t n_elem;
-  size_t size;
-  uint32_t x;
-  loc_elem *elem;
-  pthread_mutex_t mutex;
+  char *ctg;
+  gt_vector* windows; // (gt_vector*) Location records (uint64_t) per window of LOC_WINDOW_SIZE bases
   UT_hash_handle hh;
-} loc_block;
+} loc_contig;
 
 typedef struct {
-  char *ctg;
-  loc_block *lblock;
-  pthread_rwlock_t rwlock;
-  UT_hash_handle hh;
-} loc_hash;
+  loc_contig *contigs;
+  loc_contig *last; // Last contig used (maps tend to be sorted)
+} loc_table;
 
 #define ID_END_CHAR 127
 #define ID_COLON_CHAR 1
@@ -112,7 +119,7 @@ typedef struct {
   uint64_t duplicate_counts[5][DUP_LIMIT+1];
   double duplicate_rate[2]; // Overall, optical duplicate fractions
   dist_element* insert_size; // Store insert size distribution
-  loc_hash** loc_hash; // Track position and insert sizes to estimate duplicates
+  loc_table* loc_table; // Track position and insert sizes to estimate duplicates
   bool paired;
 } as_stats;
 
@@ -134,5 +141,6 @@ typedef struct {
   int num_threads;
   int qual_offset; // quality offset (33 for FASTQ, 64 for Illumina)
   as_stats **stats;
+  loc_table **loc_tables;
 } as_param;
 
@@ -465,6 +465,276 @@ static int process_file(char *fname,struct contig *ctg,int block_size,int fmt,u_
   return err;
 }
 
+/*
+ * Parallel coverage for GEM MAP files
+ *   Blocks of the input file are parsed by all threads with the library's buffered parser.
+ *   Each thread buffers the covered intervals of uniquely mapping reads per coverage window,
+ *   so no locking is needed; in between rounds the windows are added to the counts in
+ *   parallel (each window owned by one thread) through a difference array.
+ */
+static struct cov_windows *cov_windows_new(struct contig *ctg,int block_size,int n_threads)
+{
+  struct cov_windows *cw;
+  struct contig *c;
+  u_int32_t w,nw;
+  int i;
+
+  cw=lk_malloc(sizeof(struct cov_windows));
+  cw->n_threads=n_threads;
+  cw->window_size=((COV_WINDOW_SIZE+block_size-1)/block_size)*block_size;
+  nw=0;
+  for(c=ctg;c;c=c->hh.next) {
+    c->win_offset=nw;
+    nw+=(c->size+cw->window_size-1)/cw->window_size;
+  }
+  cw->n_windows=nw;
+  cw->win_ctg=lk_malloc(sizeof(struct contig *)*(nw?nw:1));
+  for(c=ctg;c;c=c->hh.next) {
+    u_int32_t n=(c->size+cw->window_size-1)/cw->window_size;
+    for(w=0;w<n;w++) cw->win_ctg[c->win_offset+w]=c;
+  }
+  cw->events=lk_malloc(sizeof(gt_vector **)*n_threads);
+  cw->n_events=lk_malloc(sizeof(u_int64_t)*n_threads);
+  for(i=0;i<n_threads;i++) {
+    cw->events[i]=lk_malloc(sizeof(gt_vector *)*(nw?nw:1));
+    for(w=0;w<nw;w++) cw->events[i][w]=0;
+    cw->n_events[i]=0;
+  }
+  return cw;
+}
+
+static void cov_windows_free(struct cov_windows *cw)
+{
+  u_int32_t w;
+  int i;
+
+  for(i=0;i<cw->n_threads;i++) {
+    for(w=0;w<cw->n_windows;w++) if(cw->events[i][w]) gt_vector_delete(cw->events[i][w]);
+    free(cw->events[i]);
+  }
+  free(cw->events);
+  free(cw->n_events);
+  free(cw->win_ctg);
+  free(cw);
+}
+
+static void cov_add_interval(struct cov_windows *cw,int tid,struct contig *c,u_int32_t x1,u_int32_t x2)
+{
+  u_int32_t w,we;
+  struct cov_event ev;
+
+  while(x1<x2) {
+    w=x1/cw->window_size;
+    we=(w+1)*cw->window_size;
+    ev.x1=x1;
+    ev.x2=(x2<we?x2:we);
+    gt_vector **v=cw->events[tid]+c->win_offset+w;
+    if(!*v) *v=gt_vector_new(1024,sizeof(struct cov_event));
+    gt_vector_insert(*v,ev,struct cov_event);
+    cw->n_events[tid]++;
+    x1=ev.x2;
+  }
+}
+
+static inline void cov_add_count(count *ct,u_int32_t x,int32_t k)
+{
+  count c=ct[x];
+  if(c<MAX_COUNT) ct[x]=(MAX_COUNT-c<k)?MAX_COUNT:c+k;
+}
+
+static void cov_apply_window(struct cov_windows *cw,u_int32_t w,int block_size,int32_t *diff)
+{
+  struct contig *c=cw->win_ctg[w];
+  u_int32_t ws,we,x,b;
+  int32_t cov;
+  int i;
+  bool empty=true;
+
+  for(i=0;i<cw->n_threads;i++) if(cw->events[i][w] && !gt_vector_is_empty(cw->events[i][w])) empty=false;
+  if(empty) return;
+  ws=(w-c->win_offset)*cw->window_size;
+  we=ws+cw->window_size;
+  if(we>c->size) we=c->size;
+  memset(diff,0,sizeof(int32_t)*(we-ws+1));
+  for(i=0;i<cw->n_threads;i++) {
+    gt_vector *v=cw->events[i][w];
+    if(!v) continue;
+    GT_VECTOR_ITERATE(v,ev,ev_pos,struct cov_event) {
+      diff[ev->x1-ws]++;
+      diff[ev->x2-ws]--;
+    }
+    gt_vector_clear(v);
+  }
+  cov=0;
+  for(x=ws;x<we;x++) {
+    cov+=diff[x-ws];
+    if(!cov) continue;
+    b=(block_size>1)?(x/block_size)*block_size:x;
+    cov_add_count(c->counts,b,cov);
+    if(c->tcounts && x<c->tsize) cov_add_count(c->tcounts,b,cov);
+  }
+}
+
+static void cov_apply_windows(struct cov_windows *cw,int block_size)
+{
+  int64_t w;
+
+#ifdef HAVE_OPENMP
+#pragma omp parallel num_threads(cw->n_threads)
+#endif
+  {
+    int32_t *diff=lk_malloc(sizeof(int32_t)*(cw->window_size+1));
+#ifdef HAVE_OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+    for(w=0;w<(int64_t)cw->n_windows;w++) cov_apply_window(cw,(u_int32_t)w,block_size,diff);
+    free(diff);
+  }
+  memset(cw->n_events,0,sizeof(u_int64_t)*cw->n_threads);
+}
+
+/* Only reads with a single match in the first non-empty stratum (and none in the next one) are used */
+static bool cov_is_unique(gt_alignment *al)
+{
+  gt_vector *counters=gt_alignment_get_counters_vector(al);
+  u_int64_t i=0;
+
+  GT_VECTOR_ITERATE(counters,k,k_pos,u_int64_t) {
+    i+=*k;
+    if(i>1) break;
+    if(!*k && i) break;
+  }
+  return i==1;
+}
+
+static struct contig *cov_find_contig(struct contig *ctg,struct contig **last,gt_string *seq_name)
+{
+  char *name=gt_string_get_string(seq_name);
+  u_int64_t i,len=gt_string_get_length(seq_name);
+  struct contig *c;
+
+  // Strip bisulphite conversion tags
+  for(i=0;i+4<=len;i++) {
+    if((name[i]=='#' || name[i]=='_') && (!strncmp(name+i+1,"C2T",3) || !strncmp(name+i+1,"G2A",3))) {
+      len=i;
+      break;
+    }
+  }
+  c=*last;
+  if(c && !strncmp(c->name,name,len) && !c->name[len]) return c;
+  HASH_FIND(hh,ctg,name,len,c);
+  if(c) *last=c;
+  return c;
+}
+
+/* The stop flag is raised by whichever thread exhausts the -n limit and polled by the others */
+static inline bool cov_get_stop(bool *stop)
+{
+  bool s;
+#ifdef HAVE_OPENMP
+#pragma omp atomic read
+#endif
+  s=*stop;
+  return s;
+}
+
+static inline void cov_set_stop(bool *stop)
+{
+#ifdef HAVE_OPENMP
+#pragma omp atomic write
+#endif
+  *stop=true;
+}
+
+static int process_map_file(char *fname,struct contig *ctg,struct cov_windows *cw,int block_size,u_int64_t *number)
+{
+  gt_input_file *input_file;
+  gt_buffered_input_file **buffered_input;
+  const bool limited=(*number!=0);
+  bool eof,stop;
+  int i,err;
+
+  input_file=gt_input_file_open(fname,false);
+  printf("Reading matches file '%s'\n",fname);
+  buffered_input=lk_malloc(sizeof(gt_buffered_input_file *)*cw->n_threads);
+  for(i=0;i<cw->n_threads;i++) buffered_input[i]=gt_buffered_input_file_new(input_file);
+  err=0;
+  stop=false;
+  do {
+    eof=true;
+#ifdef HAVE_OPENMP
+#pragma omp parallel num_threads(cw->n_threads) reduction(&&:eof)
+#endif
+    {
+#ifdef HAVE_OPENMP
+      int tid=omp_get_thread_num();
+#else
+      int tid=0;
+#endif
+      gt_alignment *al=gt_alignment_new();
+      gt_map_parser_attributes *attr=gt_input_map_parser_attributes_new(false);
+      struct contig *last=0;
+      gt_status error_code;
+      bool thread_eof=false;
+      gt_input_map_parser_attributes_set_max_parsed_maps(attr,1);
+      while(!cov_get_stop(&stop) && cw->n_events[tid]<COV_ROUND_EVENTS) {
+	error_code=gt_input_map_parser_get_alignment(buffered_input[tid],al,attr);
+	if(error_code==GT_IMP_EOF) {
+	  thread_eof=true;
+	  break;
+	}
+	if(error_code!=GT_IMP_OK) {
+	  fprintf(stderr,"Bad format for match\n");
+	  continue;
+	}
+	if(!gt_alignment_get_num_maps(al) || !cov_is_unique(al)) continue;
+	gt_map *map=gt_alignment_get_map(al,0),*next_block;
+	// Reverse GEMv0 split-maps are chained from the acceptor; the match position is the donor's
+	if(map->strand==REVERSE) while((next_block=gt_map_get_next_block(map))) map=next_block;
+	if(limited) {
+	  // Reserve a slot under the lock so that the counter never wraps past zero
+	  u_int64_t left;
+#ifdef HAVE_OPENMP
+#pragma omp critical (cov_number)
+#endif
+	  {
+	    left=*number;
+	    if(left) *number=--left;
+	  }
+	  if(!left) {
+	    cov_set_stop(&stop);
+	    break;
+	  }
+	}
+	struct contig *c=cov_find_contig(ctg,&last,map->seq_name);
+	if(!c || !map->position) continue;
+	u_int64_t sz=gt_alignment_get_read_length(al);
+	u_int64_t x=map->position-1,x1,x2;
+	if(map->strand==REVERSE) {
+	  // Reverse matches cover the bases leftwards from the match position
+	  x1=(x+1>=sz)?x+1-sz:0;
+	  x2=x+1;
+	} else {
+	  x1=x;
+	  x2=x+sz;
+	}
+	if(x2>c->size) x2=c->size;
+	if(x1>=x2) continue;
+	cov_add_interval(cw,tid,c,x1,x2);
+      }
+      eof=thread_eof;
+      gt_input_map_parser_attributes_delete(attr);
+      gt_alignment_delete(al);
+    }
+    cov_apply_windows(cw,block_size);
+  } while(!eof && !stop);
+  if(stop) err=1;
+  for(i=0;i<cw->n_threads;i++) gt_buffered_input_file_close(buffered_input[i]);
+  free(buffered_input);
+  gt_input_file_close(input_file);
+  return err;
+}
+
 struct tdc_par {
   struct contig *ctg;
   struct lk_compress *lkc;
@@ -695,6 +965,14 @@ int main(int argc,char *argv[])
       if((j=pthread_create(read_threads+i,NULL,read_det_cov,&tp))) abt(__FILE__,__LINE__,"Thread creation %d failed: %d\n",i+1,j);
     }
     for(i=0;i<nthr;i++) pthread_join(read_threads[i],NULL);
+  } else if(format==GEM_FMT) {
+    if(!err) {
+      struct cov_windows *cw=cov_windows_new(contigs,block_size,nthr);
+      for(i=optind;!err && i<argc;i++) {
+	err=process_map_file(argv[i],contigs,cw,block_size,&number);
+      }
+      cov_windows_free(cw);
+    }
   } else {
     for(i=optind;!err && i<argc;i++) {
       err=process_file(argv[i],contigs,block_size,format,&number,lkc);
@@ -14,6 +14,8 @@
 #define OUT_WIDTH 80
 #define ELAND_FMT 1
 #define GEM_FMT 0
+#define COV_WINDOW_SIZE (1<<20) // Bases per coverage window (rounded up to a multiple of the block size)
+#define COV_ROUND_EVENTS (1<<22) // Intervals buffered per thread before they are added to the counts
 
 typedef u_int16_t count;
 
@@ -37,10 +39,26 @@ struct contig {
 	count *tcounts;
 	struct range_blk *ranges;
 	struct range_blk *tranges;
+	u_int32_t win_offset; // First coverage window of the contig
 	pthread_mutex_t mut;
 	UT_hash_handle hh;
 };
 
+/* Covered interval [x1,x2) within a coverage window */
+struct cov_event {
+	u_int32_t x1;
+	u_int32_t x2;
+};
+
+struct cov_windows {
+	int n_threads;
+	u_int32_t window_size;
+	u_int32_t n_windows;
+	struct contig **win_ctg;  // Contig of each window
+	gt_vector ***events;      // [thread][window] -> (struct cov_event)
+	u_int64_t *n_events;      // Events buffered by each thread in the current round
+};
+
 struct match {
 	char *ctg;
 	char *cigar;
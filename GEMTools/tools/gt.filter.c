@@ -91,7 +91,7 @@ typedef struct {
   float max_event_distance;
   float min_levenshtein_distance;
   float max_levenshtein_distance;
-  gt_vector* map_ids;
+  gt_shash* map_ids; /* (Set of allowed sequence names) */
   gt_shash* gtf_types;
   bool filter_by_strand_se;
   bool allow_strand_r;
@@ -113,6 +113,7 @@ typedef struct {
   bool check;
   bool check_format;
   gt_file_format check_file_format;
+  bool filter_stats;
   /* Hidden */
   bool special_functionality;
   bool error_plot; // Print error distribution (depreciated)
@@ -223,6 +224,7 @@ gt_filter_args parameters = {
     /* Checking/Report */
     .check = false,
     .check_format = false,
+    .filter_stats = false,
     /* Hidden */
     .special_functionality = false,
     .error_plot = false,
@@ -322,27 +324,327 @@ GT_INLINE bool gt_filter_check_maps(
 /*
  * Filtering MAPs functions
  */
-void gt_filter_delete_map_ids(gt_vector* filter_map_ids) {
-  // Free vector
-  if (filter_map_ids!=NULL) {
-    GT_VECTOR_ITERATE(filter_map_ids,map_id,pos,gt_string*) {
-      gt_string_delete(*map_id);
-    }
-    gt_vector_delete(filter_map_ids);
-  }
+void gt_filter_delete_map_ids(gt_shash* const filter_map_ids) {
+  // Free hash (elements are plain flags)
+  if (filter_map_ids!=NULL) gt_shash_delete(filter_map_ids,false);
 }
 GT_INLINE bool gt_filter_is_sequence_name_allowed(gt_string* const seq_name) {
-  GT_VECTOR_ITERATE(parameters.map_ids,map_id,pos,gt_string*) {
-    if (gt_string_equals(seq_name,*map_id)) return true;
-  }
-  return false;
+  return gt_shash_is_contained_nstring(parameters.map_ids,gt_string_get_string(seq_name),gt_string_get_length(seq_name));
 }
+/*
+ * Filter plan
+ *   The per-map criteria of the DNA filter are compiled once (gt_filter_plan_compile) into
+ *   flat lists of predicates, so the map loop only runs the enabled ones. Thresholds that only
+ *   depend on the alignment/template (read proportions, first matching distance, ...) are
+ *   computed once per filter call into a gt_filter_plan_context.
+ */
+#define GT_FILTER_PLAN_MAX_PREDICATES 16
+#define GT_FILTER_QUALITY_LUT_SIZE 256
+
+typedef enum { GT_FILTER_PASS, GT_FILTER_REJECT, GT_FILTER_STOP } gt_filter_predicate_result;
+typedef struct {
+  gt_file_format file_format;
+  gt_template* template;
+  gt_alignment* alignment; // SE/End-maps (NULL for mmaps)
+  uint64_t first_matching_distance;
+  uint64_t max_mismatch_quality;
+  uint64_t max_strata_after_map;
+  uint64_t min_event_distance;
+  uint64_t max_event_distance;
+  uint64_t min_levenshtein_distance;
+  uint64_t max_levenshtein_distance;
+} gt_filter_plan_context;
+typedef gt_filter_predicate_result (*gt_filter_predicate_fx)(
+    gt_filter_plan_context* const context,gt_map** const mmap,gt_mmap_attributes* const mmap_attributes);
+typedef struct {
+  char* name;
+  gt_filter_predicate_fx predicate_fx;
+} gt_filter_predicate;
+typedef struct {
+  gt_filter_predicate predicates[GT_FILTER_PLAN_MAX_PREDICATES];
+  uint64_t num_predicates;
+} gt_filter_predicate_list;
+typedef struct {
+  gt_filter_predicate_list map_predicates;  // SE/End-maps (mmap[0] is the map)
+  gt_filter_predicate_list mmap_predicates; // Paired mmaps
+  bool quality_allowed[GT_FILTER_QUALITY_LUT_SIZE];
+} gt_filter_plan;
+typedef struct {
+  uint64_t num_evaluated;
+  uint64_t num_rejected;
+  uint64_t num_stopped;
+  uint64_t time_ns;
+} gt_filter_predicate_stats;
+typedef struct {
+  gt_filter_predicate_stats map_predicates[GT_FILTER_PLAN_MAX_PREDICATES];
+  gt_filter_predicate_stats mmap_predicates[GT_FILTER_PLAN_MAX_PREDICATES];
+} gt_filter_plan_stats;
+
+gt_filter_plan filter_plan = {
+    .map_predicates = { .num_predicates=0 },
+    .mmap_predicates = { .num_predicates=0 },
+};
+
 GT_INLINE bool gt_filter_is_quality_value_allowed(const uint64_t quality_score) {
+  if (quality_score < GT_FILTER_QUALITY_LUT_SIZE) return filter_plan.quality_allowed[quality_score];
+  // GT scores can go beyond the table
   GT_VECTOR_ITERATE(parameters.quality_score_ranges,quality_range,pos,gt_filter_quality_range) {
     if (quality_score >= quality_range->min && quality_score <= quality_range->max) return true;
   }
   return false;
 }
+/*
+ * Filter plan. SE/End-maps predicates
+ */
+gt_filter_predicate_result gt_filter_predicate_map_sequence_name(
+    gt_filter_plan_context* const context,gt_map** const mmap,gt_mmap_attributes* const mmap_attributes) {
+  return gt_filter_is_sequence_name_allowed(mmap[0]->seq_name) ? GT_FILTER_PASS : GT_FILTER_REJECT;
+}
+gt_filter_predicate_result gt_filter_predicate_map_max_strata_after_map(
+    gt_filter_plan_context* const context,gt_map** const mmap,gt_mmap_attributes* const mmap_attributes) {
+  const int64_t current_stratum = parameters.no_penalty_for_splitmaps ?
+      gt_map_get_no_split_distance(mmap[0]) : gt_map_get_global_distance(mmap[0]);
+  return ((current_stratum-context->first_matching_distance) > context->max_strata_after_map) ? GT_FILTER_STOP : GT_FILTER_PASS;
+}
+gt_filter_predicate_result gt_filter_predicate_map_event_distance(
+    gt_filter_plan_context* const context,gt_map** const mmap,gt_mmap_attributes* const mmap_attributes) {
+  const uint64_t total_distance = parameters.no_penalty_for_splitmaps ?
+      gt_map_get_no_split_distance(mmap[0]) : gt_map_get_global_distance(mmap[0]);
+  return (total_distance < context->min_event_distance || total_distance > context->max_event_distance) ? GT_FILTER_REJECT : GT_FILTER_PASS;
+}
+gt_filter_predicate_result gt_filter_predicate_map_levenshtein_distance(
+    gt_filter_plan_context* const context,gt_map** const mmap,gt_mmap_attributes* const mmap_attributes) {
+  const uint64_t total_distance = gt_map_get_global_levenshtein_distance(mmap[0]);
+  return (total_distance < context->min_levenshtein_distance || total_distance > context->max_levenshtein_distance) ? GT_FILTER_REJECT : GT_FILTER_PASS;
+}
+gt_filter_predicate_result gt_filter_predicate_map_strand(
+    gt_filter_plan_context* const context,gt_map** const mmap,gt_mmap_attributes* const mmap_attributes) {
+  if (mmap[0]->strand==FORWARD && !parameters.allow_strand_f) return GT_FILTER_REJECT;
+  if (mmap[0]->strand==REVERSE && !parameters.allow_strand_r) return GT_FILTER_REJECT;
+  return GT_FILTER_PASS;
+}
+gt_filter_predicate_result gt_filter_predicate_map_quality(
+    gt_filter_plan_context* const context,gt_map** const mmap,gt_mmap_attributes* const mmap_attributes) {
+  return gt_filter_is_quality_value_allowed((context->file_format==SAM) ? mmap[0]->phred_score : mmap[0]->gt_score) ?
+      GT_FILTER_PASS : GT_FILTER_REJECT;
+}
+gt_filter_predicate_result gt_filter_predicate_map_reduce_by_quality(
+    gt_filter_plan_context* const context,gt_map** const mmap,gt_mmap_attributes* const mmap_attributes) {
+  const int64_t q = gt_alignment_sum_mismatch_qualities(context->alignment,mmap[0]);
+  return (q!=0 && q!=context->max_mismatch_quality && abs(context->max_mismatch_quality-q)<=parameters.reduce_by_quality) ?
+      GT_FILTER_REJECT : GT_FILTER_PASS;
+}
+/*
+ * Filter plan. PE-mmaps predicates
+ */
+gt_filter_predicate_result gt_filter_predicate_mmap_max_strata_after_map(
+    gt_filter_plan_context* const context,gt_map** const mmap,gt_mmap_attributes* const mmap_attributes) {
+  const int64_t current_stratum = parameters.no_penalty_for_splitmaps ?
+      gt_map_get_no_split_distance(mmap[0]) + gt_map_get_no_split_distance(mmap[1]):
+      gt_map_get_global_distance(mmap[0]) + gt_map_get_global_distance(mmap[1]);
+  return ((current_stratum-context->first_matching_distance) > context->max_strata_after_map) ? GT_FILTER_STOP : GT_FILTER_PASS;
+}
+gt_filter_predicate_result gt_filter_predicate_mmap_sequence_name(
+    gt_filter_plan_context* const context,gt_map** const mmap,gt_mmap_attributes* const mmap_attributes) {
+  return (gt_filter_is_sequence_name_allowed(mmap[0]->seq_name) &&
+          gt_filter_is_sequence_name_allowed(mmap[1]->seq_name)) ? GT_FILTER_PASS : GT_FILTER_REJECT;
+}
+gt_filter_predicate_result gt_filter_predicate_mmap_event_distance(
+    gt_filter_plan_context* const context,gt_map** const mmap,gt_mmap_attributes* const mmap_attributes) {
+  const int64_t total_distance = parameters.no_penalty_for_splitmaps ?
+      gt_map_get_no_split_distance(mmap[0]) + gt_map_get_no_split_distance(mmap[1]):
+      gt_map_get_global_distance(mmap[0]) + gt_map_get_global_distance(mmap[1]);
+  return (total_distance < context->min_event_distance || total_distance > context->max_event_distance) ? GT_FILTER_REJECT : GT_FILTER_PASS;
+}
+gt_filter_predicate_result gt_filter_predicate_mmap_levenshtein_distance(
+    gt_filter_plan_context* const context,gt_map** const mmap,gt_mmap_attributes* const mmap_attributes) {
+  const int64_t total_distance = gt_map_get_global_levenshtein_distance(mmap[0])+gt_map_get_global_levenshtein_distance(mmap[1]);
+  return (total_distance < context->min_levenshtein_distance || total_distance > context->max_levenshtein_distance) ? GT_FILTER_REJECT : GT_FILTER_PASS;
+}
+gt_filter_predicate_result gt_filter_predicate_mmap_inss(
+    gt_filter_plan_context* const context,gt_map** const mmap,gt_mmap_attributes* const mmap_attributes) {
+  gt_status error_code;
+  const int64_t inss = gt_template_get_insert_size(mmap,&error_code,0,0);
+  return (parameters.min_inss > inss || inss > parameters.max_inss) ? GT_FILTER_REJECT : GT_FILTER_PASS;
+}
+gt_filter_predicate_result gt_filter_predicate_mmap_strand(
+    gt_filter_plan_context* const context,gt_map** const mmap,gt_mmap_attributes* const mmap_attributes) {
+  if (!parameters.allow_strand_f && (mmap[0]->strand==FORWARD || mmap[1]->strand==FORWARD)) return GT_FILTER_REJECT;
+  if (!parameters.allow_strand_r && (mmap[0]->strand==REVERSE || mmap[1]->strand==REVERSE)) return GT_FILTER_REJECT;
+  return GT_FILTER_PASS;
+}
+gt_filter_predicate_result gt_filter_predicate_mmap_pair_strand(
+    gt_filter_plan_context* const context,gt_map** const mmap,gt_mmap_attributes* const mmap_attributes) {
+  if (mmap[0]->strand==FORWARD && mmap[1]->strand==REVERSE && !parameters.allow_strand_fr) return GT_FILTER_REJECT;
+  if (mmap[0]->strand==REVERSE && mmap[1]->strand==FORWARD && !parameters.allow_strand_rf) return GT_FILTER_REJECT;
+  if (mmap[0]->strand==FORWARD && mmap[1]->strand==FORWARD && !parameters.allow_strand_ff) return GT_FILTER_REJECT;
+  if (mmap[0]->strand==REVERSE && mmap[1]->strand==REVERSE && !parameters.allow_strand_rr) return GT_FILTER_REJECT;
+  return GT_FILTER_PASS;
+}
+gt_filter_predicate_result gt_filter_predicate_mmap_quality(
+    gt_filter_plan_context* const context,gt_map** const mmap,gt_mmap_attributes* const mmap_attributes) {
+  return gt_filter_is_quality_value_allowed((context->file_format==SAM) ? mmap_attributes->phred_score : mmap_attributes->gt_score) ?
+      GT_FILTER_PASS : GT_FILTER_REJECT;
+}
+gt_filter_predicate_result gt_filter_predicate_mmap_reduce_by_quality(
+    gt_filter_plan_context* const context,gt_map** const mmap,gt_mmap_attributes* const mmap_attributes) {
+  const int64_t q = gt_alignment_sum_mismatch_qualities(gt_template_get_block(context->template,0),mmap[0]) +
+                    gt_alignment_sum_mismatch_qualities(gt_template_get_block(context->template,1),mmap[1]);
+  return (q!=0 && q!=context->max_mismatch_quality && abs(context->max_mismatch_quality-q)<=parameters.reduce_by_quality) ?
+      GT_FILTER_REJECT : GT_FILTER_PASS;
+}
+/*
+ * Filter plan. Compilation
+ *   A map stopping the scan (max-strata-after-map) must not be rejected beforehand by a
+ *   criterion that originally came after it (and vice versa), so the stop predicate keeps its
+ *   position. The rest go cheapest first (their order doesn't change the outcome).
+ */
+GT_INLINE void gt_filter_plan_add_predicate(
+    gt_filter_predicate_list* const predicate_list,char* const name,gt_filter_predicate_fx const predicate_fx) {
+  gt_cond_fatal_error_msg(predicate_list->num_predicates>=GT_FILTER_PLAN_MAX_PREDICATES,"Too many filtering criteria");
+  gt_filter_predicate* const predicate = predicate_list->predicates+predicate_list->num_predicates;
+  predicate->name = name;
+  predicate->predicate_fx = predicate_fx;
+  ++(predicate_list->num_predicates);
+}
+void gt_filter_plan_compile() {
+  const bool filter_event_distance =
+      parameters.min_event_distance != GT_FILTER_FLOAT_NO_VALUE || parameters.max_event_distance != GT_FILTER_FLOAT_NO_VALUE;
+  const bool filter_levenshtein_distance =
+      parameters.min_levenshtein_distance != GT_FILTER_FLOAT_NO_VALUE || parameters.max_levenshtein_distance != GT_FILTER_FLOAT_NO_VALUE;
+  // Quality ranges table
+  if (parameters.quality_score_ranges!=NULL) {
+    uint64_t quality_score;
+    for (quality_score=0;quality_score<GT_FILTER_QUALITY_LUT_SIZE;++quality_score) {
+      filter_plan.quality_allowed[quality_score] = false;
+      GT_VECTOR_ITERATE(parameters.quality_score_ranges,quality_range,pos,gt_filter_quality_range) {
+        if (quality_score >= quality_range->min && quality_score <= quality_range->max) {
+          filter_plan.quality_allowed[quality_score] = true; break;
+        }
+      }
+    }
+  }
+  // SE/End-maps (sequence name goes before the max-strata stop)
+  gt_filter_predicate_list* const map_predicates = &filter_plan.map_predicates;
+  map_predicates->num_predicates = 0;
+  if (parameters.map_ids!=NULL) gt_filter_plan_add_predicate(map_predicates,"map-id",gt_filter_predicate_map_sequence_name);
+  if (parameters.max_strata_after_map >= 0.0) {
+    gt_filter_plan_add_predicate(map_predicates,"max-strata-after-map",gt_filter_predicate_map_max_strata_after_map);
+  }
+  if (parameters.filter_by_strand_se) gt_filter_plan_add_predicate(map_predicates,"strandedness",gt_filter_predicate_map_strand);
+  if (parameters.quality_score_ranges!=NULL) gt_filter_plan_add_predicate(map_predicates,"filter-quality",gt_filter_predicate_map_quality);
+  if (filter_event_distance) gt_filter_plan_add_predicate(map_predicates,"min/max-strata",gt_filter_predicate_map_event_distance);
+  if (filter_levenshtein_distance) {
+    gt_filter_plan_add_predicate(map_predicates,"min/max-levenshtein-error",gt_filter_predicate_map_levenshtein_distance);
+  }
+  if (parameters.reduce_by_quality >= 0) {
+    gt_filter_plan_add_predicate(map_predicates,"reduce-by-quality",gt_filter_predicate_map_reduce_by_quality);
+  }
+  // PE-mmaps (max-strata stop goes first)
+  gt_filter_predicate_list* const mmap_predicates = &filter_plan.mmap_predicates;
+  mmap_predicates->num_predicates = 0;
+  if (parameters.max_strata_after_map >= 0.0) {
+    gt_filter_plan_add_predicate(mmap_predicates,"max-strata-after-map",gt_filter_predicate_mmap_max_strata_after_map);
+  }
+  if (parameters.filter_by_strand_se) gt_filter_plan_add_predicate(mmap_predicates,"strandedness",gt_filter_predicate_mmap_strand);
+  if (parameters.filter_by_strand_pe) gt_filter_plan_add_predicate(mmap_predicates,"pair-strandedness",gt_filter_predicate_mmap_pair_strand);
+  if (parameters.quality_score_ranges!=NULL) gt_filter_plan_add_predicate(mmap_predicates,"filter-quality",gt_filter_predicate_mmap_quality);
+  if (parameters.map_ids!=NULL) gt_filter_plan_add_predicate(mmap_predicates,"map-id",gt_filter_predicate_mmap_sequence_name);
+  if (filter_event_distance) gt_filter_plan_add_predicate(mmap_predicates,"min/max-strata",gt_filter_predicate_mmap_event_distance);
+  if (filter_levenshtein_distance) {
+    gt_filter_plan_add_predicate(mmap_predicates,"min/max-levenshtein-error",gt_filter_predicate_mmap_levenshtein_distance);
+  }
+  if (parameters.min_inss > INT64_MIN || parameters.max_inss < INT64_MAX) {
+    gt_filter_plan_add_predicate(mmap_predicates,"min/max-inss",gt_filter_predicate_mmap_inss);
+  }
+  if (parameters.reduce_by_quality >= 0) {
+    gt_filter_plan_add_predicate(mmap_predicates,"reduce-by-quality",gt_filter_predicate_mmap_reduce_by_quality);
+  }
+}
+/*
+ * Filter plan. Evaluation
+ */
+GT_INLINE void gt_filter_plan_context_init(
+    gt_filter_plan_context* const context,const gt_file_format file_format,
+    gt_template* const template,gt_alignment* const alignment,const uint64_t read_length) {
+  context->file_format = file_format;
+  context->template = template;
+  context->alignment = alignment;
+  context->first_matching_distance = 0;
+  context->max_mismatch_quality = 0;
+  context->max_strata_after_map = (parameters.max_strata_after_map >= 0.0) ?
+      gt_get_integer_proportion(parameters.max_strata_after_map,read_length) : UINT64_MAX;
+  // Unset bounds never reject
+  context->min_event_distance = (parameters.min_event_distance != GT_FILTER_FLOAT_NO_VALUE) ?
+      gt_get_integer_proportion(parameters.min_event_distance,read_length) : 0;
+  context->max_event_distance = (parameters.max_event_distance != GT_FILTER_FLOAT_NO_VALUE) ?
+      gt_get_integer_proportion(parameters.max_event_distance,read_length) : UINT64_MAX;
+  context->min_levenshtein_distance = (parameters.min_levenshtein_distance != GT_FILTER_FLOAT_NO_VALUE) ?
+      gt_get_integer_proportion(parameters.min_levenshtein_distance,read_length) : 0;
+  context->max_levenshtein_distance = (parameters.max_levenshtein_distance != GT_FILTER_FLOAT_NO_VALUE) ?
+      gt_get_integer_proportion(parameters.max_levenshtein_distance,read_length) : UINT64_MAX;
+}
+GT_INLINE gt_filter_predicate_result gt_filter_plan_evaluate(
+    gt_filter_predicate_list* const predicate_list,gt_filter_predicate_stats* const predicate_stats,
+    gt_filter_plan_context* const context,gt_map** const mmap,gt_mmap_attributes* const mmap_attributes) {
+  gt_filter_predicate* const predicates = predicate_list->predicates;
+  const uint64_t num_predicates = predicate_list->num_predicates;
+  uint64_t i;
+  if (gt_expect_true(predicate_stats==NULL)) {
+    for (i=0;i<num_predicates;++i) {
+      const gt_filter_predicate_result result = predicates[i].predicate_fx(context,mmap,mmap_attributes);
+      if (result!=GT_FILTER_PASS) return result;
+    }
+  } else {
+    for (i=0;i<num_predicates;++i) {
+      struct timespec time_start, time_end;
+      clock_gettime(CLOCK_MONOTONIC,&time_start);
+      const gt_filter_predicate_result result = predicates[i].predicate_fx(context,mmap,mmap_attributes);
+      clock_gettime(CLOCK_MONOTONIC,&time_end);
+      gt_filter_predicate_stats* const stats = predicate_stats+i;
+      ++(stats->num_evaluated);
+      stats->time_ns += (int64_t)(time_end.tv_sec-time_start.tv_sec)*1000000000ll + (int64_t)(time_end.tv_nsec-time_start.tv_nsec);
+      if (result!=GT_FILTER_PASS) {
+        if (result==GT_FILTER_REJECT) ++(stats->num_rejected); else ++(stats->num_stopped);
+        return result;
+      }
+    }
+  }
+  return GT_FILTER_PASS;
+}
+/*
+ * Filter plan. Stats (--filter-stats)
+ */
+GT_INLINE void gt_filter_plan_stats_merge(gt_filter_plan_stats* const stats_dst,gt_filter_plan_stats* const stats_src) {
+  uint64_t i;
+  for (i=0;i<GT_FILTER_PLAN_MAX_PREDICATES;++i) {
+    stats_dst->map_predicates[i].num_evaluated += stats_src->map_predicates[i].num_evaluated;
+    stats_dst->map_predicates[i].num_rejected += stats_src->map_predicates[i].num_rejected;
+    stats_dst->map_predicates[i].num_stopped += stats_src->map_predicates[i].num_stopped;
+    stats_dst->map_predicates[i].time_ns += stats_src->map_predicates[i].time_ns;
+    stats_dst->mmap_predicates[i].num_evaluated += stats_src->mmap_predicates[i].num_evaluated;
+    stats_dst->mmap_predicates[i].num_rejected += stats_src->mmap_predicates[i].num_rejected;
+    stats_dst->mmap_predicates[i].num_stopped += stats_src->mmap_predicates[i].num_stopped;
+    stats_dst->mmap_predicates[i].time_ns += stats_src->mmap_predicates[i].time_ns;
+  }
+}
+GT_INLINE void gt_filter_plan_print_predicate_stats(
+    char* const label,gt_filter_predicate_list* const predicate_list,gt_filter_predicate_stats* const predicate_stats) {
+  uint64_t i;
+  for (i=0;i<predicate_list->num_predicates;++i) {
+    gt_filter_predicate_stats* const stats = predicate_stats+i;
+    gt_slog("  %-6s %-26s %14"PRIu64" %14"PRIu64" (%6.2f %%) %12"PRIu64" %10.3f s %8.1f ns/eval\n",
+        label,predicate_list->predicates[i].name,stats->num_evaluated,
+        stats->num_rejected,GT_GET_PERCENTAGE(stats->num_rejected,stats->num_evaluated),stats->num_stopped,
+        (double)stats->time_ns/1E9,(stats->num_evaluated>0) ? (double)stats->time_ns/(double)stats->num_evaluated : 0.0);
+  }
+}
+GT_INLINE void gt_filter_plan_print_stats(gt_filter_plan_stats* const plan_stats) {
+  gt_log("Filter stats (predicates in evaluation order)");
+  gt_slog("  %-6s %-26s %14s %25s %12s %12s %16s\n","Maps","Predicate","Evaluated","Rejected (%)","Stopped","Time","Time/eval");
+  gt_filter_plan_print_predicate_stats("SE",&filter_plan.map_predicates,plan_stats->map_predicates);
+  gt_filter_plan_print_predicate_stats("PE",&filter_plan.mmap_predicates,plan_stats->mmap_predicates);
+}
 GT_INLINE void gt_filter_prune_matches(gt_template* const template) {
   uint64_t max_num_matches = GT_ALL;
   if (parameters.max_decoded_matches!=GT_ALL || parameters.min_decoded_strata!=0) {
@@ -515,128 +817,476 @@ GT_INLINE bool gt_filter_make_reduce_by_annotation(gt_template* const template_d
   return filtered;
 }
 
-void gt_alignment_reduction_filter(gt_alignment* const alignment_dst,gt_alignment* const alignment_src,const gt_file_format file_format) {
-  // Reduction by unique level (can be calculated beforehand)
-  GT_ALIGNMENT_ITERATE(alignment_src,map) {
-    if (parameters.reduce_to_unique_strata >= 0 &&
-       (gt_alignment_get_uniq_degree(alignment_src) >= parameters.reduce_to_unique_strata)) {
-      gt_alignment_insert_map(alignment_dst,gt_map_copy(map), parameters.check_duplicates);
-      break;
+/*
+ * Map filtering keep-mask
+ *   The map filtering stages (split-coherence, DNA, RNA & reduction) flag the maps/mmaps
+ *   they keep instead of copying them into a new template. Stages read the template through
+ *   the mask (kept maps, counters as they would be recalculated) and the template is
+ *   compacted, its counters recalculated and its maps sorted once (gt_filter_keep_mask_apply)
+ */
+#define GT_FILTER_KEEP_MASK_INITIAL_ELEMENTS 100
+typedef struct {
+  /* Maps kept (wrt the maps currently in the template) */
+  gt_vector* mmaps_keep;   // (bool)
+  gt_vector* maps_keep[2]; // (bool)
+  uint64_t num_mmaps_kept;
+  uint64_t num_maps_kept[2];
+  /* Maps kept by the current stage */
+  gt_vector* stage_mmaps_keep;   // (bool)
+  gt_vector* stage_maps_keep[2]; // (bool)
+  uint64_t stage_num_mmaps_kept;
+  uint64_t stage_num_maps_kept[2];
+  bool stage_paired;    // The stage filters mmaps (PE mapped template)
+  /* State */
+  bool modified;        // Counters have to be recalculated
+  bool rebuilt;         // Maps have to be compacted
+  bool ends_from_mmaps; // End alignments have to be rebuilt from the kept mmaps
+  bool sorted;          // Maps are in (no-split) order, so re-sorting the kept ones is the identity
+  /* Auxiliary */
+  gt_vector* counters;    // (uint64_t)
+  gt_vector* maps_sorted; // (gt_map*)
+  gt_vector* maps_used;   // (bool)
+} gt_filter_keep_mask;
+
+#define GT_FILTER_KEEP_MASK_ITERATE(keep_vector,position) \
+  const uint64_t __##position##_num_elements = gt_vector_get_used(keep_vector); \
+  const bool* const __##position##_keep = gt_vector_get_mem(keep_vector,bool); \
+  uint64_t position; \
+  for (position=0;position<__##position##_num_elements;++position) if (__##position##_keep[position])
+
+gt_filter_keep_mask* gt_filter_keep_mask_new() {
+  gt_filter_keep_mask* const keep_mask = gt_alloc(gt_filter_keep_mask);
+  keep_mask->mmaps_keep = gt_vector_new(GT_FILTER_KEEP_MASK_INITIAL_ELEMENTS,sizeof(bool));
+  keep_mask->maps_keep[0] = gt_vector_new(GT_FILTER_KEEP_MASK_INITIAL_ELEMENTS,sizeof(bool));
+  keep_mask->maps_keep[1] = gt_vector_new(GT_FILTER_KEEP_MASK_INITIAL_ELEMENTS,sizeof(bool));
+  keep_mask->stage_mmaps_keep = gt_vector_new(GT_FILTER_KEEP_MASK_INITIAL_ELEMENTS,sizeof(bool));
+  keep_mask->stage_maps_keep[0] = gt_vector_new(GT_FILTER_KEEP_MASK_INITIAL_ELEMENTS,sizeof(bool));
+  keep_mask->stage_maps_keep[1] = gt_vector_new(GT_FILTER_KEEP_MASK_INITIAL_ELEMENTS,sizeof(bool));
+  keep_mask->counters = gt_vector_new(GT_FILTER_KEEP_MASK_INITIAL_ELEMENTS,sizeof(uint64_t));
+  keep_mask->maps_sorted = gt_vector_new(GT_FILTER_KEEP_MASK_INITIAL_ELEMENTS,sizeof(gt_map*));
+  keep_mask->maps_used = gt_vector_new(GT_FILTER_KEEP_MASK_INITIAL_ELEMENTS,sizeof(bool));
+  return keep_mask;
+}
+void gt_filter_keep_mask_delete(gt_filter_keep_mask* const keep_mask) {
+  gt_vector_delete(keep_mask->mmaps_keep);
+  gt_vector_delete(keep_mask->maps_keep[0]);
+  gt_vector_delete(keep_mask->maps_keep[1]);
+  gt_vector_delete(keep_mask->stage_mmaps_keep);
+  gt_vector_delete(keep_mask->stage_maps_keep[0]);
+  gt_vector_delete(keep_mask->stage_maps_keep[1]);
+  gt_vector_delete(keep_mask->counters);
+  gt_vector_delete(keep_mask->maps_sorted);
+  gt_vector_delete(keep_mask->maps_used);
+  gt_free(keep_mask);
+}
+GT_INLINE void gt_filter_keep_mask_fill(gt_vector* const keep_vector,const uint64_t num_elements,const bool value) {
+  gt_vector_reserve(keep_vector,num_elements,false);
+  gt_vector_set_used(keep_vector,num_elements);
+  memset(gt_vector_get_mem(keep_vector,bool),value,num_elements*sizeof(bool));
+}
+GT_INLINE int gt_filter_keep_mask_cmp_no_split(
+    const uint64_t distance_a,const uint64_t score_a,const uint64_t distance_b,const uint64_t score_b) {
+  // Same order as gt_template_sort_by_distance__score_no_split()
+  if (distance_a != distance_b) return (distance_a < distance_b) ? -1 : 1;
+  return (score_a > score_b) ? -1 : (score_a < score_b ? 1 : 0);
+}
+GT_INLINE uint64_t gt_filter_keep_mask_mmap_no_split_distance(gt_map** const mmap) {
+  return gt_map_get_no_split_distance(mmap[0]) + gt_map_get_no_split_distance(mmap[1]);
+}
+GT_INLINE bool gt_filter_keep_mask_is_sorted(gt_template* const template) {
+  uint64_t i;
+  GT_TEMPLATE_IF_SE_ALINGMENT(template) {
+    GT_TEMPLATE_REDUCTION(template,alignment);
+    const uint64_t num_maps = gt_alignment_get_num_maps(alignment);
+    for (i=1;i<num_maps;++i) {
+      gt_map* const map_a = gt_alignment_get_map(alignment,i-1);
+      gt_map* const map_b = gt_alignment_get_map(alignment,i);
+      if (gt_filter_keep_mask_cmp_no_split(
+          gt_map_get_no_split_distance(map_a),map_a->gt_score,
+          gt_map_get_no_split_distance(map_b),map_b->gt_score) > 0) return false;
+    }
+  } else {
+    const uint64_t num_mmaps = gt_template_get_num_mmaps(template);
+    for (i=1;i<num_mmaps;++i) {
+      gt_mmap* const mmap_a = gt_template_get_mmap(template,i-1);
+      gt_mmap* const mmap_b = gt_template_get_mmap(template,i);
+      if (gt_filter_keep_mask_cmp_no_split(
+          gt_filter_keep_mask_mmap_no_split_distance(mmap_a->mmap),mmap_a->attributes.gt_score,
+          gt_filter_keep_mask_mmap_no_split_distance(mmap_b->mmap),mmap_b->attributes.gt_score) > 0) return false;
     }
-    if(gt_alignment_get_num_maps(alignment_src) > parameters.reduce_to_unique) break;
-    gt_alignment_insert_map(alignment_dst,gt_map_copy(map), parameters.check_duplicates);
   }
+  return true;
 }
-
-void gt_alignment_dna_filter(gt_alignment* const alignment_dst,gt_alignment* const alignment_src,const gt_file_format file_format) {
-  const uint64_t first_matching_distance = gt_counters_get_min_matching_strata(gt_alignment_get_counters_vector(alignment_src)) - 1;
-  const uint64_t max_mismatch_quality = gt_alignment_get_max_mismatch_quality(alignment_src);
-  // Reduction by unique level (can be calculated beforehand)
-  bool pick_only_first_map = false;
-  /*
-   * (1) Pre-filtering steps
-   */
-  gt_map* first_map = NULL;
-  if (parameters.keep_first_map && gt_alignment_get_num_maps(alignment_src)>0) {
-    first_map = gt_map_copy(gt_alignment_get_map(alignment_src,0));
+GT_INLINE void gt_filter_keep_mask_init(gt_filter_keep_mask* const keep_mask,gt_template* const template) {
+  const uint64_t num_blocks = gt_template_get_num_blocks(template);
+  const uint64_t num_mmaps = (num_blocks>1) ? gt_template_get_num_mmaps(template) : 0;
+  uint64_t end;
+  gt_filter_keep_mask_fill(keep_mask->mmaps_keep,num_mmaps,true);
+  keep_mask->num_mmaps_kept = num_mmaps;
+  for (end=0;end<2;++end) {
+    const uint64_t num_maps = (end<num_blocks) ? gt_alignment_get_num_maps(gt_template_get_block(template,end)) : 0;
+    gt_filter_keep_mask_fill(keep_mask->maps_keep[end],num_maps,true);
+    keep_mask->num_maps_kept[end] = num_maps;
+  }
+  keep_mask->modified = false;
+  keep_mask->rebuilt = false;
+  keep_mask->ends_from_mmaps = false;
+  keep_mask->sorted = parameters.no_penalty_for_splitmaps && gt_filter_keep_mask_is_sorted(template);
+}
+/*
+ * Template as seen through the mask
+ *   NOTE: The end alignments are only filtered individually if no mmap is kept, in which
+ *     case the ends to be rebuilt from the kept mmaps (@ends_from_mmaps) are empty
+ */
+GT_INLINE bool gt_filter_keep_mask_is_mapped(gt_filter_keep_mask* const keep_mask,gt_template* const template) {
+  if (!keep_mask->modified) return gt_template_is_mapped(template);
+  if (gt_template_get_not_unique_flag(template)) return true;
+  return (gt_template_get_num_blocks(template)==1) ? keep_mask->num_maps_kept[0]>0 : keep_mask->num_mmaps_kept>0;
+}
+GT_INLINE uint64_t gt_filter_keep_mask_get_num_maps(gt_filter_keep_mask* const keep_mask,gt_template* const template) {
+  GT_TEMPLATE_IF_SE_ALINGMENT(template) {
+    return keep_mask->num_maps_kept[0];
+  } else {
+    if (!gt_filter_keep_mask_is_mapped(keep_mask,template)) {
+      return keep_mask->num_maps_kept[0] + keep_mask->num_maps_kept[1];
+    } else {
+      return keep_mask->num_mmaps_kept;
+    }
   }
-  /*
-   * (2) Filtering of maps
-   */
-  GT_ALIGNMENT_ITERATE(alignment_src,map) {
-    // Check sequence name
-    if (parameters.map_ids!=NULL) {
-      if (!gt_filter_is_sequence_name_allowed(map->seq_name)) continue;
+}
+GT_INLINE void gt_filter_keep_mask_inc_counter(gt_vector* const counters,const uint64_t stratum) {
+  const uint64_t used_strata = stratum+1;
+  gt_vector_reserve(counters,used_strata,true);
+  if (gt_vector_get_used(counters) < used_strata) {
+    gt_vector_set_used(counters,used_strata);
+  }
+  ++(*gt_vector_get_elm(counters,stratum,uint64_t));
+}
+GT_INLINE gt_vector* gt_filter_keep_mask_get_alignment_counters(
+    gt_filter_keep_mask* const keep_mask,gt_template* const template,const uint64_t end) {
+  gt_alignment* const alignment = gt_template_get_block(template,end);
+  // SE counters are recalculated after every stage; PE end counters only change if the ends are rebuilt
+  const bool is_se = (gt_template_get_num_blocks(template)==1);
+  if (is_se ? !keep_mask->modified : !keep_mask->rebuilt) return gt_alignment_get_counters_vector(alignment);
+  const bool no_splits = is_se && parameters.no_penalty_for_splitmaps;
+  gt_vector_clear(keep_mask->counters);
+  GT_FILTER_KEEP_MASK_ITERATE(keep_mask->maps_keep[end],map_pos) {
+    gt_map* const map = gt_alignment_get_map(alignment,map_pos);
+    gt_filter_keep_mask_inc_counter(keep_mask->counters,
+        no_splits ? gt_map_get_no_split_distance(map) : gt_map_get_global_distance(map));
+  }
+  return keep_mask->counters;
+}
+GT_INLINE gt_vector* gt_filter_keep_mask_get_template_counters(gt_filter_keep_mask* const keep_mask,gt_template* const template) {
+  if (!keep_mask->modified) return gt_template_get_counters_vector(template);
+  gt_vector_clear(keep_mask->counters);
+  GT_FILTER_KEEP_MASK_ITERATE(keep_mask->mmaps_keep,mmap_pos) {
+    gt_map** const mmap = gt_template_get_mmap(template,mmap_pos)->mmap;
+    gt_filter_keep_mask_inc_counter(keep_mask->counters,parameters.no_penalty_for_splitmaps ?
+        gt_filter_keep_mask_mmap_no_split_distance(mmap) :
+        gt_map_get_global_distance(mmap[0]) + gt_map_get_global_distance(mmap[1]));
+  }
+  return keep_mask->counters;
+}
+GT_INLINE uint64_t gt_filter_keep_mask_get_alignment_max_mismatch_quality(
+    gt_filter_keep_mask* const keep_mask,gt_template* const template,const uint64_t end) {
+  gt_alignment* const alignment = gt_template_get_block(template,end);
+  uint64_t max_qual = 0;
+  GT_FILTER_KEEP_MASK_ITERATE(keep_mask->maps_keep[end],map_pos) {
+    const uint64_t q = gt_alignment_sum_mismatch_qualities(alignment,gt_alignment_get_map(alignment,map_pos));
+    if (q > max_qual) max_qual = q;
+  }
+  return max_qual;
+}
+GT_INLINE uint64_t gt_filter_keep_mask_get_template_max_mismatch_quality(gt_filter_keep_mask* const keep_mask,gt_template* const template) {
+  uint64_t max_qual = 0;
+  GT_FILTER_KEEP_MASK_ITERATE(keep_mask->mmaps_keep,mmap_pos) {
+    const uint64_t q = gt_template_sum_mismatch_qualities(template,gt_template_get_mmap(template,mmap_pos)->mmap);
+    if (q > max_qual) max_qual = q;
+  }
+  return max_qual;
+}
+/*
+ * Compaction
+ */
+GT_INLINE void gt_filter_keep_mask_clear_map_attributes(gt_map* const map) {
+  // Filtered maps used to be copies, which carry no attributes
+  GT_MAP_ITERATE(map,map_block) {
+    if (map_block->attributes!=NULL) gt_attributes_clear(map_block->attributes);
+  }
+}
+GT_INLINE void gt_filter_keep_mask_compact_maps(gt_alignment* const alignment,gt_vector* const keep_vector) {
+  gt_map** const maps = gt_vector_get_mem(alignment->maps,gt_map*);
+  const bool* const keep = gt_vector_get_mem(keep_vector,bool);
+  const uint64_t num_maps = gt_vector_get_used(alignment->maps);
+  uint64_t i, num_kept = 0;
+  for (i=0;i<num_maps;++i) {
+    if (keep[i]) {
+      gt_filter_keep_mask_clear_map_attributes(maps[i]);
+      maps[num_kept++] = maps[i];
+    } else {
+      gt_map_delete(maps[i]);
     }
-    // Filter strata beyond first mapping
-    const int64_t current_stratum = parameters.no_penalty_for_splitmaps ? gt_map_get_no_split_distance(map) : gt_map_get_global_distance(map);
-    if (parameters.max_strata_after_map >= 0.0 &&
-        (current_stratum-first_matching_distance) > gt_alignment_get_read_proportion(alignment_src,parameters.max_strata_after_map)) break;
-    // Check strata
-    if (parameters.min_event_distance != GT_FILTER_FLOAT_NO_VALUE || parameters.max_event_distance != GT_FILTER_FLOAT_NO_VALUE) {
-      const uint64_t total_distance = parameters.no_penalty_for_splitmaps ? gt_map_get_no_split_distance(map) : gt_map_get_global_distance(map);
-      if (parameters.min_event_distance != GT_FILTER_FLOAT_NO_VALUE) {
-        if (total_distance < gt_alignment_get_read_proportion(alignment_src,parameters.min_event_distance)) continue;
-      }
-      if (parameters.max_event_distance != GT_FILTER_FLOAT_NO_VALUE) {
-        if (total_distance > gt_alignment_get_read_proportion(alignment_src,parameters.max_event_distance)) continue;
+  }
+  gt_vector_set_used(alignment->maps,num_kept);
+}
+int gt_filter_keep_mask_cmp_map_ptr(const void* const a,const void* const b) {
+  const uintptr_t map_a = (uintptr_t)*((gt_map* const*)a);
+  const uintptr_t map_b = (uintptr_t)*((gt_map* const*)b);
+  return (map_a < map_b) ? -1 : (map_a > map_b);
+}
+GT_INLINE void gt_filter_keep_mask_rebuild_ends(gt_filter_keep_mask* const keep_mask,gt_template* const template) {
+  // Compact mmaps
+  gt_mmap* const mmaps = gt_vector_get_mem(template->mmaps,gt_mmap);
+  const bool* const keep = gt_vector_get_mem(keep_mask->mmaps_keep,bool);
+  const uint64_t num_mmaps = gt_vector_get_used(template->mmaps);
+  uint64_t i, num_kept = 0;
+  for (i=0;i<num_mmaps;++i) {
+    if (keep[i]) mmaps[num_kept++] = mmaps[i];
+  }
+  gt_vector_set_used(template->mmaps,num_kept);
+  // Each end holds one map per kept mmap (maps shared by several mmaps are copied)
+  uint64_t end;
+  for (end=0;end<2;++end) {
+    gt_alignment* const alignment = gt_template_get_block(template,end);
+    const uint64_t num_maps = gt_alignment_get_num_maps(alignment);
+    gt_vector_copy(keep_mask->maps_sorted,alignment->maps);
+    gt_map** const maps_sorted = gt_vector_get_mem(keep_mask->maps_sorted,gt_map*);
+    qsort(maps_sorted,num_maps,sizeof(gt_map*),gt_filter_keep_mask_cmp_map_ptr);
+    gt_filter_keep_mask_fill(keep_mask->maps_used,num_maps,false);
+    bool* const maps_used = gt_vector_get_mem(keep_mask->maps_used,bool);
+    gt_vector_clear(alignment->maps);
+    for (i=0;i<num_kept;++i) {
+      gt_map* map = mmaps[i].mmap[end];
+      gt_map** const found_map = bsearch(&map,maps_sorted,num_maps,sizeof(gt_map*),gt_filter_keep_mask_cmp_map_ptr);
+      if (found_map!=NULL && !maps_used[found_map-maps_sorted]) {
+        maps_used[found_map-maps_sorted] = true;
+        gt_filter_keep_mask_clear_map_attributes(map);
+      } else {
+        map = gt_map_copy(map);
+        mmaps[i].mmap[end] = map;
       }
+      gt_alignment_add_map(alignment,map);
+    }
+    for (i=0;i<num_maps;++i) {
+      if (!maps_used[i]) gt_map_delete(maps_sorted[i]);
     }
-    // Check levenshtein distance
-    if (parameters.min_levenshtein_distance != GT_FILTER_FLOAT_NO_VALUE || parameters.max_levenshtein_distance != GT_FILTER_FLOAT_NO_VALUE) {
-      const uint64_t total_distance = gt_map_get_global_levenshtein_distance(map);
-      if (parameters.min_levenshtein_distance != GT_FILTER_FLOAT_NO_VALUE) {
-        if (total_distance < gt_alignment_get_read_proportion(alignment_src,parameters.min_levenshtein_distance)) continue;
+    gt_alignment_recalculate_counters(alignment);
+  }
+}
+GT_INLINE void gt_filter_keep_mask_rebuild_template(gt_filter_keep_mask* const keep_mask,gt_template* const template) {
+  // Re-insert the kept maps into a new template (resolving duplicates)
+  gt_template* const template_filtered = gt_template_dup(template,false,false);
+  const uint64_t num_blocks = gt_template_get_num_blocks(template);
+  if (num_blocks>1 && keep_mask->ends_from_mmaps) {
+    GT_FILTER_KEEP_MASK_ITERATE(keep_mask->mmaps_keep,mmap_pos) {
+      gt_mmap* const mmap = gt_template_get_mmap(template,mmap_pos);
+      gt_map** mmap_copy = gt_mmap_array_copy(mmap->mmap,num_blocks);
+      gt_template_insert_mmap(template_filtered,mmap_copy,&mmap->attributes,parameters.check_duplicates);
+      free(mmap_copy);
+    }
+  } else {
+    uint64_t end;
+    for (end=0;end<num_blocks;++end) {
+      gt_alignment* const alignment_src = gt_template_get_block(template,end);
+      gt_alignment* const alignment_dst = gt_template_get_block(template_filtered,end);
+      GT_FILTER_KEEP_MASK_ITERATE(keep_mask->maps_keep[end],map_pos) {
+        gt_alignment_insert_map(alignment_dst,gt_map_copy(gt_alignment_get_map(alignment_src,map_pos)),parameters.check_duplicates);
       }
-      if (parameters.max_levenshtein_distance != GT_FILTER_FLOAT_NO_VALUE) {
-        if (total_distance > gt_alignment_get_read_proportion(alignment_src,parameters.max_levenshtein_distance)) continue;
+    }
+  }
+  gt_template_swap(template,template_filtered);
+  gt_template_delete(template_filtered);
+}
+GT_INLINE void gt_filter_keep_mask_apply(gt_filter_keep_mask* const keep_mask,gt_template* const template) {
+  if (!keep_mask->modified) return;
+  // Compact maps
+  if (keep_mask->rebuilt) {
+    if (parameters.check_duplicates) {
+      gt_filter_keep_mask_rebuild_template(keep_mask,template);
+    } else {
+      GT_TEMPLATE_IF_SE_ALINGMENT(template) {
+        gt_filter_keep_mask_compact_maps(gt_template_get_block(template,0),keep_mask->maps_keep[0]);
+      } else if (keep_mask->ends_from_mmaps) {
+        gt_filter_keep_mask_rebuild_ends(keep_mask,template);
+      } else {
+        uint64_t end;
+        for (end=0;end<2;++end) {
+          gt_alignment* const alignment = gt_template_get_block(template,end);
+          gt_filter_keep_mask_compact_maps(alignment,keep_mask->maps_keep[end]);
+          gt_alignment_recalculate_counters(alignment);
+        }
+        gt_template_clear_mmaps(template);
       }
     }
-    // Filter strand
-    if (parameters.filter_by_strand_se) {
-      if (map->strand==FORWARD && !parameters.allow_strand_f) continue;
-      if (map->strand==REVERSE && !parameters.allow_strand_r) continue;
+  }
+  // Recalculate counters
+  if (parameters.no_penalty_for_splitmaps) {
+    gt_template_recalculate_counters_and_sort_no_splits(template);
+  } else {
+    gt_template_recalculate_counters(template);
+  }
+  gt_filter_keep_mask_init(keep_mask,template);
+}
+/*
+ * Stages
+ */
+GT_INLINE void gt_filter_keep_mask_stage_begin(gt_filter_keep_mask* const keep_mask,gt_template* const template) {
+  uint64_t end;
+  keep_mask->stage_paired = gt_template_get_num_blocks(template)>1 && gt_filter_keep_mask_is_mapped(keep_mask,template);
+  gt_filter_keep_mask_fill(keep_mask->stage_mmaps_keep,gt_vector_get_used(keep_mask->mmaps_keep),false);
+  keep_mask->stage_num_mmaps_kept = 0;
+  for (end=0;end<2;++end) {
+    gt_filter_keep_mask_fill(keep_mask->stage_maps_keep[end],gt_vector_get_used(keep_mask->maps_keep[end]),false);
+    keep_mask->stage_num_maps_kept[end] = 0;
+  }
+}
+GT_INLINE void gt_filter_keep_mask_stage_keep_map(gt_filter_keep_mask* const keep_mask,const uint64_t end,const uint64_t map_pos) {
+  *gt_vector_get_elm(keep_mask->stage_maps_keep[end],map_pos,bool) = true;
+  ++(keep_mask->stage_num_maps_kept[end]);
+}
+GT_INLINE void gt_filter_keep_mask_stage_keep_mmap(gt_filter_keep_mask* const keep_mask,const uint64_t mmap_pos) {
+  *gt_vector_get_elm(keep_mask->stage_mmaps_keep,mmap_pos,bool) = true;
+  ++(keep_mask->stage_num_mmaps_kept);
+}
+GT_INLINE void gt_filter_keep_mask_stage_keep_first_map(gt_filter_keep_mask* const keep_mask,const uint64_t end) {
+  GT_FILTER_KEEP_MASK_ITERATE(keep_mask->maps_keep[end],map_pos) {
+    gt_filter_keep_mask_stage_keep_map(keep_mask,end,map_pos);
+    break;
+  }
+}
+GT_INLINE void gt_filter_keep_mask_stage_keep_first_mmap(gt_filter_keep_mask* const keep_mask) {
+  GT_FILTER_KEEP_MASK_ITERATE(keep_mask->mmaps_keep,mmap_pos) {
+    gt_filter_keep_mask_stage_keep_mmap(keep_mask,mmap_pos);
+    break;
+  }
+}
+GT_INLINE uint64_t gt_filter_keep_mask_stage_get_num_maps(gt_filter_keep_mask* const keep_mask,gt_template* const template) {
+  GT_TEMPLATE_IF_SE_ALINGMENT(template) {
+    return keep_mask->stage_num_maps_kept[0];
+  } else {
+    if (gt_template_get_not_unique_flag(template) || keep_mask->stage_num_mmaps_kept>0) {
+      return keep_mask->stage_num_mmaps_kept;
+    } else {
+      return (keep_mask->stage_paired) ? 0 : keep_mask->stage_num_maps_kept[0] + keep_mask->stage_num_maps_kept[1];
     }
-    // Filter quality scores
-    if (parameters.quality_score_ranges!=NULL) {
-      if (!gt_filter_is_quality_value_allowed((file_format==SAM) ? map->phred_score : map->gt_score)) continue;
+  }
+}
+GT_INLINE void gt_filter_keep_mask_stage_end(
+    gt_filter_keep_mask* const keep_mask,gt_template* const template,const bool take_result) {
+  uint64_t end;
+  if (take_result) {
+    if (keep_mask->stage_paired) {
+      GT_SWAP(keep_mask->mmaps_keep,keep_mask->stage_mmaps_keep);
+      keep_mask->num_mmaps_kept = keep_mask->stage_num_mmaps_kept;
+      for (end=0;end<2;++end) {
+        gt_filter_keep_mask_fill(keep_mask->maps_keep[end],gt_vector_get_used(keep_mask->maps_keep[end]),false);
+        keep_mask->num_maps_kept[end] = 0;
+      }
+      keep_mask->ends_from_mmaps = true;
+    } else {
+      for (end=0;end<2;++end) {
+        GT_SWAP(keep_mask->maps_keep[end],keep_mask->stage_maps_keep[end]);
+        keep_mask->num_maps_kept[end] = keep_mask->stage_num_maps_kept[end];
+      }
+      gt_filter_keep_mask_fill(keep_mask->mmaps_keep,gt_vector_get_used(keep_mask->mmaps_keep),false);
+      keep_mask->num_mmaps_kept = 0;
+      keep_mask->ends_from_mmaps = false;
     }
-    /*
-     * (3) Reduction of all maps
-     */
-    if (parameters.reduce_by_quality >= 0) {
-      const int64_t q = gt_alignment_sum_mismatch_qualities(alignment_src,map);
-      if (q!=0 && q!=max_mismatch_quality && abs(max_mismatch_quality-q)<=parameters.reduce_by_quality) continue;
+    keep_mask->rebuilt = true;
+  }
+  keep_mask->modified = true;
+  /*
+   * Apply right away if duplicates have to be resolved on each stage result, or if
+   * the maps are not in order (next stage has to see them sorted)
+   */
+  if (parameters.check_duplicates || (parameters.no_penalty_for_splitmaps && !keep_mask->sorted)) {
+    gt_filter_keep_mask_apply(keep_mask,template);
+  }
+}
+
+void gt_alignment_reduction_filter(
+    gt_template* const template,const uint64_t end,gt_filter_keep_mask* const keep_mask,const gt_file_format file_format) {
+  // Reduction by unique level (can be calculated beforehand)
+  const int64_t uniq_degree = (parameters.reduce_to_unique_strata >= 0) ?
+      gt_counters_get_uniq_degree(gt_filter_keep_mask_get_alignment_counters(keep_mask,template,end)) : 0;
+  const uint64_t num_maps = keep_mask->num_maps_kept[end];
+  GT_FILTER_KEEP_MASK_ITERATE(keep_mask->maps_keep[end],map_pos) {
+    if (parameters.reduce_to_unique_strata >= 0 &&
+       (uniq_degree >= parameters.reduce_to_unique_strata)) {
+      gt_filter_keep_mask_stage_keep_map(keep_mask,end,map_pos);
+      break;
     }
+    if(num_maps > parameters.reduce_to_unique) break;
+    gt_filter_keep_mask_stage_keep_map(keep_mask,end,map_pos);
+  }
+}
+
+void gt_alignment_dna_filter(
+    gt_template* const template,const uint64_t end,gt_filter_keep_mask* const keep_mask,
+    gt_filter_plan_stats* const plan_stats,const gt_file_format file_format) {
+  gt_alignment* const alignment_src = gt_template_get_block(template,end);
+  gt_filter_predicate_stats* const predicate_stats = (plan_stats!=NULL) ? plan_stats->map_predicates : NULL;
+  // Per-alignment invariants (only those the plan uses)
+  gt_filter_plan_context context;
+  gt_filter_plan_context_init(&context,file_format,template,alignment_src,gt_alignment_get_read_length(alignment_src));
+  if (parameters.max_strata_after_map >= 0.0) {
+    context.first_matching_distance =
+        gt_counters_get_min_matching_strata(gt_filter_keep_mask_get_alignment_counters(keep_mask,template,end)) - 1;
+  }
+  if (parameters.reduce_by_quality >= 0) {
+    context.max_mismatch_quality = gt_filter_keep_mask_get_alignment_max_mismatch_quality(keep_mask,template,end);
+  }
+  /*
+   * (1) Filtering of maps & (2) Reduction of all maps
+   */
+  GT_FILTER_KEEP_MASK_ITERATE(keep_mask->maps_keep[end],map_pos) {
+    gt_map* map = gt_alignment_get_map(alignment_src,map_pos);
+    const gt_filter_predicate_result result =
+        gt_filter_plan_evaluate(&filter_plan.map_predicates,predicate_stats,&context,&map,NULL);
+    if (result==GT_FILTER_STOP) break;
+    if (result==GT_FILTER_REJECT) continue;
     /*
-     * Insert the map
+     * Keep the map
      */
-    gt_alignment_insert_map(alignment_dst,gt_map_copy(map), parameters.check_duplicates);
+    gt_filter_keep_mask_stage_keep_map(keep_mask,end,map_pos);
     // Skip the rest if first map is enabled
-    if (parameters.first_map || pick_only_first_map) break;
+    if (parameters.first_map) break;
   }
   /*
-   * (4) Post-filtering steps
+   * (3) Post-filtering steps
    */
-  if (parameters.keep_first_map) {
-    if (gt_alignment_get_num_maps(alignment_dst)==0) {
-      gt_alignment_insert_map(alignment_dst,first_map, parameters.check_duplicates);
-    } else {
-      gt_map_delete(first_map);
-    }
+  if (parameters.keep_first_map && keep_mask->stage_num_maps_kept[end]==0) {
+    gt_filter_keep_mask_stage_keep_first_map(keep_mask,end);
   }
 }
-void gt_template_reduction_filter(gt_template* const template_dst,gt_template* const template_src,const gt_file_format file_format) {
-  GT_TEMPLATE_IF_SE_ALINGMENT(template_src) {
-    GT_TEMPLATE_REDUCTION(template_src,alignment_src);
-    GT_TEMPLATE_REDUCTION(template_dst,alignment_dst);
-    gt_alignment_reduction_filter(alignment_dst,alignment_src,file_format);
+void gt_template_reduction_filter(gt_template* const template,gt_filter_keep_mask* const keep_mask,const gt_file_format file_format) {
+  GT_TEMPLATE_IF_SE_ALINGMENT(template) {
+    gt_alignment_reduction_filter(template,0,keep_mask,file_format);
   } else {
-    if (!gt_template_is_mapped(template_src)) {
+    if (!keep_mask->stage_paired) {
       if(!parameters.reduce_to_pairs){
-        GT_TEMPLATE_REDUCE_BOTH_ENDS(template_src,alignment_src_end1,alignment_src_end2);
-        GT_TEMPLATE_REDUCE_BOTH_ENDS(template_dst,alignment_dst_end1,alignment_dst_end2);
-        gt_alignment_reduction_filter(alignment_dst_end1,alignment_src_end1,file_format);
-        gt_alignment_reduction_filter(alignment_dst_end2,alignment_src_end2,file_format);
+        gt_alignment_reduction_filter(template,0,keep_mask,file_format);
+        gt_alignment_reduction_filter(template,1,keep_mask,file_format);
       }
     } else {
-      GT_TEMPLATE_ITERATE_MMAP__ATTR(template_src,mmap,mmap_attributes) {
-        if (parameters.reduce_to_unique_strata >= 0 && (gt_template_get_uniq_degree(template_src) >= parameters.reduce_to_unique_strata)) {
-          gt_map** mmap_copy = gt_mmap_array_copy(mmap,__mmap_num_blocks);
-          gt_template_insert_mmap(template_dst,mmap_copy,mmap_attributes, parameters.check_duplicates);
-          free(mmap_copy);
+      const int64_t uniq_degree = (parameters.reduce_to_unique_strata >= 0) ?
+          gt_counters_get_uniq_degree(gt_filter_keep_mask_get_template_counters(keep_mask,template)) : 0;
+      const uint64_t num_mmaps = keep_mask->num_mmaps_kept;
+      GT_FILTER_KEEP_MASK_ITERATE(keep_mask->mmaps_keep,mmap_pos) {
+        if (parameters.reduce_to_unique_strata >= 0 && (uniq_degree >= parameters.reduce_to_unique_strata)) {
+          gt_filter_keep_mask_stage_keep_mmap(keep_mask,mmap_pos);
           break;
         }
-        if(gt_template_get_num_mmaps(template_src) >= parameters.reduce_to_unique) break;
-        gt_map** mmap_copy = gt_mmap_array_copy(mmap,__mmap_num_blocks);
-        gt_template_insert_mmap(template_dst,mmap_copy,mmap_attributes, parameters.check_duplicates);
-        free(mmap_copy);
-
+        if(num_mmaps >= parameters.reduce_to_unique) break;
+        gt_filter_keep_mask_stage_keep_mmap(keep_mask,mmap_pos);
       }
     }
   }
 }
-void gt_template_dna_filter(gt_template* const template_dst,gt_template* const template_src,const gt_file_format file_format) {
+void gt_template_dna_filter(
+    gt_template* const template,gt_filter_keep_mask* const keep_mask,
+    gt_filter_plan_stats* const plan_stats,const gt_file_format file_format) {
   /*
    * Filtering workflow
    *   (1) Pre-filtering steps
@@ -644,119 +1294,57 @@ void gt_template_dna_filter(gt_template* const template_dst,gt_template* const t
    *   (3) Reduction of all maps (taking them into account as a whole)
    *   (4) Post-filtering steps
    */
-  GT_TEMPLATE_IF_SE_ALINGMENT(template_src) {
-    GT_TEMPLATE_REDUCTION(template_src,alignment_src);
-    GT_TEMPLATE_REDUCTION(template_dst,alignment_dst);
-    gt_alignment_dna_filter(alignment_dst,alignment_src,file_format);
+  GT_TEMPLATE_IF_SE_ALINGMENT(template) {
+    gt_alignment_dna_filter(template,0,keep_mask,plan_stats,file_format);
   } else {
-    if (!gt_template_is_mapped(template_src)) {
-      GT_TEMPLATE_REDUCE_BOTH_ENDS(template_src,alignment_src_end1,alignment_src_end2);
-      GT_TEMPLATE_REDUCE_BOTH_ENDS(template_dst,alignment_dst_end1,alignment_dst_end2);
-      gt_alignment_dna_filter(alignment_dst_end1,alignment_src_end1,file_format);
-      gt_alignment_dna_filter(alignment_dst_end2,alignment_src_end2,file_format);
+    if (!keep_mask->stage_paired) {
+      gt_alignment_dna_filter(template,0,keep_mask,plan_stats,file_format);
+      gt_alignment_dna_filter(template,1,keep_mask,plan_stats,file_format);
     } else {
-      const uint64_t first_matching_distance = gt_counters_get_min_matching_strata(gt_template_get_counters_vector(template_src))-1;
-      const uint64_t max_mismatch_quality = gt_template_get_max_mismatch_quality(template_src);
-      // Reduction by unique level (can be calculated beforehand)
-      bool pick_only_first_map = false;
+      gt_filter_predicate_stats* const predicate_stats = (plan_stats!=NULL) ? plan_stats->mmap_predicates : NULL;
       /*
-       * (1) Pre-filtering steps
+       * (1) Per-template invariants (only those the plan uses)
        */
-      gt_map** first_mmap = NULL;
-      gt_mmap_attributes first_mmap_attributes = {0, 0, 0};
-      if (parameters.keep_first_map && gt_template_get_num_mmaps(template_src)>0) {
-        gt_mmap* const mmap = gt_template_get_mmap(template_src,0);
-        first_mmap = gt_mmap_array_copy(mmap->mmap,gt_template_get_num_blocks(template_src));
-        first_mmap_attributes = mmap->attributes;
+      gt_filter_plan_context context;
+      gt_filter_plan_context_init(&context,file_format,template,NULL,
+          gt_alignment_get_read_length(gt_template_get_end1(template))+gt_alignment_get_read_length(gt_template_get_end2(template)));
+      if (parameters.max_strata_after_map >= 0.0) {
+        context.first_matching_distance =
+            gt_counters_get_min_matching_strata(gt_filter_keep_mask_get_template_counters(keep_mask,template))-1;
+      }
+      if (parameters.reduce_by_quality >= 0) {
+        context.max_mismatch_quality = gt_filter_keep_mask_get_template_max_mismatch_quality(keep_mask,template);
       }
       /*
-       * (2) Filtering of maps
+       * (2) Filtering of maps & (3) Reduction of all maps
        */
-      GT_TEMPLATE_ITERATE_MMAP__ATTR(template_src,mmap,mmap_attributes) {
-        const int64_t current_stratum = parameters.no_penalty_for_splitmaps ?
-            gt_map_get_no_split_distance(mmap[0]) + gt_map_get_no_split_distance(mmap[1]):
-            gt_map_get_global_distance(mmap[0]) + gt_map_get_global_distance(mmap[1]);
-        if (parameters.max_strata_after_map >= 0.0 &&
-            (current_stratum-first_matching_distance) > gt_template_get_read_proportion(template_src,parameters.max_strata_after_map)) break;
-        // Check sequence name
-        if (parameters.map_ids!=NULL) {
-          if (!gt_filter_is_sequence_name_allowed(mmap[0]->seq_name)) continue;
-          if (!gt_filter_is_sequence_name_allowed(mmap[1]->seq_name)) continue;
-        }
-        // Check strata
-        if (parameters.min_event_distance != GT_FILTER_FLOAT_NO_VALUE || parameters.max_event_distance != GT_FILTER_FLOAT_NO_VALUE) {
-          const int64_t total_distance = parameters.no_penalty_for_splitmaps ?
-              gt_map_get_no_split_distance(mmap[0]) + gt_map_get_no_split_distance(mmap[1]):
-              gt_map_get_global_distance(mmap[0]) + gt_map_get_global_distance(mmap[1]);
-          if (parameters.min_event_distance != GT_FILTER_FLOAT_NO_VALUE) {
-            if (total_distance < gt_template_get_read_proportion(template_src,parameters.min_event_distance)) continue;
-          }
-          if (parameters.max_event_distance != GT_FILTER_FLOAT_NO_VALUE) {
-            if (total_distance > gt_template_get_read_proportion(template_src,parameters.max_event_distance)) continue;
-          }
-        }
-        // Check levenshtein distance
-        if (parameters.min_levenshtein_distance != GT_FILTER_FLOAT_NO_VALUE || parameters.max_levenshtein_distance != GT_FILTER_FLOAT_NO_VALUE) {
-          const int64_t total_distance = gt_map_get_global_levenshtein_distance(mmap[0])+gt_map_get_global_levenshtein_distance(mmap[1]);
-          if (parameters.min_levenshtein_distance != GT_FILTER_FLOAT_NO_VALUE) {
-            if (total_distance < gt_template_get_read_proportion(template_src,parameters.min_levenshtein_distance)) continue;
-          }
-          if (parameters.max_levenshtein_distance != GT_FILTER_FLOAT_NO_VALUE) {
-            if (total_distance > gt_template_get_read_proportion(template_src,parameters.max_levenshtein_distance)) continue;
-          }
-        }
-        // Check inss
-        if (parameters.min_inss > INT64_MIN || parameters.max_inss < INT64_MAX) {
-          gt_status error_code;
-          const int64_t inss = gt_template_get_insert_size(mmap,&error_code,0,0);
-          if (parameters.min_inss > inss || inss > parameters.max_inss) continue;
-        }
-        // Check strandness
-        if (parameters.filter_by_strand_se) {
-          if (!parameters.allow_strand_f && (mmap[0]->strand==FORWARD || mmap[1]->strand==FORWARD)) continue;
-          if (!parameters.allow_strand_r && (mmap[0]->strand==REVERSE || mmap[1]->strand==REVERSE)) continue;
-        }
-        if (parameters.filter_by_strand_pe) {
-          if (mmap[0]->strand==FORWARD && mmap[1]->strand==REVERSE && !parameters.allow_strand_fr) continue;
-          if (mmap[0]->strand==REVERSE && mmap[1]->strand==FORWARD && !parameters.allow_strand_rf) continue;
-          if (mmap[0]->strand==FORWARD && mmap[1]->strand==FORWARD && !parameters.allow_strand_ff) continue;
-          if (mmap[0]->strand==REVERSE && mmap[1]->strand==REVERSE && !parameters.allow_strand_rr) continue;
-        }
-        // Filter quality scores
-        if (parameters.quality_score_ranges!=NULL) {
-          if (!gt_filter_is_quality_value_allowed((file_format==SAM) ? mmap_attributes->phred_score : mmap_attributes->gt_score)) continue;
-        }
-        /*
-         * (3) Reduction of all maps
-         */
-        if (parameters.reduce_by_quality >= 0) {
-          const int64_t q = gt_alignment_sum_mismatch_qualities(gt_template_get_block(template_src,0), mmap[0]) +
-                            gt_alignment_sum_mismatch_qualities(gt_template_get_block(template_src,1), mmap[1]);
-          if (q!=0 && q!=max_mismatch_quality && abs(max_mismatch_quality-q)<=parameters.reduce_by_quality) continue;
-        }
+      GT_FILTER_KEEP_MASK_ITERATE(keep_mask->mmaps_keep,mmap_pos) {
+        gt_mmap* const template_mmap = gt_template_get_mmap(template,mmap_pos);
+        const gt_filter_predicate_result result = gt_filter_plan_evaluate(
+            &filter_plan.mmap_predicates,predicate_stats,&context,template_mmap->mmap,&template_mmap->attributes);
+        if (result==GT_FILTER_STOP) break;
+        if (result==GT_FILTER_REJECT) continue;
         /*
-         * Insert the map
+         * Keep the mmap
          */
-        gt_map** mmap_copy = gt_mmap_array_copy(mmap,__mmap_num_blocks);
-        gt_template_insert_mmap(template_dst,mmap_copy,mmap_attributes, parameters.check_duplicates);
-        free(mmap_copy);
+        gt_filter_keep_mask_stage_keep_mmap(keep_mask,mmap_pos);
         // Skip the rest if first map is enabled
-        if (parameters.first_map || pick_only_first_map) break;
+        if (parameters.first_map) break;
       }
       /*
        * (4) Post-filtering steps
        */
-      if (parameters.keep_first_map) {
-        if (gt_template_get_num_mmaps(template_dst)==0) {
-          gt_template_insert_mmap(template_dst,first_mmap,&first_mmap_attributes, parameters.check_duplicates);
-        }
-        free(first_mmap);
+      if (parameters.keep_first_map && keep_mask->stage_num_mmaps_kept==0) {
+        gt_filter_keep_mask_stage_keep_first_mmap(keep_mask);
       }
     }
   }
 }
-void gt_alignment_rna_filter(gt_alignment* const alignment_dst,gt_alignment* const alignment_src,const gt_file_format file_format) {
-  GT_ALIGNMENT_ITERATE(alignment_src,map) {
+void gt_alignment_rna_filter(
+    gt_template* const template,const uint64_t end,gt_filter_keep_mask* const keep_mask,const gt_file_format file_format) {
+  gt_alignment* const alignment_src = gt_template_get_block(template,end);
+  GT_FILTER_KEEP_MASK_ITERATE(keep_mask->maps_keep[end],map_pos) {
+    gt_map* const map = gt_alignment_get_map(alignment_src,map_pos);
     // Check sequence name
     if (parameters.map_ids!=NULL) {
       if (!gt_filter_is_sequence_name_allowed(map->seq_name)) continue;
@@ -779,38 +1367,35 @@ void gt_alignment_rna_filter(gt_alignment* const alignment_dst,gt_alignment* con
         if (gt_map_get_min_block_length(map) < parameters.min_block_length) continue;
       }
     }
-    // Insert the map
-    gt_alignment_insert_map(alignment_dst,gt_map_copy(map), parameters.check_duplicates);
+    // Keep the map
+    gt_filter_keep_mask_stage_keep_map(keep_mask,end,map_pos);
     // Skip the rest if best
     if (parameters.first_map) return;
   }
 }
 
-void gt_template_rna_filter(gt_template* const template_dst,gt_template* const template_src,const gt_file_format file_format) {
-  GT_TEMPLATE_IF_SE_ALINGMENT(template_src) {
-    GT_TEMPLATE_REDUCTION(template_src,alignment_src);
-    GT_TEMPLATE_REDUCTION(template_dst,alignment_dst);
+void gt_template_rna_filter(gt_template* const template,gt_filter_keep_mask* const keep_mask,const gt_file_format file_format) {
+  GT_TEMPLATE_IF_SE_ALINGMENT(template) {
     /*
      * SE
      */
-    gt_alignment_rna_filter(alignment_dst,alignment_src,file_format);
+    gt_alignment_rna_filter(template,0,keep_mask,file_format);
   } else {
     /*
      * PE
      */
-    if (!gt_template_is_mapped(template_src)) {
-      GT_TEMPLATE_REDUCE_BOTH_ENDS(template_src,alignment_src_end1,alignment_src_end2);
-      GT_TEMPLATE_REDUCE_BOTH_ENDS(template_dst,alignment_dst_end1,alignment_dst_end2);
-      gt_alignment_rna_filter(alignment_dst_end1,alignment_src_end1,file_format);
-      gt_alignment_rna_filter(alignment_dst_end2,alignment_src_end2,file_format);
+    if (!keep_mask->stage_paired) {
+      gt_alignment_rna_filter(template,0,keep_mask,file_format);
+      gt_alignment_rna_filter(template,1,keep_mask,file_format);
     } else {
-      const uint64_t num_blocks = gt_template_get_num_blocks(template_src);
-      GT_TEMPLATE_ITERATE_MMAP__ATTR(template_src,mmap,mmap_attributes) {
+      const uint64_t num_blocks = gt_template_get_num_blocks(template);
+      GT_FILTER_KEEP_MASK_ITERATE(keep_mask->mmaps_keep,mmap_pos) {
+        gt_map** const mmap = gt_template_get_mmap(template,mmap_pos)->mmap;
         // Check SM contained and get minimum intron length
         uint64_t has_sm = false;
         uint64_t min_intron_length = UINT64_MAX, min_block_length = UINT64_MAX;
         if (parameters.no_split_maps || parameters.only_split_maps || parameters.min_intron_length >= 0) {
-          GT_MMAP_ITERATE(mmap,map,end_p) {
+          GT_MMAP_ITERATE_ENDS(mmap,num_blocks,map,end_p) {
             if (gt_map_get_num_blocks(map) > 1) {
               const uint64_t mil = gt_map_get_min_intron_length(map);
               const uint64_t mbl = gt_map_get_min_block_length(map);
@@ -832,10 +1417,8 @@ void gt_template_rna_filter(gt_template* const template_dst,gt_template* const t
         if (parameters.min_block_length > 0 && min_block_length != UINT64_MAX){
           if(min_block_length < parameters.min_block_length) continue;
         }
-        // Add the mmap
-        gt_map** mmap_copy = gt_mmap_array_copy(mmap,num_blocks);
-        gt_template_insert_mmap(template_dst,mmap_copy,mmap_attributes, parameters.check_duplicates);
-        free(mmap_copy);
+        // Keep the mmap
+        gt_filter_keep_mask_stage_keep_mmap(keep_mask,mmap_pos);
         // Skip the rest if best
         if (parameters.first_map) return;
       }
@@ -844,13 +1427,13 @@ void gt_template_rna_filter(gt_template* const template_dst,gt_template* const t
 }
 GT_INLINE bool gt_filter_apply_filters(
     const gt_file_format file_format,const uint64_t line_no,
-    gt_sequence_archive* const sequence_archive,gt_template* const template) {
+    gt_sequence_archive* const sequence_archive,gt_template* const template,
+    gt_filter_keep_mask* const keep_mask,gt_filter_plan_stats* const plan_stats) {
   /*
    * Recalculate counters without penalty for splitmaps
    */
   if (parameters.no_penalty_for_splitmaps) {
-    gt_template_recalculate_counters_no_splits(template);
-    gt_template_sort_by_distance__score_no_split(template);
+    gt_template_recalculate_counters_and_sort_no_splits(template);
   }
   /*
    * Process Read/Qualities // TODO: move out of filter (this is processing)
@@ -944,103 +1527,73 @@ GT_INLINE bool gt_filter_apply_filters(
     gt_filter_mismatch_recovery_maps(parameters.name_input_file,line_no,template,sequence_archive);
   }
 
+  /*
+   * Map filtering stages (on the keep-mask, applied once at the end)
+   */
+  gt_filter_keep_mask_init(keep_mask,template);
   // check the split-map pairs for all paired alignments and
   // remove mapping pairs where the split are not coherent
-  if(gt_template_get_num_blocks(template) == 2 && gt_template_is_mapped(template)){
-    gt_template *template_filtered = gt_template_dup(template,false,false);
-    const uint64_t num_blocks = gt_template_get_num_blocks(template);
-    GT_TEMPLATE_ITERATE_MMAP__ATTR_(template,mmap,mmap_attributes) {
-      if (!gt_filter_are_overlapping_pairs_coherent(mmap))continue;
-      gt_map** mmap_copy = gt_mmap_array_copy(mmap,num_blocks);
-      gt_template_insert_mmap(template_filtered,mmap_copy,mmap_attributes, parameters.check_duplicates);
-      free(mmap_copy);
-    }
-    gt_template_swap(template,template_filtered);
-    gt_template_delete(template_filtered);
-    if (parameters.no_penalty_for_splitmaps) {
-      gt_template_recalculate_counters_no_splits(template);
-      gt_template_sort_by_distance__score_no_split(template);
-    }else{
-      gt_template_recalculate_counters(template);
+  if(gt_template_get_num_blocks(template) == 2 && gt_filter_keep_mask_is_mapped(keep_mask,template)){
+    gt_filter_keep_mask_stage_begin(keep_mask,template);
+    GT_FILTER_KEEP_MASK_ITERATE(keep_mask->mmaps_keep,mmap_pos) {
+      if (!gt_filter_are_overlapping_pairs_coherent(gt_template_get_mmap(template,mmap_pos)->mmap))continue;
+      gt_filter_keep_mask_stage_keep_mmap(keep_mask,mmap_pos);
     }
+    gt_filter_keep_mask_stage_end(keep_mask,template,true);
   }
 
-
   // Map DNA-filtering
-  uint64_t num_maps = gt_filter_get_num_maps(template);
+  uint64_t num_maps = gt_filter_keep_mask_get_num_maps(keep_mask,template);
   if (parameters.perform_dna_map_filter && (!parameters.keep_unique || num_maps > 1)) {
-    gt_template *template_filtered = gt_template_dup(template,false,false);
-    gt_template_dna_filter(template_filtered,template,file_format);
-
+    gt_filter_keep_mask_stage_begin(keep_mask,template);
+    gt_template_dna_filter(template,keep_mask,plan_stats,file_format);
     // if keep_unique is on, we only flip if we have at least one
     // alignment left
-    if(!parameters.keep_unique || gt_filter_get_num_maps(template_filtered) > 0){
-      gt_template_swap(template,template_filtered);
-    }
-
-    gt_template_delete(template_filtered);
-    if (parameters.no_penalty_for_splitmaps) {
-      gt_template_recalculate_counters_no_splits(template);
-      gt_template_sort_by_distance__score_no_split(template);
-    }else{
-      gt_template_recalculate_counters(template);
-    }
+    gt_filter_keep_mask_stage_end(keep_mask,template,
+        !parameters.keep_unique || gt_filter_keep_mask_stage_get_num_maps(keep_mask,template) > 0);
   }
 
   // Map RNA-filtering
-  num_maps = gt_filter_get_num_maps(template);
+  num_maps = gt_filter_keep_mask_get_num_maps(keep_mask,template);
   if (parameters.perform_rna_map_filter && (!parameters.keep_unique || num_maps > 1)) {
-    gt_template *template_filtered = gt_template_dup(template,false,false);
-    gt_template_rna_filter(template_filtered,template,file_format);
+    gt_filter_keep_mask_stage_begin(keep_mask,template);
+    gt_template_rna_filter(template,keep_mask,file_format);
     // if keep_unique is on, we only flip if we have at least one
     // alignment left
-    if(!parameters.keep_unique || gt_filter_get_num_maps(template_filtered) > 0){
-      gt_template_swap(template,template_filtered);
-    }
-    // delete filtered and recalculate counters
-    gt_template_delete(template_filtered);
-    if (parameters.no_penalty_for_splitmaps) {
-      gt_template_recalculate_counters_no_splits(template);
-      gt_template_sort_by_distance__score_no_split(template);
-    }else{
-      gt_template_recalculate_counters(template);
-    }
-
+    gt_filter_keep_mask_stage_end(keep_mask,template,
+        !parameters.keep_unique || gt_filter_keep_mask_stage_get_num_maps(keep_mask,template) > 0);
   }
 
-  // Map Annotation-filtering
-  num_maps = gt_filter_get_num_maps(template);
-  if (parameters.gtf != NULL && parameters.perform_annotation_filter && num_maps > 1) {
-    gt_template *template_filtered = gt_template_dup(template,false,false);
-    bool filtered = gt_filter_make_reduce_by_annotation(template_filtered,template);
-    if(filtered && (!parameters.keep_unique || gt_filter_get_num_maps(template_filtered) > 0)){
-      gt_template_swap(template,template_filtered);
-    }
+  // Map Annotation-filtering (reorders the maps, so it works on the compacted template)
+  if (parameters.gtf != NULL && parameters.perform_annotation_filter) {
+    gt_filter_keep_mask_apply(keep_mask,template);
+    num_maps = gt_filter_get_num_maps(template);
+    if (num_maps > 1) {
+      gt_template *template_filtered = gt_template_dup(template,false,false);
+      bool filtered = gt_filter_make_reduce_by_annotation(template_filtered,template);
+      if(filtered && (!parameters.keep_unique || gt_filter_get_num_maps(template_filtered) > 0)){
+        gt_template_swap(template,template_filtered);
+      }
 
-    gt_template_delete(template_filtered);
-    if (parameters.no_penalty_for_splitmaps) {
-      gt_template_recalculate_counters_no_splits(template);
-      gt_template_sort_by_distance__score_no_split(template);
-    }else{
-      gt_template_recalculate_counters(template);
+      gt_template_delete(template_filtered);
+      if (parameters.no_penalty_for_splitmaps) {
+        gt_template_recalculate_counters_and_sort_no_splits(template);
+      }else{
+        gt_template_recalculate_counters(template);
+      }
+      gt_filter_keep_mask_init(keep_mask,template);
     }
-
   }
 
   // reduce by level filter
-  num_maps = gt_filter_get_num_maps(template);
+  num_maps = gt_filter_keep_mask_get_num_maps(keep_mask,template);
   if ((parameters.reduce_to_unique_strata >= 0 || parameters.reduce_to_unique != UINT64_MAX|| parameters.reduce_to_pairs) && (num_maps > 1)) {
-    gt_template *template_filtered = gt_template_dup(template,false,false);
-    gt_template_reduction_filter(template_filtered,template,file_format);
-    gt_template_swap(template,template_filtered);
-    gt_template_delete(template_filtered);
-    if (parameters.no_penalty_for_splitmaps) {
-      gt_template_recalculate_counters_no_splits(template);
-      gt_template_sort_by_distance__score_no_split(template);
-    }else{
-      gt_template_recalculate_counters(template);
-    }
+    gt_filter_keep_mask_stage_begin(keep_mask,template);
+    gt_template_reduction_filter(template,keep_mask,file_format);
+    gt_filter_keep_mask_stage_end(keep_mask,template,true);
   }
+  // Compact the template
+  gt_filter_keep_mask_apply(keep_mask,template);
 
   // Map pruning
   if (parameters.matches_pruning) gt_filter_prune_matches(template);
@@ -1057,12 +1610,13 @@ GT_INLINE void gt_filter__print(
     uint64_t* const total_algs_checked,uint64_t* const total_algs_correct,
     uint64_t* const total_maps_checked,uint64_t* const total_maps_correct,
     gt_buffered_output_file* const buffered_output,gt_generic_printer_attributes* const generic_printer_attributes,
-    gt_buffered_output_file* const buffered_discarded_output,gt_generic_printer_attributes* const discarded_output_attributes) {
+    gt_buffered_output_file* const buffered_discarded_output,gt_generic_printer_attributes* const discarded_output_attributes,
+    gt_filter_keep_mask* const keep_mask,gt_filter_plan_stats* const plan_stats) {
   bool discaded = false;
   /*
    * Apply Filters
    */
-  if (!gt_filter_apply_filters(file_format,line_no,sequence_archive,template)) discaded = true;
+  if (!gt_filter_apply_filters(file_format,line_no,sequence_archive,template,keep_mask,plan_stats)) discaded = true;
   if (parameters.uniform_read) { // Check zero-length reads
     GT_TEMPLATE_ITERATE_ALIGNMENT(template,alignment) {
       if (gt_alignment_get_read_length(alignment)==0) return;
@@ -1132,6 +1686,33 @@ GT_INLINE void gt_filter_sample_read_print_fasta(
   gt_bofprintf(buffered_output,"\n"PRIgts"\n",
       PRIgts_trimmed_content(read,left_trim,right_trim));
 }
+/*
+ * Segmented reads regrouping. The segments of the open group are swapped out of the parsing
+ *   template and kept aside (still pointing to the input block) until the group is complete
+ */
+#define GT_FILTER_GROUP_SEGMENTS_INITIAL_ELEMENTS 16
+GT_INLINE void gt_filter_group_reads_keep_segment(
+    gt_vector* const group_segments,const uint64_t segment_pos,gt_template* const template) {
+  if (segment_pos>=gt_vector_get_used(group_segments)) {
+    gt_vector_insert(group_segments,gt_template_new(),gt_template*);
+  }
+  gt_template_swap(*gt_vector_get_elm(group_segments,segment_pos,gt_template*),template);
+}
+GT_INLINE void gt_filter_group_reads_detach_segments(gt_vector* const group_segments,const uint64_t num_segments) {
+  // The input block is about to be reloaded, so the group kept so far is copied out of it
+  uint64_t i;
+  for (i=0;i<num_segments;++i) {
+    gt_template** const segment = gt_vector_get_elm(group_segments,i,gt_template*);
+    gt_template* const segment_copy = gt_template_dup(*segment,true,true);
+    gt_template_delete(*segment);
+    *segment = segment_copy;
+  }
+}
+GT_INLINE void gt_filter_group_reads_remove_segmented_read_info(gt_template* const template) {
+  GT_TEMPLATE_ITERATE_ALIGNMENT(template,alignment) {
+    gt_attributes_remove(alignment->attributes,GT_ATTR_ID_SEGMENTED_READ_INFO); // If any
+  }
+}
 GT_INLINE void gt_filter_group_reads() {
   // Open file IN/OUT
   gt_input_file* input_file = (parameters.name_input_file==NULL) ?
@@ -1140,61 +1721,95 @@ GT_INLINE void gt_filter_group_reads() {
             gt_output_stream_new(stdout,SORTED_FILE) : gt_output_file_new(parameters.name_output_file,SORTED_FILE);
   // Prepare out-printers
   if (parameters.output_format==FILE_FORMAT_UNKNOWN) parameters.output_format = input_file->file_format; // Select output format
-  gt_generic_printer_attributes* const generic_printer_attributes = gt_generic_printer_attributes_new(parameters.output_format);
-  // SegmentedRead aux variables
-  gt_template* const group_template = gt_template_new();
-  uint64_t total_segments = 0, last_segment_id = 0;
-  GT_BEGIN_READING_WRITING_LOOP(input_file,output_file,parameters.paired_end,buffered_output,template) {
-    // Get group attribute
-    gt_segmented_read_info* const segmented_read_info = gt_attributes_get_segmented_read_info(template->attributes);
-    if (segmented_read_info==NULL) {
-      gt_filter_cond_fatal_error_msg(total_segments!=last_segment_id,
-          "Expected SegmentedRead Info => lastRead(%"PRIu64"/%"PRIu64")",last_segment_id,total_segments);
-      gt_template_restore_trim(template); // If any
-      GT_TEMPLATE_ITERATE_ALIGNMENT(group_template,alignment) {
-        gt_attributes_remove(alignment->attributes,GT_ATTR_ID_SEGMENTED_READ_INFO); // If any
+  // Only MAP/SAM blocks are synchronized wrt the tag (i.e. always contain whole groups)
+  const uint64_t num_threads = (input_file->file_format==MAP || input_file->file_format==SAM) ? parameters.num_threads : 1;
+  // Parallel I/O
+#ifdef HAVE_OPENMP
+  #pragma omp parallel num_threads(num_threads)
+#endif
+  {
+    // Prepare IN/OUT buffers & printers
+    gt_status error_code;
+    gt_buffered_input_file* const __buffered_input = gt_buffered_input_file_new(input_file);
+    gt_buffered_output_file* const buffered_output = gt_buffered_output_file_new(output_file);
+    gt_buffered_input_file_attach_buffered_output(__buffered_input,buffered_output);
+    gt_generic_printer_attributes* const generic_printer_attributes = gt_generic_printer_attributes_new(parameters.output_format);
+    gt_generic_parser_attributes* const generic_parser_attributes = gt_input_generic_parser_attributes_new(parameters.paired_end);
+    gt_input_map_parser_attributes_set_synch_segmented_reads(generic_parser_attributes->map_parser_attributes,true);
+    // SegmentedRead aux variables
+    gt_vector* const group_segments = gt_vector_new(GT_FILTER_GROUP_SEGMENTS_INITIAL_ELEMENTS,sizeof(gt_template*));
+    uint64_t total_segments = 0, last_segment_id = 0;
+    gt_template* const template = gt_template_new();
+    while (true) {
+      // Keep the open group safe from block reloading (only if the input blocks are not synchronized)
+      if (last_segment_id!=total_segments && gt_buffered_input_file_eob(__buffered_input)) {
+        gt_filter_group_reads_detach_segments(group_segments,last_segment_id);
+      }
+      if (!(error_code=gt_input_generic_parser_get_template(__buffered_input,template,generic_parser_attributes))) break;
+      if (error_code!=GT_IMP_OK) {
+        gt_error_msg("Fatal error parsing file '%s', line %"PRIu64"\n",
+            input_file->file_name,__buffered_input->current_line_num-1);
+        continue;
+      }
+      // Get group attribute
+      gt_segmented_read_info* const segmented_read_info = gt_attributes_get_segmented_read_info(template->attributes);
+      if (segmented_read_info==NULL) {
+        gt_filter_cond_fatal_error_msg(total_segments!=last_segment_id,
+            "Expected SegmentedRead Info => lastRead(%"PRIu64"/%"PRIu64")",last_segment_id,total_segments);
+        gt_template_restore_trim(template); // If any
+        gt_filter_group_reads_remove_segmented_read_info(template);
+        gt_output_generic_bofprint_template(buffered_output,template,generic_printer_attributes); // Print it, as it is
+        continue;
       }
-      gt_output_generic_bofprint_template(buffered_output,template,generic_printer_attributes); // Print it, as it is
-    } else {
       // First, undo the trim
       gt_template_restore_trim(template);
       // Tackle the group merging
+      const uint64_t segment_id = segmented_read_info->segment_id;
       if (last_segment_id==total_segments) {
         /*
          * New group
          */
-        gt_filter_cond_fatal_error_msg(segmented_read_info->total_segments==0 || segmented_read_info->segment_id!=1,
+        gt_filter_cond_fatal_error_msg(segmented_read_info->total_segments==0 || segment_id!=1,
             "Wrong SegmentedRead Info (Zero reads in group or not properly sorted)");
-        gt_template_clear(group_template,true);
-        gt_template_copy(group_template,template,true,true);
         total_segments = segmented_read_info->total_segments;
-        last_segment_id = segmented_read_info->segment_id;
-      } else if (segmented_read_info->segment_id==last_segment_id+1 && segmented_read_info->segment_id <= total_segments) {
+      } else if (segment_id==last_segment_id+1 && segment_id <= total_segments) {
         /*
-         * Old group (Keep merging)
+         * Old group (Keep collecting)
          */
+        gt_template* const group_template = *gt_vector_get_elm(group_segments,0,gt_template*);
         gt_filter_cond_fatal_error_msg(!gt_string_equals(template->tag,group_template->tag),
             "Wrong TAG in Segmented Reads Sequence ('"PRIgts"'/'"PRIgts"')",PRIgts_content(group_template->tag),PRIgts_content(template->tag));
-        gt_template_merge_template_mmaps(group_template,template);
-        last_segment_id = segmented_read_info->segment_id;
-        if (last_segment_id==total_segments) { // Close group
-          GT_TEMPLATE_ITERATE_ALIGNMENT(group_template,alignment) {
-            gt_attributes_remove(alignment->attributes,GT_ATTR_ID_SEGMENTED_READ_INFO); // If any
-          }
-          gt_output_generic_bofprint_template(buffered_output,group_template,generic_printer_attributes);
-        }
       } else {
         gt_filter_fatal_error_msg("Wrong SegmentedRead Info => Expected(%"PRIu64"/%"PRIu64")::Found(%"PRIu64"/%"PRIu64").",
-            segmented_read_info->segment_id,segmented_read_info->total_segments,last_segment_id,total_segments);
+            segment_id,segmented_read_info->total_segments,last_segment_id,total_segments);
+      }
+      gt_filter_group_reads_keep_segment(group_segments,segment_id-1,template);
+      last_segment_id = segment_id;
+      if (last_segment_id==total_segments) {
+        /*
+         * Close group (merge all the segments' mmaps into the first one at once)
+         */
+        gt_template** const segments = gt_vector_get_mem(group_segments,gt_template*);
+        gt_template_merge_template_mmaps_a(segments[0],segments+1,total_segments-1);
+        gt_filter_group_reads_remove_segmented_read_info(segments[0]);
+        gt_output_generic_bofprint_template(buffered_output,segments[0],generic_printer_attributes);
       }
     }
-  } GT_END_READING_WRITING_LOOP(input_file,output_file,template);
-  // Check proper end of merging groups
-  gt_filter_cond_fatal_error_msg(total_segments!=last_segment_id,
-      "Expected SegmentedRead Info => lastRead(%"PRIu64"/%"PRIu64")",last_segment_id,total_segments);
+    // Check proper end of merging groups
+    gt_filter_cond_fatal_error_msg(total_segments!=last_segment_id,
+        "Expected SegmentedRead Info => lastRead(%"PRIu64"/%"PRIu64")",last_segment_id,total_segments);
+    // Clean
+    GT_VECTOR_ITERATE(group_segments,segment,segment_pos,gt_template*) {
+      gt_template_delete(*segment);
+    }
+    gt_vector_delete(group_segments);
+    gt_template_delete(template);
+    gt_input_generic_parser_attributes_delete(generic_parser_attributes);
+    gt_generic_printer_attributes_delete(generic_printer_attributes);
+    gt_buffered_input_file_close(__buffered_input);
+    gt_buffered_output_file_close(buffered_output);
+  }
   // Clean
-  gt_template_delete(group_template);
-  gt_generic_printer_attributes_delete(generic_printer_attributes);
   gt_input_file_close(input_file);
   gt_output_file_close(output_file);
 }
@@ -1270,62 +1885,193 @@ GT_INLINE void gt_filter_sample_read() {
   gt_input_file_close(input_file);
   gt_output_file_close(output_file);
 }
-GT_INLINE void gt_filter_print_insert_size_distribution() {
-  // Open file IN/OUT
-  gt_input_file* input_file = (parameters.name_input_file==NULL) ?
-      gt_input_stream_open(stdin) : gt_input_file_open(parameters.name_input_file,parameters.mmap_input);
-  gt_output_file* output_file = (parameters.name_output_file==NULL) ?
-            gt_output_stream_new(stdout,SORTED_FILE) : gt_output_file_new(parameters.name_output_file,SORTED_FILE);
-  // Parallel I/O
-#ifdef HAVE_OPENMP
-  #pragma omp parallel num_threads(parameters.num_threads)
-#endif
-  {
-    GT_BEGIN_READING_WRITING_LOOP(input_file,output_file,parameters.paired_end,buffered_output,template) {
-      // Print insert size
-      if (gt_template_get_num_blocks(template)!=2) continue;
-      GT_TEMPLATE_ITERATE_(template,mmap) {
-        gt_status error_code;
-        gt_bofprintf(buffered_output,"%"PRIu64"\n",gt_template_get_insert_size(mmap,&error_code,0,0));
-        if (parameters.first_map) break;
+/*
+ * Distribution histograms (--insert-size-plot/--error-plot)
+ *   Accumulated per thread over fixed buckets and merged at the end
+ */
+#define GT_FILTER_HIST_INSERT_SIZE_RANGE 50000 /* Last bucket accumulates larger sizes */
+#define GT_FILTER_HIST_ERRORS_RANGE      256   /* Last bucket accumulates more errors */
+#define GT_FILTER_HIST_CYCLES_RANGE      GT_STATS_LARGE_READ_POS_RANGE
+#define GT_FILTER_HIST_QUALITY_RANGE     GT_STATS_QUAL_SCORE_RANGE
+typedef struct {
+  uint64_t* insert_size;    /* GT_FILTER_HIST_INSERT_SIZE_RANGE */
+  uint64_t* errors;         /* GT_FILTER_HIST_ERRORS_RANGE */
+  uint64_t* error_position; /* GT_FILTER_HIST_CYCLES_RANGE */
+  uint64_t* quality_cycle;  /* GT_FILTER_HIST_CYCLES_RANGE*GT_FILTER_HIST_QUALITY_RANGE */
+} gt_filter_histograms;
+GT_INLINE gt_filter_histograms* gt_filter_histograms_new(const bool insert_size,const bool errors) {
+  gt_filter_histograms* const histograms = gt_alloc(gt_filter_histograms);
+  histograms->insert_size = (insert_size) ? gt_calloc(GT_FILTER_HIST_INSERT_SIZE_RANGE,uint64_t,true) : NULL;
+  histograms->errors = (errors) ? gt_calloc(GT_FILTER_HIST_ERRORS_RANGE,uint64_t,true) : NULL;
+  histograms->error_position = (errors) ? gt_calloc(GT_FILTER_HIST_CYCLES_RANGE,uint64_t,true) : NULL;
+  histograms->quality_cycle = (errors) ? gt_calloc(GT_FILTER_HIST_CYCLES_RANGE*GT_FILTER_HIST_QUALITY_RANGE,uint64_t,true) : NULL;
+  return histograms;
+}
+GT_INLINE void gt_filter_histograms_delete(gt_filter_histograms* const histograms) {
+  if (histograms->insert_size!=NULL) gt_free(histograms->insert_size);
+  if (histograms->errors!=NULL) gt_free(histograms->errors);
+  if (histograms->error_position!=NULL) gt_free(histograms->error_position);
+  if (histograms->quality_cycle!=NULL) gt_free(histograms->quality_cycle);
+  gt_free(histograms);
+}
+GT_INLINE void gt_filter_histograms_add_buckets(uint64_t* const buckets_dst,uint64_t* const buckets_src,const uint64_t num_buckets) {
+  uint64_t i;
+  for (i=0;i<num_buckets;++i) buckets_dst[i] += buckets_src[i];
+}
+GT_INLINE void gt_filter_histograms_merge(gt_filter_histograms* const histograms_dst,gt_filter_histograms* const histograms_src) {
+  if (histograms_dst->insert_size!=NULL) {
+    gt_filter_histograms_add_buckets(histograms_dst->insert_size,histograms_src->insert_size,GT_FILTER_HIST_INSERT_SIZE_RANGE);
+  }
+  if (histograms_dst->errors!=NULL) {
+    gt_filter_histograms_add_buckets(histograms_dst->errors,histograms_src->errors,GT_FILTER_HIST_ERRORS_RANGE);
+    gt_filter_histograms_add_buckets(histograms_dst->error_position,histograms_src->error_position,GT_FILTER_HIST_CYCLES_RANGE);
+    gt_filter_histograms_add_buckets(histograms_dst->quality_cycle,histograms_src->quality_cycle,
+        GT_FILTER_HIST_CYCLES_RANGE*GT_FILTER_HIST_QUALITY_RANGE);
+  }
+}
+GT_INLINE void gt_filter_histograms_count_insert_size(gt_filter_histograms* const histograms,gt_template* const template) {
+  if (gt_template_get_num_blocks(template)!=2) return;
+  GT_TEMPLATE_ITERATE_(template,mmap) {
+    if (mmap[0]!=NULL && mmap[1]!=NULL) {
+      gt_status error_code;
+      const int64_t insert_size = gt_template_get_insert_size(mmap,&error_code,0,0);
+      // Negative sizes (e.g. RF-oriented pairs) are not counted, same as gt.scorereads
+      if (error_code==GT_TEMPLATE_INSERT_SIZE_OK && insert_size>0) {
+        ++histograms->insert_size[GT_MIN(insert_size,GT_FILTER_HIST_INSERT_SIZE_RANGE-1)];
       }
-    } GT_END_READING_WRITING_LOOP(input_file,output_file,template);
+    }
+    if (parameters.first_map) break;
   }
-  // Clean
-  gt_input_file_close(input_file);
-  gt_output_file_close(output_file);
 }
-GT_INLINE void gt_filter_print_error_distribution() {
-  // Open file IN/OUT
+GT_INLINE void gt_filter_histograms_count_mmap_errors(
+    gt_filter_histograms* const histograms,gt_map** const mmap,const uint64_t num_blocks) {
+  // One error value per mmap (summed over the ends), error positions per end
+  ++histograms->errors[GT_MIN(gt_mmap_get_global_levenshtein_distance(mmap,num_blocks),GT_FILTER_HIST_ERRORS_RANGE-1)];
+  GT_MMAP_ITERATE_ENDS(mmap,num_blocks,map,end_pos) {
+    if (map==NULL) continue;
+    uint64_t multi_block_offset = 0;
+    GT_MAP_ITERATE(map,map_block) {
+      GT_MISMS_ITERATE(map_block,misms) {
+        const uint64_t position = misms->position + multi_block_offset;
+        if (position < GT_FILTER_HIST_CYCLES_RANGE) ++histograms->error_position[position];
+      }
+      multi_block_offset += gt_map_get_base_length(map_block);
+    }
+  }
+}
+GT_INLINE void gt_filter_histograms_count_errors(gt_filter_histograms* const histograms,gt_template* const template) {
+  const uint64_t num_blocks = gt_template_get_num_blocks(template);
+  // Quality by cycle
+  GT_TEMPLATE_ITERATE_ALIGNMENT(template,alignment) {
+    if (!gt_alignment_has_qualities(alignment)) continue;
+    const uint64_t num_cycles = GT_MIN(gt_string_get_length(alignment->qualities),GT_FILTER_HIST_CYCLES_RANGE);
+    const uint8_t* const qualities = (uint8_t*)gt_string_get_string(alignment->qualities);
+    uint64_t cycle;
+    for (cycle=0;cycle<num_cycles;++cycle) {
+      ++histograms->quality_cycle[cycle*GT_FILTER_HIST_QUALITY_RANGE+qualities[cycle]];
+    }
+  }
+  // Errors of the maps (just the best one if --first-map)
+  if (parameters.first_map) {
+    gt_map** best_mmap = NULL;
+    uint64_t best_distance = UINT64_MAX;
+    GT_TEMPLATE_ITERATE_(template,mmap) {
+      const uint64_t distance = gt_mmap_get_global_levenshtein_distance(mmap,num_blocks);
+      if (distance < best_distance) {
+        best_distance = distance;
+        best_mmap = mmap;
+      }
+    }
+    if (best_mmap!=NULL) gt_filter_histograms_count_mmap_errors(histograms,best_mmap,num_blocks);
+  } else {
+    GT_TEMPLATE_ITERATE_(template,mmap) {
+      gt_filter_histograms_count_mmap_errors(histograms,mmap,num_blocks);
+    }
+  }
+}
+GT_INLINE void gt_filter_histograms_print_insert_size(gt_output_file* const output_file,gt_filter_histograms* const histograms) {
+  // Insert size distribution as read by gt.scorereads (--insert-dist)
+  gt_ofprintf(output_file,"Size\tPaired\n");
+  uint64_t i;
+  for (i=0;i<GT_FILTER_HIST_INSERT_SIZE_RANGE-1;++i) {
+    if (histograms->insert_size[i]) gt_ofprintf(output_file,"%"PRIu64"\t%"PRIu64"\n",i,histograms->insert_size[i]);
+  }
+  if (histograms->insert_size[i]) gt_ofprintf(output_file,">=%"PRIu64"\t%"PRIu64"\n",i,histograms->insert_size[i]);
+}
+GT_INLINE void gt_filter_histograms_print_errors(gt_output_file* const output_file,gt_filter_histograms* const histograms) {
+  uint64_t i, j;
+  gt_ofprintf(output_file,"[ERRORS]\nErrors\tCount\n");
+  for (i=0;i<GT_FILTER_HIST_ERRORS_RANGE-1;++i) {
+    if (histograms->errors[i]) gt_ofprintf(output_file,"%"PRIu64"\t%"PRIu64"\n",i,histograms->errors[i]);
+  }
+  if (histograms->errors[i]) gt_ofprintf(output_file,">=%"PRIu64"\t%"PRIu64"\n",i,histograms->errors[i]);
+  gt_ofprintf(output_file,"[ERRORS.POSITION]\nPosition\tCount\n");
+  for (i=0;i<GT_FILTER_HIST_CYCLES_RANGE;++i) {
+    if (histograms->error_position[i]) gt_ofprintf(output_file,"%"PRIu64"\t%"PRIu64"\n",i,histograms->error_position[i]);
+  }
+  gt_ofprintf(output_file,"[QUALITY.CYCLE]\nCycle\tQuality\tCount\n");
+  for (i=0;i<GT_FILTER_HIST_CYCLES_RANGE;++i) {
+    uint64_t* const cycle_qualities = histograms->quality_cycle+i*GT_FILTER_HIST_QUALITY_RANGE;
+    for (j=0;j<GT_FILTER_HIST_QUALITY_RANGE;++j) {
+      if (cycle_qualities[j]) gt_ofprintf(output_file,"%"PRIu64"\t%"PRIu64"\t%"PRIu64"\n",i,j,cycle_qualities[j]);
+    }
+  }
+}
+GT_INLINE void gt_filter_print_distribution(const bool insert_size) {
+  // Open file IN/OUT (Histograms are printed at the end, so no ordering is kept)
   gt_input_file* input_file = (parameters.name_input_file==NULL) ?
       gt_input_stream_open(stdin) : gt_input_file_open(parameters.name_input_file,parameters.mmap_input);
   gt_output_file* output_file = (parameters.name_output_file==NULL) ?
-            gt_output_stream_new(stdout,SORTED_FILE) : gt_output_file_new(parameters.name_output_file,SORTED_FILE);
-  // Parallel I/O
+            gt_output_stream_new(stdout,UNSORTED_FILE) : gt_output_file_new(parameters.name_output_file,UNSORTED_FILE);
+  gt_filter_histograms* const histograms = gt_filter_histograms_new(insert_size,!insert_size);
+  // Parallel reading+process
 #ifdef HAVE_OPENMP
   #pragma omp parallel num_threads(parameters.num_threads)
 #endif
   {
-    GT_BEGIN_READING_WRITING_LOOP(input_file,output_file,parameters.paired_end,buffered_output,template) {
-      // Print levenshtein distance of the maps
-      if (parameters.first_map)  {
-        uint64_t best_distance = UINT64_MAX;
-        GT_TEMPLATE_ITERATE_(template,mmap) {
-          const uint64_t dist = gt_map_get_global_levenshtein_distance(*mmap);
-          if (dist < best_distance) best_distance = dist;
-        }
-        if (best_distance < UINT64_MAX) gt_bofprintf(buffered_output,"%"PRIu64"\n",best_distance);
+    gt_filter_histograms* const thread_histograms = gt_filter_histograms_new(insert_size,!insert_size);
+    gt_buffered_input_file* buffered_input = gt_buffered_input_file_new(input_file);
+    gt_generic_parser_attributes* const generic_parser_attributes = gt_input_generic_parser_attributes_new(parameters.paired_end);
+    gt_template* const template = gt_template_new();
+    gt_status error_code;
+    while ((error_code=gt_input_generic_parser_get_template(buffered_input,template,generic_parser_attributes))) {
+      if (error_code!=GT_IMP_OK) {
+        gt_error_msg("Fatal error parsing file '%s', line %"PRIu64"\n",input_file->file_name,buffered_input->current_line_num-1);
+        continue;
+      }
+      if (insert_size) {
+        gt_filter_histograms_count_insert_size(thread_histograms,template);
       } else {
-        GT_TEMPLATE_ITERATE_(template,mmap) {
-          gt_bofprintf(buffered_output,"%"PRIu64"\n",gt_map_get_global_levenshtein_distance(*mmap));
-        }
+        gt_filter_histograms_count_errors(thread_histograms,template);
       }
-    } GT_END_READING_WRITING_LOOP(input_file,output_file,template);
+    }
+    // Merge & Clean
+#ifdef HAVE_OPENMP
+    #pragma omp critical
+#endif
+    gt_filter_histograms_merge(histograms,thread_histograms);
+    gt_filter_histograms_delete(thread_histograms);
+    gt_template_delete(template);
+    gt_input_generic_parser_attributes_delete(generic_parser_attributes);
+    gt_buffered_input_file_close(buffered_input);
+  }
+  // Print
+  if (insert_size) {
+    gt_filter_histograms_print_insert_size(output_file,histograms);
+  } else {
+    gt_filter_histograms_print_errors(output_file,histograms);
   }
   // Clean
+  gt_filter_histograms_delete(histograms);
   gt_input_file_close(input_file);
   gt_output_file_close(output_file);
 }
+GT_INLINE void gt_filter_print_insert_size_distribution() {
+  gt_filter_print_distribution(true);
+}
+GT_INLINE void gt_filter_print_error_distribution() {
+  gt_filter_print_distribution(false);
+}
 /*
  * Handler for opening an archive (GEMIndex/MULTIFastaFile)
  */
@@ -1398,6 +2144,10 @@ void gt_filter_read__write() {
     parameters.gtf = gt_gtf_read_from_file(parameters.annotation, parameters.num_threads);
   }
 
+  // Compile the map filtering criteria
+  gt_filter_plan_compile();
+  gt_filter_plan_stats* const plan_stats = parameters.filter_stats ? gt_calloc(1,gt_filter_plan_stats,true) : NULL;
+
   // Parallel reading+process
   uint64_t total_algs_checked=0, total_algs_correct=0, total_maps_checked=0, total_maps_correct=0;
 #ifdef HAVE_OPENMP
@@ -1430,6 +2180,8 @@ void gt_filter_read__write() {
      */
     uint64_t record_num = 0;
     gt_template* template = gt_template_new();
+    gt_filter_keep_mask* const keep_mask = gt_filter_keep_mask_new();
+    gt_filter_plan_stats* const thread_plan_stats = (plan_stats!=NULL) ? gt_calloc(1,gt_filter_plan_stats,true) : NULL;
     if (parameters.check_format && parameters.check_file_format==FASTA) {
       /*
        * FASTA I/O loop
@@ -1439,7 +2191,7 @@ void gt_filter_read__write() {
         // Apply all filters and print
         gt_filter__print(input_file->file_format,buffered_input->current_line_num-1,sequence_archive,template,
             &total_algs_checked,&total_algs_correct,&total_maps_checked,&total_maps_correct,
-            buffered_output,generic_printer_attributes,buffered_discarded_output,discarded_output_attributes);
+            buffered_output,generic_printer_attributes,buffered_discarded_output,discarded_output_attributes,keep_mask,thread_plan_stats);
       }
     } else if (parameters.check_format && parameters.check_file_format==MAP) {
       /*
@@ -1451,7 +2203,7 @@ void gt_filter_read__write() {
         // Apply all filters and print
         gt_filter__print(input_file->file_format,buffered_input->current_line_num-1,sequence_archive,template,
             &total_algs_checked,&total_algs_correct,&total_maps_checked,&total_maps_correct,
-            buffered_output,generic_printer_attributes,buffered_discarded_output,discarded_output_attributes);
+            buffered_output,generic_printer_attributes,buffered_discarded_output,discarded_output_attributes,keep_mask,thread_plan_stats);
       }
       gt_input_map_parser_attributes_delete(attr);
     } else if (parameters.check_format && parameters.check_file_format==SAM) {
@@ -1464,7 +2216,7 @@ void gt_filter_read__write() {
         // Apply all filters and print
         gt_filter__print(input_file->file_format,buffered_input->current_line_num-1,sequence_archive,template,
             &total_algs_checked,&total_algs_correct,&total_maps_checked,&total_maps_correct,
-            buffered_output,generic_printer_attributes,buffered_discarded_output,discarded_output_attributes);
+            buffered_output,generic_printer_attributes,buffered_discarded_output,discarded_output_attributes,keep_mask,thread_plan_stats);
       }
       gt_input_sam_parser_attributes_delete(attr);
     } else {
@@ -1478,11 +2230,19 @@ void gt_filter_read__write() {
         // Apply all filters and print
         gt_filter__print(input_file->file_format,buffered_input->current_line_num-1,sequence_archive,template,
             &total_algs_checked,&total_algs_correct,&total_maps_checked,&total_maps_correct,
-            buffered_output,generic_printer_attributes,buffered_discarded_output,discarded_output_attributes);
+            buffered_output,generic_printer_attributes,buffered_discarded_output,discarded_output_attributes,keep_mask,thread_plan_stats);
       }
       gt_input_generic_parser_attributes_delete(generic_parser_attributes);
     }
     // Clean
+    if (thread_plan_stats!=NULL) {
+#ifdef HAVE_OPENMP
+      #pragma omp critical
+#endif
+      gt_filter_plan_stats_merge(plan_stats,thread_plan_stats);
+      gt_free(thread_plan_stats);
+    }
+    gt_filter_keep_mask_delete(keep_mask);
     gt_template_delete(template);
     gt_buffered_input_file_close(buffered_input);
     gt_generic_printer_attributes_delete(generic_printer_attributes);
@@ -1499,6 +2259,13 @@ void gt_filter_read__write() {
         total_algs_checked,total_algs_correct,GT_GET_PERCENTAGE(total_algs_correct,total_algs_checked),
         total_maps_correct,GT_GET_PERCENTAGE(total_maps_correct,total_maps_checked));
   }
+  /*
+   * Print filter stats
+   */
+  if (plan_stats!=NULL) {
+    gt_filter_plan_print_stats(plan_stats);
+    gt_free(plan_stats);
+  }
   // Release archive & Clean
   if (sequence_archive) gt_sequence_archive_delete(sequence_archive);
   gt_filter_delete_map_ids(parameters.map_ids);
@@ -1581,17 +2348,14 @@ void gt_filter_get_argument_pair_strandness(char* const strandness_opt) {
   parameters.filter_by_strand_pe = true;
 }
 void gt_filter_get_argument_map_id(char* const maps_ids) {
-  // Allocate vector
-  parameters.map_ids = gt_vector_new(20,sizeof(gt_string*));
+  // Allocate hash
+  if (parameters.map_ids==NULL) parameters.map_ids = gt_shash_new();
   // Add all the valid map Ids (sequence names)
   char *opt;
   opt = strtok(maps_ids,",");
   while (opt!=NULL) {
-    // Get id
-    gt_string* map_id = gt_string_new(0);
-    gt_string_set_string(map_id,opt);
-    // Add to the vector
-    gt_vector_insert(parameters.map_ids,map_id,gt_string*);
+    // Add to the set
+    gt_shash_insert(parameters.map_ids,opt,true,bool);
     // Next
     opt = strtok(NULL,","); // Reload
   }
@@ -1916,6 +2680,9 @@ void parse_arguments(int argc,char** argv) {
       parameters.load_index = true;
       parameters.display_pretty = true;
       break;
+    case 1004: // filter-stats
+      parameters.filter_stats = true;
+      break;
     /* Misc */
     case 't': // threads
 #ifdef HAVE_OPENMP
@@ -1975,9 +2742,9 @@ int main(int argc,char** argv) {
 
   // Depreciated
   } else if (parameters.error_plot) {
-    gt_filter_print_insert_size_distribution();
-  } else if (parameters.insert_size_plot) {
     gt_filter_print_error_distribution();
+  } else if (parameters.insert_size_plot) {
+    gt_filter_print_insert_size_distribution();
   // Depreciated
 
   } else {
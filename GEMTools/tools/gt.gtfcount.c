@@ -22,6 +22,7 @@ typedef struct {
   char *name_output_file;
   char *gene_counts_file;
   char *annotation;
+  char *compiled_annotation;
   FILE *output_file;
   FILE *output_file_json;
   bool shell;
@@ -73,6 +74,7 @@ gt_gtfcount_args parameters = {
     .gene_counts_file=NULL,
     .coverage_profiles=false,
     .annotation=NULL,
+    .compiled_annotation=NULL,
     .paired=false,
     .unique_only=true,
     .weighted_counts=false,
@@ -467,6 +469,9 @@ void parse_arguments(int argc,char** argv) {
     case 'p':
       parameters.paired = true;
       break;
+    case 201:
+      parameters.compiled_annotation = optarg;
+      break;
     /* Counts */
     case 'w':
       parameters.weighted_counts = true;
@@ -826,6 +831,15 @@ int main(int argc,char** argv) {
   gt_gtf* const gtf = gt_gtf_read_from_file(parameters.annotation, parameters.num_threads);
   gt_gtfcount_warn("Done\n");
 
+  // store the compiled annotation
+  if(parameters.compiled_annotation != NULL){
+    gt_gtfcount_warn("Writing compiled annotation...");
+    gt_gtf_write_compiled(gtf, parameters.compiled_annotation);
+    gt_gtfcount_warn("Done\n");
+    gt_gtf_delete(gtf);
+    return 0;
+  }
+
   // run the shell
   if(parameters.shell){
     gt_gtfcount_run_shell(gtf);
@@ -0,0 +1,541 @@
+/*
+ * PROJECT: GEM-Tools library
+ * FILE: gt.junctions.c
+ * DATE: 19/10/2026
+ * DESCRIPTION: Extracts the junction sites supported by the split-maps of a MAP file
+ */
+
+#include <getopt.h>
+#ifdef HAVE_OPENMP
+#include <omp.h>
+#endif
+
+#include "gem_tools.h"
+
+#define GT_JUNCTIONS_TABLE_INITIAL_CAPACITY 1024
+
+typedef struct {
+  /* I/O */
+  char* name_input_file;
+  char* name_output_file;
+  bool paired_end;
+  /* Junctions */
+  uint64_t min_split_size;
+  uint64_t max_split_size;
+  uint64_t max_matches;
+  uint64_t coverage;
+  char* name_annotation_file;
+  char* name_annotation_junctions_file;
+  /* Misc */
+  uint64_t num_threads;
+  bool verbose;
+} gt_junctions_args;
+
+gt_junctions_args parameters = {
+  /* I/O */
+  .name_input_file=NULL,
+  .name_output_file=NULL,
+  .paired_end=false,
+  /* Junctions */
+  .min_split_size=4,
+  .max_split_size=2500000,
+  .max_matches=1,
+  .coverage=0,
+  .name_annotation_file=NULL,
+  .name_annotation_junctions_file=NULL,
+  /* Misc */
+  .num_threads=1,
+  .verbose=false,
+};
+
+/*
+ * Junction site. Sites are stored with (left<right) whatever the strand
+ * of the split-maps supporting them; the strand is only decided on output.
+ */
+typedef struct {
+  uint64_t sequence_id; // 1-based, 0 marks an empty slot of the table
+  uint64_t left;  // Last base of the left block
+  uint64_t right; // First base of the right block
+  uint64_t forward_count;
+  uint64_t reverse_count;
+} gt_junctions_site;
+
+/*
+ * Open-addressing table of sites (linear probing, power of two capacity)
+ */
+typedef struct {
+  gt_junctions_site* sites;
+  uint64_t capacity;
+  uint64_t num_sites;
+} gt_junctions_table;
+
+/*
+ * Site counter. One per thread plus the merged one
+ */
+typedef struct {
+  gt_shash* sequence_ids;     // Sequence name -> (uint64_t) sequence_id
+  gt_vector* sequence_names;  // (char*) Sequence names indexed by sequence_id-1
+  gt_junctions_table* sites;
+  /* Last sequence looked up */
+  gt_string* last_sequence_name;
+  uint64_t last_sequence_id;
+  /* Stats */
+  uint64_t num_templates;
+  uint64_t num_splits;
+} gt_junctions_counter;
+
+/*
+ * Junctions table
+ */
+GT_INLINE gt_junctions_table* gt_junctions_table_new(const uint64_t capacity) {
+  gt_junctions_table* const table = gt_alloc(gt_junctions_table);
+  table->sites = gt_calloc(capacity,gt_junctions_site,true);
+  table->capacity = capacity;
+  table->num_sites = 0;
+  return table;
+}
+GT_INLINE void gt_junctions_table_delete(gt_junctions_table* const table) {
+  gt_free(table->sites);
+  gt_free(table);
+}
+GT_INLINE uint64_t gt_junctions_table_hash(const uint64_t sequence_id,const uint64_t left,const uint64_t right) {
+  uint64_t hash = (sequence_id*0x9E3779B97F4A7C15ull) ^ left;
+  hash = (hash*0xBF58476D1CE4E5B9ull) ^ right;
+  hash ^= hash >> 31;
+  hash *= 0x94D049BB133111EBull;
+  return hash ^ (hash >> 29);
+}
+GT_INLINE gt_junctions_site* gt_junctions_table_probe(
+    gt_junctions_site* const sites,const uint64_t capacity,
+    const uint64_t sequence_id,const uint64_t left,const uint64_t right) {
+  const uint64_t mask = capacity-1;
+  uint64_t slot = gt_junctions_table_hash(sequence_id,left,right) & mask;
+  while (sites[slot].sequence_id!=0) {
+    gt_junctions_site* const site = sites+slot;
+    if (site->sequence_id==sequence_id && site->left==left && site->right==right) return site;
+    slot = (slot+1) & mask;
+  }
+  return sites+slot; // Empty slot
+}
+GT_INLINE void gt_junctions_table_grow(gt_junctions_table* const table) {
+  const uint64_t capacity = 2*table->capacity;
+  gt_junctions_site* const sites = gt_calloc(capacity,gt_junctions_site,true);
+  uint64_t i;
+  for (i=0;i<table->capacity;++i) {
+    gt_junctions_site* const site = table->sites+i;
+    if (site->sequence_id==0) continue;
+    *gt_junctions_table_probe(sites,capacity,site->sequence_id,site->left,site->right) = *site;
+  }
+  gt_free(table->sites);
+  table->sites = sites;
+  table->capacity = capacity;
+}
+GT_INLINE gt_junctions_site* gt_junctions_table_get_site(
+    gt_junctions_table* const table,const uint64_t sequence_id,const uint64_t left,const uint64_t right) {
+  gt_junctions_site* site = gt_junctions_table_probe(table->sites,table->capacity,sequence_id,left,right);
+  if (site->sequence_id!=0) return site;
+  // Keep the load factor under 1/2
+  if (2*(table->num_sites+1) > table->capacity) {
+    gt_junctions_table_grow(table);
+    site = gt_junctions_table_probe(table->sites,table->capacity,sequence_id,left,right);
+  }
+  site->sequence_id = sequence_id;
+  site->left = left;
+  site->right = right;
+  ++table->num_sites;
+  return site;
+}
+GT_INLINE bool gt_junctions_table_contains(
+    gt_junctions_table* const table,const uint64_t sequence_id,const uint64_t left,const uint64_t right) {
+  return gt_junctions_table_probe(table->sites,table->capacity,sequence_id,left,right)->sequence_id!=0;
+}
+
+/*
+ * Junctions counter
+ */
+GT_INLINE gt_junctions_counter* gt_junctions_counter_new(void) {
+  gt_junctions_counter* const counter = gt_alloc(gt_junctions_counter);
+  counter->sequence_ids = gt_shash_new();
+  counter->sequence_names = gt_vector_new(32,sizeof(char*));
+  counter->sites = gt_junctions_table_new(GT_JUNCTIONS_TABLE_INITIAL_CAPACITY);
+  counter->last_sequence_name = gt_string_new(32);
+  counter->last_sequence_id = 0;
+  counter->num_templates = 0;
+  counter->num_splits = 0;
+  return counter;
+}
+GT_INLINE void gt_junctions_counter_delete(gt_junctions_counter* const counter) {
+  gt_shash_delete(counter->sequence_ids,true);
+  gt_vector_delete(counter->sequence_names);
+  gt_junctions_table_delete(counter->sites);
+  gt_string_delete(counter->last_sequence_name);
+  gt_free(counter);
+}
+GT_INLINE uint64_t gt_junctions_counter_get_sequence_id(gt_junctions_counter* const counter,char* const sequence_name) {
+  uint64_t* sequence_id = gt_shash_get(counter->sequence_ids,sequence_name,uint64_t);
+  if (sequence_id!=NULL) return *sequence_id;
+  sequence_id = gt_malloc_uint64();
+  *sequence_id = gt_vector_get_used(counter->sequence_names)+1;
+  gt_shash_insert(counter->sequence_ids,sequence_name,sequence_id,uint64_t);
+  gt_vector_insert(counter->sequence_names,gt_shash_get_key(counter->sequence_ids,sequence_name),char*);
+  return *sequence_id;
+}
+GT_INLINE uint64_t gt_junctions_counter_get_map_sequence_id(gt_junctions_counter* const counter,gt_map* const map) {
+  // Split-maps come sorted by sequence more often than not
+  gt_string* const sequence_name = gt_map_get_string_seq_name(map);
+  if (counter->last_sequence_id==0 || !gt_string_equals(counter->last_sequence_name,sequence_name)) {
+    gt_string_set_nstring(counter->last_sequence_name,gt_string_get_string(sequence_name),gt_string_get_length(sequence_name));
+    counter->last_sequence_id = gt_junctions_counter_get_sequence_id(counter,gt_string_get_string(counter->last_sequence_name));
+  }
+  return counter->last_sequence_id;
+}
+GT_INLINE void gt_junctions_counter_count_map(gt_junctions_counter* const counter,gt_map* const map) {
+  GT_MAP_ITERATE(map,map_block) {
+    if (!gt_map_has_next_block(map_block)) break;
+    if (gt_map_get_junction(map_block)!=SPLICE) continue;
+    gt_map* const next_block = gt_map_get_next_block(map_block);
+    if (gt_map_get_strand(map_block)!=gt_map_get_strand(next_block)) continue;
+    if (!gt_string_equals(gt_map_get_string_seq_name(map_block),gt_map_get_string_seq_name(next_block))) continue;
+    // Blocks of reverse split-maps are stored in read order (decreasing positions)
+    const bool in_order = gt_map_get_position(map_block)<=gt_map_get_position(next_block);
+    gt_map* const left_block = in_order ? map_block : next_block;
+    gt_map* const right_block = in_order ? next_block : map_block;
+    const uint64_t left = gt_map_get_end_mapping_position(left_block);
+    const uint64_t right = gt_map_get_position(right_block);
+    if (right<=left) continue; // Overlapping blocks
+    const uint64_t split_size = right-left-1;
+    if (split_size<parameters.min_split_size || split_size>parameters.max_split_size) continue;
+    // Count
+    const uint64_t sequence_id = gt_junctions_counter_get_map_sequence_id(counter,map_block);
+    gt_junctions_site* const site = gt_junctions_table_get_site(counter->sites,sequence_id,left,right);
+    if (gt_map_get_strand(map_block)==REVERSE) ++site->reverse_count; else ++site->forward_count;
+    ++counter->num_splits;
+  }
+}
+GT_INLINE void gt_junctions_counter_count_template(gt_junctions_counter* const counter,gt_template* const template) {
+  ++counter->num_templates;
+  GT_TEMPLATE_ITERATE_ALIGNMENT(template,alignment) {
+    // Multi-maps beyond the max-matches are not trusted
+    const uint64_t num_matches = GT_MAX(gt_alignment_get_num_maps(alignment),
+        gt_counters_reduce_sum(gt_alignment_get_counters_vector(alignment)));
+    if (num_matches==0 || num_matches>parameters.max_matches) continue;
+    GT_ALIGNMENT_ITERATE(alignment,map) {
+      if (gt_map_get_num_blocks(map)>1) gt_junctions_counter_count_map(counter,map);
+    }
+  }
+}
+GT_INLINE void gt_junctions_counter_merge(gt_junctions_counter* const counter,gt_junctions_counter* const source) {
+  // Translate the sequence ids of the source
+  const uint64_t num_sequences = gt_vector_get_used(source->sequence_names);
+  uint64_t* const sequence_ids = gt_calloc(num_sequences+1,uint64_t,true);
+  uint64_t i;
+  for (i=0;i<num_sequences;++i) {
+    sequence_ids[i+1] = gt_junctions_counter_get_sequence_id(counter,*gt_vector_get_elm(source->sequence_names,i,char*));
+  }
+  // Add up the sites
+  for (i=0;i<source->sites->capacity;++i) {
+    gt_junctions_site* const source_site = source->sites->sites+i;
+    if (source_site->sequence_id==0) continue;
+    gt_junctions_site* const site = gt_junctions_table_get_site(counter->sites,
+        sequence_ids[source_site->sequence_id],source_site->left,source_site->right);
+    site->forward_count += source_site->forward_count;
+    site->reverse_count += source_site->reverse_count;
+  }
+  counter->num_templates += source->num_templates;
+  counter->num_splits += source->num_splits;
+  gt_free(sequence_ids);
+}
+
+/*
+ * Annotated sites (positions at either side of an annotated junction).
+ *   Stored as (sequence_id,position,position) on the sites table
+ */
+GT_INLINE void gt_junctions_add_annotated_site(
+    gt_junctions_counter* const counter,gt_junctions_table* const annotated_sites,
+    char* const sequence_name,const uint64_t position) {
+  const uint64_t sequence_id = gt_junctions_counter_get_sequence_id(counter,sequence_name);
+  gt_junctions_table_get_site(annotated_sites,sequence_id,position,position);
+}
+int gt_junctions_cmp_exons(const void* const a,const void* const b) {
+  const gt_gtf_entry* const exon_a = *(gt_gtf_entry**)a;
+  const gt_gtf_entry* const exon_b = *(gt_gtf_entry**)b;
+  // Transcript IDs are unique strings of the annotation
+  if (exon_a->transcript_id!=exon_b->transcript_id) return (exon_a->transcript_id<exon_b->transcript_id) ? -1 : 1;
+  if (exon_a->start!=exon_b->start) return (exon_a->start<exon_b->start) ? -1 : 1;
+  return 0;
+}
+void gt_junctions_load_annotation(gt_junctions_counter* const counter,gt_junctions_table* const annotated_sites) {
+  gt_gtf* const gtf = gt_gtf_read_from_file(parameters.name_annotation_file,parameters.num_threads);
+  gt_vector* const exons = gt_vector_new(1024,sizeof(gt_gtf_entry*));
+  GT_SHASH_BEGIN_ITERATE(gtf->refs,sequence_name,ref,gt_gtf_ref) {
+    // Gather the exons of the reference grouped by transcript
+    gt_vector_clear(exons);
+    GT_VECTOR_ITERATE(ref->entries,entry_it,entry_pos,gt_gtf_entry*) {
+      gt_gtf_entry* const entry = *entry_it;
+      if (entry->transcript_id==NULL || entry->type==NULL) continue;
+      if (!gt_streq(gt_string_get_string(entry->type),"exon")) continue;
+      if (entry->end<=entry->start+1) continue; // Same filter as the annotation junctions of the pipeline
+      gt_vector_insert(exons,entry,gt_gtf_entry*);
+    }
+    const uint64_t num_exons = gt_vector_get_used(exons);
+    gt_gtf_entry** const exon = gt_vector_get_mem(exons,gt_gtf_entry*);
+    qsort(exon,num_exons,sizeof(gt_gtf_entry*),gt_junctions_cmp_exons);
+    // Consecutive exons of a transcript define a junction
+    uint64_t i;
+    for (i=1;i<num_exons;++i) {
+      if (exon[i]->transcript_id!=exon[i-1]->transcript_id) continue;
+      gt_junctions_add_annotated_site(counter,annotated_sites,sequence_name,exon[i-1]->end);
+      gt_junctions_add_annotated_site(counter,annotated_sites,sequence_name,exon[i]->start);
+    }
+  } GT_SHASH_END_ITERATE;
+  gt_vector_delete(exons);
+  gt_gtf_delete(gtf);
+}
+void gt_junctions_load_annotation_junctions(gt_junctions_counter* const counter,gt_junctions_table* const annotated_sites) {
+  // Junctions file (chr1 strand1 pos1 chr2 strand2 pos2)
+  FILE* const junctions_file = fopen(parameters.name_annotation_junctions_file,"r");
+  gt_cond_fatal_error(junctions_file==NULL,FILE_OPEN,parameters.name_annotation_junctions_file);
+  char* line = NULL;
+  size_t line_allocated = 0;
+  uint64_t line_num = 0;
+  while (getline(&line,&line_allocated,junctions_file)!=-1) {
+    ++line_num;
+    if (line[0]=='\n' || line[0]=='#') continue;
+    char* fields[6];
+    char* cursor = line;
+    uint64_t num_fields;
+    for (num_fields=0;num_fields<6 && cursor!=NULL;++num_fields) fields[num_fields] = strsep(&cursor,"\t\n");
+    if (num_fields<6 || fields[2][0]=='\0' || fields[5][0]=='\0') {
+      gt_fatal_error_msg("Error parsing junctions file '%s':%"PRIu64"\n",parameters.name_annotation_junctions_file,line_num);
+    }
+    gt_junctions_add_annotated_site(counter,annotated_sites,fields[0],strtoull(fields[2],NULL,10));
+    gt_junctions_add_annotated_site(counter,annotated_sites,fields[3],strtoull(fields[5],NULL,10));
+  }
+  free(line);
+  fclose(junctions_file);
+}
+
+/*
+ * Output
+ */
+int gt_junctions_cmp_sites(const void* const a,const void* const b) {
+  const gt_junctions_site* const site_a = (gt_junctions_site*)a;
+  const gt_junctions_site* const site_b = (gt_junctions_site*)b;
+  if (site_a->sequence_id!=site_b->sequence_id) return (site_a->sequence_id<site_b->sequence_id) ? -1 : 1;
+  if (site_a->left!=site_b->left) return (site_a->left<site_b->left) ? -1 : 1;
+  if (site_a->right!=site_b->right) return (site_a->right<site_b->right) ? -1 : 1;
+  return 0;
+}
+int gt_junctions_cmp_sequence_names(const void* const a,const void* const b) {
+  return strcmp(*(char**)a,*(char**)b);
+}
+uint64_t gt_junctions_print_sites(
+    FILE* const output,gt_junctions_counter* const counter,
+    gt_junctions_table* const annotated_sites,uint64_t* const num_rescued) {
+  // Sort the sequences by name
+  const uint64_t num_sequences = gt_vector_get_used(counter->sequence_names);
+  char** const sequence_names = gt_calloc(num_sequences,char*,false);
+  memcpy(sequence_names,gt_vector_get_mem(counter->sequence_names,char*),num_sequences*sizeof(char*));
+  qsort(sequence_names,num_sequences,sizeof(char*),gt_junctions_cmp_sequence_names);
+  uint64_t* const sequence_rank = gt_calloc(num_sequences+1,uint64_t,true);
+  uint64_t i;
+  for (i=0;i<num_sequences;++i) {
+    sequence_rank[*gt_shash_get(counter->sequence_ids,sequence_names[i],uint64_t)] = i;
+  }
+  // Select the sites (sequence_id replaced by the rank of its name)
+  gt_junctions_site* const sites = gt_calloc(counter->sites->num_sites,gt_junctions_site,false);
+  uint64_t num_sites = 0;
+  *num_rescued = 0;
+  for (i=0;i<counter->sites->capacity;++i) {
+    gt_junctions_site* const site = counter->sites->sites+i;
+    if (site->sequence_id==0) continue;
+    if (site->forward_count+site->reverse_count < parameters.coverage) {
+      if (annotated_sites==NULL) continue;
+      if (!gt_junctions_table_contains(annotated_sites,site->sequence_id,site->left,site->left) &&
+          !gt_junctions_table_contains(annotated_sites,site->sequence_id,site->right,site->right)) continue;
+      ++(*num_rescued);
+    }
+    sites[num_sites] = *site;
+    sites[num_sites].sequence_id = sequence_rank[site->sequence_id];
+    ++num_sites;
+  }
+  qsort(sites,num_sites,sizeof(gt_junctions_site),gt_junctions_cmp_sites);
+  // Print (donor first)
+  for (i=0;i<num_sites;++i) {
+    gt_junctions_site* const site = sites+i;
+    char* const sequence_name = sequence_names[site->sequence_id];
+    if (site->forward_count>=site->reverse_count) {
+      fprintf(output,"%s\t+\t%"PRIu64"\t%s\t+\t%"PRIu64"\n",sequence_name,site->left,sequence_name,site->right);
+    } else {
+      fprintf(output,"%s\t-\t%"PRIu64"\t%s\t-\t%"PRIu64"\n",sequence_name,site->right,sequence_name,site->left);
+    }
+  }
+  gt_free(sites);
+  gt_free(sequence_rank);
+  gt_free(sequence_names);
+  return num_sites;
+}
+
+void gt_junctions_extract() {
+  // Open file IN/OUT
+  gt_input_file* const input_file = (parameters.name_input_file==NULL) ?
+      gt_input_stream_open(stdin) : gt_input_file_open(parameters.name_input_file,false);
+  FILE* const output = (parameters.name_output_file==NULL) ? stdout : fopen(parameters.name_output_file,"w");
+  gt_cond_fatal_error(output==NULL,FILE_OPEN,parameters.name_output_file);
+
+  // Annotated sites
+  gt_junctions_counter* const counter = gt_junctions_counter_new();
+  gt_junctions_table* annotated_sites = NULL;
+  if (parameters.name_annotation_file!=NULL || parameters.name_annotation_junctions_file!=NULL) {
+    annotated_sites = gt_junctions_table_new(GT_JUNCTIONS_TABLE_INITIAL_CAPACITY);
+    if (parameters.name_annotation_file!=NULL) gt_junctions_load_annotation(counter,annotated_sites);
+    if (parameters.name_annotation_junctions_file!=NULL) gt_junctions_load_annotation_junctions(counter,annotated_sites);
+  }
+
+  // Parallel reading+process
+  gt_junctions_counter** const thread_counters = gt_calloc(parameters.num_threads,gt_junctions_counter*,true);
+#ifdef HAVE_OPENMP
+  #pragma omp parallel num_threads(parameters.num_threads)
+#endif
+  {
+#ifdef HAVE_OPENMP
+    uint64_t tid = omp_get_thread_num();
+#else
+    uint64_t tid = 0;
+#endif
+    gt_junctions_counter* const thread_counter = gt_junctions_counter_new();
+    thread_counters[tid] = thread_counter;
+    gt_buffered_input_file* buffered_input = gt_buffered_input_file_new(input_file);
+    gt_map_parser_attributes* const input_map_attributes = gt_input_map_parser_attributes_new(parameters.paired_end);
+    gt_status error_code;
+    gt_template* template = gt_template_new();
+    while ((error_code=gt_input_map_parser_get_template(buffered_input,template,input_map_attributes))) {
+      if (error_code!=GT_IMP_OK) {
+        gt_error_msg("Fatal error parsing file '%s':%"PRIu64"\n",parameters.name_input_file,buffered_input->current_line_num-1);
+        continue;
+      }
+      gt_junctions_counter_count_template(thread_counter,template);
+    }
+    // Clean
+    gt_template_delete(template);
+    gt_input_map_parser_attributes_delete(input_map_attributes);
+    gt_buffered_input_file_close(buffered_input);
+  }
+
+  // Merge the thread counters (OpenMP may run fewer threads than requested)
+  uint64_t i;
+  for (i=0;i<parameters.num_threads;++i) {
+    if (thread_counters[i]==NULL) continue;
+    gt_junctions_counter_merge(counter,thread_counters[i]);
+    gt_junctions_counter_delete(thread_counters[i]);
+  }
+  gt_free(thread_counters);
+
+  // Print the junctions
+  uint64_t num_rescued;
+  const uint64_t num_printed = gt_junctions_print_sites(output,counter,annotated_sites,&num_rescued);
+  if (parameters.verbose) {
+    fprintf(stderr,"[GT.junctions] Templates %"PRIu64" :: Splits %"PRIu64" :: Junctions %"PRIu64" (%"PRIu64" printed, %"PRIu64" rescued by the annotation)\n",
+        counter->num_templates,counter->num_splits,counter->sites->num_sites,num_printed,num_rescued);
+  }
+
+  // Clean
+  if (annotated_sites!=NULL) gt_junctions_table_delete(annotated_sites);
+  gt_junctions_counter_delete(counter);
+  gt_input_file_close(input_file);
+  if (output!=stdout) fclose(output);
+}
+
+void usage(const gt_option* const options,char* groups[],const bool print_inactive) {
+  fprintf(stderr, "USE: ./gt.junctions [ARGS]...\n");
+  gt_options_fprint_menu(stderr,options,groups,false,print_inactive);
+}
+
+void parse_arguments(int argc,char** argv) {
+  struct option* gt_junctions_getopt = gt_options_adaptor_getopt(gt_junctions_options);
+  gt_string* const gt_junctions_short_getopt = gt_options_adaptor_getopt_short(gt_junctions_options);
+  int option, option_index;
+  while (true) {
+    // Get option &  Select case
+    if ((option=getopt_long(argc,argv,
+        gt_string_get_string(gt_junctions_short_getopt),gt_junctions_getopt,&option_index))==-1) break;
+    switch (option) {
+    /* I/O */
+    case 'i':
+      parameters.name_input_file = optarg;
+      break;
+    case 'o':
+      parameters.name_output_file = optarg;
+      break;
+    case 'p':
+      parameters.paired_end = true;
+      break;
+    /* Junctions */
+    case 's':
+      parameters.min_split_size = atol(optarg);
+      break;
+    case 'S':
+      parameters.max_split_size = atol(optarg);
+      break;
+    case 'm':
+      parameters.max_matches = atol(optarg);
+      break;
+    case 'c':
+      parameters.coverage = atol(optarg);
+      break;
+    case 'a':
+      parameters.name_annotation_file = optarg;
+      break;
+    case 'j':
+      parameters.name_annotation_junctions_file = optarg;
+      break;
+    /* Misc */
+    case 'v':
+      parameters.verbose = true;
+      break;
+    case 't':
+#ifdef HAVE_OPENMP
+      parameters.num_threads = atol(optarg);
+#endif
+      break;
+    case 'h':
+      usage(gt_junctions_options,gt_junctions_groups,false);
+      exit(1);
+      break;
+    case 'H':
+      usage(gt_junctions_options,gt_junctions_groups,true);
+      exit(1);
+    case 'J':
+      gt_options_fprint_json_menu(stderr,gt_junctions_options,gt_junctions_groups,true,false);
+      exit(1);
+      break;
+    case '?':
+    default:
+      gt_fatal_error_msg("Option not recognized");
+    }
+  }
+  /*
+   * Parameters check
+   */
+  if (parameters.num_threads==0) {
+    gt_fatal_error_msg("Invalid number of threads");
+  }
+  if (parameters.min_split_size>parameters.max_split_size) {
+    gt_fatal_error_msg("Invalid split size range [%"PRIu64",%"PRIu64"]",parameters.min_split_size,parameters.max_split_size);
+  }
+  // Free
+  gt_string_delete(gt_junctions_short_getopt);
+}
+
+int main(int argc,char** argv) {
+  // GT error handler
+  gt_handle_error_signals();
+
+  // Parsing command-line options
+  parse_arguments(argc,argv);
+
+  // Extract junctions
+  gt_junctions_extract();
+
+  return 0;
+}
@@ -33,6 +33,8 @@ typedef struct {
   bool optional_field_XT;
   bool optional_field_XS;
   bool optional_field_md;
+  bool optional_field_MD;
+  char* splice_motifs;
   /* Misc */
   uint64_t num_threads;
   bool verbose;
@@ -60,6 +62,8 @@ gt_stats_args parameters = {
   .optional_field_XT=false,
   .optional_field_XS=false,
   .optional_field_md=false,
+  .optional_field_MD=false,
+  .splice_motifs=NULL,
   /* Misc */
   .num_threads=1,
   .verbose=false,
@@ -84,140 +88,6 @@ gt_sequence_archive* gt_filter_open_sequence_archive(const bool load_sequences)
   return sequence_archive;
 }
 
-#define PHRED_KONST -0.23025850929940456840 // -log(10)/10;
-
-void gt_map2sam_calc_phred(gt_template *template)
-{
-	typedef struct {
-		char *key;
-		double prob;
-		uint64_t score;
-		uint8_t phred;
-		UT_hash_handle hh;
-	} map_hash;
-
-	map_hash *mhash[3]={0,0,0}, *mp_hash, *tmp;
-	int rd;
-	size_t buf_len=1024;
-	char *buf=malloc(buf_len);
-	gt_cond_fatal_error(!buf,MEM_HANDLER);
-	uint64_t min_score[3]={0xffff,0xffff,0xffff};
-	{
-		GT_TEMPLATE_ITERATE_MMAP__ATTR_(template,maps,maps_attr) {
-			if(!maps_attr) gt_fatal_error(TEMPLATE_NOT_SCORED);
-			uint64_t score=maps_attr->gt_score;
-			if(score==GT_MAP_NO_GT_SCORE) gt_fatal_error(TEMPLATE_NOT_SCORED);
-			uint64_t seq_like[2],interval_like;
-			seq_like[0]=score&0xffff;
-			seq_like[1]=(score>>16)&0xffff;
-			interval_like=(score>>32)&0xff;
-			// Build up list of single end alignments (need this so we can scale the MAPQ score)
-			// Use hash to avoid counting a single end alignment twice if it occurs in two paired alignments
-			for(rd=0;rd<2;rd++) if(maps[rd]) {
-				size_t ssize=gt_string_get_length(maps[rd]->seq_name);
-				size_t key_size=ssize+sizeof(maps[rd]->position);
-				if(key_size>buf_len) {
-					buf_len=key_size*2;
-					buf=realloc(buf,buf_len);
-					gt_cond_fatal_error(!buf,MEM_HANDLER);
-				}
-				memcpy(buf,gt_string_get_string(maps[rd]->seq_name),ssize);
-				memcpy(buf+ssize,&maps[rd]->position,sizeof(maps[rd]->position));
-				HASH_FIND(hh,mhash[rd],buf,key_size,mp_hash);
-				if(!mp_hash) {
-					mp_hash=malloc(sizeof(map_hash));
-					gt_cond_fatal_error(!mp_hash,MEM_HANDLER);
-					mp_hash->key=malloc(key_size);
-					gt_cond_fatal_error(!mp_hash->key,MEM_HANDLER);
-					memcpy(mp_hash->key,buf,key_size);
-					mp_hash->score=seq_like[rd];
-					HASH_ADD_KEYPTR(hh,mhash[rd],mp_hash->key,key_size,mp_hash);
-					if(seq_like[rd]<min_score[rd]) min_score[rd]=seq_like[rd];
-				}
-			}
-			if(maps[0] && maps[1]) { // True paired alignments.  Shouldn't need to check for duplicates, but we will anyway
-				// seq_name should be the same for the two ends in a paired alignment, but we're not taking any chances
-				size_t ssize1=gt_string_get_length(maps[0]->seq_name);
-				size_t ssize2=gt_string_get_length(maps[1]->seq_name);
-				size_t key_size=ssize1+ssize2+2*sizeof(maps[0]->position);
-				if(key_size>buf_len) {
-					buf_len=key_size*2;
-					buf=realloc(buf,buf_len);
-					gt_cond_fatal_error(!buf,MEM_HANDLER);
-				}
-				memcpy(buf,gt_string_get_string(maps[0]->seq_name),ssize1);
-				memcpy(buf+ssize1,gt_string_get_string(maps[1]->seq_name),ssize2);
-				memcpy(buf+ssize1+ssize2,&maps[0]->position,sizeof(maps[0]->position));
-				memcpy(buf+ssize1+ssize2+sizeof(maps[0]->position),&maps[1]->position,sizeof(maps[0]->position));
-				HASH_FIND(hh,mhash[2],buf,key_size,mp_hash);
-				if(!mp_hash) {
-					mp_hash=malloc(sizeof(map_hash));
-					gt_cond_fatal_error(!mp_hash,MEM_HANDLER);
-					mp_hash->key=malloc(key_size);
-					gt_cond_fatal_error(!mp_hash->key,MEM_HANDLER);
-					memcpy(mp_hash->key,buf,key_size);
-					uint64_t sc=seq_like[0]+seq_like[1]+interval_like;
-					mp_hash->score=sc;
-					HASH_ADD_KEYPTR(hh,mhash[2],mp_hash->key,key_size,mp_hash);
-					if(sc<min_score[2]) min_score[2]=sc;
-				}
-			}
-		}
-	}
-	// Now we can calculate the single and paired end MAPQ values
-	for(rd=0;rd<3;rd++) if(mhash[rd]) {
-		double z=0.0;
-		for(mp_hash=mhash[rd];mp_hash;mp_hash=mp_hash->hh.next) {
-			mp_hash->prob=exp(PHRED_KONST*(double)(mp_hash->score-min_score[rd]));
-			z+=mp_hash->prob;
-		}
-		for(mp_hash=mhash[rd];mp_hash;mp_hash=mp_hash->hh.next) {
-			mp_hash->prob/=z;
-			if(1.0-mp_hash->prob<1.0e-255) mp_hash->phred=254;
-			else {
-				int tp=(int)(0.5+log(1.0-mp_hash->prob)/PHRED_KONST);
-				if(tp>254) tp=254;
-				mp_hash->phred=tp;
-			}
-		}
-	}
-	// And now we have to enter the MAPQ values in the map structures
-	{
-		GT_TEMPLATE_ITERATE_MMAP__ATTR_(template,maps,maps_attr) {
-			for(rd=0;rd<2;rd++) if(maps[rd]) {
-				size_t ssize=gt_string_get_length(maps[rd]->seq_name);
-				size_t key_size=ssize+sizeof(maps[rd]->position);
-				memcpy(buf,gt_string_get_string(maps[rd]->seq_name),ssize);
-				memcpy(buf+ssize,&maps[rd]->position,sizeof(maps[rd]->position));
-				HASH_FIND(hh,mhash[rd],buf,key_size,mp_hash);
-				assert(mp_hash);
-				maps[rd]->phred_score=mp_hash->phred;
-			}
-			if(maps[0] && maps[1]) { // True paired alignments.  Shouldn't need to check for duplicates, but we will anyway
-				// seq_name should be the same for the two ends in a paired alignment, but we're not taking any chances
-				size_t ssize1=gt_string_get_length(maps[0]->seq_name);
-				size_t ssize2=gt_string_get_length(maps[1]->seq_name);
-				size_t key_size=ssize1+ssize2+2*sizeof(maps[0]->position);
-				memcpy(buf,gt_string_get_string(maps[0]->seq_name),ssize1);
-				memcpy(buf+ssize1,gt_string_get_string(maps[1]->seq_name),ssize2);
-				memcpy(buf+ssize1+ssize2,&maps[0]->position,sizeof(maps[0]->position));
-				memcpy(buf+ssize1+ssize2+sizeof(maps[0]->position),&maps[1]->position,sizeof(maps[0]->position));
-				HASH_FIND(hh,mhash[2],buf,key_size,mp_hash);
-				assert(mp_hash);
-				maps_attr->phred_score=mp_hash->phred;
-			}
-		}
-	}
-	free(buf);
-	for(rd=0;rd<3;rd++) if(mhash[rd]) {
-		HASH_ITER(hh,mhash[rd],mp_hash,tmp) {
-			HASH_DEL(mhash[rd],mp_hash);
-			free(mp_hash->key);
-			free(mp_hash);
-		}
-	}
-}
-
 void gt_map2sam_read__write() {
   // Open file IN/OUT
   gt_input_file* const input_file = (parameters.name_input_file==NULL) ?
@@ -233,6 +103,15 @@ void gt_map2sam_read__write() {
     gt_sam_header_set_sequence_archive(sam_headers,sequence_archive);
   }
 
+  // Splice-site motifs (XS)
+  gt_sam_splice_motifs* splice_motifs = NULL;
+  if (parameters.optional_field_XS && parameters.splice_motifs!=NULL) {
+    splice_motifs = gt_sam_splice_motifs_new();
+    if (gt_sam_splice_motifs_parse(splice_motifs,parameters.splice_motifs)) {
+      gt_fatal_error_msg("Splice motifs not recognized: '%s'",parameters.splice_motifs);
+    }
+  }
+
   // Print SAM headers
   gt_output_sam_ofprint_headers_sh(output_file,sam_headers);
 
@@ -256,25 +135,32 @@ void gt_map2sam_read__write() {
     if (parameters.optional_field_NM) gt_sam_attributes_add_tag_NM(output_sam_attributes->sam_attributes);
     if (parameters.optional_field_XT) gt_sam_attributes_add_tag_XT(output_sam_attributes->sam_attributes);
     if (parameters.optional_field_md) gt_sam_attributes_add_tag_md(output_sam_attributes->sam_attributes);
-    if (parameters.optional_field_XS) gt_sam_attributes_add_tag_XS(output_sam_attributes->sam_attributes);
+    if (parameters.optional_field_MD) gt_sam_attributes_add_tag_MD(output_sam_attributes->sam_attributes);
+    if (parameters.load_index_sequences) gt_output_sam_attributes_set_reference_sequence_archive(output_sam_attributes,sequence_archive);
+    if (parameters.optional_field_XS) {
+      gt_sam_attributes_add_tag_XS(output_sam_attributes->sam_attributes);
+      gt_output_sam_attributes_set_splice_motifs(output_sam_attributes,splice_motifs);
+    }
     if (parameters.calc_phred) {
     	gt_sam_attributes_add_tag_MQ(output_sam_attributes->sam_attributes);
     	gt_sam_attributes_add_tag_UQ(output_sam_attributes->sam_attributes);
     	gt_sam_attributes_add_tag_PQ(output_sam_attributes->sam_attributes);
     }
+    gt_map_score_mapq_scratch* const mapq_scratch = (parameters.calc_phred) ? gt_map_score_mapq_scratch_new() : NULL;
     gt_template* template = gt_template_new();
     while ((error_code=gt_input_map_parser_get_template(buffered_input,template,input_map_attributes))) {
       if (error_code!=GT_IMP_OK) {
         gt_error_msg("Fatal error parsing file '%s':%"PRIu64"\n",parameters.name_input_file,buffered_input->current_line_num-1);
         continue;
       }
-      if(parameters.calc_phred) gt_map2sam_calc_phred(template);
+      if (parameters.calc_phred) gt_map_score_template_mapq(template,mapq_scratch);
       // Print SAM template
       gt_output_sam_bofprint_template(buffered_output,template,output_sam_attributes);
     }
 
     // Clean
     gt_template_delete(template);
+    if (mapq_scratch) gt_map_score_mapq_scratch_delete(mapq_scratch);
     gt_input_map_parser_attributes_delete(input_map_attributes);
     gt_output_sam_attributes_delete(output_sam_attributes);
     gt_buffered_input_file_close(buffered_input);
@@ -283,6 +169,7 @@ void gt_map2sam_read__write() {
 
   // Release archive & Clean
   if (sequence_archive) gt_sequence_archive_delete(sequence_archive);
+  if (splice_motifs) gt_sam_splice_motifs_delete(splice_motifs);
   gt_sam_header_delete(sam_headers);
   gt_input_file_close(input_file);
   gt_output_file_close(output_file);
@@ -358,10 +245,18 @@ void parse_arguments(int argc,char** argv) {
       break;
     case 503: // XS
       parameters.optional_field_XS = true;
+      parameters.load_index_sequences = true; // Splice-site motifs
       break;
     case 504: // md
       parameters.optional_field_md = true;
       break;
+    case 505: // MD
+      parameters.optional_field_MD = true;
+      parameters.load_index_sequences = true; // Deleted bases (if any reference)
+      break;
+    case 506: // splice-motifs
+      parameters.splice_motifs = optarg;
+      break;
     /* Format */
     case 'c':
       parameters.compact_format = true;
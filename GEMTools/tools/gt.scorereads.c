@@ -15,6 +15,10 @@
 #include "gem_tools.h"
 
 #define DEFAULT_INS_CUTOFF 0.01 /* Insert sizes in the upper or lower cutoff percentiles will not be used */
+#define DEFAULT_MODEL_SAMPLE 1000000 /* Uniquely mapped pairs sampled to estimate the insert size distribution */
+#define MAX_SAMPLE_INSERT (1<<22)
+#define INS_MODEL_MAGIC 0x4d534e4952535447ull /* "GTSRINSM" */
+#define INS_MODEL_VERSION 1
 #define MAP_THRESHOLD 3
 #define AP_BUF_SIZE 16384
 #define QUAL_FASTQ 33
@@ -38,6 +42,8 @@ typedef struct {
   char *input_files[2];
   char *output_file;
   char *dist_file;
+  char *model_file; // Compiled insert size model to write (--compile-model)
+  uint64_t model_sample;
   double ins_cutoff;
   bool mmap_input;
   bool verbose;
@@ -49,6 +55,8 @@ typedef struct {
   int64_t max_insert;
   double *ins_dist;
   uint8_t *ins_phred;
+  u_int64_t ins_pairs; // Pairs supporting the insert size model
+  gt_mm *ins_model_mm; // Backing memory of a mapped compiled model
   int num_threads;
   int mapping_cutoff;
   int indel_quality;
@@ -59,6 +67,8 @@ sr_param param = {
 		.input_files={NULL,NULL},
 		.output_file=NULL,
 		.dist_file=NULL,
+		.model_file=NULL,
+		.model_sample=DEFAULT_MODEL_SAMPLE,
 		.ins_cutoff=DEFAULT_INS_CUTOFF,
 		.mmap_input=false,
 		.compress=NONE,
@@ -71,7 +81,9 @@ sr_param param = {
 		.min_insert=0,
 		.max_insert=0,
 		.ins_dist=NULL,
-		.ins_phred=NULL
+		.ins_phred=NULL,
+		.ins_pairs=0,
+		.ins_model_mm=NULL
 };
 
 void usage(const gt_option* const options,char* groups[],const bool print_inactive) {
@@ -88,15 +100,6 @@ static void *sr_malloc(size_t s)
 	return p;
 }
 
-static void *sr_calloc(size_t n,size_t s)
-{
-	void *p;
-
-	p=calloc(n,s);
-	gt_cond_fatal_error(!p,MEM_HANDLER);
-	return p;
-}
-
 static void *sr_realloc(void *ptr,size_t s)
 {
 	void *p;
@@ -111,8 +114,128 @@ typedef struct {
 	u_int64_t y;
 } hist_entry;
 
+/*
+ * Insert size model (phred of the insert size distribution within [min_insert,max_insert])
+ */
+static void build_insert_model(sr_param *param,hist_entry *hist,size_t ct,u_int64_t total,int64_t user_insert[2],int iset[2])
+{
+	double z1=param->ins_cutoff*(double)total;
+	double z2=(1.0-param->ins_cutoff)*(double)total;
+	double z=0.0;
+	int i;
+	for(i=0;i<ct;i++) {
+		z+=hist[i].y;
+		if(z>=z1) break;
+	}
+	int i1=i;
+	param->min_insert=hist[i].x;
+	if(iset[0] && user_insert[0]>param->min_insert) param->min_insert=user_insert[0];
+	for(i++;i<ct;i++) {
+		z+=hist[i].y;
+		if(z>=z2) break;
+	}
+	int i2=i-1;
+	param->max_insert=hist[i2].x;
+	if(iset[1] && user_insert[1]<param->max_insert) param->max_insert=user_insert[1];
+	gt_cond_fatal_error_msg(param->min_insert>param->max_insert,
+			"Insert size bounds %"PRId64" - %"PRId64" exclude the insert distribution",param->min_insert,param->max_insert);
+	fprintf(stderr,"Insert distribution %"PRId64" - %"PRId64"\n",param->min_insert,param->max_insert);
+	param->ins_pairs=total;
+	int k=param->max_insert-param->min_insert+1;
+	param->ins_dist=sr_malloc(sizeof(double)*k);
+	param->ins_phred=sr_malloc((size_t)k);
+	for(i=0;i<k;i++) {
+		param->ins_dist[i]=0.0;
+		param->ins_phred[i]=255;
+	}
+	for(i=i1;i<=i2;i++) {
+		if(hist[i].x<param->min_insert || hist[i].x>param->max_insert) continue;
+		double zt=(double)hist[i].y/(double)total;
+		param->ins_dist[hist[i].x-param->min_insert]=zt;
+		int phred=255;
+		if(zt>0.0) {
+			phred=(int)(log(zt)*-10.0/log(10.0)+.5);
+			if(phred>255) phred=255;
+		}
+		param->ins_phred[hist[i].x-param->min_insert]=phred;
+	}
+}
+
+/*
+ * Compiled model layout (native endianness, 8-byte aligned sections)
+ *   MAGIC,VERSION,min_insert,max_insert,num_pairs,ins_cutoff(bits)
+ *   double ins_dist[max-min+1]
+ *   uint8_t ins_phred[max-min+1]
+ */
+static void write_model_uint64(FILE *file,uint64_t value,char *file_name)
+{
+	gt_cond_fatal_error(fwrite(&value,sizeof(uint64_t),1,file)!=1,FILE_WRITE,file_name);
+}
+
+static void write_insert_model(sr_param *param)
+{
+	const uint64_t k=param->max_insert-param->min_insert+1;
+	uint64_t cutoff_bits;
+	memcpy(&cutoff_bits,&param->ins_cutoff,sizeof(uint64_t));
+	FILE *file=fopen(param->model_file,"wb");
+	gt_cond_fatal_error(file==NULL,FILE_OPEN,param->model_file);
+	write_model_uint64(file,INS_MODEL_MAGIC,param->model_file);
+	write_model_uint64(file,INS_MODEL_VERSION,param->model_file);
+	write_model_uint64(file,(uint64_t)param->min_insert,param->model_file);
+	write_model_uint64(file,(uint64_t)param->max_insert,param->model_file);
+	write_model_uint64(file,param->ins_pairs,param->model_file);
+	write_model_uint64(file,cutoff_bits,param->model_file);
+	gt_cond_fatal_error(fwrite(param->ins_dist,sizeof(double),k,file)!=k,FILE_WRITE,param->model_file);
+	gt_cond_fatal_error(fwrite(param->ins_phred,1,k,file)!=k,FILE_WRITE,param->model_file);
+	gt_cond_fatal_error(fclose(file),FILE_WRITE,param->model_file);
+	fprintf(stderr,"Insert size model written to '%s' (%"PRIu64" entries)\n",param->model_file,k);
+}
+
+static bool is_insert_model(char *file_name)
+{
+	FILE *file=fopen(file_name,"rb");
+	if(file==NULL) return false;
+	uint64_t magic=0;
+	const bool compiled=fread(&magic,sizeof(uint64_t),1,file)==1 && magic==INS_MODEL_MAGIC;
+	fclose(file);
+	return compiled;
+}
+
+// Map a compiled model. Explicit insert bounds can only narrow the model's range
+static void read_insert_model(sr_param *param,int iset[2])
+{
+	gt_mm *mm=gt_mm_bulk_mmap_file(param->dist_file,GT_MM_READ_ONLY,false);
+	gt_mm_read_uint64(mm);
+	const uint64_t version=gt_mm_read_uint64(mm);
+	gt_cond_fatal_error_msg(version!=INS_MODEL_VERSION,
+			"Insert size model '%s' has version %"PRIu64", expected %d. Please recompile the model",param->dist_file,version,INS_MODEL_VERSION);
+	const int64_t model_min=(int64_t)gt_mm_read_uint64(mm);
+	const int64_t model_max=(int64_t)gt_mm_read_uint64(mm);
+	param->ins_pairs=gt_mm_read_uint64(mm);
+	gt_mm_read_uint64(mm); // Cutoff
+	const uint64_t k=model_max-model_min+1;
+	double *ins_dist=gt_mm_read_mem(mm,k*sizeof(double));
+	uint8_t *ins_phred=gt_mm_read_mem(mm,k);
+	int64_t min_insert=model_min,max_insert=model_max;
+	if(iset[0] && param->min_insert>min_insert) min_insert=param->min_insert;
+	if(iset[1] && param->max_insert<max_insert) max_insert=param->max_insert;
+	gt_cond_fatal_error_msg(min_insert>max_insert,
+			"Insert size bounds %"PRId64" - %"PRId64" exclude the insert size model",min_insert,max_insert);
+	param->min_insert=min_insert;
+	param->max_insert=max_insert;
+	param->ins_dist=ins_dist+(min_insert-model_min);
+	param->ins_phred=ins_phred+(min_insert-model_min);
+	param->ins_model_mm=mm;
+	fprintf(stderr,"Insert distribution %"PRId64" - %"PRId64"\n",param->min_insert,param->max_insert);
+}
+
 void read_dist_file(sr_param *param,int iset[2])
 {
+	if(is_insert_model(param->dist_file)) {
+		read_insert_model(param,iset);
+		return;
+	}
+	int64_t user_insert[2]={param->min_insert,param->max_insert};
 	gt_input_file* file=gt_input_file_open(param->dist_file,false);
 	gt_buffered_input_file* bfile=gt_buffered_input_file_new(file);
 	gt_status nl=0;
@@ -188,37 +311,7 @@ void read_dist_file(sr_param *param,int iset[2])
 		if(i<nl) break;
 	} while(nl);
 	if(first==false && ct>2) {
-		double z1=param->ins_cutoff*(double)total;
-		double z2=(1.0-param->ins_cutoff)*(double)total;
-		double z=0.0;
-		int i;
-		for(i=0;i<ct;i++) {
-			z+=hist[i].y;
-			if(z>=z1) break;
-		}
-		int i1=i;
-		if(!iset[0] || hist[i].x>param->min_insert) param->min_insert=hist[i].x;
-		for(i++;i<ct;i++) {
-			z+=hist[i].y;
-			if(z>=z2) break;
-		}
-		int i2=i-1;
-		if(!iset[1] || hist[i2].x<param->max_insert) param->max_insert=hist[i2].x;
-		fprintf(stderr,"Insert distribution %"PRId64" - %"PRId64"\n",param->min_insert,param->max_insert);
-		int k=param->max_insert-param->min_insert+1;
-		param->ins_dist=sr_malloc(sizeof(double)*k);
-		param->ins_phred=sr_malloc((size_t)k);
-		for(i=0;i<k;i++) param->ins_dist[i]=0.0;
-		for(i=i1;i<=i2;i++) {
-			double zt=(double)hist[i].y/(double)total;
-			param->ins_dist[hist[i].x-param->min_insert]=zt;
-			int phred=255;
-			if(zt>0.0) {
-				phred=(int)(log(zt)*-10.0/log(10.0)+.5);
-				if(phred>255) phred=255;
-			}
-			param->ins_phred[hist[i].x-param->min_insert]=phred;
-		}
+		build_insert_model(param,hist,ct,total,user_insert,iset);
 	} else {
 		if(ftype==UNKNOWN) fprintf(stderr,"Insert distribution file format not recognized\n");
 		else fprintf(stderr,"No valid lines read in from insert distribution file\n");
@@ -228,18 +321,166 @@ void read_dist_file(sr_param *param,int iset[2])
 	gt_input_file_close(file);
 }
 
-static uint64_t calculate_dist_score(gt_alignment *al, gt_map *map, int qual_offset,int qual_penalty)
+// Count the insert size of one uniquely mapped pair
+static bool sample_insert_size(gt_alignment *alignment1,gt_alignment *alignment2,gt_vector *counts)
+{
+	if(gt_alignment_get_num_maps(alignment1)!=1 || gt_alignment_get_num_maps(alignment2)!=1) return false;
+	gt_map *mmap[2]={gt_alignment_get_map(alignment1,0),gt_alignment_get_map(alignment2,0)};
+	gt_status gt_err;
+	int64_t x=gt_template_get_insert_size(mmap,&gt_err,0,0);
+	if(gt_err!=GT_TEMPLATE_INSERT_SIZE_OK || x<=0 || x>=MAX_SAMPLE_INSERT) return false;
+	if(x>=gt_vector_get_used(counts)) {
+		const uint64_t used=gt_vector_get_used(counts);
+		gt_vector_reserve(counts,x+1,false);
+		memset(gt_vector_get_mem(counts,u_int64_t)+used,0,(x+1-used)*sizeof(u_int64_t));
+		gt_vector_set_used(counts,x+1);
+	}
+	++(*gt_vector_get_elm(counts,x,u_int64_t));
+	return true;
+}
+
+/*
+ * Build the insert size distribution from a first streaming pass over
+ * (at most param->model_sample) uniquely mapped pairs of the input
+ */
+void estimate_insert_dist(sr_param *param,int iset[2])
+{
+	int64_t user_insert[2]={param->min_insert,param->max_insert};
+	gt_vector *counts=gt_vector_new(1024,sizeof(u_int64_t));
+	gt_template *template=gt_template_new();
+	u_int64_t sampled=0;
+	gt_status error_code;
+	if(param->input_files[1]) {
+		pthread_mutex_t mutex=PTHREAD_MUTEX_INITIALIZER;
+		gt_input_file* input_file1=gt_input_file_open(param->input_files[0],param->mmap_input);
+		gt_input_file* input_file2=gt_input_file_open(param->input_files[1],param->mmap_input);
+		gt_buffered_input_file* buffered_input1=gt_buffered_input_file_new(input_file1);
+		gt_buffered_input_file* buffered_input2=gt_buffered_input_file_new(input_file2);
+		gt_alignment *alignment2=gt_alignment_new();
+		while(sampled<param->model_sample && gt_input_map_parser_synch_blocks(buffered_input1,buffered_input2,&mutex)) {
+			// Always consume one record from each file so that both ends stay in step
+			gt_status error_code1=gt_input_map_parser_get_template(buffered_input1,template,NULL);
+			gt_status error_code2=gt_input_map_parser_get_alignment(buffered_input2,alignment2,NULL);
+			if(error_code1==GT_IMP_EOF || error_code2==GT_IMP_EOF) {
+				gt_error_msg("Files '%s','%s' have a different number of records\n",param->input_files[0],param->input_files[1]);
+				break;
+			}
+			if(error_code1!=GT_IMP_OK || error_code2!=GT_IMP_OK || gt_template_get_num_blocks(template)!=1) continue;
+			if(!(gt_string_nequals(template->tag,alignment2->tag,gt_string_get_length(template->tag)))) {
+				gt_error_msg("Fatal ID mismatch ('%*s','%*s') parsing files '%s','%s'\n",PRIgts_content(template->tag),PRIgts_content(alignment2->tag),param->input_files[0],param->input_files[1]);
+				break;
+			}
+			if(sample_insert_size(gt_template_get_block(template,0),alignment2,counts)) sampled++;
+		}
+		gt_alignment_delete(alignment2);
+		gt_buffered_input_file_close(buffered_input1);
+		gt_buffered_input_file_close(buffered_input2);
+		gt_input_file_close(input_file1);
+		gt_input_file_close(input_file2);
+	} else {
+		gt_input_file* input_file=param->input_files[0]?gt_input_file_open(param->input_files[0],param->mmap_input):gt_input_stream_open(stdin);
+		gt_buffered_input_file* buffered_input=gt_buffered_input_file_new(input_file);
+		while(sampled<param->model_sample && (error_code=gt_input_generic_parser_get_template(buffered_input,template,param->parser_attr))) {
+			if(error_code!=GT_IMP_OK || gt_template_get_num_blocks(template)!=2) continue;
+			if(sample_insert_size(gt_template_get_block(template,0),gt_template_get_block(template,1),counts)) sampled++;
+		}
+		gt_buffered_input_file_close(buffered_input);
+		gt_input_file_close(input_file);
+	}
+	gt_template_delete(template);
+	// Histogram of the observed sizes
+	size_t ct=0;
+	hist_entry *hist=sr_malloc(sizeof(hist_entry)*(gt_vector_get_used(counts)+1));
+	GT_VECTOR_ITERATE(counts,count,x,u_int64_t) {
+		if(*count) {
+			hist[ct].x=x;
+			hist[ct++].y=*count;
+		}
+	}
+	fprintf(stderr,"Sampled %"PRIu64" uniquely mapped pairs\n",(uint64_t)sampled);
+	if(ct>2) build_insert_model(param,hist,ct,sampled,user_insert,iset);
+	else fprintf(stderr,"Not enough uniquely mapped pairs to estimate the insert distribution\n");
+	free(hist);
+	gt_vector_delete(counts);
+}
+
+/*
+ * Per-thread scratch for scoring and pairing (reused across templates)
+ */
+typedef struct {
+	gt_string *seq_name;
+	gt_strand strand;
+	int64_t key;
+	uint64_t idx;
+} sr_map_key;
+
+typedef struct {
+	uint64_t idx[2];
+	int64_t x;
+} sr_pair;
+
+typedef struct {
+	gt_vector *keys_end;   // (sr_map_key) End2 maps keyed by their end coordinate
+	gt_vector *keys_start; // (sr_map_key) End2 maps keyed by their start coordinate
+	gt_vector *pairs;      // (sr_pair)
+	gt_vector *map_flag;   // (char)
+	gt_vector *qual_cache; // (uint8_t) Quality term of a mismatch at each read position
+} sr_buffer;
+
+static sr_buffer *sr_buffer_new(void)
+{
+	sr_buffer *buf=sr_malloc(sizeof(sr_buffer));
+	buf->keys_end=gt_vector_new(16,sizeof(sr_map_key));
+	buf->keys_start=gt_vector_new(16,sizeof(sr_map_key));
+	buf->pairs=gt_vector_new(16,sizeof(sr_pair));
+	buf->map_flag=gt_vector_new(32,sizeof(char));
+	buf->qual_cache=gt_vector_new(256,sizeof(uint8_t));
+	return buf;
+}
+
+static void sr_buffer_delete(sr_buffer *buf)
+{
+	gt_vector_delete(buf->keys_end);
+	gt_vector_delete(buf->keys_start);
+	gt_vector_delete(buf->pairs);
+	gt_vector_delete(buf->map_flag);
+	gt_vector_delete(buf->qual_cache);
+	free(buf);
+}
+
+// Clamped quality of every read position, computed once per alignment
+static void cache_qualities(gt_alignment *al,sr_buffer *buf,int qual_offset)
+{
+	gt_vector_clear(buf->qual_cache);
+	if(!gt_alignment_has_qualities(al)) return;
+	const uint64_t len=gt_string_get_length(al->qualities);
+	const char *quals=gt_string_get_string(al->qualities);
+	gt_vector_reserve(buf->qual_cache,len,false);
+	uint8_t *cache=gt_vector_get_mem(buf->qual_cache,uint8_t);
+	uint64_t i;
+	for(i=0;i<len;i++) {
+		int q=quals[i]-qual_offset;
+		cache[i]=(q>MAX_QUAL)?MAX_QUAL:((q<0)?0:q);
+	}
+	gt_vector_set_used(buf->qual_cache,len);
+}
+
+static uint64_t calculate_dist_score(gt_alignment *al, gt_map *map, sr_buffer *buf, int qual_offset,int qual_penalty)
 {
-	register gt_string* const quals = al->qualities;
-	register const bool has_qualities = gt_alignment_has_qualities(al);
+	const bool has_qualities = gt_alignment_has_qualities(al);
+	const uint64_t qual_len = gt_vector_get_used(buf->qual_cache);
+	const uint8_t *qual_cache = gt_vector_get_mem(buf->qual_cache,uint8_t);
 	uint64_t score=0;
 	GT_MAP_ITERATE(map,map_block) {
 		GT_MISMS_ITERATE(map_block,misms) {
 			int quality_misms;
 			if (has_qualities) {
-				quality_misms = gt_string_get_string(quals)[misms->position]-qual_offset;
-				if(quality_misms>MAX_QUAL) quality_misms=MAX_QUAL;
-				else if(quality_misms<0) quality_misms=0;
+				if(misms->position<qual_len) quality_misms=qual_cache[misms->position];
+				else {
+					quality_misms = gt_string_get_string(al->qualities)[misms->position]-qual_offset;
+					if(quality_misms>MAX_QUAL) quality_misms=MAX_QUAL;
+					else if(quality_misms<0) quality_misms=0;
+				}
 			} else quality_misms=MISSING_QUAL;
 			switch (misms->misms_type) {
 			case MISMS:
@@ -256,42 +497,168 @@ static uint64_t calculate_dist_score(gt_alignment *al, gt_map *map, int qual_off
 	return score;
 }
 
-static void pair_read(gt_template *template,gt_alignment *alignment1,gt_alignment *alignment2,sr_param *param)
+static void score_alignment(gt_alignment *al,sr_buffer *buf,sr_param *param)
+{
+	bool cached=false;
+	GT_ALIGNMENT_ITERATE(al,map) {
+		if(map->gt_score==GT_MAP_NO_GT_SCORE) {
+			if(!cached) {
+				cache_qualities(al,buf,param->qual_offset);
+				cached=true;
+			}
+			map->gt_score=calculate_dist_score(al,map,buf,param->qual_offset,param->indel_quality);
+		}
+	}
+}
+
+/*
+ * Reference coordinates used by gt_template_get_insert_size (taken from the last block):
+ *   start = position of the first base of the alignment span, end = start + span
+ *   FORWARD end1 vs other end2: x = 1 + end(end2) - start(end1)
+ *   otherwise:                  x = 1 + end(end1) - start(end2)
+ */
+static void get_map_key(gt_map *map,sr_map_key *key_start,sr_map_key *key_end)
+{
+	gt_map *last=NULL;
+	uint64_t length=0;
+	GT_MAP_ITERATE(map,map_block) {
+		last=map_block;
+		length+=gt_map_get_base_length(map_block);
+	}
+	key_start->seq_name=key_end->seq_name=last->seq_name;
+	key_start->strand=key_end->strand=last->strand;
+	key_end->key=last->position+length;
+	key_start->key=key_end->key-gt_map_get_base_length(last);
+}
+
+static int cmp_seq_name(gt_string *s1,gt_string *s2)
+{
+	if(s1==s2) return 0;
+	const uint64_t l1=gt_string_get_length(s1),l2=gt_string_get_length(s2);
+	int c=memcmp(gt_string_get_string(s1),gt_string_get_string(s2),(l1<l2)?l1:l2);
+	if(c) return c;
+	return (l1<l2)?-1:(l1>l2);
+}
+
+static int cmp_map_key(const void *s1,const void *s2)
+{
+	const sr_map_key *k1=s1,*k2=s2;
+	int c=cmp_seq_name(k1->seq_name,k2->seq_name);
+	if(c) return c;
+	if(k1->strand!=k2->strand) return (k1->strand<k2->strand)?-1:1;
+	if(k1->key!=k2->key) return (k1->key<k2->key)?-1:1;
+	return (k1->idx<k2->idx)?-1:(k1->idx>k2->idx);
+}
+
+static int cmp_pair(const void *s1,const void *s2)
+{
+	const sr_pair *p1=s1,*p2=s2;
+	if(p1->idx[0]!=p2->idx[0]) return (p1->idx[0]<p2->idx[0])?-1:1;
+	return (p1->idx[1]<p2->idx[1])?-1:(p1->idx[1]>p2->idx[1]);
+}
+
+// First key in [keys,keys+n) not less than (seq_name,strand,key)
+static uint64_t lower_bound_key(sr_map_key *keys,uint64_t n,gt_string *seq_name,gt_strand strand,int64_t key)
+{
+	uint64_t lo=0,hi=n;
+	while(lo<hi) {
+		uint64_t mid=lo+(hi-lo)/2;
+		int c=cmp_seq_name(keys[mid].seq_name,seq_name);
+		if(!c) c=(keys[mid].strand<strand)?-1:(keys[mid].strand>strand);
+		if(!c) c=(keys[mid].key<key)?-1:(keys[mid].key>key);
+		if(c<0) lo=mid+1; else hi=mid;
+	}
+	return lo;
+}
+
+// Sweep the end2 keys of (seq_name,strand) with key in [lo,hi] and record the pairs
+static void add_pairs_in_range(sr_buffer *buf,gt_vector *keys_v,uint64_t idx1,gt_string *seq_name,gt_strand strand,
+		int64_t lo,int64_t hi,bool forward,int64_t key1,sr_param *param)
+{
+	sr_map_key *keys=gt_vector_get_mem(keys_v,sr_map_key);
+	const uint64_t n=gt_vector_get_used(keys_v);
+	uint64_t k;
+	for(k=lower_bound_key(keys,n,seq_name,strand,lo);k<n;k++) {
+		if(keys[k].key>hi || keys[k].strand!=strand || cmp_seq_name(keys[k].seq_name,seq_name)) break;
+		const int64_t x=forward?(1+keys[k].key-key1):(1+key1-keys[k].key);
+		if(x<param->min_insert || x>param->max_insert) continue;
+		gt_vector_reserve_additional(buf->pairs,1);
+		sr_pair *pair=gt_vector_get_free_elm(buf->pairs,sr_pair);
+		pair->idx[0]=idx1;
+		pair->idx[1]=keys[k].idx;
+		pair->x=x;
+		gt_vector_inc_used(buf->pairs);
+	}
+}
+
+static void pair_read(gt_template *template,gt_alignment *alignment1,gt_alignment *alignment2,sr_buffer *buf,sr_param *param)
 {
 	gt_alignment_recalculate_counters(alignment1);
 	gt_alignment_recalculate_counters(alignment2);
 	gt_mmap_attributes attr;
-	gt_map *mmap[2];
 	uint64_t nmap[2];
 	nmap[0]=gt_alignment_get_num_maps(alignment1);
 	nmap[1]=gt_alignment_get_num_maps(alignment2);
 	if(nmap[0]+nmap[1]) {
-		char *map_flag[2];
-		map_flag[0]=sr_calloc((size_t)(nmap[0]+nmap[1]),sizeof(char));
-		map_flag[1]=map_flag[0]+nmap[0];
+		score_alignment(alignment1,buf,param);
+		score_alignment(alignment2,buf,param);
+		// Index end2 maps by (sequence,strand,coordinate)
+		gt_vector_clear(buf->keys_end);
+		gt_vector_clear(buf->keys_start);
+		gt_vector_clear(buf->pairs);
+		gt_vector_reserve(buf->keys_end,nmap[1],false);
+		gt_vector_reserve(buf->keys_start,nmap[1],false);
+		sr_map_key *keys_end=gt_vector_get_mem(buf->keys_end,sr_map_key);
+		sr_map_key *keys_start=gt_vector_get_mem(buf->keys_start,sr_map_key);
 		uint64_t i=0;
+		GT_ALIGNMENT_ITERATE(alignment2,map2) {
+			get_map_key(map2,keys_start+i,keys_end+i);
+			keys_start[i].idx=keys_end[i].idx=i;
+			i++;
+		}
+		gt_vector_set_used(buf->keys_end,nmap[1]);
+		gt_vector_set_used(buf->keys_start,nmap[1]);
+		qsort(keys_end,nmap[1],sizeof(sr_map_key),cmp_map_key);
+		qsort(keys_start,nmap[1],sizeof(sr_map_key),cmp_map_key);
+		// Sweep the end2 maps within [min_insert,max_insert] of each end1 map
+		const gt_strand strands[3]={FORWARD,REVERSE,UNKNOWN};
+		i=0;
 		GT_ALIGNMENT_ITERATE(alignment1,map1) {
-			if(map1->gt_score==GT_MAP_NO_GT_SCORE) map1->gt_score=calculate_dist_score(alignment1,map1,param->qual_offset,param->indel_quality);
-			mmap[0]=map1;
-			uint64_t j=0;
-			GT_ALIGNMENT_ITERATE(alignment2,map2) {
-				if(map2->gt_score==GT_MAP_NO_GT_SCORE) map2->gt_score=calculate_dist_score(alignment2,map2,param->qual_offset,param->indel_quality);
-				mmap[1]=map2;
-				gt_status gt_err;
-				int64_t x=gt_template_get_insert_size(mmap,&gt_err,0,0);
-				if(gt_err==GT_TEMPLATE_INSERT_SIZE_OK && x>=param->min_insert && x<=param->max_insert) {
-					attr.distance=gt_map_get_global_distance(map1)+gt_map_get_global_distance(map2);
-					attr.gt_score=map1->gt_score|(map2->gt_score<<16);
-					if(param->ins_phred) attr.gt_score|=((uint64_t)param->ins_phred[x-param->min_insert]<<32);
-					attr.phred_score=255;
-					gt_template_inc_counter(template,attr.distance);
-					gt_template_add_mmap_ends(template,map1,map2,&attr);
-					map_flag[0][i]=map_flag[1][j]=1;
+			sr_map_key key_start,key_end;
+			get_map_key(map1,&key_start,&key_end);
+			int s;
+			for(s=0;s<3;s++) if(strands[s]!=key_start.strand) {
+				if(key_start.strand==FORWARD) {
+					add_pairs_in_range(buf,buf->keys_end,i,key_start.seq_name,strands[s],
+							key_start.key+param->min_insert-1,key_start.key+param->max_insert-1,true,key_start.key,param);
+				} else {
+					add_pairs_in_range(buf,buf->keys_start,i,key_end.seq_name,strands[s],
+							key_end.key-param->max_insert+1,key_end.key-param->min_insert+1,false,key_end.key,param);
 				}
-				j++;
 			}
 			i++;
 		}
+		// Emit paired mmaps in (end1,end2) order, then the unpaired ends
+		const uint64_t npairs=gt_vector_get_used(buf->pairs);
+		sr_pair *pairs=gt_vector_get_mem(buf->pairs,sr_pair);
+		qsort(pairs,npairs,sizeof(sr_pair),cmp_pair);
+		gt_vector_reserve(buf->map_flag,nmap[0]+nmap[1],true);
+		char *map_flag[2];
+		map_flag[0]=gt_vector_get_mem(buf->map_flag,char);
+		map_flag[1]=map_flag[0]+nmap[0];
+		memset(map_flag[0],0,nmap[0]+nmap[1]);
+		uint64_t p;
+		for(p=0;p<npairs;p++) {
+			gt_map *map1=gt_alignment_get_map(alignment1,pairs[p].idx[0]);
+			gt_map *map2=gt_alignment_get_map(alignment2,pairs[p].idx[1]);
+			attr.distance=gt_map_get_global_distance(map1)+gt_map_get_global_distance(map2);
+			attr.gt_score=map1->gt_score|(map2->gt_score<<16);
+			if(param->ins_phred) attr.gt_score|=((uint64_t)param->ins_phred[pairs[p].x-param->min_insert]<<32);
+			attr.phred_score=255;
+			gt_template_inc_counter(template,attr.distance);
+			gt_template_add_mmap_ends(template,map1,map2,&attr);
+			map_flag[0][pairs[p].idx[0]]=map_flag[1][pairs[p].idx[1]]=1;
+		}
 		for(i=0;i<nmap[0];i++) {
 			if(!map_flag[0][i]) {
 				gt_map *map=gt_alignment_get_map(alignment1,i);
@@ -312,7 +679,6 @@ static void pair_read(gt_template *template,gt_alignment *alignment1,gt_alignmen
 				gt_template_add_mmap_ends(template,0,map,&attr);
 			}
 		}
-		free(map_flag[0]);
 	}
 	gt_attributes_remove(template->attributes,GT_ATTR_ID_TAG_PAIR);
 }
@@ -397,6 +763,16 @@ int parse_arguments(int argc,char** argv) {
   			err=-6;
   		}
   		break;
+  	case 404:
+  		param.model_file=optarg;
+  		break;
+  	case 405:
+  		param.model_sample=strtoull(optarg,&p,10);
+  		if(*p || param.model_sample==0) {
+  			fprintf(stderr,"Illegal model sample size: '%s'\n",optarg);
+  			err=-7;
+  		}
+  		break;
   	case 'm':
   		param.mapping_cutoff=(int)strtol(optarg,&p,10);
   		if(*p || param.mapping_cutoff<0) {
@@ -461,7 +837,11 @@ int parse_arguments(int argc,char** argv) {
 				break;
 			}
 		}
-		if(gt_input_generic_parser_attributes_is_paired(param.parser_attr) && param.dist_file) read_dist_file(&param,insert_set);
+		if(param.model_file && !gt_input_generic_parser_attributes_is_paired(param.parser_attr)) {
+			fputs("An insert size model can only be compiled from paired reads (--paired-end or --i2)\n",stderr);
+			err=-16;
+		} else if(gt_input_generic_parser_attributes_is_paired(param.parser_attr) && param.dist_file) read_dist_file(&param,insert_set);
+		else if(param.model_file) estimate_insert_dist(&param,insert_set);
 		else if(!insert_set[1]) {
 				if(param.min_insert<=1000) param.max_insert=1000;
 				else param.max_insert=param.min_insert+1000;
@@ -480,6 +860,17 @@ int main(int argc,char *argv[])
 
   // Parsing command-line options
   err=parse_arguments(argc,argv);
+  if(!err && param.model_file) {
+		// Compile the insert size model and exit
+		gt_cond_fatal_error_msg(!param.ins_phred,"No insert size model to compile");
+		write_insert_model(&param);
+		if(param.ins_model_mm) gt_mm_free(param.ins_model_mm);
+		else {
+			free(param.ins_dist);
+			free(param.ins_phred);
+		}
+		return 0;
+  }
   if(!err) {
 		// Open out file
 		gt_output_file *output_file;
@@ -512,6 +903,7 @@ int main(int argc,char *argv[])
 				gt_buffered_input_file_attach_buffered_output(buffered_input1,buffered_output);
 				gt_status error_code;
 				gt_template *template=gt_template_new();
+				sr_buffer *sr_buf=sr_buffer_new();
 				while(gt_input_map_parser_synch_blocks(buffered_input1,buffered_input2,&mutex)) {
 					error_code=gt_input_map_parser_get_template(buffered_input1,template,NULL);
 					if(error_code!=GT_IMP_OK) {
@@ -534,12 +926,13 @@ int main(int argc,char *argv[])
 						gt_error_msg("Fatal ID mismatch ('%*s','%*s') parsing files '%s','%s'\n",PRIgts_content(template->tag),PRIgts_content(alignment2->tag),param.input_files[0],param.input_files[1]);
 						break;
 					}
-					pair_read(template,alignment1,alignment2,&param);
+					pair_read(template,alignment1,alignment2,sr_buf,&param);
 					if (gt_output_generic_bofprint_template(buffered_output,template,param.printer_attr)) {
 						gt_error_msg("Fatal error outputting read '"PRIgts"'\n",PRIgts_content(gt_template_get_string_tag(template)));
 					}
 				}
 				gt_template_delete(template);
+				sr_buffer_delete(sr_buf);
 				gt_buffered_input_file_close(buffered_input1);
 				gt_buffered_input_file_close(buffered_input2);
 				gt_buffered_output_file_close(buffered_output);
@@ -548,7 +941,7 @@ int main(int argc,char *argv[])
 			gt_input_file_close(input_file2);
 		} else { // Single input file (could be single end or interleaved paired end
 			gt_input_file* input_file=param.input_files[0]?gt_input_file_open(param.input_files[0],param.mmap_input):gt_input_stream_open(stdin);
-#ifdef OPENMP
+#ifdef HAVE_OPENMP
 #pragma omp parallel num_threads(param.num_threads)
 #endif
 			{
@@ -557,6 +950,7 @@ int main(int argc,char *argv[])
 				gt_buffered_input_file_attach_buffered_output(buffered_input,buffered_output);
 				gt_status error_code;
 				gt_template *template=gt_template_new();
+				sr_buffer *sr_buf=sr_buffer_new();
 				if(gt_input_generic_parser_attributes_is_paired(param.parser_attr)) {
 					while ((error_code=gt_input_generic_parser_get_template(buffered_input,template,param.parser_attr))) {
 						if (error_code!=GT_IMP_OK) {
@@ -565,7 +959,7 @@ int main(int argc,char *argv[])
 						}
 						gt_alignment *alignment1=gt_template_get_block(template,0);
 						gt_alignment *alignment2=gt_template_get_block(template,1);
-						pair_read(template,alignment1,alignment2,&param);
+						pair_read(template,alignment1,alignment2,sr_buf,&param);
 						if (gt_output_generic_bofprint_template(buffered_output,template,param.printer_attr)) {
 							gt_error_msg("Fatal error outputting read '"PRIgts"'\n",PRIgts_content(gt_template_get_string_tag(template)));
 						}
@@ -578,10 +972,8 @@ int main(int argc,char *argv[])
 						}
 						gt_alignment *alignment=gt_template_get_block(template,0);
 						gt_alignment_recalculate_counters(alignment);
-						GT_ALIGNMENT_ITERATE(alignment,map) {
-							if(map->gt_score==GT_MAP_NO_GT_SCORE) map->gt_score=calculate_dist_score(alignment,map,param.qual_offset,param.indel_quality);
-							map->phred_score=255;
-						}
+						score_alignment(alignment,sr_buf,&param);
+						GT_ALIGNMENT_ITERATE(alignment,map) map->phred_score=255;
 						if (gt_output_generic_bofprint_alignment(buffered_output,alignment,param.printer_attr)) {
 							gt_error_msg("Fatal error outputting read '"PRIgts"'\n",PRIgts_content(gt_template_get_string_tag(template)));
 						}
@@ -589,6 +981,7 @@ int main(int argc,char *argv[])
 				}
 				// Clean
 				gt_template_delete(template);
+				sr_buffer_delete(sr_buf);
 				gt_buffered_input_file_close(buffered_input);
 				gt_buffered_output_file_close(buffered_output);
 			}
@@ -596,7 +989,8 @@ int main(int argc,char *argv[])
 		}
 		gt_output_file_close(output_file);
 		gt_generic_printer_attributes_delete(param.printer_attr);
-		if(param.ins_dist) {
+		if(param.ins_model_mm) gt_mm_free(param.ins_model_mm);
+		else if(param.ins_dist) {
 			free(param.ins_dist);
 			free(param.ins_phred);
 		}
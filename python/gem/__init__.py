@@ -145,6 +145,7 @@ executables = execs_dict({
     "gt.map.2.sam": "gt.map.2.sam",
     "gt.mapset": "gt.mapset",
     "gt.gtfcount": "gt.gtfcount",
+    "gt.junctions": "gt.junctions",
     "gt.stats": "gt.stats"
     })
 
@@ -661,12 +662,6 @@ def extract_junctions(input,
         threads=threads,
         extra=extra)
 
-    annotation_junctions = None
-    if annotation is not None:
-        annotation_junctions = annotation
-        if isinstance(annotation, basestring):
-            annotation_junctions = gem.junctions.from_gtf(annotation)
-
     denovo_junctions = splits.extract_denovo_junctions(
         splitmap.raw_stream(),  # pass the raw stream
         minsplit=min_split,
@@ -676,7 +671,7 @@ def extract_junctions(input,
         max_junction_matches=max_junction_matches,
         process=splitmap.process,
         threads=max(1, threads / 2),
-        annotation_junctions=annotation_junctions
+        annotation_junctions=annotation
     )
     return denovo_junctions
 
@@ -1,5 +1,7 @@
 #!/usr/bin/env python
+import os
 import re
+import tempfile
 import logging
 import gem
 from gem.junctions import JunctionSite
@@ -15,70 +17,42 @@ def extract_denovo_junctions(input, minsplit=4, maxsplit=2500000, sites=None, co
                 merged into, default is None
     coverage  - if > 0, a junction must be found > coverage times
                 to be considered, default is 0 and therefore disabled
+    annotation_junctions - GTF annotation or set of annotated junction
+                sites. Junctions that share a site with an annotated
+                junction are kept regardless of the coverage
     """
-    splits2junctions_p = [
-        gem.executables['gem-rna-tools'],
-        'splits-2-junctions',
+    junctions_p = [
+        gem.executables['gt.junctions'],
         '--min-split-size', str(minsplit),
         '--max-split-size', str(maxsplit),
         '--max-matches', str(max_junction_matches),
+        '--coverage', str(coverage),
         '--threads', str(threads)
     ]
-    p = gem.utils.run_tool(splits2junctions_p, input=input, write_map=True)
+    annotation_file = None
+    if coverage > 0 and annotation_junctions is not None:
+        if isinstance(annotation_junctions, basestring):
+            junctions_p.extend(['--annotation', annotation_junctions])
+        else:
+            annotation_file = tempfile.NamedTemporaryFile(suffix=".junctions", delete=False)
+            for site in annotation_junctions:
+                annotation_file.write("%s\n" % (str(site)))
+            annotation_file.close()
+            junctions_p.extend(['--annotation-junctions', annotation_file.name])
+    p = gem.utils.run_tool(junctions_p, input=input, write_map=True)
 
     ## read from process stdout and get junctions
     if sites is None:
         sites = set([])
     initial_size = len(sites)
-    local_sites = {}
     for line in p.stdout:
-        js = JunctionSite(line=line)
-        if coverage > 0:
-            if js.hash not in local_sites:
-                local_sites[js.hash] = js
-                local_sites[js.hash].coverage = 1
-            else:
-                local_sites[js.hash].coverage += 1
-        else:
-            sites.add(js)
-
-    if coverage > 0:
-        annotation_positions = None
-
-        def __get_junciton_sites(site):
-            """Helper to create hashable strings out of the junctions site chromosome
-            and position. This returns a tuple with two string that represent
-            the two junciton sites
-            """
-            j1 = "%s-%s" % (str(site.descriptor[0]), str(site.descriptor[2]))
-            j2 = "%s-%s" % (str(site.descriptor[3]), str(site.descriptor[5]))
-            return (j1, j2)
-
-        if annotation_junctions is not None:
-            # create a position dict from the annotation
-            # junctions to make sure that coverage is ignored
-            # if the junctions is covered just by one side of
-            # the annotation junciton side
-            logging.info("Updating junction position lookup")
-            annotation_positions = {}
-            for site in annotation_junctions:
-                j1, j2 = __get_junciton_sites(site)
-                annotation_positions[j1] = True
-                annotation_positions[j2] = True
-            logging.info("Annotation position lookup prepared")
-
-        for i, e in local_sites.items():
-            if e.coverage >= coverage:
-                sites.add(e)
-            else:
-                if annotation_positions is not None:
-                    j1, j2 = __get_junciton_sites(e)
-                    if j1 in annotation_positions or j2 in annotation_positions:
-                        sites.add(e)
+        sites.add(JunctionSite(line=line))
 
     exit_value = p.wait()
     if process is not None:
         process.wait()
+    if annotation_file is not None:
+        os.remove(annotation_file.name)
     if exit_value != 0:
         logging.error("Error while executing junction extraction")
         exit(1)
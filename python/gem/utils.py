@@ -364,6 +364,13 @@ class ProcessInput(object):
     def write(self, process):
         self.process = process
         logging.debug("Preparing process input stream -- clean_id: %s, append_extra: %s, write_map:%s" % (str(self.clean_id), str(self.append_extra), str(self.write_map)))
+        if isinstance(self.input, (gt.InputFile, gt.interleave)):
+            # write on native threads into a copy of the process stdin
+            # descriptor, closed by the writer when done
+            outfile = gt.OutputFile(os.dup(self.process.stdin.fileno()), clean_id=self.clean_id, append_extra=self.append_extra)
+            self.process.stdin.close()
+            self.thread = self.input.write_stream(outfile, write_map=self.write_map, threads=2, async=True)
+            return
         self.thread = mp.Process(target=ProcessInput.__write_input, args=(self,))
         register_process(self.thread)
         #self.thread = Thread(target=ProcessInput.__write_input, args=(self,))
@@ -372,7 +379,10 @@ class ProcessInput(object):
 
     def wait(self):
         if self.thread is not None:
-            self.thread.join()
+            if isinstance(self.thread, gt.WriteStreamHandle):
+                self.thread.wait()
+            else:
+                self.thread.join()
 
 
 class ProcessWrapper(object):
@@ -26,6 +26,10 @@ cdef extern from "Python.h":
     PyObject* PyString_FromStringAndSize(char *v, Py_ssize_t len)
     void PyEval_InitThreads()
 
+cdef extern from "stdio.h":
+    FILE* fdopen(int fd, char* mode)
+    int fclose(FILE* stream)
+
 cdef extern from "fileobject.h":
     ctypedef class __builtin__.file [object PyFileObject]:
         pass
@@ -213,6 +217,7 @@ cdef extern from "gem_tools.h" nogil:
         pass
     gt_template* gt_template_new()
     void gt_template_delete(gt_template* template)
+    gt_template* gt_template_dup(gt_template* template, bool copy_maps, bool copy_mmaps)
     char* gt_template_get_tag(gt_template* template)
     void gt_template_set_tag(gt_template* template, char* tag, uint64_t length)
     uint64_t gt_template_get_num_blocks(gt_template* template)
@@ -301,4 +306,40 @@ cdef extern from "gem_tools.h" nogil:
 
 
 cdef extern from "gemtools_binding.h" nogil:
-    void gt_write_stream(gt_output_file* output, gt_input_file** inputs, uint64_t num_inputs, bool append_extra, bool clean_id, bool interleave, uint64_t threads, bool write_map, bool remove_scores)
\ No newline at end of file
+    gt_status gt_write_stream(gt_output_file* output, gt_input_file** inputs, uint64_t num_inputs, bool append_extra, bool clean_id, bool interleave, uint64_t threads, bool write_map, bool remove_scores)
+
+    # write stream jobs
+    ctypedef struct gt_write_stream_job:
+        pass
+    gt_write_stream_job* gt_write_stream_start(gt_output_file* output, FILE* output_stream, gt_input_file** inputs, uint64_t num_inputs, bool append_extra, bool clean_id, bool interleave, uint64_t threads, bool write_map, bool remove_scores)
+    bool gt_write_stream_job_is_done(gt_write_stream_job* job)
+    gt_status gt_write_stream_job_join(gt_write_stream_job* job)
+    void gt_write_stream_job_delete(gt_write_stream_job* job)
+
+    # template batches
+    ctypedef long long gt_batch_column
+    ctypedef enum gt_batch_column_id:
+        GT_BATCH_READ_LENGTH
+        GT_BATCH_BEST_STRATUM
+        GT_BATCH_NUM_MAPS
+        GT_BATCH_MAPQ
+        GT_BATCH_CONTIG
+        GT_BATCH_POSITION
+        GT_BATCH_NUM_COLUMNS
+
+    ctypedef struct gt_template_batch:
+        pass
+    gt_template_batch* gt_template_batch_new()
+    void gt_template_batch_delete(gt_template_batch* batch)
+    uint64_t gt_template_batch_get_num_templates(gt_template_batch* batch)
+    gt_template* gt_template_batch_get_template(gt_template_batch* batch, uint64_t position)
+    gt_batch_column* gt_template_batch_get_column(gt_template_batch* batch, gt_batch_column_id column)
+    gt_status gt_template_batch_write(gt_output_file* output, gt_template_batch* batch, unsigned char* keep_mask, bool write_map, gt_output_map_attributes* map_attributes, gt_output_fasta_attributes* fasta_attributes)
+
+    ctypedef struct gt_batch_reader:
+        pass
+    gt_batch_reader* gt_batch_reader_new(gt_input_file* input_file, bool force_paired_reads, uint64_t threads)
+    void gt_batch_reader_delete(gt_batch_reader* reader)
+    uint64_t gt_batch_reader_fill(gt_batch_reader* reader, gt_template_batch* batch, uint64_t num_templates)
+    uint64_t gt_batch_reader_get_num_contigs(gt_batch_reader* reader)
+    char* gt_batch_reader_get_contig_name(gt_batch_reader* reader, uint64_t contig_id)
@@ -1,8 +1,8 @@
 from gemapi cimport *
+from cpython.buffer cimport PyObject_GetBuffer, PyBuffer_Release, PyBUF_SIMPLE, PyBUF_WRITABLE, PyBUF_FORMAT
 
 import os
 import sys
-import multiprocessing
 import string
 
 
@@ -178,14 +178,17 @@ cdef class interleave(object):
                     if mises >= self.length or self.i >= self.length:
                         raise StopIteration()
 
-    cpdef write_stream(self, OutputFile output, bool write_map=False, uint64_t threads=1):
+    cpdef write_stream(self, OutputFile output, bool write_map=False, uint64_t threads=1, bool async=False):
         """Write the content interleaved to the output file
 
         output_file   -- the output file
         write_map     -- if true, write map, otherwise write fasta/q sequence
         threads       -- number of threads to use (if supported by the iterator)
+        async         -- return without waiting for the write to finish
+
+        Returns the WriteStreamHandle of the write
         """
-        __run_write_stream(self.files, output, write_map, max(threads, self.threads), self.interleave, None)
+        return __run_write_stream(self.files, output, write_map, max(threads, self.threads), self.interleave, None, async=async)
 
     cpdef close(self):
         try:
@@ -208,6 +211,8 @@ cdef class OutputFile:
     """
     # the target output file
     cdef gt_output_file* output_file
+    # the stream opened from a file descriptor target (closed along with the output)
+    cdef FILE* output_stream
     # the target
     cdef readonly object target
     # the map attributes
@@ -230,7 +235,8 @@ cdef class OutputFile:
         the first space in the id or the everything after the casava id in case
         of tempalte tags encoded as casava >= 1.8+.
 
-        target       -- the target file or stream
+        target       -- the target file name (also a FIFO), file descriptor or stream.
+                        File descriptors are owned (and closed) by the output file
         clean_id     -- ensure /1 /2 read pair encoding
         append_extra -- append additional infomration to the id
         init_buffer  -- if true, the buffered output will be initialized, default True
@@ -250,6 +256,8 @@ cdef class OutputFile:
         # open the outout file or stream
         if isinstance(target, basestring):
             self._open_file(<char*> target)
+        elif isinstance(target, (int, long)):
+            self._open_fd(target)
         else:
             self._open_stream(<file> target)
 
@@ -274,6 +282,16 @@ cdef class OutputFile:
         """
         self.output_file = gt_output_stream_new(PyFile_AsFile(stream), SORTED_FILE)
 
+    cpdef _open_fd(self, int fd):
+        """Initialize this instance from a file descriptor
+
+        fd -- the output file descriptor (i.e. the write end of a pipe)
+        """
+        self.output_stream = fdopen(fd, "w")
+        if self.output_stream is NULL:
+            raise IOError("Can not open file descriptor %d for writing" % fd)
+        self.output_file = gt_output_stream_new(self.output_stream, SORTED_FILE)
+
     cpdef _open_file(self, char* file_name):
         """Initialize this instance from a file
 
@@ -287,7 +305,10 @@ cdef class OutputFile:
         if self.output_file is not NULL:
             gt_output_file_close(self.output_file)
             self.output_file = NULL
-        if not isinstance(self.target, basestring):
+        if self.output_stream is not NULL:
+            fclose(self.output_stream)
+            self.output_stream = NULL
+        if not isinstance(self.target, (basestring, int, long)):
             self.target.close()
 
     cpdef write(self, Template template, write_map=True):
@@ -306,6 +327,36 @@ cdef class OutputFile:
         else:
             gt_output_fasta_ofprint_template(self.output_file, template.template, self.fasta_attributes)
 
+    cpdef write_batch(self, TemplateBatch batch, write_map=True, mask=None):
+        """Write all the templates of a batch to this output file.
+        Output filters are not applied (they work on single templates),
+        use the mask to select templates instead.
+
+        batch     -- the source batch
+        write_map -- writes map or fastq/a format
+        mask      -- optional keep mask, one byte per template (i.e. a
+                     numpy bool array computed from the batch columns).
+                     Only templates with a non zero entry are written
+        """
+        cdef Py_buffer mask_buffer
+        cdef unsigned char* keep_mask = NULL
+        cdef bool map_output = write_map
+        cdef gt_status status
+        if self.filters is not None:
+            raise ValueError("Output filters can not be applied to batches, use a mask")
+        if mask is not None:
+            PyObject_GetBuffer(mask, &mask_buffer, PyBUF_SIMPLE)
+            if mask_buffer.len != len(batch):
+                PyBuffer_Release(&mask_buffer)
+                raise ValueError("The mask must have one byte per template (%d bytes given, %d templates)" % (mask_buffer.len, len(batch)))
+            keep_mask = <unsigned char*> mask_buffer.buf
+        with nogil:
+            status = gt_template_batch_write(self.output_file, batch.batch, keep_mask, map_output, self.map_attributes, self.fasta_attributes)
+        if mask is not None:
+            PyBuffer_Release(&mask_buffer)
+        if status != GT_STATUS_OK:
+            raise IOError("Error writing template batch")
+
 
 
 cdef class InputFile(object):
@@ -434,7 +485,18 @@ cdef class InputFile(object):
                 self.process.wait()
         return s
 
-    cpdef write_stream(self, OutputFile output, bool write_map=False, uint64_t threads=1):
+    def batches(self, uint64_t num_templates=1000, uint64_t threads=1):
+        """Return an iterator over batches of up to num_templates templates.
+        Batches are parsed in C without holding the GIL and expose per-template
+        columns (see TemplateBatch). With more than one thread, MAP input
+        is parsed in parallel (the order of the templates is kept).
+
+        num_templates -- maximum number of templates per batch
+        threads       -- number of parsing threads
+        """
+        return TemplateBatchReader(self, num_templates, threads)
+
+    cpdef write_stream(self, OutputFile output, bool write_map=False, uint64_t threads=1, bool async=False):
         """Write the content of this input stream to the output file
         file.
 
@@ -442,8 +504,11 @@ cdef class InputFile(object):
         write_map     -- if true, write map, otherwise write fasta/q sequence
         interleave    -- interleave muliple inputs
         threads       -- number of threads to use (if supported by the iterator)
+        async         -- return without waiting for the write to finish
+
+        Returns the WriteStreamHandle of the write
         """
-        __run_write_stream([self], output, write_map, threads, True, self.process, remove_scores=self.remove_scores)
+        return __run_write_stream([self], output, write_map, threads, True, self.process, async=async, remove_scores=self.remove_scores)
 
     cpdef close(self):
         if self.buffered_input is not NULL:
@@ -457,36 +522,262 @@ cdef class InputFile(object):
             self.input_file = NULL
 
 
-cpdef __run_write_stream(source, OutputFile output, bool write_map=False, uint64_t threads=1, bool interleave=True, parent=None, function=__write_stream, bool async=False, bool remove_scores=False):
-    import gem.utils
-    process = multiprocessing.Process(target=function, args=(source, output, write_map, threads, interleave, remove_scores))
-    gem.utils.register_process(process)
-    process.start()
+cdef class TemplateBatchReader(object):
+    """Iterator over the template batches of an input file.
+    Contig IDs are consistent across all the batches of a reader.
+    """
+    # the source input file
+    cdef readonly InputFile source
+    # max number of templates per batch
+    cdef readonly uint64_t batch_size
+    # contig names (the contig ID is the position in the list)
+    cdef readonly object contigs
+    cdef gt_input_file* input_file
+    cdef gt_batch_reader* reader
+
+    def __init__(self, InputFile source, uint64_t batch_size=1000, uint64_t threads=1):
+        self.source = source
+        self.batch_size = batch_size
+        self.contigs = []
+        self.input_file = source._open()
+        self.reader = gt_batch_reader_new(self.input_file, source.force_paired_reads, threads)
+
+    def __dealloc__(self):
+        self.close()
+
+    def __iter__(self):
+        return self
+
+    def __next__(self):
+        cdef TemplateBatch batch = TemplateBatch()
+        cdef uint64_t num_templates = 0
+        cdef uint64_t num_contigs = 0
+        if self.reader is not NULL:
+            with nogil:
+                num_templates = gt_batch_reader_fill(self.reader, batch.batch, self.batch_size)
+        if num_templates == 0:
+            if self.reader is not NULL and self.source.process is not None:
+                # if this is a stream based process, make sure we clean up
+                self.source.process.wait()
+            self.close()
+            raise StopIteration()
+        num_contigs = gt_batch_reader_get_num_contigs(self.reader)
+        while len(self.contigs) < num_contigs:
+            self.contigs.append(gt_batch_reader_get_contig_name(self.reader, len(self.contigs)))
+        batch.contigs = self.contigs
+        return batch
+
+    cpdef close(self):
+        if self.reader is not NULL:
+            gt_batch_reader_delete(self.reader)
+            self.reader = NULL
+        if self.input_file is not NULL:
+            gt_input_file_close(self.input_file)
+            self.input_file = NULL
+
+
+cdef class TemplateBatch:
+    """Templates parsed by InputFile.batches(). Columns (one value
+    per template) are exposed as read-only int64 buffers and can be
+    wrapped by numpy without copying (numpy.asarray(batch.mapq)).
+    Templates are only materialized on access (batch[i] returns a copy).
+    """
+    cdef gt_template_batch* batch
+    # contig names, indexed by the contig_ids column
+    cdef readonly object contigs
+
+    def __cinit__(self):
+        self.batch = gt_template_batch_new()
+
+    def __dealloc__(self):
+        gt_template_batch_delete(self.batch)
+
+    def __len__(self):
+        return gt_template_batch_get_num_templates(self.batch)
+
+    def __getitem__(self, int64_t i):
+        cdef int64_t num_templates = gt_template_batch_get_num_templates(self.batch)
+        cdef Template template
+        if i < 0:
+            i += num_templates
+        if i < 0 or i >= num_templates:
+            raise IndexError("Template index out of range")
+        template = Template()
+        gt_template_delete(template.template)
+        template.template = gt_template_dup(gt_template_batch_get_template(self.batch, i), True, True)
+        return template
+
+    cdef BatchColumn _column(self, gt_batch_column_id column):
+        cdef BatchColumn c = BatchColumn()
+        c.batch = self
+        c.data = gt_template_batch_get_column(self.batch, column)
+        c.shape[0] = gt_template_batch_get_num_templates(self.batch)
+        c.strides[0] = sizeof(gt_batch_column)
+        return c
+
+    property read_lengths:
+        """Total read length (all ends)"""
+        def __get__(self):
+            return self._column(GT_BATCH_READ_LENGTH)
+
+    property best_strata:
+        """First stratum with maps, -1 if unmapped"""
+        def __get__(self):
+            return self._column(GT_BATCH_BEST_STRATUM)
+
+    property num_maps:
+        """Number of maps (paired maps for paired templates)"""
+        def __get__(self):
+            return self._column(GT_BATCH_NUM_MAPS)
+
+    property mapq:
+        """MAPQ of the first map, -1 if unmapped or not scored"""
+        def __get__(self):
+            return self._column(GT_BATCH_MAPQ)
+
+    property contig_ids:
+        """Contig of the first map (index in contigs), -1 if unmapped"""
+        def __get__(self):
+            return self._column(GT_BATCH_CONTIG)
+
+    property positions:
+        """Position of the first map, 0 if unmapped"""
+        def __get__(self):
+            return self._column(GT_BATCH_POSITION)
+
+
+cdef class BatchColumn:
+    """Read-only int64 column of a TemplateBatch (supports the buffer protocol)"""
+    # keeps the batch memory alive
+    cdef TemplateBatch batch
+    cdef gt_batch_column* data
+    cdef Py_ssize_t shape[1]
+    cdef Py_ssize_t strides[1]
+
+    def __len__(self):
+        return self.shape[0]
+
+    def __getitem__(self, Py_ssize_t i):
+        if i < 0:
+            i += self.shape[0]
+        if i < 0 or i >= self.shape[0]:
+            raise IndexError("Column index out of range")
+        return self.data[i]
+
+    def tolist(self):
+        return [self.data[i] for i in range(self.shape[0])]
+
+    def __getbuffer__(self, Py_buffer* buffer, int flags):
+        if flags & PyBUF_WRITABLE:
+            raise BufferError("Batch columns are read-only")
+        buffer.buf = <void*> self.data
+        buffer.obj = self
+        buffer.len = self.shape[0] * sizeof(gt_batch_column)
+        buffer.itemsize = sizeof(gt_batch_column)
+        buffer.readonly = 1
+        buffer.ndim = 1
+        if flags & PyBUF_FORMAT:
+            buffer.format = "q"
+        else:
+            buffer.format = NULL
+        buffer.shape = self.shape
+        buffer.strides = self.strides
+        buffer.suboffsets = NULL
+        buffer.internal = NULL
+
+    def __releasebuffer__(self, Py_buffer* buffer):
+        pass
+
 
+cpdef __run_write_stream(source, OutputFile output, bool write_map=False, uint64_t threads=1, bool interleave=True, parent=None, bool async=False, bool remove_scores=False):
+    """Write the source input files to the output on native threads
+    (no process is forked). Unless async, the write is waited for.
+    Returns the WriteStreamHandle of the write.
+    """
+    handle = WriteStreamHandle(source, output, write_map, threads, interleave, parent, remove_scores)
     if not async:
-        process.join()
-        if parent is not None:
-            parent.wait()
-    return process
-
-cpdef __write_stream(source, OutputFile output, bool write_map=False, uint64_t threads=1, bool interleave=True, bool remove_scores=False):
-    cdef gt_output_file* output_file = output.output_file
-    cdef uint64_t num_inputs = len(source)
-    cdef gt_input_file** inputs = <gt_input_file**>malloc( num_inputs *sizeof(gt_input_file*))
-    cdef bool clean_id = output.clean_id
-    cdef bool append_extra = output.append_extra
-    cdef uint64_t use_threads = threads
-
-    for i in range(num_inputs):
-        inputs[i] = (<InputFile> source[i])._open()
-
-    with nogil:
-        gt_write_stream(output_file, inputs, num_inputs, append_extra, clean_id, interleave, use_threads, write_map, remove_scores)
-
-    output.close()
-    for i in range(num_inputs):
-        gt_input_file_close(inputs[i])
-    free(inputs)
+        handle.wait()
+    return handle
+
+
+cdef class WriteStreamHandle(object):
+    """Handle on a stream write running on native threads
+    with the GIL released. The write owns the output file and the
+    inputs, and closes them as soon as it is done (so a process reading
+    from a pipe/FIFO output gets EOF right away).
+    """
+    cdef gt_write_stream_job* job
+    # the target output file
+    cdef readonly OutputFile output
+    # the process that creates the input (waited for after the write)
+    cdef readonly object parent
+    # the source input files
+    cdef readonly object source
+    # the output and parent have been closed and waited for
+    cdef bool finished
+
+    def __init__(self, source, OutputFile output, bool write_map=False, uint64_t threads=1, bool interleave=True, parent=None, bool remove_scores=False):
+        cdef uint64_t num_inputs = len(source)
+        cdef gt_input_file** inputs = NULL
+        cdef gt_output_file* output_file = output.output_file
+        cdef FILE* output_stream = output.output_stream
+        if output_file is NULL:
+            raise ValueError("The output file is closed")
+        self.output = output
+        self.parent = parent
+        self.source = source
+        inputs = <gt_input_file**>malloc(num_inputs * sizeof(gt_input_file*))
+        for i in range(num_inputs):
+            inputs[i] = (<InputFile> source[i])._open()
+        # the write owns the output from now on
+        output.output_file = NULL
+        output.output_stream = NULL
+        self.job = gt_write_stream_start(output_file, output_stream, inputs, num_inputs, output.append_extra, output.clean_id, interleave, threads, write_map, remove_scores)
+        free(inputs)
+
+    def __dealloc__(self):
+        if self.job is not NULL:
+            with nogil:
+                gt_write_stream_job_delete(self.job)
+            self.job = NULL
+
+    cpdef bool done(self):
+        """True if the write finished"""
+        return gt_write_stream_job_is_done(self.job)
+
+    def is_alive(self):
+        return not self.done()
+
+    property exitcode:
+        """None while writing, 0 if the write succeeded, 1 otherwise"""
+        def __get__(self):
+            if not self.done():
+                return None
+            return 0 if self._join() == GT_STATUS_OK else 1
+
+    cdef gt_status _join(self):
+        cdef gt_status status
+        with nogil:
+            status = gt_write_stream_job_join(self.job)
+        return status
+
+    def join(self):
+        """Wait for the write to finish"""
+        self._join()
+
+    cpdef wait(self):
+        """Wait for the write to finish, close the output and wait for the
+        parent process (if any). Raises an IOError if the write failed.
+        """
+        cdef gt_status status = self._join()
+        if not self.finished:
+            self.finished = True
+            self.output.close()
+            if self.parent is not None:
+                self.parent.wait()
+        if status != GT_STATUS_OK:
+            raise IOError("Error while writing to %s" % (str(self.output.target)))
+        return True
 
 
 cdef _create_alignment(gt_alignment* ali):
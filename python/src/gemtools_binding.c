@@ -10,7 +10,7 @@ bool gt_input_file_has_qualities(gt_input_file* file){
 }
 
 
-void gt_write_stream(gt_output_file* output, gt_input_file** inputs, uint64_t num_inputs, bool append_extra, bool clean_id, bool interleave, uint64_t threads, bool write_map, bool remove_scores){
+gt_status gt_write_stream(gt_output_file* output, gt_input_file** inputs, uint64_t num_inputs, bool append_extra, bool clean_id, bool interleave, uint64_t threads, bool write_map, bool remove_scores){
   // prepare attributes
 
   gt_output_fasta_attributes* attributes = 0;
@@ -34,6 +34,7 @@ void gt_write_stream(gt_output_file* output, gt_input_file** inputs, uint64_t nu
   // generic parser attributes
   gt_generic_parser_attributes* parser_attributes = gt_input_generic_parser_attributes_new(false); // do not force pairs
   pthread_mutex_t input_mutex = PTHREAD_MUTEX_INITIALIZER;
+  gt_status write_status = GT_STATUS_OK;
 
   if(interleave){
     // main loop, interleave
@@ -52,8 +53,10 @@ void gt_write_stream(gt_output_file* output, gt_input_file** inputs, uint64_t nu
 
       gt_template* template = gt_template_new();
       gt_status status;
+      gt_status synch_status;
+      bool failed = false;
       i=0;
-      while( gt_input_generic_parser_synch_blocks_a(&input_mutex, buffered_input, num_inputs, parser_attributes) == GT_STATUS_OK ){
+      while( (synch_status = gt_input_generic_parser_synch_blocks_a(&input_mutex, buffered_input, num_inputs, parser_attributes)) == GT_STATUS_OK ){
         for(i=0; i<num_inputs; i++){
           if( (status = gt_input_generic_parser_get_template(buffered_input[i], template, parser_attributes)) == GT_STATUS_OK){
             if(write_map){
@@ -62,9 +65,15 @@ void gt_write_stream(gt_output_file* output, gt_input_file** inputs, uint64_t nu
               gt_output_fasta_bofprint_template(buffered_output, template, attributes);
             }
             c++;
+          }else if(status == GT_STATUS_FAIL){
+            failed = true; // bad record (skipped)
           }
         }
       }
+      if(synch_status == GT_STATUS_FAIL || failed){
+        #pragma omp critical
+        write_status = GT_STATUS_FAIL;
+      }
       gt_buffered_output_file_close(buffered_output);
       for(i=0; i<num_inputs; i++){
         gt_buffered_input_file_close(buffered_input[i]);
@@ -84,6 +93,7 @@ void gt_write_stream(gt_output_file* output, gt_input_file** inputs, uint64_t nu
       gt_buffered_input_file* current_input = 0;
       gt_template* template = gt_template_new();
       gt_status status = 0;
+      bool failed = false;
       for(i=0; i<num_inputs;i++){
         // create input buffer
         if(i>0){
@@ -96,7 +106,8 @@ void gt_write_stream(gt_output_file* output, gt_input_file** inputs, uint64_t nu
         gt_buffered_input_file_attach_buffered_output(current_input, buffered_output);
 
         // read
-        while( gt_input_generic_parser_synch_blocks_a(&input_mutex, buffered_input, 1, parser_attributes) == GT_STATUS_OK ){
+        gt_status synch_status;
+        while( (synch_status = gt_input_generic_parser_synch_blocks_a(&input_mutex, buffered_input, 1, parser_attributes)) == GT_STATUS_OK ){
           if( (status = gt_input_generic_parser_get_template(current_input, template, parser_attributes)) == GT_STATUS_OK){
             if(write_map){
               gt_output_map_bofprint_template(buffered_output, template, map_attributes);
@@ -104,8 +115,14 @@ void gt_write_stream(gt_output_file* output, gt_input_file** inputs, uint64_t nu
               gt_output_fasta_bofprint_template(buffered_output, template, attributes);
             }
             c++;
+          }else if(status == GT_STATUS_FAIL){
+            failed = true; // bad record (skipped)
           }
         }
+        if(synch_status == GT_STATUS_FAIL || failed){
+          #pragma omp critical
+          write_status = GT_STATUS_FAIL;
+        }
         last_id = inputs[i]->processed_id;
       }
       gt_buffered_input_file_close(current_input);
@@ -118,10 +135,343 @@ void gt_write_stream(gt_output_file* output, gt_input_file** inputs, uint64_t nu
   if(attributes != NULL) gt_output_fasta_attributes_delete(attributes);
   if(map_attributes != NULL)gt_output_map_attributes_delete(map_attributes);
   gt_input_generic_parser_attributes_delete(parser_attributes);
+  return write_status;
 
   // register uint64_t i = 0;
   // for(i=0; i<num_inputs; i++){
   //     gt_input_file_close(inputs[i]);
   // }
   // gt_output_file_close(output);
-}
\ No newline at end of file
+}
+
+/*
+ * Write stream jobs
+ *   gt_write_stream() on a native thread. The job owns the output (and the stream it
+ *   was opened from, if any) and the inputs, and closes them when done, so that the
+ *   reader of a FIFO/pipe gets EOF without waiting for the caller
+ */
+void* gt_write_stream_job_run(void* job_ptr){
+  gt_write_stream_job* job = (gt_write_stream_job*)job_ptr;
+  gt_status status = gt_write_stream(job->output, job->inputs, job->num_inputs, job->append_extra, job->clean_id,
+      job->interleave, job->threads, job->write_map, job->remove_scores);
+  if(gt_output_file_close(job->output) != 0) status = GT_STATUS_FAIL;
+  if(job->output_stream != NULL && fclose(job->output_stream) != 0) status = GT_STATUS_FAIL;
+  register uint64_t i = 0;
+  for(i=0; i<job->num_inputs; i++){
+    gt_input_file_close(job->inputs[i]);
+  }
+  pthread_mutex_lock(&job->mutex);
+  job->status = status;
+  job->done = true;
+  pthread_mutex_unlock(&job->mutex);
+  return NULL;
+}
+
+gt_write_stream_job* gt_write_stream_start(gt_output_file* output, FILE* output_stream, gt_input_file** inputs, uint64_t num_inputs, bool append_extra, bool clean_id, bool interleave, uint64_t threads, bool write_map, bool remove_scores){
+  gt_write_stream_job* job = malloc(sizeof(gt_write_stream_job));
+  job->output = output;
+  job->output_stream = output_stream;
+  job->inputs = malloc(num_inputs * sizeof(gt_input_file*));
+  memcpy(job->inputs, inputs, num_inputs * sizeof(gt_input_file*));
+  job->num_inputs = num_inputs;
+  job->append_extra = append_extra;
+  job->clean_id = clean_id;
+  job->interleave = interleave;
+  job->threads = threads;
+  job->write_map = write_map;
+  job->remove_scores = remove_scores;
+  job->status = GT_STATUS_OK;
+  job->done = false;
+  job->joined = false;
+  pthread_mutex_init(&job->mutex, NULL);
+  if(pthread_create(&job->thread, NULL, gt_write_stream_job_run, job) != 0){
+    gt_error_msg("Could not start the write stream thread");
+    job->joined = true;
+    gt_write_stream_job_run(job); // run it here instead
+  }
+  return job;
+}
+
+bool gt_write_stream_job_is_done(gt_write_stream_job* job){
+  pthread_mutex_lock(&job->mutex);
+  const bool done = job->done;
+  pthread_mutex_unlock(&job->mutex);
+  return done;
+}
+
+gt_status gt_write_stream_job_join(gt_write_stream_job* job){
+  if(!job->joined){
+    pthread_join(job->thread, NULL);
+    job->joined = true;
+  }
+  return job->status;
+}
+
+void gt_write_stream_job_delete(gt_write_stream_job* job){
+  gt_write_stream_job_join(job);
+  pthread_mutex_destroy(&job->mutex);
+  free(job->inputs);
+  free(job);
+}
+
+/*
+ * Template batches
+ */
+gt_template_batch* gt_template_batch_new(){
+  gt_template_batch* batch = malloc(sizeof(gt_template_batch));
+  batch->num_templates = 0;
+  batch->templates = gt_vector_new(64, sizeof(gt_template*));
+  uint64_t i;
+  for(i=0; i<GT_BATCH_NUM_COLUMNS; i++){
+    batch->columns[i] = gt_vector_new(64, sizeof(gt_batch_column));
+  }
+  batch->text = gt_vector_new(64*1024, sizeof(char));
+  batch->records = gt_vector_new(64, sizeof(uint64_t));
+  batch->line_nums = gt_vector_new(64, sizeof(uint64_t));
+  batch->status = gt_vector_new(64, sizeof(gt_status));
+  batch->first_maps = gt_vector_new(64, sizeof(gt_map*));
+  return batch;
+}
+
+void gt_template_batch_delete(gt_template_batch* batch){
+  GT_VECTOR_ITERATE(batch->templates, template, n, gt_template*){
+    gt_template_delete(*template);
+  }
+  gt_vector_delete(batch->templates);
+  uint64_t i;
+  for(i=0; i<GT_BATCH_NUM_COLUMNS; i++){
+    gt_vector_delete(batch->columns[i]);
+  }
+  gt_vector_delete(batch->text);
+  gt_vector_delete(batch->records);
+  gt_vector_delete(batch->line_nums);
+  gt_vector_delete(batch->status);
+  gt_vector_delete(batch->first_maps);
+  free(batch);
+}
+
+uint64_t gt_template_batch_get_num_templates(gt_template_batch* batch){
+  return batch->num_templates;
+}
+
+gt_template* gt_template_batch_get_template(gt_template_batch* batch, uint64_t position){
+  gt_check(position >= batch->num_templates, POSITION_OUT_OF_RANGE_INFO, position, (uint64_t)0, batch->num_templates-1);
+  return *gt_vector_get_elm(batch->templates, position, gt_template*);
+}
+
+gt_batch_column* gt_template_batch_get_column(gt_template_batch* batch, gt_batch_column_id column){
+  return gt_vector_get_mem(batch->columns[column], gt_batch_column);
+}
+
+/* Make room for num_templates (templates are kept allocated between fills) */
+void gt_template_batch_prepare(gt_template_batch* batch, uint64_t num_templates){
+  register uint64_t i = gt_vector_get_used(batch->templates);
+  if(i < num_templates){
+    gt_vector_reserve(batch->templates, num_templates, false);
+    for(; i<num_templates; i++){
+      *gt_vector_get_elm(batch->templates, i, gt_template*) = gt_template_new();
+    }
+    gt_vector_set_used(batch->templates, num_templates);
+  }
+  for(i=0; i<GT_BATCH_NUM_COLUMNS; i++){
+    gt_vector_reserve(batch->columns[i], num_templates, false);
+  }
+  gt_vector_reserve(batch->status, num_templates, false);
+  gt_vector_reserve(batch->first_maps, num_templates, false);
+  batch->num_templates = 0;
+}
+
+/* Columns of a single template. Returns its first map (NULL if unmapped) */
+gt_map* gt_template_batch_fill_columns(gt_template_batch* batch, uint64_t position){
+  gt_template* template = *gt_vector_get_elm(batch->templates, position, gt_template*);
+  // lengths and counters
+  gt_vector_get_mem(batch->columns[GT_BATCH_READ_LENGTH], gt_batch_column)[position] = gt_template_get_total_length(template);
+  int64_t best_stratum = -1;
+  register uint64_t i = 0;
+  const uint64_t num_counters = gt_template_get_num_counters(template);
+  for(i=0; i<num_counters; i++){
+    if(gt_template_get_counter(template, i) > 0){
+      best_stratum = i;
+      break;
+    }
+  }
+  gt_vector_get_mem(batch->columns[GT_BATCH_BEST_STRATUM], gt_batch_column)[position] = best_stratum;
+  // first map
+  gt_map* first_map = NULL;
+  uint64_t gt_score = GT_MAP_NO_GT_SCORE;
+  uint8_t phred_score = GT_MAP_NO_PHRED_SCORE;
+  uint64_t num_maps = 0;
+  if(gt_template_get_num_blocks(template) == 1){
+    gt_alignment* alignment = gt_template_get_block(template, 0);
+    num_maps = gt_alignment_get_num_maps(alignment);
+    if(num_maps > 0){
+      first_map = gt_alignment_get_map(alignment, 0);
+      gt_score = first_map->gt_score;
+      phred_score = first_map->phred_score;
+    }
+  }else{
+    num_maps = gt_template_get_num_mmaps(template);
+    if(num_maps > 0){
+      gt_mmap* mmap = gt_template_get_mmap(template, 0);
+      first_map = (mmap->mmap[0] != NULL) ? mmap->mmap[0] : mmap->mmap[1];
+      gt_score = mmap->attributes.gt_score;
+      phred_score = mmap->attributes.phred_score;
+    }
+  }
+  gt_vector_get_mem(batch->columns[GT_BATCH_NUM_MAPS], gt_batch_column)[position] = num_maps;
+  gt_vector_get_mem(batch->columns[GT_BATCH_MAPQ], gt_batch_column)[position] =
+      (phred_score != GT_MAP_NO_PHRED_SCORE) ? phred_score : ((gt_score != GT_MAP_NO_GT_SCORE) ? get_mapq(gt_score) : -1);
+  gt_vector_get_mem(batch->columns[GT_BATCH_POSITION], gt_batch_column)[position] = (first_map != NULL) ? gt_map_get_position(first_map) : 0;
+  return first_map;
+}
+
+/*
+ * Batch reader
+ */
+gt_batch_reader* gt_batch_reader_new(gt_input_file* input_file, bool force_paired_reads, uint64_t threads){
+  gt_batch_reader* reader = malloc(sizeof(gt_batch_reader));
+  reader->input_file = input_file;
+  reader->buffered_input = gt_buffered_input_file_new(input_file);
+  reader->parser_attributes = gt_input_generic_parser_attributes_new(force_paired_reads);
+  reader->num_threads = (threads > 0) ? threads : 1;
+  reader->eof = false;
+  reader->contig_ids = gt_shash_new();
+  reader->contig_names = gt_vector_new(32, sizeof(char*));
+  return reader;
+}
+
+void gt_batch_reader_delete(gt_batch_reader* reader){
+  gt_buffered_input_file_close(reader->buffered_input);
+  gt_input_generic_parser_attributes_delete(reader->parser_attributes);
+  gt_shash_delete(reader->contig_ids, true);
+  gt_vector_delete(reader->contig_names);
+  free(reader);
+}
+
+uint64_t gt_batch_reader_get_num_contigs(gt_batch_reader* reader){
+  return gt_vector_get_used(reader->contig_names);
+}
+
+char* gt_batch_reader_get_contig_name(gt_batch_reader* reader, uint64_t contig_id){
+  return *gt_vector_get_elm(reader->contig_names, contig_id, char*);
+}
+
+int64_t gt_batch_reader_get_contig_id(gt_batch_reader* reader, char* contig_name){
+  int64_t* contig_id = gt_shash_get(reader->contig_ids, contig_name, int64_t);
+  if(contig_id == NULL){
+    contig_id = malloc(sizeof(int64_t));
+    *contig_id = gt_vector_get_used(reader->contig_names);
+    char* key = gt_shash_insert(reader->contig_ids, contig_name, contig_id, int64_t);
+    gt_vector_insert(reader->contig_names, key, char*);
+  }
+  return *contig_id;
+}
+
+/*
+ * Copy the next num_templates MAP records out of the input blocks
+ * (so that they outlive block reloads and can be parsed in parallel)
+ */
+uint64_t gt_batch_reader_fetch_map_records(gt_batch_reader* reader, gt_template_batch* batch, uint64_t num_templates){
+  gt_buffered_input_file* buffered_input = reader->buffered_input;
+  gt_vector_clear(batch->text);
+  gt_vector_clear(batch->records);
+  gt_vector_clear(batch->line_nums);
+  register uint64_t n = 0;
+  for(n=0; n<num_templates; n++){
+    if(gt_buffered_input_file_eob(buffered_input)){
+      if(gt_input_map_parser_reload_buffer(buffered_input, true, GT_NUM_LINES_10K) != GT_STATUS_OK){
+        reader->eof = true;
+        break;
+      }
+    }
+    const char* line = buffered_input->cursor;
+    const uint64_t line_num = buffered_input->current_line_num;
+    gt_input_map_parser_next_record(buffered_input); // Terminates the line (EOS)
+    const uint64_t length = strlen(line);
+    const uint64_t offset = gt_vector_get_used(batch->text);
+    gt_vector_reserve_additional(batch->text, length+1);
+    memcpy(gt_vector_get_mem(batch->text, char)+offset, line, length+1);
+    gt_vector_add_used(batch->text, length+1);
+    gt_vector_insert(batch->records, offset, uint64_t);
+    gt_vector_insert(batch->line_nums, line_num, uint64_t);
+  }
+  return n;
+}
+
+/*
+ * Parse up to num_templates into the batch and fill its columns. Returns the number of
+ * templates parsed (0 at the end of the input). Parsing stops at the first bad record.
+ * MAP input (not forcing pairs) is parsed in parallel using the reader threads.
+ */
+uint64_t gt_batch_reader_fill(gt_batch_reader* reader, gt_template_batch* batch, uint64_t num_templates){
+  gt_template_batch_prepare(batch, num_templates);
+  if(reader->eof || num_templates == 0) return 0;
+  gt_template** templates = gt_vector_get_mem(batch->templates, gt_template*);
+  gt_map** first_maps = gt_vector_get_mem(batch->first_maps, gt_map*);
+  int64_t i = 0;
+  uint64_t num_parsed = 0;
+  if(reader->num_threads > 1 && reader->input_file->file_format == MAP &&
+     !gt_input_generic_parser_attributes_is_paired(reader->parser_attributes)){
+    const uint64_t num_records = gt_batch_reader_fetch_map_records(reader, batch, num_templates);
+    char* text = gt_vector_get_mem(batch->text, char);
+    uint64_t* records = gt_vector_get_mem(batch->records, uint64_t);
+    uint64_t* line_nums = gt_vector_get_mem(batch->line_nums, uint64_t);
+    gt_status* status = gt_vector_get_mem(batch->status, gt_status);
+    #pragma omp parallel for num_threads(reader->num_threads) schedule(dynamic,64)
+    for(i=0; i<(int64_t)num_records; i++){
+      status[i] = gt_input_map_parse_template(text+records[i], templates[i]);
+      templates[i]->template_id = line_nums[i];
+      if(status[i] == 0) first_maps[i] = gt_template_batch_fill_columns(batch, i);
+    }
+    for(num_parsed=0; num_parsed<num_records && status[num_parsed]==0; num_parsed++); // (0 if parsed)
+    if(num_parsed < num_records){
+      gt_error_msg("Error parsing MAP record (line %"PRIu64", error code %d)", line_nums[num_parsed], status[num_parsed]);
+      reader->eof = true;
+    }
+  }else{
+    for(num_parsed=0; num_parsed<num_templates; num_parsed++){
+      if(gt_input_generic_parser_get_template(reader->buffered_input, templates[num_parsed], reader->parser_attributes) != GT_STATUS_OK){
+        reader->eof = true; // EOF or bad record (as in the template iterator)
+        break;
+      }
+      first_maps[num_parsed] = gt_template_batch_fill_columns(batch, num_parsed);
+    }
+  }
+  // contig IDs (dictionary shared across batches)
+  gt_batch_column* contigs = gt_vector_get_mem(batch->columns[GT_BATCH_CONTIG], gt_batch_column);
+  for(i=0; i<(int64_t)num_parsed; i++){
+    contigs[i] = (first_maps[i] != NULL) ? gt_batch_reader_get_contig_id(reader, gt_map_get_seq_name(first_maps[i])) : -1;
+  }
+  batch->num_templates = num_parsed;
+  for(i=0; i<GT_BATCH_NUM_COLUMNS; i++){
+    gt_vector_set_used(batch->columns[i], num_parsed);
+  }
+  return num_parsed;
+}
+
+/*
+ * Write the batch templates (only those with a non-zero keep_mask entry if given)
+ */
+gt_status gt_template_batch_write(gt_output_file* output, gt_template_batch* batch, uint8_t* keep_mask, bool write_map, gt_output_map_attributes* map_attributes, gt_output_fasta_attributes* fasta_attributes){
+  gt_string* buffer = gt_string_new(1024*1024);
+  gt_template** templates = gt_vector_get_mem(batch->templates, gt_template*);
+  gt_status status = GT_STATUS_OK;
+  register uint64_t i = 0;
+  for(i=0; i<batch->num_templates; i++){
+    if(keep_mask != NULL && !keep_mask[i]) continue;
+    if(write_map){
+      gt_output_map_sprint_template(buffer, templates[i], map_attributes);
+    }else{
+      gt_output_fasta_sprint_template(buffer, templates[i], fasta_attributes);
+    }
+    if(gt_string_get_length(buffer) >= GT_BATCH_WRITE_CHUNK){
+      if(gt_ofprintf(output, "%.*s", (int)gt_string_get_length(buffer), gt_string_get_string(buffer)) < 0) status = GT_STATUS_FAIL;
+      gt_string_clear(buffer);
+    }
+  }
+  if(gt_string_get_length(buffer) > 0){
+    if(gt_ofprintf(output, "%.*s", (int)gt_string_get_length(buffer), gt_string_get_string(buffer)) < 0) status = GT_STATUS_FAIL;
+  }
+  gt_string_delete(buffer);
+  return status;
+}
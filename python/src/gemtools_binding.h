@@ -6,6 +6,85 @@
 
 #define get_mapq(score) ((int)floor((sqrt(score)/256.0)*255))
 
-void gt_write_stream(gt_output_file* output, gt_input_file** inputs, uint64_t num_inputs, bool append_extra, bool clean_id, bool interleave, uint64_t threads, bool write_map, bool remove_scores);
+gt_status gt_write_stream(gt_output_file* output, gt_input_file** inputs, uint64_t num_inputs, bool append_extra, bool clean_id, bool interleave, uint64_t threads, bool write_map, bool remove_scores);
 bool gt_input_file_has_qualities(gt_input_file* file);
+
+/*
+ * Write stream jobs (gt_write_stream() running on its own thread)
+ */
+typedef struct {
+  gt_output_file* output;
+  FILE* output_stream; /* Closed along with the output if not NULL */
+  gt_input_file** inputs;
+  uint64_t num_inputs;
+  bool append_extra;
+  bool clean_id;
+  bool interleave;
+  uint64_t threads;
+  bool write_map;
+  bool remove_scores;
+  /* Thread and completion status */
+  pthread_t thread;
+  pthread_mutex_t mutex;
+  bool done;
+  bool joined;
+  gt_status status;
+} gt_write_stream_job;
+
+gt_write_stream_job* gt_write_stream_start(gt_output_file* output, FILE* output_stream, gt_input_file** inputs, uint64_t num_inputs, bool append_extra, bool clean_id, bool interleave, uint64_t threads, bool write_map, bool remove_scores);
+bool gt_write_stream_job_is_done(gt_write_stream_job* job);
+gt_status gt_write_stream_job_join(gt_write_stream_job* job);
+void gt_write_stream_job_delete(gt_write_stream_job* job);
+
+/*
+ * Template batches
+ *   Up to N templates parsed in one call (no python objects involved) along with
+ *   per-template columns (one int64 value per template and column)
+ */
+#define GT_BATCH_WRITE_CHUNK (4*1024*1024)
+
+typedef int64_t gt_batch_column;
+typedef enum {
+  GT_BATCH_READ_LENGTH,  // Total read length (all ends)
+  GT_BATCH_BEST_STRATUM, // First non-zero counter (-1 if unmapped)
+  GT_BATCH_NUM_MAPS,     // Number of maps (mmaps if paired)
+  GT_BATCH_MAPQ,         // MAPQ of the first map (-1 if unmapped or not scored)
+  GT_BATCH_CONTIG,       // Contig ID of the first map (-1 if unmapped). See gt_batch_reader_get_contig_name()
+  GT_BATCH_POSITION,     // Position of the first map (0 if unmapped)
+  GT_BATCH_NUM_COLUMNS
+} gt_batch_column_id;
+typedef struct {
+  uint64_t num_templates;
+  gt_vector* templates; /* (gt_template*) */
+  gt_vector* columns[GT_BATCH_NUM_COLUMNS]; /* (gt_batch_column) */
+  /* Raw records (threaded MAP parsing) */
+  gt_vector* text; /* (char) */
+  gt_vector* records; /* (uint64_t) text offset of each record */
+  gt_vector* line_nums; /* (uint64_t) */
+  gt_vector* status; /* (gt_status) Parser error code of each record */
+  gt_vector* first_maps; /* (gt_map*) */
+} gt_template_batch;
+typedef struct {
+  gt_input_file* input_file;
+  gt_buffered_input_file* buffered_input;
+  gt_generic_parser_attributes* parser_attributes;
+  uint64_t num_threads;
+  bool eof;
+  /* Contig dictionary (IDs are stable across batches) */
+  gt_shash* contig_ids; /* (int64_t) */
+  gt_vector* contig_names; /* (char*) */
+} gt_batch_reader;
+
+gt_template_batch* gt_template_batch_new();
+void gt_template_batch_delete(gt_template_batch* batch);
+uint64_t gt_template_batch_get_num_templates(gt_template_batch* batch);
+gt_template* gt_template_batch_get_template(gt_template_batch* batch, uint64_t position);
+gt_batch_column* gt_template_batch_get_column(gt_template_batch* batch, gt_batch_column_id column);
+gt_status gt_template_batch_write(gt_output_file* output, gt_template_batch* batch, uint8_t* keep_mask, bool write_map, gt_output_map_attributes* map_attributes, gt_output_fasta_attributes* fasta_attributes);
+
+gt_batch_reader* gt_batch_reader_new(gt_input_file* input_file, bool force_paired_reads, uint64_t threads);
+void gt_batch_reader_delete(gt_batch_reader* reader);
+uint64_t gt_batch_reader_fill(gt_batch_reader* reader, gt_template_batch* batch, uint64_t num_templates);
+uint64_t gt_batch_reader_get_num_contigs(gt_batch_reader* reader);
+char* gt_batch_reader_get_contig_name(gt_batch_reader* reader, uint64_t contig_id);
 #endif /* GEMTOOLS_BINDING_H */
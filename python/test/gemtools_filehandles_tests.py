@@ -131,3 +131,30 @@ def test_writing_interleaved_file():
         lines = f.readlines()
         assert len(lines) == 80000
 
+
+
+def test_writing_to_file_descriptor():
+    source = files.open(testfiles["reads_1.fastq"])
+    read_fd, write_fd = os.pipe()
+    handle = source.write_stream(gt.OutputFile(write_fd), write_map=False, async=True)
+    # the writer closes the descriptor when done
+    with os.fdopen(read_fd) as f:
+        lines = f.readlines()
+    assert handle.wait()
+    assert handle.exitcode == 0
+    assert len(lines) == 40000, len(lines)
+
+
+@with_setup(setup_func, cleanup)
+def test_writing_batches():
+    source = gt.InputFile(testfiles["test.map"])
+    target = results_dir + "/write_batches.map"
+    out = gt.OutputFile(target)
+    for batch in source.batches(4):
+        # keep uniquely mapped templates
+        mask = bytearray([1 if n == 1 else 0 for n in batch.num_maps.tolist()])
+        out.write_batch(batch, mask=mask)
+    out.close()
+    with open(target) as f:
+        lines = f.readlines()
+        assert len(lines) == 6, len(lines)
@@ -88,6 +88,32 @@ def test_template_to_map():
     assert template.to_map() == "A/1\tAAA\t\t0\t-", "Not '%s'" % template.to_map()
 
 
+def test_template_batches():
+    infile = gt.InputFile(testfiles["test.map"])
+    batches = [b for b in infile.batches(4)]
+    assert [len(b) for b in batches] == [4, 4, 2], [len(b) for b in batches]
+    best_strata = sum([b.best_strata.tolist() for b in batches], [])
+    assert best_strata == [1, 3, 0, 1, 0, 1, 1, 0, 0, 0], best_strata
+    num_maps = sum([b.num_maps.tolist() for b in batches], [])
+    assert num_maps == [3, 2, 2, 4, 1, 1, 1, 1, 1, 1], num_maps
+    assert batches[0].read_lengths.tolist() == [75, 75, 75, 75]
+    assert batches[0].positions[0] == 77597507
+    # contig ids are shared by all batches of the input
+    contigs = batches[-1].contigs
+    assert [contigs[i] for i in batches[0].contig_ids.tolist()] == ["chr11", "chrM", "chrM", "chr6"]
+    assert contigs[batches[-1].contig_ids[1]] == "chr1"
+    # templates are copied out of the batch
+    assert batches[0][0].tag == "HWI-ST661:153:D0FTJACXX:2:1102:13924:124292"
+    assert batches[-1][-1].level() == 0
+
+
+def test_template_batches_threads():
+    columns = lambda b: (b.best_strata.tolist(), b.num_maps.tolist(), b.contig_ids.tolist(), b.positions.tolist())
+    single = [columns(b) for b in gt.InputFile(testfiles["test.map"]).batches(3)]
+    threaded = [columns(b) for b in gt.InputFile(testfiles["test.map"]).batches(3, threads=2)]
+    assert single == threaded
+
+
 def test_template_to_fasta():
     template = gt.Template()
     template.parse("A/1\tAAA\t\t0\t-\n")
@@ -262,6 +262,20 @@ def test_junction_extraction_from_splitmap():
     assert len(jj) == 260
 
 
+@with_setup(setup_func, cleanup)
+def test_denovo_junctions_coverage_and_annotation_rescue():
+    input = gt.InputFile(testfiles["chr21_mapping_initial_split.map"])
+    denovo = gem.splits.extract_denovo_junctions(input)
+    assert len(denovo) == 23
+    ## all sites are covered by a single split map
+    input = gt.InputFile(testfiles["chr21_mapping_initial_split.map"])
+    assert len(gem.splits.extract_denovo_junctions(input, coverage=2)) == 0
+    ## using the sites as annotation rescues all of them
+    input = gt.InputFile(testfiles["chr21_mapping_initial_split.map"])
+    rescued = gem.splits.extract_denovo_junctions(input, coverage=2, annotation_junctions=denovo)
+    assert rescued == denovo
+
+
 @with_setup(setup_func, cleanup)
 def test_quality_pass_on_execution():
     input = files.open(testfiles["reads_1.fastq"])